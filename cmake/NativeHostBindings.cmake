@@ -0,0 +1,55 @@
+# Binding generation for managed plugins
+#
+# native_host_generate_bindings(<target>
+#     ASSEMBLY <path/to/Plugin.dll>
+#     OUTPUT <path/to/Plugin.bindings.h>
+#     [DEPENDS <targets or files>...])
+#
+# Reads the plugin's metadata with BindingGenerator (the assembly is never loaded) and writes a
+# C/C++ header with the struct layouts and function pointer types of every [UnmanagedCallersOnly]
+# export. The header's directory is added to the target's include path.
+
+set(NATIVE_HOST_BINDING_GENERATOR_DIR "${CMAKE_BINARY_DIR}/tools/BindingGenerator")
+set(NATIVE_HOST_BINDING_GENERATOR "${NATIVE_HOST_BINDING_GENERATOR_DIR}/BindingGenerator.dll")
+
+file(GLOB NATIVE_HOST_BINDING_GENERATOR_SOURCES
+    "${CMAKE_SOURCE_DIR}/src/BindingGenerator/*.cs"
+    "${CMAKE_SOURCE_DIR}/src/BindingGenerator/*.csproj"
+)
+
+add_custom_command(
+    OUTPUT ${NATIVE_HOST_BINDING_GENERATOR}
+    COMMAND ${DOTNET_EXE} build ${CMAKE_SOURCE_DIR}/src/BindingGenerator/BindingGenerator.csproj
+        -c Release
+        -o ${NATIVE_HOST_BINDING_GENERATOR_DIR}
+    DEPENDS ${NATIVE_HOST_BINDING_GENERATOR_SOURCES}
+    WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
+    COMMENT "Building BindingGenerator"
+)
+add_custom_target(build_binding_generator DEPENDS ${NATIVE_HOST_BINDING_GENERATOR})
+
+function(native_host_generate_bindings TARGET)
+    cmake_parse_arguments(ARG "" "ASSEMBLY;OUTPUT" "DEPENDS" ${ARGN})
+    if(NOT ARG_ASSEMBLY OR NOT ARG_OUTPUT)
+        message(FATAL_ERROR "native_host_generate_bindings requires ASSEMBLY and OUTPUT")
+    endif()
+
+    get_filename_component(OUTPUT_NAME ${ARG_OUTPUT} NAME_WE)
+    get_filename_component(OUTPUT_DIR ${ARG_OUTPUT} DIRECTORY)
+    set(GENERATE_TARGET ${TARGET}_${OUTPUT_NAME}_bindings)
+
+    # The plugin is usually produced by a dotnet publish target without declared outputs, so the
+    # generator runs on every build; it only rewrites the header when the content changes.
+    add_custom_target(${GENERATE_TARGET}
+        COMMAND ${DOTNET_EXE} ${NATIVE_HOST_BINDING_GENERATOR} ${ARG_ASSEMBLY}
+            -o ${ARG_OUTPUT}
+            --pointer-size ${CMAKE_SIZEOF_VOID_P}
+        BYPRODUCTS ${ARG_OUTPUT}
+        DEPENDS build_binding_generator ${ARG_DEPENDS}
+        COMMENT "Generating bindings for ${ARG_ASSEMBLY}"
+        VERBATIM
+    )
+
+    add_dependencies(${TARGET} ${GENERATE_TARGET})
+    target_include_directories(${TARGET} PRIVATE ${OUTPUT_DIR})
+endfunction()
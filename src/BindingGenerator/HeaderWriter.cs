@@ -0,0 +1,183 @@
+using System.Text;
+
+namespace BindingGenerator;
+
+/// <summary>
+/// Emits a C/C++ header with struct layouts and function pointer types for the exports
+/// </summary>
+internal static class HeaderWriter
+{
+    private static readonly HashSet<string> ReservedNames = new()
+    {
+        "auto", "bool", "break", "case", "char", "class", "const", "continue", "default", "delete", "do",
+        "double", "else", "enum", "extern", "float", "for", "goto", "if", "inline", "int", "long", "new",
+        "operator", "private", "protected", "public", "register", "restrict", "return", "short", "signed",
+        "sizeof", "static", "struct", "switch", "template", "this", "throw", "typedef", "union", "unsigned",
+        "virtual", "void", "volatile", "while"
+    };
+
+    public static string Write(MetadataModel model, string sourceName)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine($"/* Generated by BindingGenerator from {sourceName}. Do not edit. */");
+        sb.AppendLine();
+        sb.AppendLine("#pragma once");
+        sb.AppendLine();
+        sb.AppendLine("#include <stddef.h>");
+        sb.AppendLine("#include <stdint.h>");
+        sb.AppendLine("#ifndef __cplusplus");
+        sb.AppendLine("#include <stdbool.h>");
+        sb.AppendLine("#endif");
+        sb.AppendLine();
+        sb.AppendLine("#ifndef NATIVE_HOST_BINDING_ASSERT");
+        sb.AppendLine("#ifdef __cplusplus");
+        sb.AppendLine("#define NATIVE_HOST_BINDING_ASSERT(cond, msg) static_assert(cond, msg)");
+        sb.AppendLine("#define NATIVE_HOST_BINDING_ALIGNOF(type) alignof(type)");
+        sb.AppendLine("#else");
+        sb.AppendLine("#define NATIVE_HOST_BINDING_ASSERT(cond, msg) _Static_assert(cond, msg)");
+        sb.AppendLine("#define NATIVE_HOST_BINDING_ALIGNOF(type) _Alignof(type)");
+        sb.AppendLine("#endif");
+        sb.AppendLine("#endif");
+        sb.AppendLine();
+        sb.AppendLine($"NATIVE_HOST_BINDING_ASSERT(sizeof(void *) == {model.PointerSize}, \"{sourceName} bindings were generated for {model.PointerSize * 8}-bit targets\");");
+        sb.AppendLine();
+        sb.AppendLine("#ifdef __cplusplus");
+        sb.AppendLine("extern \"C\"");
+        sb.AppendLine("{");
+        sb.AppendLine("#endif");
+
+        var structs = model.Structs.Where(s => s.UnsupportedReason == null).ToList();
+        if (structs.Count > 0)
+        {
+            sb.AppendLine();
+            foreach (var definition in structs)
+            {
+                sb.AppendLine($"typedef struct {definition.CName} {definition.CName};");
+            }
+
+            foreach (var definition in structs)
+            {
+                sb.AppendLine();
+                WriteStruct(sb, model, definition);
+            }
+        }
+
+        foreach (var group in model.Exports.GroupBy(e => e.ManagedTypeName))
+        {
+            var typeCName = group.First().TypeCName;
+            sb.AppendLine();
+            sb.AppendLine($"/* {group.Key} */");
+            sb.AppendLine($"#define {typeCName}_TYPE_NAME \"{group.Key}, {model.AssemblyName}\"");
+            foreach (var export in group)
+            {
+                var parameters = export.Parameters.Count == 0
+                    ? "void"
+                    : string.Join(", ", export.Parameters.Select(p => Declare(p.Type, ParameterName(p.Name))));
+                sb.AppendLine($"typedef {TypeName(export.ReturnType)} (*{typeCName}_{export.MethodName}_fn)({parameters});");
+                if (export.EntryPoint != null)
+                {
+                    sb.AppendLine($"#define {typeCName}_{export.MethodName}_ENTRY_POINT \"{export.EntryPoint}\"");
+                }
+            }
+        }
+
+        sb.AppendLine();
+        sb.AppendLine("#ifdef __cplusplus");
+        sb.AppendLine("}");
+        sb.AppendLine("#endif");
+        return sb.ToString();
+    }
+
+    private static void WriteStruct(StringBuilder sb, MetadataModel model, StructDefinition definition)
+    {
+        sb.AppendLine($"/* {definition.ManagedName} */");
+        if (definition.Overlapping)
+        {
+            // Overlapping explicit fields have no portable C equivalent, keep only size and alignment
+            var unit = definition.Size % definition.Alignment == 0 ? definition.Alignment : 1;
+            sb.AppendLine($"struct {definition.CName}");
+            sb.AppendLine("{");
+            sb.AppendLine($"    uint{unit * 8}_t storage[{definition.Size / unit}];");
+            sb.AppendLine("};");
+        }
+        else
+        {
+            if (definition.Pack != 0)
+            {
+                sb.AppendLine($"#pragma pack(push, {definition.Pack})");
+            }
+
+            sb.AppendLine($"struct {definition.CName}");
+            sb.AppendLine("{");
+            var end = 0;
+            var padding = 0;
+            foreach (var field in definition.Fields.OrderBy(f => f.Offset))
+            {
+                if (field.Offset > AlignUp(end, field.Alignment))
+                {
+                    sb.AppendLine($"    uint8_t _padding{padding++}[{field.Offset - end}];");
+                }
+                sb.AppendLine($"    {Declare(field.Type, FieldName(field.Name))};");
+                end = field.Offset + field.Size;
+            }
+            if (definition.Fields.Count == 0 || definition.Size > AlignUp(end, definition.Alignment))
+            {
+                sb.AppendLine($"    uint8_t _padding{padding}[{definition.Size - end}];");
+            }
+            sb.AppendLine("};");
+
+            if (definition.Pack != 0)
+            {
+                sb.AppendLine("#pragma pack(pop)");
+            }
+        }
+
+        sb.AppendLine($"NATIVE_HOST_BINDING_ASSERT(sizeof({definition.CName}) == {definition.Size}, \"{definition.ManagedName} size mismatch\");");
+        sb.AppendLine($"NATIVE_HOST_BINDING_ASSERT(NATIVE_HOST_BINDING_ALIGNOF({definition.CName}) == {definition.Alignment}, \"{definition.ManagedName} alignment mismatch\");");
+        if (!definition.Overlapping)
+        {
+            foreach (var field in definition.Fields)
+            {
+                sb.AppendLine($"NATIVE_HOST_BINDING_ASSERT(offsetof({definition.CName}, {FieldName(field.Name)}) == {field.Offset}, \"{definition.ManagedName}.{field.Name} offset mismatch\");");
+            }
+        }
+    }
+
+    private static int AlignUp(int value, int alignment) => (value + alignment - 1) / alignment * alignment;
+
+    private static string TypeName(NativeType type) => type switch
+    {
+        PrimitiveNativeType p => p.CName,
+        PointerNativeType p => p.Element switch
+        {
+            UnsupportedNativeType => "void *",
+            StructNativeType s when s.Definition.UnsupportedReason != null => "void *",
+            PointerNativeType => TypeName(p.Element) + "*",
+            _ => TypeName(p.Element) + " *"
+        },
+        StructNativeType s => s.Definition.CName,
+        _ => throw new InvalidOperationException($"Type cannot be emitted: {type}")
+    };
+
+    private static string Declare(NativeType type, string name)
+    {
+        var typeName = TypeName(type);
+        return typeName.EndsWith('*') ? typeName + name : typeName + " " + name;
+    }
+
+    private static string FieldName(string managedName)
+    {
+        // Backing fields of auto-properties are named <Name>k__BackingField
+        if (managedName.StartsWith('<') && managedName.IndexOf('>') > 1)
+        {
+            managedName = managedName[1..managedName.IndexOf('>')];
+        }
+        return ParameterName(managedName);
+    }
+
+    private static string ParameterName(string managedName)
+    {
+        var name = MetadataModel.ToCName(managedName);
+        return ReservedNames.Contains(name) ? name + "_" : name;
+    }
+}
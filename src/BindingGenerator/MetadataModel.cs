@@ -0,0 +1,412 @@
+using System.Collections.Immutable;
+using System.Reflection;
+using System.Reflection.Metadata;
+using System.Reflection.PortableExecutable;
+
+namespace BindingGenerator;
+
+/// <summary>
+/// C-side view of a managed type appearing in an export signature or struct field
+/// </summary>
+internal abstract record NativeType;
+
+internal sealed record PrimitiveNativeType(string CName, int Size) : NativeType;
+
+internal sealed record PointerNativeType(NativeType Element) : NativeType;
+
+internal sealed record StructNativeType(StructDefinition Definition) : NativeType;
+
+internal sealed record UnsupportedNativeType(string Reason) : NativeType;
+
+internal sealed record StructField(string Name, NativeType Type, int Offset, int Size, int Alignment);
+
+/// <summary>
+/// Layout of a blittable value type as computed by the runtime's sequential/explicit layout rules
+/// </summary>
+internal sealed class StructDefinition
+{
+    public required string ManagedName { get; init; }
+    public required string CName { get; init; }
+    public List<StructField> Fields { get; } = new();
+    public int Size { get; set; }
+    public int Alignment { get; set; } = 1;
+    public int Pack { get; set; }
+    public bool Overlapping { get; set; }
+    public string? UnsupportedReason { get; set; }
+}
+
+internal sealed record ExportParameter(string Name, NativeType Type);
+
+internal sealed record ExportMethod(
+    string ManagedTypeName,
+    string TypeCName,
+    string MethodName,
+    string? EntryPoint,
+    NativeType ReturnType,
+    IReadOnlyList<ExportParameter> Parameters);
+
+/// <summary>
+/// [UnmanagedCallersOnly] exports and the value types they use, read from metadata only.
+/// The assembly is never loaded into the runtime.
+/// </summary>
+internal sealed class MetadataModel
+{
+    private readonly MetadataReader _reader;
+    private readonly Dictionary<TypeDefinitionHandle, StructDefinition> _structsByHandle = new();
+    private readonly SignatureProvider _provider;
+
+    public string AssemblyName { get; }
+    public int PointerSize { get; }
+    public List<StructDefinition> Structs { get; } = new();
+    public List<ExportMethod> Exports { get; } = new();
+    public List<string> Warnings { get; } = new();
+
+    private MetadataModel(MetadataReader reader, int pointerSize)
+    {
+        _reader = reader;
+        _provider = new SignatureProvider(this);
+        PointerSize = pointerSize;
+        AssemblyName = reader.GetString(reader.GetAssemblyDefinition().Name);
+    }
+
+    public static MetadataModel Read(string assemblyPath, int pointerSize)
+    {
+        using var stream = File.OpenRead(assemblyPath);
+        using var peReader = new PEReader(stream);
+        if (!peReader.HasMetadata)
+        {
+            throw new BadImageFormatException($"{assemblyPath} is not a managed assembly");
+        }
+
+        var model = new MetadataModel(peReader.GetMetadataReader(), pointerSize);
+        model.CollectExports();
+        return model;
+    }
+
+    private void CollectExports()
+    {
+        foreach (var typeHandle in _reader.TypeDefinitions)
+        {
+            var type = _reader.GetTypeDefinition(typeHandle);
+            foreach (var methodHandle in type.GetMethods())
+            {
+                var method = _reader.GetMethodDefinition(methodHandle);
+                if (!TryGetUnmanagedCallersOnly(method, out var entryPoint))
+                {
+                    continue;
+                }
+
+                var managedTypeName = GetManagedName(typeHandle);
+                var methodName = _reader.GetString(method.Name);
+                var signature = method.DecodeSignature(_provider, null);
+
+                var names = new Dictionary<int, string>();
+                foreach (var parameterHandle in method.GetParameters())
+                {
+                    var parameter = _reader.GetParameter(parameterHandle);
+                    names[parameter.SequenceNumber] = _reader.GetString(parameter.Name);
+                }
+
+                var parameters = signature.ParameterTypes
+                    .Select((t, i) => new ExportParameter(names.GetValueOrDefault(i + 1, $"arg{i}"), t))
+                    .ToList();
+
+                var unsupported = parameters.Select(p => FindUnsupported(p.Type))
+                    .Prepend(FindUnsupported(signature.ReturnType))
+                    .FirstOrDefault(r => r != null);
+                if (signature.GenericParameterCount > 0)
+                {
+                    unsupported = "generic methods cannot be exported";
+                }
+
+                if (unsupported != null)
+                {
+                    Warnings.Add($"skipping {managedTypeName}.{methodName}: {unsupported}");
+                    continue;
+                }
+
+                Exports.Add(new ExportMethod(
+                    managedTypeName,
+                    ToCName(managedTypeName),
+                    methodName,
+                    entryPoint,
+                    signature.ReturnType,
+                    parameters));
+            }
+        }
+    }
+
+    private bool TryGetUnmanagedCallersOnly(MethodDefinition method, out string? entryPoint)
+    {
+        entryPoint = null;
+        foreach (var attributeHandle in method.GetCustomAttributes())
+        {
+            var attribute = _reader.GetCustomAttribute(attributeHandle);
+            if (!IsAttribute(attribute, "System.Runtime.InteropServices", "UnmanagedCallersOnlyAttribute"))
+            {
+                continue;
+            }
+
+            var value = attribute.DecodeValue(new AttributeTypeProvider());
+            foreach (var argument in value.NamedArguments)
+            {
+                if (argument.Name == "EntryPoint" && argument.Value is string name)
+                {
+                    entryPoint = name;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    private bool IsAttribute(CustomAttribute attribute, string ns, string name)
+    {
+        EntityHandle parent;
+        switch (attribute.Constructor.Kind)
+        {
+            case HandleKind.MemberReference:
+                parent = _reader.GetMemberReference((MemberReferenceHandle)attribute.Constructor).Parent;
+                break;
+            case HandleKind.MethodDefinition:
+                parent = _reader.GetMethodDefinition((MethodDefinitionHandle)attribute.Constructor).GetDeclaringType();
+                break;
+            default:
+                return false;
+        }
+
+        return parent.Kind switch
+        {
+            HandleKind.TypeReference => IsTypeReference((TypeReferenceHandle)parent, ns, name),
+            HandleKind.TypeDefinition => IsTypeDefinition((TypeDefinitionHandle)parent, ns, name),
+            _ => false
+        };
+    }
+
+    private bool IsTypeReference(TypeReferenceHandle handle, string ns, string name)
+    {
+        var reference = _reader.GetTypeReference(handle);
+        return _reader.StringComparer.Equals(reference.Namespace, ns) && _reader.StringComparer.Equals(reference.Name, name);
+    }
+
+    private bool IsTypeDefinition(TypeDefinitionHandle handle, string ns, string name)
+    {
+        var definition = _reader.GetTypeDefinition(handle);
+        return _reader.StringComparer.Equals(definition.Namespace, ns) && _reader.StringComparer.Equals(definition.Name, name);
+    }
+
+    /// <summary>
+    /// Managed type name as accepted by Type.GetType, with '+' separating nested types
+    /// </summary>
+    private string GetManagedName(TypeDefinitionHandle handle)
+    {
+        var type = _reader.GetTypeDefinition(handle);
+        var name = _reader.GetString(type.Name);
+        var declaring = type.GetDeclaringType();
+        if (!declaring.IsNil)
+        {
+            return GetManagedName(declaring) + "+" + name;
+        }
+
+        var ns = _reader.GetString(type.Namespace);
+        return string.IsNullOrEmpty(ns) ? name : ns + "." + name;
+    }
+
+    internal static string ToCName(string managedName)
+    {
+        var chars = managedName.Select(c => char.IsAsciiLetterOrDigit(c) ? c : '_').ToArray();
+        var name = new string(chars);
+        return name.Length == 0 || char.IsAsciiDigit(name[0]) ? "_" + name : name;
+    }
+
+    private static string? FindUnsupported(NativeType type) => type switch
+    {
+        UnsupportedNativeType u => u.Reason,
+        // Pointers to types without a native layout are emitted as void*
+        PointerNativeType => null,
+        StructNativeType s => s.Definition.UnsupportedReason,
+        _ => null
+    };
+
+    internal (int Size, int Alignment) SizeOf(NativeType type) => type switch
+    {
+        PrimitiveNativeType p => (p.Size, Math.Max(p.Size, 1)),
+        PointerNativeType => (PointerSize, PointerSize),
+        StructNativeType s => (s.Definition.Size, s.Definition.Alignment),
+        _ => throw new InvalidOperationException($"Type has no native layout: {type}")
+    };
+
+    private static int AlignUp(int value, int alignment) => (value + alignment - 1) / alignment * alignment;
+
+    internal NativeType ResolveDefinition(TypeDefinitionHandle handle, byte rawTypeKind)
+    {
+        if (rawTypeKind != (byte)SignatureTypeKind.ValueType)
+        {
+            return new UnsupportedNativeType($"{GetManagedName(handle)} is a reference type");
+        }
+
+        var type = _reader.GetTypeDefinition(handle);
+        if (IsEnum(type))
+        {
+            foreach (var fieldHandle in type.GetFields())
+            {
+                var field = _reader.GetFieldDefinition(fieldHandle);
+                if ((field.Attributes & FieldAttributes.Static) == 0)
+                {
+                    return field.DecodeSignature(_provider, null);
+                }
+            }
+        }
+
+        if (_structsByHandle.TryGetValue(handle, out var existing))
+        {
+            return new StructNativeType(existing);
+        }
+
+        var managedName = GetManagedName(handle);
+        var definition = new StructDefinition { ManagedName = managedName, CName = ToCName(managedName) };
+        // Registered before the fields are decoded so self-referencing pointers resolve
+        _structsByHandle[handle] = definition;
+        ComputeLayout(type, definition);
+        Structs.Add(definition);
+        return new StructNativeType(definition);
+    }
+
+    private bool IsEnum(TypeDefinition type)
+    {
+        var baseType = type.BaseType;
+        return baseType.Kind == HandleKind.TypeReference && IsTypeReference((TypeReferenceHandle)baseType, "System", "Enum");
+    }
+
+    private void ComputeLayout(TypeDefinition type, StructDefinition definition)
+    {
+        var layoutKind = type.Attributes & TypeAttributes.LayoutMask;
+        if (layoutKind == TypeAttributes.AutoLayout)
+        {
+            definition.UnsupportedReason = $"{definition.ManagedName} uses auto layout";
+            return;
+        }
+
+        var isExplicit = layoutKind == TypeAttributes.ExplicitLayout;
+        var layout = type.GetLayout();
+        definition.Pack = layout.PackingSize;
+        var pack = layout.PackingSize == 0 ? 8 : layout.PackingSize;
+
+        var end = 0;
+        var alignment = 1;
+        foreach (var fieldHandle in type.GetFields())
+        {
+            var field = _reader.GetFieldDefinition(fieldHandle);
+            if ((field.Attributes & FieldAttributes.Static) != 0)
+            {
+                continue;
+            }
+
+            var fieldType = field.DecodeSignature(_provider, null);
+            var unsupported = FindUnsupported(fieldType);
+            if (unsupported != null)
+            {
+                definition.UnsupportedReason = unsupported;
+                return;
+            }
+
+            var (size, naturalAlignment) = SizeOf(fieldType);
+            var fieldAlignment = Math.Min(naturalAlignment, pack);
+            var offset = isExplicit ? field.GetOffset() : AlignUp(end, fieldAlignment);
+            if (offset < end)
+            {
+                definition.Overlapping = true;
+            }
+
+            definition.Fields.Add(new StructField(_reader.GetString(field.Name), fieldType, offset, size, fieldAlignment));
+            end = Math.Max(end, offset + size);
+            alignment = Math.Max(alignment, fieldAlignment);
+        }
+
+        definition.Alignment = alignment;
+        definition.Size = Math.Max(AlignUp(end, alignment), 1);
+        if (layout.Size > definition.Size)
+        {
+            definition.Size = layout.Size;
+        }
+    }
+
+    private sealed class SignatureProvider : ISignatureTypeProvider<NativeType, object?>
+    {
+        private readonly MetadataModel _model;
+
+        public SignatureProvider(MetadataModel model) => _model = model;
+
+        public NativeType GetPrimitiveType(PrimitiveTypeCode typeCode) => typeCode switch
+        {
+            PrimitiveTypeCode.Void => new PrimitiveNativeType("void", 0),
+            PrimitiveTypeCode.Boolean => new PrimitiveNativeType("bool", 1),
+            PrimitiveTypeCode.Char => new PrimitiveNativeType("uint16_t", 2),
+            PrimitiveTypeCode.SByte => new PrimitiveNativeType("int8_t", 1),
+            PrimitiveTypeCode.Byte => new PrimitiveNativeType("uint8_t", 1),
+            PrimitiveTypeCode.Int16 => new PrimitiveNativeType("int16_t", 2),
+            PrimitiveTypeCode.UInt16 => new PrimitiveNativeType("uint16_t", 2),
+            PrimitiveTypeCode.Int32 => new PrimitiveNativeType("int32_t", 4),
+            PrimitiveTypeCode.UInt32 => new PrimitiveNativeType("uint32_t", 4),
+            PrimitiveTypeCode.Int64 => new PrimitiveNativeType("int64_t", 8),
+            PrimitiveTypeCode.UInt64 => new PrimitiveNativeType("uint64_t", 8),
+            PrimitiveTypeCode.Single => new PrimitiveNativeType("float", 4),
+            PrimitiveTypeCode.Double => new PrimitiveNativeType("double", 8),
+            PrimitiveTypeCode.IntPtr => new PrimitiveNativeType("intptr_t", _model.PointerSize),
+            PrimitiveTypeCode.UIntPtr => new PrimitiveNativeType("uintptr_t", _model.PointerSize),
+            _ => new UnsupportedNativeType($"{typeCode} is not blittable")
+        };
+
+        public NativeType GetTypeFromDefinition(MetadataReader reader, TypeDefinitionHandle handle, byte rawTypeKind) =>
+            _model.ResolveDefinition(handle, rawTypeKind);
+
+        public NativeType GetTypeFromReference(MetadataReader reader, TypeReferenceHandle handle, byte rawTypeKind)
+        {
+            var reference = reader.GetTypeReference(handle);
+            return new UnsupportedNativeType(
+                $"{reader.GetString(reference.Namespace)}.{reader.GetString(reference.Name)} is defined in another assembly");
+        }
+
+        public NativeType GetPointerType(NativeType elementType) => new PointerNativeType(elementType);
+
+        public NativeType GetFunctionPointerType(MethodSignature<NativeType> signature) =>
+            new PointerNativeType(new PrimitiveNativeType("void", 0));
+
+        public NativeType GetModifiedType(NativeType modifier, NativeType unmodifiedType, bool isRequired) => unmodifiedType;
+
+        public NativeType GetPinnedType(NativeType elementType) => elementType;
+
+        public NativeType GetByReferenceType(NativeType elementType) => new UnsupportedNativeType("ref parameters are not allowed");
+
+        public NativeType GetSZArrayType(NativeType elementType) => new UnsupportedNativeType("arrays are not blittable");
+
+        public NativeType GetArrayType(NativeType elementType, ArrayShape shape) => new UnsupportedNativeType("arrays are not blittable");
+
+        public NativeType GetGenericInstantiation(NativeType genericType, ImmutableArray<NativeType> typeArguments) =>
+            new UnsupportedNativeType("generic types are not supported");
+
+        public NativeType GetGenericMethodParameter(object? genericContext, int index) =>
+            new UnsupportedNativeType("generic parameters are not supported");
+
+        public NativeType GetGenericTypeParameter(object? genericContext, int index) =>
+            new UnsupportedNativeType("generic parameters are not supported");
+
+        public NativeType GetTypeFromSpecification(MetadataReader reader, object? genericContext, TypeSpecificationHandle handle, byte rawTypeKind) =>
+            reader.GetTypeSpecification(handle).DecodeSignature(this, genericContext);
+    }
+
+    /// <summary>
+    /// Only used to read the named arguments of UnmanagedCallersOnlyAttribute
+    /// </summary>
+    private sealed class AttributeTypeProvider : ICustomAttributeTypeProvider<object?>
+    {
+        public object? GetPrimitiveType(PrimitiveTypeCode typeCode) => typeCode;
+        public object? GetSystemType() => typeof(Type);
+        public object? GetSZArrayType(object? elementType) => elementType;
+        public object? GetTypeFromDefinition(MetadataReader reader, TypeDefinitionHandle handle, byte rawTypeKind) => null;
+        public object? GetTypeFromReference(MetadataReader reader, TypeReferenceHandle handle, byte rawTypeKind) => null;
+        public object? GetTypeFromSerializedName(string name) => name;
+        public PrimitiveTypeCode GetUnderlyingEnumType(object? type) => PrimitiveTypeCode.Int32;
+        public bool IsSystemType(object? type) => ReferenceEquals(type, typeof(Type));
+    }
+}
@@ -0,0 +1,78 @@
+namespace BindingGenerator;
+
+internal static class Program
+{
+    private static int Main(string[] args)
+    {
+        string? assemblyPath = null;
+        string? outputPath = null;
+        var pointerSize = 8;
+
+        for (var i = 0; i < args.Length; i++)
+        {
+            switch (args[i])
+            {
+                case "-o":
+                case "--output":
+                    outputPath = ++i < args.Length ? args[i] : null;
+                    break;
+                case "--pointer-size":
+                    if (++i >= args.Length || !int.TryParse(args[i], out pointerSize) || (pointerSize != 4 && pointerSize != 8))
+                    {
+                        return Usage("--pointer-size must be 4 or 8");
+                    }
+                    break;
+                default:
+                    if (assemblyPath != null)
+                    {
+                        return Usage($"Unexpected argument: {args[i]}");
+                    }
+                    assemblyPath = args[i];
+                    break;
+            }
+        }
+
+        if (assemblyPath == null || outputPath == null)
+        {
+            return Usage(null);
+        }
+
+        try
+        {
+            var model = MetadataModel.Read(assemblyPath, pointerSize);
+            foreach (var warning in model.Warnings)
+            {
+                Console.Error.WriteLine($"warning: {warning}");
+            }
+
+            var header = HeaderWriter.Write(model, Path.GetFileName(assemblyPath));
+            var directory = Path.GetDirectoryName(Path.GetFullPath(outputPath));
+            if (!string.IsNullOrEmpty(directory))
+            {
+                Directory.CreateDirectory(directory);
+            }
+
+            // Leave the file untouched when nothing changed so dependent sources are not rebuilt
+            if (!File.Exists(outputPath) || File.ReadAllText(outputPath) != header)
+            {
+                File.WriteAllText(outputPath, header);
+            }
+            return 0;
+        }
+        catch (Exception ex) when (ex is IOException or BadImageFormatException or InvalidOperationException)
+        {
+            Console.Error.WriteLine($"error: {ex.Message}");
+            return 1;
+        }
+    }
+
+    private static int Usage(string? error)
+    {
+        if (error != null)
+        {
+            Console.Error.WriteLine($"error: {error}");
+        }
+        Console.Error.WriteLine("Usage: BindingGenerator <assembly.dll> -o <header.h> [--pointer-size 4|8]");
+        return 2;
+    }
+}
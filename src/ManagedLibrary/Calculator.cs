@@ -10,6 +10,7 @@ public class Calculator
     private static readonly ILogger<Calculator> Logger = ManagedLibrary2.LoggerFactory.CreateLogger<Calculator>();
     private static Assembly? _dynamicAssembly;
     private static Type? _dynamicCalculatorType;
+    private static bool _resolveHandlerInstalled;
 
     static Calculator()
     {
@@ -21,14 +22,7 @@ public class Calculator
     {
         try
         {
-            string assemblyLocation = Assembly.GetExecutingAssembly().Location;
-            string assemblyDirectory = Path.GetDirectoryName(assemblyLocation);
-
-            AppDomain.CurrentDomain.AssemblyResolve += CurrentDomain_AssemblyResolve;
-
-
-            string assemblyPath = Path.Combine(assemblyDirectory, "ManagedLibrary3.dll");
-            _dynamicAssembly = Assembly.LoadFrom(assemblyPath);
+            _dynamicAssembly = LoadDynamicAssembly();
             _dynamicCalculatorType = _dynamicAssembly.GetType("ManagedLibrary3.DynamicCalculator");
             Logger.LogInformation("Successfully loaded ManagedLibrary3");
         }
@@ -39,7 +33,32 @@ public class Calculator
         Logger.LogInformation("Hello, World!");
     }
 
-    private static Assembly CurrentDomain_AssemblyResolve(object sender, ResolveEventArgs args)
+    // ManagedLibrary3 is not referenced. The host's plugin load context finds it next to this
+    // assembly; without PluginSupport the plugin runs in a context that does not, so fall back to
+    // loading it by path and resolving its dependencies from the same directory
+    private static Assembly LoadDynamicAssembly()
+    {
+        try
+        {
+            return Assembly.Load(new AssemblyName("ManagedLibrary3"));
+        }
+        catch (FileNotFoundException)
+        {
+            string assemblyLocation = Assembly.GetExecutingAssembly().Location;
+            string assemblyDirectory = Path.GetDirectoryName(assemblyLocation)!;
+
+            if (!_resolveHandlerInstalled)
+            {
+                AppDomain.CurrentDomain.AssemblyResolve += CurrentDomain_AssemblyResolve;
+                _resolveHandlerInstalled = true;
+            }
+
+            string assemblyPath = Path.Combine(assemblyDirectory, "ManagedLibrary3.dll");
+            return Assembly.LoadFrom(assemblyPath);
+        }
+    }
+
+    private static Assembly? CurrentDomain_AssemblyResolve(object? sender, ResolveEventArgs args)
     {
         string dependencyPath = GetDependencyPath(args.Name);
         if (File.Exists(dependencyPath))
@@ -53,7 +72,7 @@ public class Calculator
     private static string GetDependencyPath(string assemblyName)
     {
         string assemblyLocation = Assembly.GetExecutingAssembly().Location;
-        string assemblyDirectory = Path.GetDirectoryName(assemblyLocation);
+        string assemblyDirectory = Path.GetDirectoryName(assemblyLocation)!;
         string dependencyPath = Path.Combine(assemblyDirectory, assemblyName.Split(',')[0] + ".dll");
         return dependencyPath;
     }
@@ -0,0 +1,78 @@
+using System.Diagnostics.CodeAnalysis;
+
+namespace NativeHost;
+
+/// <summary>
+/// Read-mostly map whose lookups never lock
+/// </summary>
+/// <remarks>
+/// Readers use the current snapshot; writers copy it under a lock and publish the copy, so a
+/// reader sees either the map before or after a write, never one in progress. Writes cost a
+/// copy of the map and suit tables that change far less often than they are read, such as
+/// loaded assemblies.
+/// </remarks>
+internal sealed class CopyOnWriteMap<TKey, TValue> where TKey : notnull
+{
+    private readonly object _writeLock = new();
+    private Dictionary<TKey, TValue> _snapshot = new();
+
+    public int Count => Volatile.Read(ref _snapshot).Count;
+
+    /// <summary>
+    /// Values at the time of the call; later writes do not affect the returned collection
+    /// </summary>
+    public IReadOnlyCollection<TValue> Values => Volatile.Read(ref _snapshot).Values;
+
+    public bool ContainsKey(TKey key) => Volatile.Read(ref _snapshot).ContainsKey(key);
+
+    public bool TryGetValue(TKey key, [MaybeNullWhen(false)] out TValue value)
+        => Volatile.Read(ref _snapshot).TryGetValue(key, out value);
+
+    public void Set(TKey key, TValue value)
+    {
+        lock (_writeLock)
+        {
+            var copy = new Dictionary<TKey, TValue>(_snapshot) { [key] = value };
+            Volatile.Write(ref _snapshot, copy);
+        }
+    }
+
+    /// <summary>
+    /// Adds or replaces several entries with a single copy
+    /// </summary>
+    public void SetRange(IEnumerable<KeyValuePair<TKey, TValue>> entries)
+    {
+        lock (_writeLock)
+        {
+            var copy = new Dictionary<TKey, TValue>(_snapshot);
+            foreach (var (key, value) in entries)
+            {
+                copy[key] = value;
+            }
+            Volatile.Write(ref _snapshot, copy);
+        }
+    }
+
+    public bool Remove(TKey key)
+    {
+        lock (_writeLock)
+        {
+            if (!_snapshot.ContainsKey(key))
+            {
+                return false;
+            }
+            var copy = new Dictionary<TKey, TValue>(_snapshot);
+            copy.Remove(key);
+            Volatile.Write(ref _snapshot, copy);
+            return true;
+        }
+    }
+
+    public void Clear()
+    {
+        lock (_writeLock)
+        {
+            Volatile.Write(ref _snapshot, new Dictionary<TKey, TValue>());
+        }
+    }
+}
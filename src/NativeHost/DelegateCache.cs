@@ -0,0 +1,44 @@
+using System.Collections.Concurrent;
+
+namespace NativeHost;
+
+/// <summary>
+/// Resolved delegates of one assembly, safe for concurrent lookups
+/// </summary>
+/// <remarks>
+/// Entries are keyed by type name, method name and delegate type, so a hit allocates nothing and
+/// takes no lock. The delegate type is part of the key because the same method may be requested
+/// through different delegate types.
+/// </remarks>
+internal sealed class DelegateCache
+{
+    private readonly record struct Key(string TypeName, string MethodName, Type DelegateType);
+
+    private readonly ConcurrentDictionary<Key, Delegate> _delegates = new();
+
+    public int Count => _delegates.Count;
+
+    /// <summary>
+    /// Returns the cached delegate or resolves it with <paramref name="factory"/>
+    /// </summary>
+    /// <remarks>
+    /// Threads racing on the first lookup of a method may each call the factory; one result is
+    /// kept and every caller receives that instance.
+    /// </remarks>
+    public T GetOrAdd<T, TState>(string typeName, string methodName, Func<TState, string, string, T> factory, TState state)
+        where T : Delegate
+    {
+        var key = new Key(typeName, methodName, typeof(T));
+        if (_delegates.TryGetValue(key, out var cached))
+        {
+            return (T)cached;
+        }
+
+        return (T)_delegates.GetOrAdd(
+            key,
+            static (k, resolve) => resolve.factory(resolve.state, k.TypeName, k.MethodName),
+            (factory, state));
+    }
+
+    public void Clear() => _delegates.Clear();
+}
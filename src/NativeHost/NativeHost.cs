@@ -8,11 +8,12 @@ public sealed class NativeHost : IDisposable
 {
     private bool _isDisposed;
     private readonly IntPtr _handle;
-    private readonly Dictionary<IntPtr, Assembly> _assemblies;
+    // Checked on every GetFunction; loads and unloads are rare, so lookups read a snapshot without locking
+    private readonly CopyOnWriteMap<IntPtr, Assembly> _assemblies;
 
     public NativeHost()
     {
-        _assemblies = new Dictionary<IntPtr, Assembly>();
+        _assemblies = new CopyOnWriteMap<IntPtr, Assembly>();
 
         var status = NativeMethods.Create(out _handle);
         if (status != NativeHostStatus.Success)
@@ -48,10 +49,86 @@ public sealed class NativeHost : IDisposable
         }
 
         var assembly = new Assembly(this, assemblyHandle, assemblyPath);
-        _assemblies[assemblyHandle] = assembly;
+        _assemblies.Set(assemblyHandle, assembly);
         return assembly;
     }
 
+    /// <summary>
+    /// Load a .NET assembly from an in-memory image
+    /// </summary>
+    /// <param name="image">Assembly image; the runtime copies it during the call</param>
+    /// <param name="name">Display name of the assembly</param>
+    /// <returns>Assembly instance</returns>
+    public unsafe Assembly LoadFromMemory(ReadOnlySpan<byte> image, string name)
+    {
+        ThrowIfDisposed();
+
+        if (image.IsEmpty || string.IsNullOrEmpty(name))
+        {
+            throw new ArgumentException("Image and name cannot be empty");
+        }
+
+        NativeHostStatus status;
+        IntPtr assemblyHandle;
+        fixed (byte* imagePtr = image)
+        {
+            status = NativeMethods.LoadFromMemory(_handle, imagePtr, (nuint)image.Length, name, out assemblyHandle);
+        }
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, $"Failed to load assembly from memory: {name}");
+        }
+
+        var assembly = new Assembly(this, assemblyHandle, name);
+        _assemblies.Set(assemblyHandle, assembly);
+        return assembly;
+    }
+
+    /// <summary>
+    /// Load several .NET assemblies concurrently
+    /// </summary>
+    /// <param name="assemblyPaths">Paths to the .NET assembly files</param>
+    /// <returns>Assembly instances in the order of the paths</returns>
+    /// <remarks>
+    /// Assemblies that loaded before a failure stay owned by the host and are released with it.
+    /// </remarks>
+    public Assembly[] LoadAll(IReadOnlyList<string> assemblyPaths)
+    {
+        ThrowIfDisposed();
+
+        if (assemblyPaths == null || assemblyPaths.Any(string.IsNullOrEmpty))
+        {
+            throw new ArgumentException("Assembly paths cannot be null or empty", nameof(assemblyPaths));
+        }
+
+        var paths = assemblyPaths.ToArray();
+        var handles = new IntPtr[paths.Length];
+        var statuses = new NativeHostStatus[paths.Length];
+        NativeMethods.LoadAll(_handle, paths, (uint)paths.Length, handles, statuses, IntPtr.Zero);
+
+        var assemblies = new Assembly[paths.Length];
+        var loaded = new List<KeyValuePair<IntPtr, Assembly>>(paths.Length);
+        for (var i = 0; i < paths.Length; i++)
+        {
+            if (statuses[i] == NativeHostStatus.Success)
+            {
+                assemblies[i] = new Assembly(this, handles[i], paths[i]);
+                loaded.Add(new(handles[i], assemblies[i]));
+            }
+        }
+        _assemblies.SetRange(loaded);
+
+        for (var i = 0; i < paths.Length; i++)
+        {
+            if (statuses[i] != NativeHostStatus.Success)
+            {
+                ThrowForStatus(statuses[i], $"Failed to load assembly: {paths[i]}");
+            }
+        }
+
+        return assemblies;
+    }
+
     /// <summary>
     /// Unload an assembly from the host
     /// </summary>
@@ -115,11 +192,199 @@ public sealed class NativeHost : IDisposable
         return Marshal.GetDelegateForFunctionPointer<T>(functionPtr);
     }
 
+    /// <summary>
+    /// Get the resource accounting of a loaded assembly
+    /// </summary>
+    internal AssemblyStats GetStats(IntPtr assemblyHandle)
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.GetAssemblyStats(_handle, assemblyHandle, out var stats);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, "Failed to get assembly stats");
+        }
+
+        return stats;
+    }
+
+    /// <summary>
+    /// Start aggregating runtime JIT, loader and GC events, optionally recording them to a .nettrace file
+    /// </summary>
+    public void StartTrace(TraceKeywords keywords = TraceKeywords.All, string? outputPath = null)
+    {
+        ThrowIfDisposed();
+
+        var options = new TraceOptions { Keywords = keywords };
+        try
+        {
+            if (outputPath != null)
+            {
+                options.OutputPath = Marshal.StringToCoTaskMemUTF8(outputPath);
+            }
+
+            var status = NativeMethods.TraceStart(_handle, options);
+            if (status != NativeHostStatus.Success)
+            {
+                ThrowForStatus(status, "Failed to start runtime trace");
+            }
+        }
+        finally
+        {
+            Marshal.FreeCoTaskMem(options.OutputPath);
+        }
+    }
+
+    /// <summary>
+    /// Stop the runtime trace; totals stay available until the next StartTrace
+    /// </summary>
+    public void StopTrace()
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.TraceStop(_handle);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, "Failed to stop runtime trace");
+        }
+    }
+
+    /// <summary>
+    /// Get the JIT statistics of a method collected by the runtime trace
+    /// </summary>
+    public MethodTraceStats GetMethodTraceStats(string typeName, string methodName)
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.TraceGetMethodStats(_handle, typeName, methodName, out var stats);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, $"Failed to get trace stats for {typeName}.{methodName}");
+        }
+
+        return stats;
+    }
+
+    /// <summary>
+    /// Get the process-wide totals collected by the runtime trace
+    /// </summary>
+    public TraceSummary GetTraceSummary()
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.TraceGetSummary(_handle, out var summary);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, "Failed to get trace summary");
+        }
+
+        return summary;
+    }
+
+    /// <summary>
+    /// Release every host arena allocation made on the calling thread
+    /// </summary>
+    public static void ResetArena() => NativeMethods.ArenaReset();
+
+    /// <summary>
+    /// Get the host arena totals across all threads
+    /// </summary>
+    public ArenaStats GetArenaStats()
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.GetArenaStats(_handle, out var stats);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, "Failed to get arena stats");
+        }
+
+        return stats;
+    }
+
+    /// <summary>
+    /// Switch per-entry-point latency profiling on (every <paramref name="sampleRate"/>th call per
+    /// thread is timed) or off (0)
+    /// </summary>
+    /// <remarks>
+    /// Cached delegates are dropped so that later lookups pick up the timing trampolines, or the
+    /// plain entry points once profiling is off.
+    /// </remarks>
+    public void SetProfiling(uint sampleRate)
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.SetProfiling(_handle, sampleRate);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, "Failed to set profiling");
+        }
+
+        foreach (var assembly in _assemblies.Values)
+        {
+            assembly.ClearCache();
+        }
+    }
+
+    /// <summary>
+    /// Get a snapshot of the latency of every profiled entry point
+    /// </summary>
+    public unsafe IReadOnlyList<LatencyProfile> GetLatencyProfiles()
+    {
+        ThrowIfDisposed();
+
+        // Entry points may be added between the two calls; retry until the snapshot fits
+        var profiles = Array.Empty<NativeLatencyProfile>();
+        uint count;
+        while (true)
+        {
+            NativeHostStatus status;
+            fixed (NativeLatencyProfile* buffer = profiles)
+            {
+                status = NativeMethods.GetLatencyProfiles(_handle, buffer, (uint)profiles.Length, out count);
+            }
+            if (status != NativeHostStatus.Success)
+            {
+                ThrowForStatus(status, "Failed to get latency profiles");
+            }
+            if (count <= profiles.Length)
+            {
+                break;
+            }
+            profiles = new NativeLatencyProfile[count];
+        }
+
+        var result = new LatencyProfile[count];
+        for (var i = 0; i < count; i++)
+        {
+            result[i] = new LatencyProfile(
+                profiles[i].Assembly,
+                Marshal.PtrToStringUTF8(profiles[i].TypeName) ?? string.Empty,
+                Marshal.PtrToStringUTF8(profiles[i].MethodName) ?? string.Empty,
+                profiles[i].Stats);
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// Clear the latency statistics of every profiled entry point
+    /// </summary>
+    public void ResetLatencyProfiles()
+    {
+        ThrowIfDisposed();
+
+        var status = NativeMethods.ResetLatencyProfiles(_handle);
+        if (status != NativeHostStatus.Success)
+        {
+            ThrowForStatus(status, "Failed to reset latency profiles");
+        }
+    }
+
     public void Dispose()
     {
         if (!_isDisposed)
         {
-            foreach (var assembly in _assemblies.Values.ToList())
+            foreach (var assembly in _assemblies.Values)
             {
                 assembly.Dispose();
             }
@@ -167,6 +432,14 @@ public sealed class NativeHost : IDisposable
                 throw new MissingMethodException(message);
             case NativeHostStatus.ErrorInvalidArg:
                 throw new ArgumentException(message);
+            case NativeHostStatus.ErrorPluginCrashed:
+                throw new InvalidOperationException($"Plugin process exited: {message}");
+            case NativeHostStatus.ErrorTaskFaulted:
+                throw new InvalidOperationException($"Plugin task faulted: {message}");
+            case NativeHostStatus.ErrorNotSupported:
+                throw new NotSupportedException(message);
+            case NativeHostStatus.ErrorTimeout:
+                throw new TimeoutException(message);
             default:
                 throw new InvalidOperationException($"Unknown error {status}: {message}");
         }
@@ -179,7 +452,7 @@ public sealed class NativeHost : IDisposable
 public sealed class Assembly : IDisposable
 {
     private readonly NativeHost _host;
-    private readonly Dictionary<string, Delegate> _cachedDelegates;
+    private readonly DelegateCache _cachedDelegates;
     private bool _isDisposed;
 
     public IntPtr Handle { get; }
@@ -190,25 +463,33 @@ public sealed class Assembly : IDisposable
         _host = host ?? throw new ArgumentNullException(nameof(host));
         Handle = handle;
         AssemblyPath = assemblyPath;
-        _cachedDelegates = new Dictionary<string, Delegate>();
+        _cachedDelegates = new DelegateCache();
     }
 
     /// <summary>
     /// Get a function pointer to a specific method
     /// </summary>
+    /// <remarks>
+    /// Safe to call from many threads; cached lookups take no lock and allocate nothing.
+    /// </remarks>
     public T GetFunction<T>(string typeName, string methodName) where T : Delegate
     {
         ThrowIfDisposed();
 
-        var key = $"{AssemblyPath}:{typeName}.{methodName}";
-        if (_cachedDelegates.TryGetValue(key, out var cachedDelegate))
-        {
-            return (T)cachedDelegate;
-        }
+        return _cachedDelegates.GetOrAdd<T, Assembly>(
+            typeName,
+            methodName,
+            static (assembly, type, method) => assembly._host.GetFunction<T>(assembly.Handle, type, method),
+            this);
+    }
 
-        var function = _host.GetFunction<T>(Handle, typeName, methodName);
-        _cachedDelegates[key] = function;
-        return function;
+    /// <summary>
+    /// Get the resource accounting of this assembly
+    /// </summary>
+    public AssemblyStats GetStats()
+    {
+        ThrowIfDisposed();
+        return _host.GetStats(Handle);
     }
 
     /// <summary>
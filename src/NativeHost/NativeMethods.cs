@@ -15,10 +15,127 @@ public enum NativeHostStatus
     ErrorRuntimeInit = -300,
     ErrorHostfxrNotFound = -302,
     ErrorDelegateNotFound = -303,
+    ErrorPluginCrashed = -304,
+    ErrorTaskFaulted = -305,
     ErrorAssemblyLoad = -400,
     ErrorTypeLoad = -401,
     ErrorMethodLoad = -402,
-    ErrorInvalidArg = -500
+    ErrorInvalidArg = -500,
+    ErrorNotSupported = -501,
+    ErrorTimeout = -502
+}
+
+/// <summary>
+/// Per-assembly resource accounting that matches native_assembly_stats_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct AssemblyStats
+{
+    public ulong Invocations;
+    public ulong SampledInvocations;
+    public ulong CpuTimeNs;
+    public ulong AllocatedBytes;
+    public long RetainedBytes;
+}
+
+/// <summary>
+/// Runtime event categories that match native_trace_keywords_t
+/// </summary>
+[Flags]
+public enum TraceKeywords : uint
+{
+    Jit = 0x1,
+    Loader = 0x2,
+    Gc = 0x4,
+    All = Jit | Loader | Gc
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct TraceOptions
+{
+    public TraceKeywords Keywords;
+    public IntPtr OutputPath;
+}
+
+/// <summary>
+/// Per-method JIT statistics that match native_method_trace_stats_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct MethodTraceStats
+{
+    public uint JitCount;
+    public uint TierUpCount;
+    public uint ReadyToRunRejected;
+    public int OptimizationTier;
+    public ulong JitTimeNs;
+    public ulong MaxJitTimeNs;
+}
+
+/// <summary>
+/// Process-wide trace totals that match native_trace_summary_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct TraceSummary
+{
+    public ulong JitCount;
+    public ulong JitTimeNs;
+    public ulong TypeLoadCount;
+    public ulong TypeLoadTimeNs;
+    public ulong AssemblyLoadCount;
+    public ulong GcCount;
+    public ulong GcPauseCount;
+    public ulong GcPauseTimeNs;
+    public ulong GcMaxPauseNs;
+}
+
+/// <summary>
+/// Host arena totals across all threads, matching native_arena_stats_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct ArenaStats
+{
+    public ulong Allocations;
+    public ulong AllocatedBytes;
+    public ulong LiveAllocations;
+    public ulong LiveBytes;
+    public ulong ReservedBytes;
+    public ulong Resets;
+    public ulong LeakedAllocations;
+    public ulong LeakedBytes;
+    public uint ThreadCount;
+}
+
+/// <summary>
+/// Sampled call latency of one entry point, matching native_latency_stats_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct LatencyStats
+{
+    public ulong Count;
+    public ulong TotalNs;
+    public ulong MinNs;
+    public ulong MaxNs;
+    public ulong P50Ns;
+    public ulong P90Ns;
+    public ulong P99Ns;
+    public ulong P999Ns;
+}
+
+/// <summary>
+/// Latency of one profiled entry point
+/// </summary>
+public readonly record struct LatencyProfile(IntPtr AssemblyHandle, string TypeName, string MethodName, LatencyStats Stats);
+
+/// <summary>
+/// Matches native_latency_profile_t; the names point into host memory
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativeLatencyProfile
+{
+    public IntPtr Assembly;
+    public IntPtr TypeName;
+    public IntPtr MethodName;
+    public LatencyStats Stats;
 }
 
 /// <summary>
@@ -42,6 +159,21 @@ internal static partial class NativeMethods
         string assemblyPath,
         out IntPtr assemblyHandle);
 
+    [LibraryImport(LibraryName, EntryPoint = "native_host_load_assembly_from_memory", StringMarshalling = StringMarshalling.Utf8)]
+    internal static unsafe partial NativeHostStatus LoadFromMemory(IntPtr handle,
+        byte* image,
+        nuint size,
+        string name,
+        out IntPtr assemblyHandle);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_load_assemblies", StringMarshalling = StringMarshalling.Utf8)]
+    internal static partial NativeHostStatus LoadAll(IntPtr handle,
+        string[] assemblyPaths,
+        uint count,
+        [Out] IntPtr[] assemblyHandles,
+        [Out] NativeHostStatus[] statuses,
+        IntPtr options);
+
     [LibraryImport(LibraryName, EntryPoint = "native_host_unload_assembly")]
     internal static partial NativeHostStatus Unload(IntPtr handle, IntPtr assemblyHandle);
 
@@ -52,4 +184,45 @@ internal static partial class NativeMethods
         string typeName,
         string methodName,
         out IntPtr functionPointer);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_get_assembly_stats")]
+    internal static partial NativeHostStatus GetAssemblyStats(
+        IntPtr handle,
+        IntPtr assemblyHandle,
+        out AssemblyStats stats);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_trace_start")]
+    internal static partial NativeHostStatus TraceStart(IntPtr handle, in TraceOptions options);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_trace_stop")]
+    internal static partial NativeHostStatus TraceStop(IntPtr handle);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_trace_get_method_stats", StringMarshalling = StringMarshalling.Utf8)]
+    internal static partial NativeHostStatus TraceGetMethodStats(
+        IntPtr handle,
+        string typeName,
+        string methodName,
+        out MethodTraceStats stats);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_trace_get_summary")]
+    internal static partial NativeHostStatus TraceGetSummary(IntPtr handle, out TraceSummary summary);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_arena_reset")]
+    internal static partial void ArenaReset();
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_get_arena_stats")]
+    internal static partial NativeHostStatus GetArenaStats(IntPtr handle, out ArenaStats stats);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_set_profiling")]
+    internal static partial NativeHostStatus SetProfiling(IntPtr handle, uint sampleRate);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_get_latency_profiles")]
+    internal static unsafe partial NativeHostStatus GetLatencyProfiles(
+        IntPtr handle,
+        NativeLatencyProfile* profiles,
+        uint capacity,
+        out uint count);
+
+    [LibraryImport(LibraryName, EntryPoint = "native_host_reset_latency_profiles")]
+    internal static partial NativeHostStatus ResetLatencyProfiles(IntPtr handle);
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+using System.Runtime.InteropServices;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Completes Task-returning plugin methods through a native callback
+/// </summary>
+/// <remarks>
+/// <c>[UnmanagedCallersOnly]</c> methods cannot return a Task, so an async plugin method is
+/// exposed through a shim that takes the host's completion callback and state as two trailing
+/// arguments and returns immediately; the callback runs when the task finishes, on the thread
+/// that completed it, or inline when the task has already completed:
+/// <code>
+/// [UnmanagedCallersOnly]
+/// public static void FetchAsync(int id, IntPtr callback, IntPtr state)
+///     => AsyncBridge.Complete(FetchCoreAsync(id), callback, state);
+/// </code>
+/// The host resolves the shim with an async signature ("T" followed by the result type and the
+/// argument types) and calls it through native_host_invoke_async.
+/// </remarks>
+public static unsafe class AsyncBridge
+{
+    private const int Success = 0;
+    private const int ErrorTaskFaulted = -305;
+
+    /// <summary>
+    /// Result slot passed to the native callback, matching native_value_t
+    /// </summary>
+    [StructLayout(LayoutKind.Explicit, Size = 8)]
+    private struct NativeValue
+    {
+        [FieldOffset(0)] public int I32;
+        [FieldOffset(0)] public long I64;
+        [FieldOffset(0)] public double F64;
+    }
+
+    public static void Complete(Task task, IntPtr callback, IntPtr state)
+        => Complete(task, callback, state, static _ => default);
+
+    public static void Complete(Task<int> task, IntPtr callback, IntPtr state)
+        => Complete(task, callback, state, static t => new NativeValue { I32 = ((Task<int>)t).Result });
+
+    public static void Complete(Task<long> task, IntPtr callback, IntPtr state)
+        => Complete(task, callback, state, static t => new NativeValue { I64 = ((Task<long>)t).Result });
+
+    public static void Complete(Task<double> task, IntPtr callback, IntPtr state)
+        => Complete(task, callback, state, static t => new NativeValue { F64 = ((Task<double>)t).Result });
+
+    private static void Complete(Task task, IntPtr callback, IntPtr state, Func<Task, NativeValue> result)
+    {
+        if (task.IsCompleted)
+        {
+            Signal(task, callback, state, result);
+            return;
+        }
+
+        task.ContinueWith(
+            static (t, s) =>
+            {
+                var (pendingCallback, pendingState, getResult) = ((IntPtr, IntPtr, Func<Task, NativeValue>))s!;
+                Signal(t, pendingCallback, pendingState, getResult);
+            },
+            (callback, state, result),
+            CancellationToken.None,
+            TaskContinuationOptions.ExecuteSynchronously,
+            TaskScheduler.Default);
+    }
+
+    private static void Signal(Task task, IntPtr callback, IntPtr state, Func<Task, NativeValue> result)
+    {
+        var status = task.IsCompletedSuccessfully ? Success : ErrorTaskFaulted;
+        var value = status == Success ? result(task) : default;
+        ((delegate* unmanaged<IntPtr, int, NativeValue*, void>)callback)(state, status, &value);
+    }
+}
@@ -0,0 +1,136 @@
+using System.Collections.Concurrent;
+using System.Security.Cryptography;
+using System.Text;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Resolved dependency paths of one plugin, keyed by assembly simple name
+/// </summary>
+/// <remarks>
+/// Misses are cached in memory too, so framework assemblies falling back to the default context
+/// are probed once per process. When a cache directory is configured, every resolved path is
+/// appended with its write time to a file stamped with the plugin and deps.json write times. A
+/// later process whose stamp matches starts from that map and never constructs an
+/// <see cref="System.Runtime.Loader.AssemblyDependencyResolver"/> for names it has seen before.
+/// A persisted path is used only while the dependency's write time still matches, and misses
+/// are never persisted, so an assembly added or replaced next to the plugin is picked up.
+/// </remarks>
+internal sealed class DependencyCache
+{
+    private const string FormatVersion = "v2";
+
+    private readonly ConcurrentDictionary<string, string?> _entries = new(StringComparer.OrdinalIgnoreCase);
+    // Read from the cache file; moved to _entries once the dependency's write time is checked
+    private readonly ConcurrentDictionary<string, (string Path, long Ticks)> _persisted = new(StringComparer.OrdinalIgnoreCase);
+    private readonly string? _filePath;
+    private readonly object _writeLock = new();
+
+    private DependencyCache(string? filePath)
+    {
+        _filePath = filePath;
+    }
+
+    public int Count => _entries.Count;
+
+    public static DependencyCache Open(string pluginPath, string? cacheDirectory)
+    {
+        if (string.IsNullOrEmpty(cacheDirectory))
+        {
+            return new DependencyCache(null);
+        }
+
+        var hash = Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(pluginPath)), 0, 8);
+        var filePath = Path.Combine(cacheDirectory, $"{Path.GetFileNameWithoutExtension(pluginPath)}-{hash}.depcache");
+        var cache = new DependencyCache(filePath);
+        cache.LoadOrReset(Stamp(pluginPath));
+        return cache;
+    }
+
+    public string? GetOrResolve(string name, Func<string, string?> resolve)
+    {
+        if (_entries.TryGetValue(name, out var path))
+        {
+            return path;
+        }
+
+        if (_persisted.TryRemove(name, out var persisted) && WriteTicks(persisted.Path) == persisted.Ticks)
+        {
+            return _entries.GetOrAdd(name, persisted.Path);
+        }
+
+        path = resolve(name);
+        if (_entries.TryAdd(name, path) && path != null)
+        {
+            Append(name, path);
+        }
+        return path;
+    }
+
+    // A missing file reports a fixed date long before any real write time, so it never matches
+    private static long WriteTicks(string path) => File.GetLastWriteTimeUtc(path).Ticks;
+
+    private static string Stamp(string pluginPath)
+    {
+        var depsPath = Path.ChangeExtension(pluginPath, ".deps.json");
+        var depsTicks = File.Exists(depsPath) ? File.GetLastWriteTimeUtc(depsPath).Ticks : 0;
+        return $"{FormatVersion}\t{File.GetLastWriteTimeUtc(pluginPath).Ticks}\t{depsTicks}";
+    }
+
+    private void LoadOrReset(string stamp)
+    {
+        try
+        {
+            if (File.Exists(_filePath))
+            {
+                using var reader = new StreamReader(_filePath!);
+                if (reader.ReadLine() == stamp)
+                {
+                    // Name, dependency write time and path; a later line for a name replaces an earlier one
+                    string? line;
+                    while ((line = reader.ReadLine()) != null)
+                    {
+                        var fields = line.Split('\t', 3);
+                        if (fields.Length == 3 && fields[0].Length > 0 && long.TryParse(fields[1], out var ticks))
+                        {
+                            _persisted[fields[0]] = (fields[2], ticks);
+                        }
+                    }
+                    return;
+                }
+            }
+
+            Directory.CreateDirectory(Path.GetDirectoryName(_filePath)!);
+            File.WriteAllText(_filePath!, stamp + "\n");
+        }
+        catch (IOException)
+        {
+            // A cache that cannot be read or written only costs probing
+        }
+        catch (UnauthorizedAccessException)
+        {
+        }
+    }
+
+    private void Append(string name, string path)
+    {
+        if (_filePath == null)
+        {
+            return;
+        }
+
+        lock (_writeLock)
+        {
+            try
+            {
+                File.AppendAllText(_filePath, $"{name}\t{WriteTicks(path)}\t{path}\n");
+            }
+            catch (IOException)
+            {
+            }
+            catch (UnauthorizedAccessException)
+            {
+            }
+        }
+    }
+}
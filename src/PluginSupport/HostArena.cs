@@ -0,0 +1,108 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Allocates variable-size results from the host's per-thread arena
+/// </summary>
+/// <remarks>
+/// Memory comes from the arena of the calling thread and is released by the native caller in one
+/// shot per request (native_host_arena_reset), so returning a record or string costs a pointer bump
+/// instead of a <see cref="System.Runtime.InteropServices.Marshal.AllocHGlobal(int)"/> and a native
+/// <c>free</c> per call:
+/// <code>
+/// [UnmanagedCallersOnly]
+/// public static byte* Describe(int id) => HostArena.CopyUtf8($"record-{id}");
+/// </code>
+/// Results are valid until the calling thread resets its arena; code running after an await is on
+/// another thread and allocates from that thread's arena.
+/// </remarks>
+public static unsafe class HostArena
+{
+    // Bumps a pointer in the thread's current block and returns null instead of locking or
+    // allocating, so it is called without the GC transition of an ordinary P/Invoke
+    private static delegate* unmanaged[SuppressGCTransition]<nuint, nuint, void*> s_tryAllocate;
+
+    // Creates and registers the thread's arena under a lock or mallocs a new block; it may block,
+    // so it goes through an ordinary transition that lets a GC proceed meanwhile
+    private static delegate* unmanaged<nuint, nuint, void*> s_allocate;
+
+    /// <summary>
+    /// Called by the native host once the runtime is initialized
+    /// </summary>
+    [UnmanagedCallersOnly]
+    public static void Register(void* tryAllocate, void* allocate)
+    {
+        s_tryAllocate = (delegate* unmanaged[SuppressGCTransition]<nuint, nuint, void*>)tryAllocate;
+        s_allocate = (delegate* unmanaged<nuint, nuint, void*>)allocate;
+    }
+
+    /// <summary>
+    /// Whether the host registered its arena
+    /// </summary>
+    public static bool IsAvailable => s_allocate != null;
+
+    /// <summary>
+    /// Allocates uninitialized memory from the calling thread's arena
+    /// </summary>
+    /// <param name="size">Size in bytes</param>
+    /// <param name="alignment">Power of two no greater than 4096</param>
+    public static void* Allocate(nuint size, nuint alignment = 16)
+    {
+        var tryAllocate = s_tryAllocate;
+        if (tryAllocate == null)
+        {
+            throw new InvalidOperationException("The host did not register an arena");
+        }
+
+        var memory = tryAllocate(size, alignment);
+        return memory != null ? memory : AllocateSlow(size, alignment);
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private static void* AllocateSlow(nuint size, nuint alignment)
+    {
+        var memory = s_allocate(size, alignment);
+        if (memory == null)
+        {
+            throw new OutOfMemoryException($"Host arena allocation of {size} bytes failed");
+        }
+        return memory;
+    }
+
+    /// <summary>
+    /// Allocates an array of <paramref name="count"/> uninitialized elements
+    /// </summary>
+    public static Span<T> Allocate<T>(int count) where T : unmanaged
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(count);
+        // The largest power of two dividing the element size, capped at the natural alignment of 16
+        var alignment = Math.Min(sizeof(T) & -sizeof(T), 16);
+        var memory = Allocate((nuint)count * (nuint)sizeof(T), (nuint)alignment);
+        return new Span<T>(memory, count);
+    }
+
+    /// <summary>
+    /// Copies <paramref name="data"/> into the arena
+    /// </summary>
+    public static byte* Copy(ReadOnlySpan<byte> data)
+    {
+        var memory = (byte*)Allocate((nuint)data.Length, 1);
+        data.CopyTo(new Span<byte>(memory, data.Length));
+        return memory;
+    }
+
+    /// <summary>
+    /// Encodes <paramref name="value"/> as a null-terminated UTF-8 string in the arena
+    /// </summary>
+    public static byte* CopyUtf8(ReadOnlySpan<char> value)
+    {
+        var length = Encoding.UTF8.GetByteCount(value);
+        var memory = (byte*)Allocate((nuint)length + 1, 1);
+        Encoding.UTF8.GetBytes(value, new Span<byte>(memory, length));
+        memory[length] = 0;
+        return memory;
+    }
+}
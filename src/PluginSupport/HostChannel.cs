@@ -0,0 +1,248 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Producer end of an event channel created with native_host_create_channel
+/// </summary>
+/// <remarks>
+/// The channel is a ring buffer in native memory that this class writes directly, so an event
+/// costs a copy and a store instead of a managed-to-native transition. The host drains it in
+/// batches with native_host_channel_drain:
+/// <code>
+/// [UnmanagedCallersOnly]
+/// public static void Start(nint channel) => s_events = HostChannel.FromHandle(channel);
+///
+/// s_events.TryWrite(in sample);
+/// </code>
+/// Native code is only called to wake a sleeping consumer and, when the buffer is full, to block
+/// until the consumer frees space. A channel has a single producer: create one channel per
+/// producing thread. The layout mirrors EventChannel::Header in native_host.cpp.
+/// </remarks>
+public sealed unsafe class HostChannel
+{
+    private const uint Magic = 0x4E484543; // "NHEC"
+    private const uint Padding = 0xFFFFFFFF;
+    private const int HeaderSize = 192;
+
+    // Header offsets, checked by static_asserts on the native side
+    private const int CapacityOffset = 4;
+    private const int MaxEventSizeOffset = 8;
+    private const int ProducerFenceOffset = 12;
+    private const int WakeOffset = 16;
+    private const int WaitForSpaceOffset = 24;
+    private const int HeadOffset = 64;
+    private const int ProducerWaitingOffset = 72;
+    private const int CompletedOffset = 76;
+    private const int TailOffset = 128;
+    private const int ConsumerWaitingOffset = 136;
+
+    private readonly byte* _header;
+    private readonly byte* _data;
+    private readonly uint _mask;
+    private readonly bool _fence;
+    private readonly delegate* unmanaged<byte*, void> _wake;
+    private readonly delegate* unmanaged<byte*, ulong, uint, int> _waitForSpace;
+
+    // Owned by the producer: the next write position and the last tail read from the consumer
+    private ulong _head;
+    private ulong _cachedTail;
+
+    // Reserved but not yet committed record
+    private ulong _pending;
+
+    private HostChannel(byte* header)
+    {
+        _header = header;
+        _data = header + HeaderSize;
+        Capacity = *(int*)(header + CapacityOffset);
+        MaxEventSize = *(int*)(header + MaxEventSizeOffset);
+        _mask = (uint)Capacity - 1;
+        _fence = *(uint*)(header + ProducerFenceOffset) != 0;
+        _wake = *(delegate* unmanaged<byte*, void>*)(header + WakeOffset);
+        _waitForSpace = *(delegate* unmanaged<byte*, ulong, uint, int>*)(header + WaitForSpaceOffset);
+        _head = Volatile.Read(ref *(ulong*)(header + HeadOffset));
+        _cachedTail = Volatile.Read(ref *(ulong*)(header + TailOffset));
+    }
+
+    /// <summary>
+    /// Opens the producer end of a channel handle passed in by the host
+    /// </summary>
+    public static HostChannel FromHandle(nint handle)
+    {
+        if (handle == 0 || *(uint*)handle != Magic)
+        {
+            throw new ArgumentException("Not an event channel handle", nameof(handle));
+        }
+        return new HostChannel((byte*)handle);
+    }
+
+    /// <summary>
+    /// Ring buffer size in bytes
+    /// </summary>
+    public int Capacity { get; }
+
+    /// <summary>
+    /// Largest event accepted, half the capacity less the record header
+    /// </summary>
+    public int MaxEventSize { get; }
+
+    /// <summary>
+    /// Writes an event if there is room for it, without waiting
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public bool TryWrite(ReadOnlySpan<byte> data)
+    {
+        if (!TryReserve(data.Length, out var buffer))
+        {
+            return false;
+        }
+        data.CopyTo(buffer);
+        Commit();
+        return true;
+    }
+
+    /// <summary>
+    /// Writes an unmanaged value as an event if there is room for it, without waiting
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public bool TryWrite<T>(in T value) where T : unmanaged
+    {
+        if (!TryReserve(sizeof(T), out var buffer))
+        {
+            return false;
+        }
+        Unsafe.WriteUnaligned(ref MemoryMarshal.GetReference(buffer), value);
+        Commit();
+        return true;
+    }
+
+    /// <summary>
+    /// Writes an event, blocking while the buffer is full
+    /// </summary>
+    public void Write(ReadOnlySpan<byte> data) => Write(data, Timeout.InfiniteTimeSpan);
+
+    /// <summary>
+    /// Writes an event, blocking up to <paramref name="timeout"/> while the buffer is full
+    /// </summary>
+    /// <returns>False if the consumer did not free enough space in time</returns>
+    public bool Write(ReadOnlySpan<byte> data, TimeSpan timeout)
+    {
+        if (TryWrite(data))
+        {
+            return true;
+        }
+        if (!WaitForSpace(data.Length, timeout))
+        {
+            return false;
+        }
+        return TryWrite(data);
+    }
+
+    /// <summary>
+    /// Reserves space for an event of <paramref name="size"/> bytes to be filled in place
+    /// </summary>
+    /// <remarks>
+    /// The event becomes visible to the consumer on <see cref="Commit"/>; nothing else may be
+    /// written in between.
+    /// </remarks>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public bool TryReserve(int size, out Span<byte> buffer)
+    {
+        if ((uint)size > (uint)MaxEventSize)
+        {
+            throw new ArgumentOutOfRangeException(nameof(size), size, $"Events are limited to {MaxEventSize} bytes");
+        }
+
+        var length = RecordSize(size);
+        var offset = (uint)_head & _mask;
+        var padding = (uint)Capacity - offset < length ? (uint)Capacity - offset : 0;
+        var end = _head + padding + length;
+        if (end - _cachedTail > (ulong)Capacity)
+        {
+            _cachedTail = Volatile.Read(ref *(ulong*)(_header + TailOffset));
+            if (end - _cachedTail > (ulong)Capacity)
+            {
+                buffer = default;
+                return false;
+            }
+        }
+
+        if (padding != 0)
+        {
+            *(uint*)(_data + offset) = Padding;
+            offset = 0;
+        }
+        *(uint*)(_data + offset) = (uint)size;
+        buffer = new Span<byte>(_data + offset + sizeof(uint), size);
+        _pending = end;
+        return true;
+    }
+
+    /// <summary>
+    /// Publishes the event from the last <see cref="TryReserve"/>
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public void Commit()
+    {
+        _head = _pending;
+        Volatile.Write(ref *(ulong*)(_header + HeadOffset), _head);
+        // The consumer issues a process-wide barrier before it sleeps, so a plain read is enough
+        // unless the host found no such barrier on this system
+        if (_fence)
+        {
+            Interlocked.MemoryBarrier();
+        }
+        if (Volatile.Read(ref *(uint*)(_header + ConsumerWaitingOffset)) != 0)
+        {
+            _wake(_header);
+        }
+    }
+
+    /// <summary>
+    /// Marks the end of the stream; the consumer drains what is left and then sees it completed
+    /// </summary>
+    public void Complete()
+    {
+        Volatile.Write(ref *(uint*)(_header + CompletedOffset), 1u);
+        Interlocked.MemoryBarrier();
+        if (Volatile.Read(ref *(uint*)(_header + ConsumerWaitingOffset)) != 0)
+        {
+            _wake(_header);
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static uint RecordSize(int size) => ((uint)size + sizeof(uint) + 7) & ~7u;
+
+    private bool WaitForSpace(int size, TimeSpan timeout)
+    {
+        var length = RecordSize(size);
+        var offset = (uint)_head & _mask;
+        var padding = (uint)Capacity - offset < length ? (uint)Capacity - offset : 0;
+        var required = _head + padding + length - (ulong)Capacity;
+        ref var tail = ref *(ulong*)(_header + TailOffset);
+
+        var spinner = new SpinWait();
+        while (!spinner.NextSpinWillYield)
+        {
+            if (Volatile.Read(ref tail) >= required)
+            {
+                return true;
+            }
+            spinner.SpinOnce();
+        }
+
+        var timeoutMs = timeout == Timeout.InfiniteTimeSpan ? uint.MaxValue : (uint)Math.Clamp(timeout.TotalMilliseconds, 0, uint.MaxValue - 1);
+        Volatile.Write(ref *(uint*)(_header + ProducerWaitingOffset), 1u);
+        // Pairs with the consumer's fence after it releases space
+        Interlocked.MemoryBarrier();
+        if (Volatile.Read(ref tail) >= required)
+        {
+            Volatile.Write(ref *(uint*)(_header + ProducerWaitingOffset), 0u);
+            return true;
+        }
+        return _waitForSpace(_header, required, timeoutMs) != 0;
+    }
+}
@@ -0,0 +1,22 @@
+using System.Runtime.InteropServices;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Diagnostics entry points called by the native host
+/// </summary>
+/// <remarks>
+/// The native host loads this assembly into the default load context, so plugins
+/// referencing it without copying it to their output share the same instance.
+/// </remarks>
+public static class HostDiagnostics
+{
+    /// <summary>
+    /// Managed bytes allocated by the calling thread, used for per-assembly accounting
+    /// </summary>
+    [UnmanagedCallersOnly]
+    public static long GetAllocatedBytesForCurrentThread()
+    {
+        return GC.GetAllocatedBytesForCurrentThread();
+    }
+}
@@ -0,0 +1,77 @@
+using System.Runtime.InteropServices;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Native function pointers registered by the embedding application
+/// </summary>
+/// <remarks>
+/// Plugins describe the host's table as a struct of <c>delegate* unmanaged</c> fields in
+/// registration order and call through it directly, without DllImport probing or marshalling:
+/// <code>
+/// struct MetricsServices
+/// {
+///     public delegate* unmanaged&lt;int, double, void&gt; Record;
+/// }
+///
+/// var services = HostServices.GetTable&lt;MetricsServices&gt;();
+/// if (services != null) services->Record(id, value);
+/// </code>
+/// </remarks>
+public static unsafe class HostServices
+{
+    private sealed class Table
+    {
+        public readonly void** Entries;
+        public readonly int Count;
+
+        public Table(void** entries, int count)
+        {
+            Entries = entries;
+            Count = count;
+        }
+    }
+
+    private static volatile Table? s_table;
+
+    /// <summary>
+    /// Called by the native host; the table stays valid for the lifetime of the process
+    /// </summary>
+    [UnmanagedCallersOnly]
+    public static void Register(void** entries, int count)
+    {
+        s_table = new Table(entries, count);
+    }
+
+    /// <summary>
+    /// Number of registered function pointers, zero if the host registered none
+    /// </summary>
+    public static int Count => s_table?.Count ?? 0;
+
+    /// <summary>
+    /// Registered function pointer at the given index, or null if out of range
+    /// </summary>
+    public static void* Get(int index)
+    {
+        var table = s_table;
+        if (table == null || (uint)index >= (uint)table.Count)
+        {
+            return null;
+        }
+        return table.Entries[index];
+    }
+
+    /// <summary>
+    /// Views the registered table as a struct of function pointers
+    /// </summary>
+    /// <returns>Null if no table is registered or it has fewer entries than <typeparamref name="T"/> declares</returns>
+    public static T* GetTable<T>() where T : unmanaged
+    {
+        var table = s_table;
+        if (table == null || sizeof(T) > table.Count * sizeof(void*))
+        {
+            return null;
+        }
+        return (T*)table.Entries;
+    }
+}
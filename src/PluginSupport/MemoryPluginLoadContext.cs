@@ -0,0 +1,62 @@
+using System.Reflection;
+using System.Runtime.Loader;
+using System.Text;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Load context for a plugin loaded from an in-memory image instead of a file
+/// </summary>
+/// <remarks>
+/// Dependencies are resolved by simple name through a native callback, which serves them from
+/// the same plugin bundle. Without a callback, or when the callback has no image for a name,
+/// resolution falls back to the default context like <see cref="PluginLoadContext"/> does.
+/// </remarks>
+internal sealed unsafe class MemoryPluginLoadContext : AssemblyLoadContext
+{
+    private static readonly string SupportAssemblyName = typeof(MemoryPluginLoadContext).Assembly.GetName().Name!;
+
+    private readonly delegate* unmanaged<IntPtr, byte*, byte**, long*, int> _resolve;
+    private readonly IntPtr _resolveContext;
+
+    public MemoryPluginLoadContext(
+        string name,
+        delegate* unmanaged<IntPtr, byte*, byte**, long*, int> resolve,
+        IntPtr resolveContext)
+        : base(name)
+    {
+        _resolve = resolve;
+        _resolveContext = resolveContext;
+    }
+
+    /// <summary>
+    /// Loads an image without copying it into a managed array first; the runtime keeps its own copy
+    /// </summary>
+    public Assembly LoadFromImage(byte* image, long size)
+    {
+        using var stream = new UnmanagedMemoryStream(image, size);
+        return LoadFromStream(stream);
+    }
+
+    protected override Assembly? Load(AssemblyName assemblyName)
+    {
+        var name = assemblyName.Name;
+        if (name == null || name == SupportAssemblyName || _resolve == null)
+        {
+            return null;
+        }
+
+        byte* image;
+        long size;
+        var utf8Name = Encoding.UTF8.GetBytes(name + "\0");
+        fixed (byte* namePtr = utf8Name)
+        {
+            if (_resolve(_resolveContext, namePtr, &image, &size) != 0)
+            {
+                return null;
+            }
+        }
+
+        return LoadFromImage(image, size);
+    }
+}
@@ -0,0 +1,60 @@
+using System.Reflection;
+using System.Runtime.Loader;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Load context for one plugin that resolves its dependencies from the plugin's .deps.json
+/// </summary>
+/// <remarks>
+/// Resolution goes through <see cref="DependencyCache"/> first, so repeated and persisted
+/// lookups are a dictionary hit. Assemblies the plugin loads by name without referencing them
+/// are found next to the plugin. Anything unresolved, including this assembly, falls back to
+/// the default context and is shared with the host.
+/// </remarks>
+internal sealed class PluginLoadContext : AssemblyLoadContext
+{
+    private static readonly string SupportAssemblyName = typeof(PluginLoadContext).Assembly.GetName().Name!;
+
+    private readonly string _pluginDirectory;
+    private readonly DependencyCache _cache;
+    private readonly Lazy<AssemblyDependencyResolver> _resolver;
+
+    public PluginLoadContext(string pluginPath, DependencyCache cache)
+        : base(Path.GetFileNameWithoutExtension(pluginPath))
+    {
+        _pluginDirectory = Path.GetDirectoryName(pluginPath)!;
+        _cache = cache;
+        _resolver = new Lazy<AssemblyDependencyResolver>(() => new AssemblyDependencyResolver(pluginPath));
+    }
+
+    protected override Assembly? Load(AssemblyName assemblyName)
+    {
+        var name = assemblyName.Name;
+        if (name == null || name == SupportAssemblyName)
+        {
+            return null;
+        }
+
+        var path = _cache.GetOrResolve(name, ResolveAssembly);
+        return path == null ? null : LoadFromAssemblyPath(path);
+    }
+
+    protected override IntPtr LoadUnmanagedDll(string unmanagedDllName)
+    {
+        var path = _resolver.Value.ResolveUnmanagedDllToPath(unmanagedDllName);
+        return path == null ? IntPtr.Zero : LoadUnmanagedDllFromPath(path);
+    }
+
+    private string? ResolveAssembly(string name)
+    {
+        var path = _resolver.Value.ResolveAssemblyToPath(new AssemblyName(name));
+        if (path != null)
+        {
+            return path;
+        }
+
+        var local = Path.Combine(_pluginDirectory, name + ".dll");
+        return File.Exists(local) ? local : null;
+    }
+}
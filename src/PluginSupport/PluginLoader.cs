@@ -0,0 +1,236 @@
+using System.Reflection;
+using System.Runtime.InteropServices;
+using System.Runtime.Loader;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Plugin loading entry points called by the native host
+/// </summary>
+/// <remarks>
+/// Each plugin path gets one <see cref="PluginLoadContext"/> for the lifetime of the process,
+/// matching the runtime's component loading; plugins loaded from memory get a
+/// <see cref="MemoryPluginLoadContext"/>. Return values are native_host status codes.
+/// </remarks>
+public static unsafe class PluginLoader
+{
+    private const int Success = 0;
+    private const int ErrorAssemblyLoad = -400;
+    private const int ErrorTypeLoad = -401;
+    private const int ErrorMethodLoad = -402;
+
+    private static readonly object s_lock = new();
+    private static readonly Dictionary<string, Lazy<int>> s_pluginIds = new(StringComparer.Ordinal);
+    private static readonly List<(AssemblyLoadContext Context, Assembly Assembly)> s_plugins = new();
+    private static string? s_cacheDirectory;
+
+    /// <summary>
+    /// Sets the directory for persisted dependency caches, or disables persistence when null
+    /// </summary>
+    [UnmanagedCallersOnly]
+    public static void Configure(byte* cacheDirectory)
+    {
+        s_cacheDirectory = cacheDirectory == null ? null : Marshal.PtrToStringUTF8((IntPtr)cacheDirectory);
+    }
+
+    /// <summary>
+    /// Loads a plugin into its own load context, reusing the context for a path loaded before
+    /// </summary>
+    /// <remarks>
+    /// Loading happens outside the lock so that bulk loads of different plugins run concurrently;
+    /// concurrent loads of the same path wait for the first one.
+    /// </remarks>
+    [UnmanagedCallersOnly]
+    public static int LoadPlugin(byte* path, int* pluginId)
+    {
+        string fullPath;
+        Lazy<int> entry;
+        try
+        {
+            fullPath = Path.GetFullPath(Marshal.PtrToStringUTF8((IntPtr)path)!);
+        }
+        catch (Exception)
+        {
+            return ErrorAssemblyLoad;
+        }
+
+        lock (s_lock)
+        {
+            if (!s_pluginIds.TryGetValue(fullPath, out var existing))
+            {
+                existing = new Lazy<int>(() => Load(fullPath));
+                s_pluginIds.Add(fullPath, existing);
+            }
+            entry = existing;
+        }
+
+        return GetOrLoad(fullPath, entry, pluginId);
+    }
+
+    /// <summary>
+    /// Loads a plugin from an in-memory image into its own load context
+    /// </summary>
+    /// <param name="name">Display name of the plugin, used as the load context name</param>
+    /// <param name="key">Identity for reuse across calls, or null to always create a new plugin</param>
+    /// <param name="resolve">Native callback resolving dependency images by simple name, may be null</param>
+    [UnmanagedCallersOnly]
+    public static int LoadPluginFromMemory(
+        byte* name,
+        byte* key,
+        byte* image,
+        long size,
+        delegate* unmanaged<IntPtr, byte*, byte**, long*, int> resolve,
+        IntPtr resolveContext,
+        int* pluginId)
+    {
+        string contextName;
+        string? pluginKey;
+        try
+        {
+            contextName = Marshal.PtrToStringUTF8((IntPtr)name)!;
+            pluginKey = key == null ? null : Marshal.PtrToStringUTF8((IntPtr)key);
+        }
+        catch (Exception)
+        {
+            return ErrorAssemblyLoad;
+        }
+
+        var imageAddress = (IntPtr)image;
+        var resolveAddress = (IntPtr)resolve;
+        Func<int> load = () => LoadImage(contextName, imageAddress, size, resolveAddress, resolveContext);
+
+        if (pluginKey == null)
+        {
+            try
+            {
+                *pluginId = load();
+                return Success;
+            }
+            catch (Exception)
+            {
+                return ErrorAssemblyLoad;
+            }
+        }
+
+        Lazy<int> entry;
+        lock (s_lock)
+        {
+            if (!s_pluginIds.TryGetValue(pluginKey, out var existing))
+            {
+                existing = new Lazy<int>(load);
+                s_pluginIds.Add(pluginKey, existing);
+            }
+            entry = existing;
+        }
+
+        return GetOrLoad(pluginKey, entry, pluginId);
+    }
+
+    private static int GetOrLoad(string key, Lazy<int> entry, int* pluginId)
+    {
+        try
+        {
+            *pluginId = entry.Value;
+            return Success;
+        }
+        catch (Exception)
+        {
+            // Allow a later attempt after a failed load
+            lock (s_lock)
+            {
+                if (s_pluginIds.TryGetValue(key, out var current) && current == entry)
+                {
+                    s_pluginIds.Remove(key);
+                }
+            }
+            return ErrorAssemblyLoad;
+        }
+    }
+
+    private static int Load(string fullPath)
+    {
+        var context = new PluginLoadContext(fullPath, DependencyCache.Open(fullPath, s_cacheDirectory));
+        return Register(context, context.LoadFromAssemblyPath(fullPath));
+    }
+
+    private static int LoadImage(string name, IntPtr image, long size, IntPtr resolve, IntPtr resolveContext)
+    {
+        var context = new MemoryPluginLoadContext(
+            name, (delegate* unmanaged<IntPtr, byte*, byte**, long*, int>)resolve, resolveContext);
+        return Register(context, context.LoadFromImage((byte*)image, size));
+    }
+
+    private static int Register(AssemblyLoadContext context, Assembly assembly)
+    {
+        lock (s_lock)
+        {
+            s_plugins.Add((context, assembly));
+            return s_plugins.Count - 1;
+        }
+    }
+
+    /// <summary>
+    /// Resolves an [UnmanagedCallersOnly] method of a loaded plugin
+    /// </summary>
+    /// <param name="typeName">Type name, optionally assembly-qualified, resolved within the plugin's context</param>
+    [UnmanagedCallersOnly]
+    public static int GetFunctionPointer(int pluginId, byte* typeName, byte* methodName, IntPtr* functionPointer)
+    {
+        var status = ResolveType(pluginId, typeName, out var type);
+        if (status != Success)
+        {
+            return status;
+        }
+
+        try
+        {
+            var method = type!.GetMethod(
+                Marshal.PtrToStringUTF8((IntPtr)methodName)!,
+                BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.Static);
+            if (method == null || method.GetCustomAttribute<UnmanagedCallersOnlyAttribute>() == null)
+            {
+                return ErrorMethodLoad;
+            }
+
+            *functionPointer = method.MethodHandle.GetFunctionPointer();
+            return Success;
+        }
+        catch (Exception)
+        {
+            return ErrorMethodLoad;
+        }
+    }
+
+    /// <summary>
+    /// Resolves a type of a loaded plugin within the plugin's context
+    /// </summary>
+    /// <param name="typeName">Type name, optionally assembly-qualified</param>
+    internal static int ResolveType(int pluginId, byte* typeName, out Type? type)
+    {
+        type = null;
+        AssemblyLoadContext context;
+        Assembly assembly;
+        lock (s_lock)
+        {
+            if ((uint)pluginId >= (uint)s_plugins.Count)
+            {
+                return ErrorAssemblyLoad;
+            }
+            (context, assembly) = s_plugins[pluginId];
+        }
+
+        try
+        {
+            var name = Marshal.PtrToStringUTF8((IntPtr)typeName)!;
+            using (context.EnterContextualReflection())
+            {
+                type = Type.GetType(name, throwOnError: false) ?? assembly.GetType(name, throwOnError: false);
+            }
+        }
+        catch (Exception)
+        {
+            return ErrorTypeLoad;
+        }
+        return type == null ? ErrorTypeLoad : Success;
+    }
+}
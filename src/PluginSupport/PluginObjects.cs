@@ -0,0 +1,108 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Plugin objects handed to the native host as GCHandles
+/// </summary>
+/// <remarks>
+/// The host constructs an instance with native_host_create_object and gets back the
+/// <see cref="GCHandle"/> keeping it alive. [UnmanagedCallersOnly] methods must be static, so an
+/// instance method is exported through a static shim taking that handle as its first argument;
+/// getting the object back is a single dereference instead of a lookup in a lock-protected
+/// static dictionary:
+/// <code>
+/// [UnmanagedCallersOnly]
+/// public static int Log(nint self, int level) => PluginObjects.Get&lt;Session&gt;(self).Log(level);
+/// </code>
+/// Released handles are cleared and kept for the next object rather than freed, since
+/// allocating a handle takes the runtime's handle table lock.
+/// </remarks>
+public static unsafe class PluginObjects
+{
+    private const int Success = 0;
+    private const int ErrorTypeLoad = -401;
+
+    // Enough for request-scoped sessions to be recycled without growing the handle table
+    private const int MaxPooledHandles = 1024;
+
+    private static readonly object s_lock = new();
+    private static readonly Stack<GCHandle> s_pool = new();
+
+    /// <summary>
+    /// Returns the object behind a handle from native_host_create_object
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static T Get<T>(nint handle) where T : class
+        => (T)GCHandle.FromIntPtr(handle).Target!;
+
+    /// <summary>
+    /// Constructs an instance of a plugin type with its public parameterless constructor
+    /// </summary>
+    /// <param name="typeName">Type name, optionally assembly-qualified, resolved within the plugin's context</param>
+    [UnmanagedCallersOnly]
+    public static int CreateObject(int pluginId, byte* typeName, IntPtr* handle)
+    {
+        var status = PluginLoader.ResolveType(pluginId, typeName, out var type);
+        if (status != Success)
+        {
+            return status;
+        }
+
+        object instance;
+        try
+        {
+            instance = Activator.CreateInstance(type!)!;
+        }
+        catch (Exception)
+        {
+            // No public parameterless constructor, an abstract type, or a constructor that threw
+            return ErrorTypeLoad;
+        }
+
+        GCHandle gcHandle;
+        lock (s_lock)
+        {
+            s_pool.TryPop(out gcHandle);
+        }
+        if (gcHandle.IsAllocated)
+        {
+            gcHandle.Target = instance;
+        }
+        else
+        {
+            gcHandle = GCHandle.Alloc(instance);
+        }
+
+        *handle = GCHandle.ToIntPtr(gcHandle);
+        return Success;
+    }
+
+    /// <summary>
+    /// Releases objects from native_host_create_object, returning their handles to the pool
+    /// </summary>
+    /// <remarks>
+    /// The host validates the handles, so every entry is a live handle released exactly once.
+    /// </remarks>
+    [UnmanagedCallersOnly]
+    public static void ReleaseObjects(IntPtr* handles, int count)
+    {
+        lock (s_lock)
+        {
+            for (var i = 0; i < count; i++)
+            {
+                var gcHandle = GCHandle.FromIntPtr(handles[i]);
+                if (s_pool.Count < MaxPooledHandles)
+                {
+                    gcHandle.Target = null;
+                    s_pool.Push(gcHandle);
+                }
+                else
+                {
+                    gcHandle.Free();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,317 @@
+using System.Diagnostics.Tracing;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace PluginSupport;
+
+/// <summary>
+/// Per-method JIT statistics, matching native_method_trace_stats_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct MethodTraceStats
+{
+    public uint JitCount;
+    public uint TierUpCount;
+    public uint ReadyToRunRejected;
+    public int OptimizationTier;
+    public ulong JitTimeNs;
+    public ulong MaxJitTimeNs;
+}
+
+/// <summary>
+/// Process-wide totals, matching native_trace_summary_t
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct TraceSummary
+{
+    public ulong JitCount;
+    public ulong JitTimeNs;
+    public ulong TypeLoadCount;
+    public ulong TypeLoadTimeNs;
+    public ulong AssemblyLoadCount;
+    public ulong GcCount;
+    public ulong GcPauseCount;
+    public ulong GcPauseTimeNs;
+    public ulong GcMaxPauseNs;
+}
+
+/// <summary>
+/// In-process runtime event session aggregating JIT, loader and GC events
+/// </summary>
+/// <remarks>
+/// Events come from the runtime's own provider through an <see cref="EventListener"/>, so no
+/// diagnostic port or external tool is involved. The runtime dispatches them in batches, so
+/// totals lag the code that produced them by a short interval.
+/// </remarks>
+public static unsafe class RuntimeTrace
+{
+    // Keyword flags shared with native_trace_keywords_t in native_host.h
+    private const uint TraceJit = 0x1;
+    private const uint TraceLoader = 0x2;
+    private const uint TraceGc = 0x4;
+
+    private static readonly object s_lock = new();
+    private static RuntimeEventListener? s_listener;
+
+    /// <summary>
+    /// Starts a new session, discarding the totals of the previous one
+    /// </summary>
+    [UnmanagedCallersOnly]
+    public static int Start(uint keywords)
+    {
+        var listener = new RuntimeEventListener(ToEventKeywords(keywords));
+        RuntimeEventListener? previous;
+        lock (s_lock)
+        {
+            previous = s_listener;
+            s_listener = listener;
+        }
+
+        // Disabling waits for the event dispatcher, so it must not run under a lock the listener takes
+        previous?.Dispose();
+        return 0;
+    }
+
+    /// <summary>
+    /// Stops delivering events; the totals stay queryable until the next Start
+    /// </summary>
+    [UnmanagedCallersOnly]
+    public static void Stop()
+    {
+        Current()?.Disable();
+    }
+
+    /// <summary>
+    /// Totals for the methods named <paramref name="typeName"/>.<paramref name="methodName"/>,
+    /// all overloads and instantiations combined
+    /// </summary>
+    /// <returns>0 on success, -1 when no session has been started</returns>
+    [UnmanagedCallersOnly]
+    public static int GetMethodStats(byte* typeName, byte* methodName, MethodTraceStats* stats)
+    {
+        var type = Marshal.PtrToStringUTF8((IntPtr)typeName) ?? string.Empty;
+        var method = Marshal.PtrToStringUTF8((IntPtr)methodName) ?? string.Empty;
+
+        // Entry points are usually named with an assembly-qualified type
+        var comma = type.IndexOf(',');
+        if (comma >= 0)
+        {
+            type = type[..comma].Trim();
+        }
+
+        var listener = Current();
+        if (listener == null)
+        {
+            return -1;
+        }
+        *stats = listener.GetMethodStats(type, method);
+        return 0;
+    }
+
+    /// <returns>0 on success, -1 when no session has been started</returns>
+    [UnmanagedCallersOnly]
+    public static int GetSummary(TraceSummary* summary)
+    {
+        var listener = Current();
+        if (listener == null)
+        {
+            return -1;
+        }
+        *summary = listener.GetSummary();
+        return 0;
+    }
+
+    private static RuntimeEventListener? Current()
+    {
+        lock (s_lock)
+        {
+            return s_listener;
+        }
+    }
+
+    private static EventKeywords ToEventKeywords(uint keywords)
+    {
+        EventKeywords result = 0;
+        if ((keywords & TraceJit) != 0)
+        {
+            result |= RuntimeEventListener.JitKeywords;
+        }
+        if ((keywords & TraceLoader) != 0)
+        {
+            result |= RuntimeEventListener.LoaderKeywords;
+        }
+        if ((keywords & TraceGc) != 0)
+        {
+            result |= RuntimeEventListener.GcKeywords;
+        }
+        return result;
+    }
+
+    private sealed class RuntimeEventListener : EventListener
+    {
+        private const string RuntimeProvider = "Microsoft-Windows-DotNETRuntime";
+
+        public const EventKeywords GcKeywords = (EventKeywords)0x1;
+        public const EventKeywords LoaderKeywords = (EventKeywords)(0x8 | 0x8000000000);       // Loader | TypeDiagnostic
+        public const EventKeywords JitKeywords = (EventKeywords)(0x10 | 0x1000000000);         // Jit | TieredCompilation
+
+        private const int GCStart = 1;
+        private const int GCRestartEEEnd = 3;
+        private const int GCSuspendEEBegin = 9;
+        private const int TypeLoadStart = 73;
+        private const int TypeLoadStop = 74;
+        private const int MethodLoadVerbose = 143;
+        private const int MethodJittingStarted = 145;
+        private const int AssemblyLoad = 154;
+
+        private const uint ReadyToRunRejectedFlag = 0x40;
+        private const int OptimizationTierShift = 7;
+        private const int OptimizedTier1 = 4;
+
+        private readonly EventKeywords _keywords;
+        private readonly object _lock = new();
+        private readonly Dictionary<string, MethodTraceStats> _methods = new();
+        private readonly Dictionary<ulong, DateTime> _jitStarts = new();
+        private readonly Dictionary<uint, DateTime> _typeLoadStarts = new();
+        private TraceSummary _summary;
+        private DateTime _suspendStart;
+        private EventSource? _runtimeSource;
+
+        public RuntimeEventListener(EventKeywords keywords)
+        {
+            _keywords = keywords;
+            // The runtime source usually exists already and was reported from the base constructor
+            if (_runtimeSource != null)
+            {
+                EnableEvents(_runtimeSource, EventLevel.Verbose, _keywords);
+            }
+        }
+
+        public void Disable()
+        {
+            if (_runtimeSource != null)
+            {
+                DisableEvents(_runtimeSource);
+            }
+        }
+
+        protected override void OnEventSourceCreated(EventSource source)
+        {
+            if (source.Name != RuntimeProvider)
+            {
+                return;
+            }
+            _runtimeSource = source;
+            if (_keywords != 0)
+            {
+                EnableEvents(source, EventLevel.Verbose, _keywords);
+            }
+        }
+
+        protected override void OnEventWritten(EventWrittenEventArgs e)
+        {
+            lock (_lock)
+            {
+                switch (e.EventId)
+                {
+                    case MethodJittingStarted:
+                        _jitStarts[Get<ulong>(e, "MethodID")] = e.TimeStamp;
+                        break;
+                    case MethodLoadVerbose:
+                        OnMethodLoaded(e);
+                        break;
+                    case TypeLoadStart:
+                        _typeLoadStarts[Get<uint>(e, "TypeLoadStartID")] = e.TimeStamp;
+                        break;
+                    case TypeLoadStop:
+                        if (_typeLoadStarts.Remove(Get<uint>(e, "TypeLoadStartID"), out var typeLoadStart))
+                        {
+                            _summary.TypeLoadCount++;
+                            _summary.TypeLoadTimeNs += ElapsedNs(typeLoadStart, e.TimeStamp);
+                        }
+                        break;
+                    case AssemblyLoad:
+                        _summary.AssemblyLoadCount++;
+                        break;
+                    case GCStart:
+                        _summary.GcCount++;
+                        break;
+                    case GCSuspendEEBegin:
+                        _suspendStart = e.TimeStamp;
+                        break;
+                    case GCRestartEEEnd:
+                        if (_suspendStart != default)
+                        {
+                            var pause = ElapsedNs(_suspendStart, e.TimeStamp);
+                            _summary.GcPauseCount++;
+                            _summary.GcPauseTimeNs += pause;
+                            _summary.GcMaxPauseNs = Math.Max(_summary.GcMaxPauseNs, pause);
+                            _suspendStart = default;
+                        }
+                        break;
+                }
+            }
+        }
+
+        private void OnMethodLoaded(EventWrittenEventArgs e)
+        {
+            // Only code produced by the JIT during the session has a matching start event
+            if (!_jitStarts.Remove(Get<ulong>(e, "MethodID"), out var start))
+            {
+                return;
+            }
+
+            var key = MethodKey(Get<string>(e, "MethodNamespace"), Get<string>(e, "MethodName"));
+            var flags = Get<uint>(e, "MethodFlags");
+            var tier = (int)((flags >> OptimizationTierShift) & 0x7);
+            var elapsed = ElapsedNs(start, e.TimeStamp);
+
+            _methods.TryGetValue(key, out var stats);
+            if (tier == OptimizedTier1 && stats.JitCount > 0)
+            {
+                stats.TierUpCount++;
+            }
+            if ((flags & ReadyToRunRejectedFlag) != 0)
+            {
+                stats.ReadyToRunRejected++;
+            }
+            stats.JitCount++;
+            stats.OptimizationTier = tier;
+            stats.JitTimeNs += elapsed;
+            stats.MaxJitTimeNs = Math.Max(stats.MaxJitTimeNs, elapsed);
+            _methods[key] = stats;
+
+            _summary.JitCount++;
+            _summary.JitTimeNs += elapsed;
+        }
+
+        public MethodTraceStats GetMethodStats(string typeName, string methodName)
+        {
+            lock (_lock)
+            {
+                _methods.TryGetValue(MethodKey(typeName, methodName), out var stats);
+                return stats;
+            }
+        }
+
+        public TraceSummary GetSummary()
+        {
+            lock (_lock)
+            {
+                return _summary;
+            }
+        }
+
+        private static string MethodKey(string? typeName, string? methodName)
+            => new StringBuilder(typeName).Append("::").Append(methodName).ToString();
+
+        private static ulong ElapsedNs(DateTime start, DateTime end)
+            => end > start ? (ulong)(end - start).Ticks * 100 : 0;
+
+        private static T? Get<T>(EventWrittenEventArgs e, string name)
+        {
+            var index = e.PayloadNames?.IndexOf(name) ?? -1;
+            return index >= 0 && e.Payload![index] is T value ? value : default;
+        }
+    }
+}
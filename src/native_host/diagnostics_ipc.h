@@ -0,0 +1,366 @@
+/**
+ * @file diagnostics_ipc.h
+ * @brief 通过运行时诊断端口录制 EventPipe 会话（内部头文件）
+ *
+ * CoreCLR 在每个进程中监听一个诊断端口（Unix 域套接字或命名管道），dotnet-trace 等工具
+ * 通过它启动 EventPipe 会话。宿主连接自身进程的端口，使用同一协议录制 .nettrace 文件：
+ *
+ * 1. 发送 CollectTracing2 请求，应答中返回会话编号，之后同一连接上持续输出 nettrace 数据
+ * 2. 后台线程把数据写入文件
+ * 3. 停止时在新连接上发送 StopTracing，运行时写完剩余事件后关闭数据连接
+ *
+ * 运行时以 DOTNET_EnableDiagnostics=0 启动时诊断端口不存在，会话无法启动。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace DiagnosticsIpc
+{
+    constexpr char MAGIC[14] = "DOTNET_IPC_V1";
+    constexpr uint8_t COMMAND_SET_EVENT_PIPE = 0x02;
+    constexpr uint8_t COMMAND_SET_SERVER = 0xFF;
+    constexpr uint8_t EVENT_PIPE_STOP_TRACING = 0x01;
+    constexpr uint8_t EVENT_PIPE_COLLECT_TRACING_2 = 0x03;
+    constexpr uint8_t SERVER_RESPONSE_OK = 0x00;
+    constexpr uint32_t FORMAT_NETTRACE = 1;
+
+    struct Header
+    {
+        char magic[14];
+        uint16_t size; ///< 含消息头的总字节数
+        uint8_t command_set;
+        uint8_t command_id;
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 20, "IPC header layout is part of the protocol");
+
+    struct Provider
+    {
+        std::string name;
+        uint64_t keywords;
+        uint32_t level;
+    };
+
+    /**
+     * @brief 到当前进程诊断端口的一条连接
+     */
+    class Connection
+    {
+#ifdef _WIN32
+        HANDLE pipe_ = INVALID_HANDLE_VALUE;
+#else
+        int fd_ = -1;
+#endif
+
+    public:
+        Connection() = default;
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+        ~Connection() { close(); }
+
+        bool connect()
+        {
+#ifdef _WIN32
+            auto name = L"\\\\.\\pipe\\dotnet-diagnostic-" + std::to_wstring(GetCurrentProcessId());
+            pipe_ = CreateFileW(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+            return pipe_ != INVALID_HANDLE_VALUE;
+#else
+            // 端口名为 dotnet-diagnostic-{pid}-{启动时间}-socket，位于 TMPDIR 下
+            const char *tmp = std::getenv("TMPDIR");
+            std::filesystem::path directory = tmp && *tmp ? tmp : "/tmp";
+            std::string prefix = "dotnet-diagnostic-" + std::to_string(getpid()) + "-";
+
+            std::error_code ec;
+            for (const auto &item : std::filesystem::directory_iterator(directory, ec))
+            {
+                auto name = item.path().filename().string();
+                if (name.compare(0, prefix.size(), prefix) != 0)
+                {
+                    continue;
+                }
+
+                sockaddr_un address{};
+                address.sun_family = AF_UNIX;
+                auto path = item.path().string();
+                if (path.size() >= sizeof(address.sun_path))
+                {
+                    continue;
+                }
+                std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+                fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+                if (fd_ >= 0 && ::connect(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+                {
+                    return true;
+                }
+                close();
+            }
+            return false;
+#endif
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (pipe_ != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(pipe_);
+                pipe_ = INVALID_HANDLE_VALUE;
+            }
+#else
+            if (fd_ >= 0)
+            {
+                ::close(fd_);
+                fd_ = -1;
+            }
+#endif
+        }
+
+        /**
+         * @brief 中断其他线程在此连接上阻塞的读取
+         */
+        void shutdown()
+        {
+#ifdef _WIN32
+            CancelIoEx(pipe_, nullptr);
+#else
+            ::shutdown(fd_, SHUT_RDWR);
+#endif
+        }
+
+        bool write(const void *data, size_t size)
+        {
+            auto *bytes = static_cast<const uint8_t *>(data);
+            while (size > 0)
+            {
+#ifdef _WIN32
+                DWORD written = 0;
+                if (!WriteFile(pipe_, bytes, static_cast<DWORD>(size), &written, nullptr))
+                {
+                    return false;
+                }
+#else
+                ssize_t written = ::write(fd_, bytes, size);
+                if (written <= 0)
+                {
+                    return false;
+                }
+#endif
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        /**
+         * @return 读取的字节数，连接关闭或出错时返回 0
+         */
+        size_t read_some(void *data, size_t size)
+        {
+#ifdef _WIN32
+            DWORD read = 0;
+            return ReadFile(pipe_, data, static_cast<DWORD>(size), &read, nullptr) ? read : 0;
+#else
+            ssize_t read = ::read(fd_, data, size);
+            return read > 0 ? static_cast<size_t>(read) : 0;
+#endif
+        }
+
+        bool read(void *data, size_t size)
+        {
+            auto *bytes = static_cast<uint8_t *>(data);
+            while (size > 0)
+            {
+                size_t read = read_some(bytes, size);
+                if (read == 0)
+                {
+                    return false;
+                }
+                bytes += read;
+                size -= read;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 发送一条命令并读取应答，应答为 OK 时返回其中的 64 位值
+         */
+        bool request(uint8_t command_id, const std::vector<uint8_t> &payload, uint64_t &value)
+        {
+            Header header{};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.size = static_cast<uint16_t>(sizeof(Header) + payload.size());
+            header.command_set = COMMAND_SET_EVENT_PIPE;
+            header.command_id = command_id;
+
+            std::vector<uint8_t> message(sizeof(Header));
+            std::memcpy(message.data(), &header, sizeof(Header));
+            message.insert(message.end(), payload.begin(), payload.end());
+            if (sizeof(Header) + payload.size() > UINT16_MAX || !write(message.data(), message.size()))
+            {
+                return false;
+            }
+
+            Header response{};
+            if (!read(&response, sizeof(response)) || std::memcmp(response.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+                response.command_set != COMMAND_SET_SERVER || response.command_id != SERVER_RESPONSE_OK ||
+                response.size < sizeof(Header) + sizeof(value))
+            {
+                return false;
+            }
+            return read(&value, sizeof(value));
+        }
+    };
+
+    inline void append(std::vector<uint8_t> &buffer, const void *data, size_t size)
+    {
+        auto *bytes = static_cast<const uint8_t *>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void append(std::vector<uint8_t> &buffer, T value)
+    {
+        append(buffer, &value, sizeof(value));
+    }
+
+    /**
+     * @brief 追加协议字符串：UTF-16 字符数（含结尾的 \0）和 UTF-16LE 字符，空字符串只写长度 0
+     *
+     * 提供程序名都是 ASCII，逐字节扩展即可。
+     */
+    inline void append_string(std::vector<uint8_t> &buffer, const std::string &value)
+    {
+        if (value.empty())
+        {
+            append<uint32_t>(buffer, 0);
+            return;
+        }
+        append<uint32_t>(buffer, static_cast<uint32_t>(value.size() + 1));
+        for (char c : value)
+        {
+            append<uint16_t>(buffer, static_cast<uint8_t>(c));
+        }
+        append<uint16_t>(buffer, 0);
+    }
+
+    /**
+     * @brief 把 EventPipe 会话写入 .nettrace 文件
+     */
+    class TraceSession
+    {
+        Connection stream_;
+        std::ofstream file_;
+        std::thread writer_;
+        uint64_t session_id_ = 0;
+        bool running_ = false;
+
+        void copy_stream()
+        {
+            std::vector<char> buffer(64 * 1024);
+            while (size_t read = stream_.read_some(buffer.data(), buffer.size()))
+            {
+                file_.write(buffer.data(), static_cast<std::streamsize>(read));
+            }
+            file_.flush();
+        }
+
+    public:
+        TraceSession() = default;
+        TraceSession(const TraceSession &) = delete;
+        TraceSession &operator=(const TraceSession &) = delete;
+        ~TraceSession() { stop(); }
+
+        /**
+         * @param providers 启用的提供程序
+         * @param output_path 输出文件路径
+         * @param[out] error 失败原因
+         */
+        bool start(const std::vector<Provider> &providers, const std::filesystem::path &output_path, std::string &error)
+        {
+            file_.open(output_path, std::ios::binary | std::ios::trunc);
+            if (!file_)
+            {
+                error = "cannot open " + output_path.u8string();
+                return false;
+            }
+            if (!stream_.connect())
+            {
+                error = "diagnostic port not found";
+                file_.close();
+                return false;
+            }
+
+            std::vector<uint8_t> payload;
+            append<uint32_t>(payload, 256); // 循环缓冲区大小（MB）
+            append<uint32_t>(payload, FORMAT_NETTRACE);
+            append<uint8_t>(payload, 1); // 停止时输出 rundown 事件，离线分析时才能解析方法名
+            append<uint32_t>(payload, static_cast<uint32_t>(providers.size()));
+            for (const auto &provider : providers)
+            {
+                append<uint64_t>(payload, provider.keywords);
+                append<uint32_t>(payload, provider.level);
+                append_string(payload, provider.name);
+                append_string(payload, {});
+            }
+
+            if (!stream_.request(EVENT_PIPE_COLLECT_TRACING_2, payload, session_id_))
+            {
+                error = "CollectTracing request rejected";
+                stream_.close();
+                file_.close();
+                return false;
+            }
+
+            running_ = true;
+            writer_ = std::thread([this] { copy_stream(); });
+            return true;
+        }
+
+        /**
+         * @brief 停止会话，等待运行时写完剩余事件
+         */
+        void stop()
+        {
+            if (!running_)
+            {
+                return;
+            }
+            running_ = false;
+
+            Connection control;
+            std::vector<uint8_t> payload;
+            append<uint64_t>(payload, session_id_);
+            uint64_t stopped = 0;
+            if (!control.connect() || !control.request(EVENT_PIPE_STOP_TRACING, payload, stopped))
+            {
+                // 无法正常停止时断开数据连接，运行时随之结束会话
+                stream_.shutdown();
+            }
+
+            writer_.join();
+            stream_.close();
+            file_.close();
+        }
+
+        bool running() const { return running_; }
+    };
+}
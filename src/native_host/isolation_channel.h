@@ -0,0 +1,225 @@
+/**
+ * @file isolation_channel.h
+ * @brief 隔离模式下宿主进程与辅助进程共享的调用通道（内部头文件）
+ *
+ * 共享内存区域由宿主进程创建，包含固定数量的调用槽和一个有界 MPSC 队列：
+ *
+ * 1. 调用线程占用空闲槽，写入请求后把槽索引放入队列并敲门铃
+ * 2. 辅助进程单线程出队执行，写回结果并把槽标记为完成
+ * 3. 双方先自旋等待，超时后才通过 futex 休眠，唤醒只在对方休眠时发生
+ *
+ * 共享内存中只有无锁原子量，辅助进程崩溃不会留下被持有的锁。
+ */
+
+#pragma once
+
+#include "native_host.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace IsolationChannel
+{
+    constexpr uint32_t MAGIC = 0x4E484943; // "NHIC"
+    constexpr uint32_t VERSION = 1;
+    constexpr uint32_t SLOT_COUNT = 32;
+    constexpr uint32_t MAX_ARGS = 4;
+    constexpr size_t PAYLOAD_SIZE = 4096;
+
+    static_assert((SLOT_COUNT & (SLOT_COUNT - 1)) == 0, "SLOT_COUNT must be a power of two");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory atomics must be lock free");
+
+    /**
+     * @brief 请求类型
+     */
+    enum class Op : uint32_t
+    {
+        LoadAssembly = 1,   ///< payload: 程序集路径；target: 程序集编号
+        UnloadAssembly = 2, ///< target: 程序集编号
+        GetMethod = 3,      ///< payload: 类型名\0方法名\0签名；target: 程序集编号；aux: 方法编号
+        Invoke = 4,         ///< target: 方法编号；args/result
+    };
+
+    /**
+     * @brief 调用槽状态
+     */
+    enum SlotState : uint32_t
+    {
+        SLOT_FREE = 0,    ///< 空闲
+        SLOT_CLAIMED = 1, ///< 调用线程正在写入请求
+        SLOT_PENDING = 2, ///< 已入队，等待辅助进程处理
+        SLOT_DONE = 3,    ///< 结果已写回
+    };
+
+    struct alignas(64) Slot
+    {
+        std::atomic<uint32_t> state;
+        std::atomic<uint32_t> waiting; ///< 调用线程是否在 futex 上休眠
+        Op op;
+        uint32_t target;
+        uint32_t aux;
+        int32_t status;
+        native_value_t args[MAX_ARGS];
+        native_value_t result;
+        char payload[PAYLOAD_SIZE];
+    };
+
+    /**
+     * @brief 有界 MPSC 队列（按序号的环形缓冲区），元素为槽索引
+     *
+     * 每个槽同一时刻最多入队一次，容量等于槽数，入队不会失败。
+     */
+    struct Queue
+    {
+        struct Cell
+        {
+            std::atomic<uint32_t> sequence;
+            uint32_t slot;
+        };
+
+        alignas(64) std::atomic<uint32_t> head; ///< 下一个入队位置
+        alignas(64) std::atomic<uint32_t> tail; ///< 下一个出队位置，仅辅助进程修改
+        alignas(64) Cell cells[SLOT_COUNT];
+
+        void init()
+        {
+            for (uint32_t i = 0; i < SLOT_COUNT; ++i)
+            {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            head.store(0, std::memory_order_relaxed);
+            tail.store(0, std::memory_order_relaxed);
+        }
+
+        bool push(uint32_t slot)
+        {
+            uint32_t pos = head.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = cells[pos & (SLOT_COUNT - 1)];
+                uint32_t seq = cell.sequence.load(std::memory_order_acquire);
+                int32_t diff = static_cast<int32_t>(seq - pos);
+                if (diff == 0)
+                {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.slot = slot;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief 队首是否有可出队的元素，仅消费者调用
+         */
+        bool ready() const
+        {
+            uint32_t pos = tail.load(std::memory_order_relaxed);
+            return cells[pos & (SLOT_COUNT - 1)].sequence.load(std::memory_order_acquire) == pos + 1;
+        }
+
+        bool pop(uint32_t &slot)
+        {
+            uint32_t pos = tail.load(std::memory_order_relaxed);
+            Cell &cell = cells[pos & (SLOT_COUNT - 1)];
+            uint32_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<int32_t>(seq - (pos + 1)) < 0)
+            {
+                return false;
+            }
+            slot = cell.slot;
+            cell.sequence.store(pos + SLOT_COUNT, std::memory_order_release);
+            tail.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+    };
+
+    /**
+     * @brief 共享内存区域布局
+     */
+    struct Region
+    {
+        uint32_t magic;
+        uint32_t version;
+        alignas(64) std::atomic<uint32_t> doorbell;        ///< 每次入队递增，辅助进程在其上休眠
+        std::atomic<uint32_t> worker_sleeping;             ///< 辅助进程是否在 futex 上休眠
+        Queue queue;
+        Slot slots[SLOT_COUNT];
+
+        void init()
+        {
+            magic = MAGIC;
+            version = VERSION;
+            doorbell.store(0, std::memory_order_relaxed);
+            worker_sleeping.store(0, std::memory_order_relaxed);
+            queue.init();
+            for (auto &slot : slots)
+            {
+                slot.state.store(SLOT_FREE, std::memory_order_relaxed);
+                slot.waiting.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * @brief 自旋等待的时长
+     *
+     * 单核机器上自旋只会推迟对方运行，直接进入 futex 等待。
+     */
+    inline std::chrono::microseconds spin_time()
+    {
+        static const auto spin = std::thread::hardware_concurrency() > 1
+                                     ? std::chrono::microseconds(50)
+                                     : std::chrono::microseconds(0);
+        return spin;
+    }
+
+    /**
+     * @brief 自旋等待时让出流水线
+     */
+    inline void cpu_relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+#ifdef __linux__
+    /**
+     * @brief 跨进程 futex 等待，值不等于 expected 或超时后返回
+     */
+    inline void futex_wait(std::atomic<uint32_t> *word, uint32_t expected, std::chrono::milliseconds timeout)
+    {
+        timespec ts{};
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+    }
+
+    inline void futex_wake(std::atomic<uint32_t> *word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    }
+#endif
+}
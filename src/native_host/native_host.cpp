@@ -27,20 +27,63 @@
 #define MAX_PATH_LENGTH MAX_PATH
 #else
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <errno.h>
+#include <link.h>
+#include <linux/membarrier.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#ifdef __x86_64__
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
 #define MAX_PATH_LENGTH PATH_MAX
 #endif
 
 #include "native_host.h"
+#include "isolation_channel.h"
+#include "diagnostics_ipc.h"
+#include "plugin_bundle.h"
+#include "plugin_metadata.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <unordered_map>
 #include <sstream>
+#ifndef NATIVE_HOST_MOCK_HOSTFXR
 #include <nethost.h>
+#endif
 #include <coreclr_delegates.h>
 #include <hostfxr.h>
+#include <chrono>
 #include <filesystem>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 namespace
 {
@@ -51,9 +94,27 @@ namespace
 #ifdef _WIN32
     using char_t = wchar_t;
     using lib_handle = HMODULE;
+    constexpr const char *hostfxr_library_name = "hostfxr.dll";
+#elif defined(__APPLE__)
+    using char_t = char;
+    using lib_handle = void *;
+    constexpr const char *hostfxr_library_name = "libhostfxr.dylib";
 #else
     using char_t = char;
     using lib_handle = void *;
+    constexpr const char *hostfxr_library_name = "libhostfxr.so";
+#endif
+
+// 把热路径上很少执行的分支移出，使热路径不必保存额外的寄存器
+#ifdef _MSC_VER
+#define NATIVE_HOST_NOINLINE __declspec(noinline)
+#else
+#define NATIVE_HOST_NOINLINE __attribute__((noinline))
+#endif
+
+// 按入口点的跳板（计时和延迟绑定）需要为每种调用约定手写桩，目前只实现了 x86-64 System V
+#if defined(__linux__) && defined(__x86_64__)
+#define NATIVE_HOST_TRAMPOLINES
 #endif
 
     /**
@@ -160,6 +221,246 @@ namespace
 #endif
     }
 
+    /**
+     * @brief 获取 native_host 库自身所在的目录
+     *
+     * 用于把应用本地运行时等相对路径解析到库旁边，而不是进程的当前目录。
+     * 静态链接进可执行文件时为可执行文件所在的目录。
+     */
+    std::filesystem::path module_directory()
+    {
+#ifdef _WIN32
+        HMODULE module = nullptr;
+        if (!GetModuleHandleExW(
+                GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                reinterpret_cast<LPCWSTR>(&module_directory),
+                &module))
+        {
+            log_error("GetModuleHandleEx failed", GetLastError());
+            return std::filesystem::current_path();
+        }
+        wchar_t path[MAX_PATH_LENGTH];
+        DWORD size = GetModuleFileNameW(module, path, MAX_PATH_LENGTH);
+        if (size == 0 || size == MAX_PATH_LENGTH)
+        {
+            log_error("GetModuleFileName failed", GetLastError());
+            return std::filesystem::current_path();
+        }
+        return std::filesystem::path(path).parent_path();
+#else
+        Dl_info info;
+#ifdef __linux__
+        // 对可执行文件本身 dladdr 只返回 argv[0]，可能是相对于启动目录的路径或不含目录
+        link_map *map = nullptr;
+        if (dladdr1(reinterpret_cast<void *>(&module_directory), &info, reinterpret_cast<void **>(&map),
+                    RTLD_DL_LINKMAP) != 0 &&
+            map && map->l_name[0] == '\0')
+        {
+            std::error_code ec;
+            auto executable = std::filesystem::read_symlink("/proc/self/exe", ec);
+            if (!ec)
+            {
+                return executable.parent_path();
+            }
+        }
+#endif
+        if (dladdr(reinterpret_cast<void *>(&module_directory), &info) == 0 || !info.dli_fname)
+        {
+            log_error("dladdr failed");
+            return std::filesystem::current_path();
+        }
+        return std::filesystem::absolute(info.dli_fname).parent_path();
+#endif
+    }
+
+    /**
+     * @brief 将 UTF-8 路径解析为绝对路径，相对路径以 native_host 库所在目录为基准
+     */
+    std::filesystem::path resolve_module_relative(const std::string &path)
+    {
+        std::filesystem::path result(to_native_path(path.c_str()));
+        if (result.is_relative())
+        {
+            result = module_directory() / result;
+        }
+        return result.lexically_normal();
+    }
+
+    /**
+     * @brief 查找进程中已加载的库
+     *
+     * @param file_name 库的文件名，不含目录
+     * @param[out] path 已加载的库的完整路径
+     * @return 进程中已加载同名库时返回 true
+     */
+    bool find_loaded_module(const char *file_name, std::filesystem::path &path)
+    {
+#ifdef _WIN32
+        HMODULE module = GetModuleHandleW(to_native_path(file_name).c_str());
+        if (!module)
+        {
+            return false;
+        }
+        wchar_t buffer[MAX_PATH_LENGTH];
+        DWORD size = GetModuleFileNameW(module, buffer, MAX_PATH_LENGTH);
+        if (size == 0 || size == MAX_PATH_LENGTH)
+        {
+            log_error("GetModuleFileName failed", GetLastError());
+            return false;
+        }
+        path = buffer;
+        return true;
+#elif defined(__APPLE__)
+        for (uint32_t i = 0, count = _dyld_image_count(); i < count; ++i)
+        {
+            const char *name = _dyld_get_image_name(i);
+            if (name && std::filesystem::path(name).filename() == file_name)
+            {
+                path = name;
+                return true;
+            }
+        }
+        return false;
+#elif defined(__linux__)
+        struct Search
+        {
+            const char *file_name;
+            std::filesystem::path *path;
+        } search{file_name, &path};
+
+        // 按文件名匹配：hostfxr 没有 soname，dlopen(RTLD_NOLOAD) 只能按加载时的完整路径找到它
+        return dl_iterate_phdr(
+                   [](dl_phdr_info *info, size_t, void *data) -> int
+                   {
+                       auto *search = static_cast<Search *>(data);
+                       if (!info->dlpi_name || !*info->dlpi_name ||
+                           std::filesystem::path(info->dlpi_name).filename() != search->file_name)
+                       {
+                           return 0;
+                       }
+                       *search->path = info->dlpi_name;
+                       return 1;
+                   },
+                   &search) != 0;
+#else
+        (void)file_name;
+        (void)path;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 程序集的种类
+     */
+    enum class AssemblyKind
+    {
+        Managed,   ///< 由 CoreCLR 加载和 JIT 的托管程序集
+        NativeAot, ///< NativeAOT 编译的本机共享库，通过导出符号直接调用
+        Isolated   ///< 加载在隔离辅助进程中的程序集，只能按签名调用
+    };
+
+    /**
+     * @brief 根据镜像头判断程序集种类
+     *
+     * 托管程序集在所有平台上都是带 CLI 头的 PE 文件；ELF、Mach-O 以及没有 CLI 头的 PE 文件
+     * 都视为 NativeAOT 本机库。无法识别的镜像交给运行时处理并报告错误。
+     *
+     * @param read 按偏移读取镜像内容的函数，超出范围时返回 false
+     */
+    template <typename Read>
+    AssemblyKind detect_image_kind(Read read)
+    {
+        unsigned char header[4] = {};
+        if (!read(0, header, sizeof(header)))
+        {
+            return AssemblyKind::Managed;
+        }
+
+        auto read_u16 = [&](uint64_t offset, uint32_t &value)
+        {
+            unsigned char bytes[2] = {};
+            if (!read(offset, bytes, sizeof(bytes)))
+                return false;
+            value = bytes[0] | (bytes[1] << 8);
+            return true;
+        };
+        auto read_u32 = [&](uint64_t offset, uint32_t &value)
+        {
+            unsigned char bytes[4] = {};
+            if (!read(offset, bytes, sizeof(bytes)))
+                return false;
+            value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+            return true;
+        };
+
+        uint32_t magic = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+        if (magic == 0x464c457f || // ELF
+            magic == 0xfeedface || magic == 0xfeedfacf || magic == 0xcefaedfe || magic == 0xcffaedfe || // Mach-O
+            magic == 0xbebafeca) // Mach-O universal
+        {
+            return AssemblyKind::NativeAot;
+        }
+
+        if (header[0] != 'M' || header[1] != 'Z')
+        {
+            return AssemblyKind::Managed;
+        }
+
+        // PE：检查可选头中的 CLI 头数据目录（索引 14）
+        constexpr uint32_t CLI_HEADER_DIRECTORY = 14;
+        uint32_t pe_offset = 0, signature = 0, optional_magic = 0;
+        if (!read_u32(0x3c, pe_offset) || !read_u32(pe_offset, signature) || signature != 0x00004550)
+        {
+            return AssemblyKind::Managed;
+        }
+
+        uint64_t optional_header = pe_offset + 4 + 20;
+        if (!read_u16(optional_header, optional_magic))
+        {
+            return AssemblyKind::Managed;
+        }
+
+        uint64_t directory_count_offset = optional_header + (optional_magic == 0x20b ? 108 : 92);
+        uint32_t directory_count = 0, cli_rva = 0, cli_size = 0;
+        if (!read_u32(directory_count_offset, directory_count))
+        {
+            return AssemblyKind::Managed;
+        }
+        if (directory_count <= CLI_HEADER_DIRECTORY)
+        {
+            return AssemblyKind::NativeAot;
+        }
+
+        uint64_t cli_directory = directory_count_offset + 4 + CLI_HEADER_DIRECTORY * 8;
+        if (!read_u32(cli_directory, cli_rva) || !read_u32(cli_directory + 4, cli_size))
+        {
+            return AssemblyKind::Managed;
+        }
+        return (cli_rva == 0 && cli_size == 0) ? AssemblyKind::NativeAot : AssemblyKind::Managed;
+    }
+
+    AssemblyKind detect_assembly_kind(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return detect_image_kind([&](uint64_t offset, unsigned char *buffer, size_t count)
+                                 {
+                                     file.seekg(static_cast<std::streamoff>(offset));
+                                     return static_cast<bool>(file.read(reinterpret_cast<char *>(buffer), count));
+                                 });
+    }
+
+    AssemblyKind detect_assembly_kind(const void *image, size_t size)
+    {
+        auto bytes = static_cast<const unsigned char *>(image);
+        return detect_image_kind([&](uint64_t offset, unsigned char *buffer, size_t count)
+                                 {
+                                     if (offset > size || count > size - offset)
+                                         return false;
+                                     std::memcpy(buffer, bytes + offset, count);
+                                     return true;
+                                 });
+    }
+
     /**
      * @brief .NET错误代码映射和分类
      *
@@ -189,465 +490,6894 @@ namespace
     }
 
     /**
-     * @brief .NET主机库的RAII包装器
+     * @brief 程序集资源统计
      *
-     * 确保.NET主机框架解析器库的正确加载和卸载。
+     * 调用次数在每次调用时累加；CPU 时间和托管分配字节数按线程本地的倒计数采样，
+     * 使未被采样的调用只付出一次原子加法的开销。
      */
-    class HostFxrLibrary
+    namespace Accounting
     {
-        lib_handle handle_;
+        using allocated_bytes_fn = int64_t(CORECLR_DELEGATE_CALLTYPE *)();
 
-    public:
-        explicit HostFxrLibrary(const char_t *path) : handle_(nullptr)
+        constexpr uint32_t DEFAULT_SAMPLE_RATE = 64;
+
+        std::atomic<uint32_t> sample_rate{DEFAULT_SAMPLE_RATE};
+        std::atomic<allocated_bytes_fn> allocated_bytes{nullptr};
+        thread_local uint32_t sample_countdown = 0;
+
+        uint64_t thread_cpu_time_ns()
         {
-            handle_ = load_library(path);
-            if (handle_)
-            {
 #ifdef _WIN32
-                int size = WideCharToMultiByte(CP_UTF8, 0, path, -1, nullptr, 0, nullptr, nullptr);
-                std::string path_str;
-                if (size > 0)
-                {
-                    path_str.resize(size - 1); // -1 because size includes null terminator
-                    WideCharToMultiByte(CP_UTF8, 0, path, -1, &path_str[0], size, nullptr, nullptr);
-                }
+            FILETIME creation, exit, kernel, user;
+            if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+            {
+                return 0;
+            }
+            auto to_ns = [](const FILETIME &ft)
+            {
+                return ((static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 100;
+            };
+            return to_ns(kernel) + to_ns(user);
 #else
-                std::string path_str(path);
-#endif
-                log_info("Loaded library: " + path_str);
+            timespec ts;
+            if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+            {
+                return 0;
             }
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#endif
         }
 
-        ~HostFxrLibrary()
+        int64_t current_allocated_bytes()
         {
-            if (handle_)
+            auto fn = allocated_bytes.load(std::memory_order_acquire);
+            return fn ? fn() : 0;
+        }
+
+        bool should_sample()
+        {
+            uint32_t rate = sample_rate.load(std::memory_order_relaxed);
+            if (rate == 0)
             {
-                free_library(handle_);
-                log_info("Unloaded library");
+                return false;
+            }
+            if (sample_countdown == 0 || sample_countdown > rate)
+            {
+                sample_countdown = rate;
             }
+            return --sample_countdown == 0;
         }
-
-        lib_handle get() const { return handle_; }
-        operator bool() const { return handle_ != nullptr; }
-    };
+    }
 
     /**
-     * @brief .NET运行时管理
-     *
-     * 管理.NET运行时初始化并提供核心运行时功能的单例类。
+     * @brief 线程本地的分配区
      *
-     * 主要职责：
-     * - 加载和初始化 .NET 运行时
-     * - 管理运行时配置
-     * - 提供程序集加载能力
+     * 托管代码返回的变长结果（序列化记录、字符串等）从调用线程的分配区中顺序分配，
+     * 本机代码在请求结束时一次性重置，不需要逐个释放。每个线程只访问自己的分配区，分配不加锁；
+     * 计数只由所属线程写入，查询统计时由其他线程汇总读取。
      */
-    class Runtime
+    namespace Arena
     {
-        bool initialized_ = false;
-        load_assembly_and_get_function_pointer_fn load_assembly_fn_ = nullptr;
-        hostfxr_close_fn close_fn_ = nullptr;
-        std::unique_ptr<HostFxrLibrary> hostfxr_lib_;
-        static constexpr const char *config_path = "init.runtimeconfig.json";
+        constexpr size_t BLOCK_SIZE = 64 * 1024;
+        constexpr size_t RETAINED_BYTES = 1024 * 1024; ///< 重置后保留供复用的块容量上限
+        constexpr size_t MAX_ALIGNMENT = 4096;
 
-        bool load_hostfxr()
+        struct Block
         {
-            char_t hostfxr_path[MAX_PATH_LENGTH];
-            size_t buffer_size = sizeof(hostfxr_path) / sizeof(char_t);
+            Block *next;
+            size_t size; ///< 含块头的总字节数
+        };
 
-            int rc = get_hostfxr_path(hostfxr_path, &buffer_size, nullptr);
-            if (rc != 0)
+        struct Counters
+        {
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> allocated_bytes{0};
+            std::atomic<uint64_t> live_allocations{0};
+            std::atomic<uint64_t> live_bytes{0};
+            std::atomic<uint64_t> reserved_bytes{0};
+            std::atomic<uint64_t> resets{0};
+        };
+
+        // 只由所属线程写入，读改写不需要原子指令
+        inline void add(std::atomic<uint64_t> &counter, uint64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        class ThreadArena;
+
+        thread_local ThreadArena *current_arena = nullptr;
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<ThreadArena *> arenas;
+            native_arena_stats_t exited{}; ///< 已退出线程的累计值
+        };
+
+        // 不析构：进程退出时仍可能有线程销毁分配区
+        Registry &registry()
+        {
+            static auto *instance = new Registry();
+            return *instance;
+        }
+
+        class ThreadArena
+        {
+            Block *used_ = nullptr;  ///< 已分配过的块，表头为当前块
+            Block *spare_ = nullptr; ///< 重置后保留的空闲块
+            size_t spare_bytes_ = 0;
+            char *cursor_ = nullptr;
+            char *limit_ = nullptr;
+            Counters counters_;
+
+            static char *align_up(char *p, size_t alignment)
             {
-                log_error("Failed to get hostfxr path", rc);
-                return false;
+                auto value = reinterpret_cast<uintptr_t>(p);
+                return reinterpret_cast<char *>((value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
             }
 
-            hostfxr_lib_ = std::make_unique<HostFxrLibrary>(hostfxr_path);
-            if (!hostfxr_lib_ || !*hostfxr_lib_)
+            bool grow(size_t size, size_t alignment)
             {
-                log_error("Failed to load hostfxr library");
-                return false;
+                size_t needed = sizeof(Block) + size + alignment;
+                Block *block = nullptr;
+                if (spare_ && needed <= BLOCK_SIZE)
+                {
+                    block = spare_;
+                    spare_ = block->next;
+                    spare_bytes_ -= block->size;
+                }
+                else
+                {
+                    // 大于标准块的分配独占一个块，重置时直接释放
+                    size_t block_size = std::max(needed, BLOCK_SIZE);
+                    block = static_cast<Block *>(std::malloc(block_size));
+                    if (!block)
+                    {
+                        return false;
+                    }
+                    block->size = block_size;
+                    add(counters_.reserved_bytes, block_size);
+                }
+
+                block->next = used_;
+                used_ = block;
+                cursor_ = reinterpret_cast<char *>(block + 1);
+                limit_ = reinterpret_cast<char *>(block) + block->size;
+                return true;
             }
 
-            auto init_fn = (hostfxr_initialize_for_runtime_config_fn)
-                get_function(hostfxr_lib_->get(), "hostfxr_initialize_for_runtime_config");
-            auto get_delegate_fn = (hostfxr_get_runtime_delegate_fn)
-                get_function(hostfxr_lib_->get(), "hostfxr_get_runtime_delegate");
-            close_fn_ = (hostfxr_close_fn)
-                get_function(hostfxr_lib_->get(), "hostfxr_close");
+            void free_blocks(Block *block)
+            {
+                while (block)
+                {
+                    Block *next = block->next;
+                    counters_.reserved_bytes.store(counters_.reserved_bytes.load(std::memory_order_relaxed) - block->size,
+                                                   std::memory_order_relaxed);
+                    std::free(block);
+                    block = next;
+                }
+            }
 
-            if (!init_fn || !get_delegate_fn || !close_fn_)
+        public:
+            ThreadArena()
             {
-                log_error("Failed to get required functions");
-                return false;
+                auto &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.arenas.push_back(this);
             }
 
-            hostfxr_handle ctx = nullptr;
-            rc = init_fn(to_native_path(config_path).c_str(), nullptr, &ctx);
+            ~ThreadArena()
+            {
+                auto &r = registry();
+                {
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    r.arenas.erase(std::find(r.arenas.begin(), r.arenas.end(), this));
+                    r.exited.allocations += counters_.allocations.load(std::memory_order_relaxed) +
+                                            counters_.live_allocations.load(std::memory_order_relaxed);
+                    r.exited.allocated_bytes += counters_.allocated_bytes.load(std::memory_order_relaxed) +
+                                                counters_.live_bytes.load(std::memory_order_relaxed);
+                    r.exited.resets += counters_.resets.load(std::memory_order_relaxed);
+                    r.exited.leaked_allocations += counters_.live_allocations.load(std::memory_order_relaxed);
+                    r.exited.leaked_bytes += counters_.live_bytes.load(std::memory_order_relaxed);
+                }
+                current_arena = nullptr;
+                if (counters_.live_allocations.load(std::memory_order_relaxed) > 0)
+                {
+                    log_error("Thread exited without resetting its host arena, " +
+                              std::to_string(counters_.live_bytes.load(std::memory_order_relaxed)) + " bytes released");
+                }
+                free_blocks(used_);
+                free_blocks(spare_);
+            }
 
-            // rc返回值为1时，也是 hostfxr已经初始化，只是使用了相同配置，
-            // 但是当前实现只有一个 runtime 单例，所以这里不会出现此种情形。
-            if (rc != 0)
+            ThreadArena(const ThreadArena &) = delete;
+            ThreadArena &operator=(const ThreadArena &) = delete;
+
+            NATIVE_HOST_NOINLINE void *allocate_slow(size_t size, size_t alignment)
             {
-                log_error("Failed to initialize runtime", rc);
-                return false;
+                if (!grow(size, alignment))
+                {
+                    return nullptr;
+                }
+                char *p = align_up(cursor_, alignment);
+                cursor_ = p + size;
+                add(counters_.live_allocations, 1);
+                add(counters_.live_bytes, size);
+                return p;
             }
 
-            rc = get_delegate_fn(
-                ctx,
-                hdt_load_assembly_and_get_function_pointer,
-                (void **)&load_assembly_fn_);
+            /**
+             * @brief 只在当前块中分配，空间不足时返回 nullptr，不申请新块
+             *
+             * 累计值在重置时从在用计数折算，分配路径只更新两个计数。
+             */
+            void *try_allocate(size_t size, size_t alignment)
+            {
+                char *p = align_up(cursor_, alignment);
+                if (!cursor_ || size > static_cast<size_t>(limit_ - p))
+                {
+                    return nullptr;
+                }
+                cursor_ = p + size;
+                add(counters_.live_allocations, 1);
+                add(counters_.live_bytes, size);
+                return p;
+            }
 
-            if (rc != 0 || !load_assembly_fn_)
+            void *allocate(size_t size, size_t alignment)
             {
-                close_fn_(ctx);
-                log_error("Failed to get load assembly function", rc);
-                return false;
+                void *p = try_allocate(size, alignment);
+                return p ? p : allocate_slow(size, alignment);
             }
 
-            close_fn_(ctx);
-            log_info("Runtime initialized successfully");
-            return true;
+            /**
+             * @brief 释放全部分配，标准大小的块保留复用，超过保留上限或独占的块归还系统
+             */
+            void reset()
+            {
+                while (used_)
+                {
+                    Block *block = used_;
+                    used_ = block->next;
+                    if (block->size == BLOCK_SIZE && spare_bytes_ + BLOCK_SIZE <= RETAINED_BYTES)
+                    {
+                        block->next = spare_;
+                        spare_ = block;
+                        spare_bytes_ += BLOCK_SIZE;
+                    }
+                    else
+                    {
+                        block->next = nullptr;
+                        free_blocks(block);
+                    }
+                }
+                cursor_ = limit_ = nullptr;
+                add(counters_.allocations, counters_.live_allocations.load(std::memory_order_relaxed));
+                add(counters_.allocated_bytes, counters_.live_bytes.load(std::memory_order_relaxed));
+                counters_.live_allocations.store(0, std::memory_order_relaxed);
+                counters_.live_bytes.store(0, std::memory_order_relaxed);
+                add(counters_.resets, 1);
+            }
+
+            void collect(native_arena_stats_t &stats) const
+            {
+                // 重置时先累加再清零在用计数，并发读取可能短暂少计或多计一轮
+                uint64_t live_allocations = counters_.live_allocations.load(std::memory_order_relaxed);
+                uint64_t live_bytes = counters_.live_bytes.load(std::memory_order_relaxed);
+                stats.allocations += counters_.allocations.load(std::memory_order_relaxed) + live_allocations;
+                stats.allocated_bytes += counters_.allocated_bytes.load(std::memory_order_relaxed) + live_bytes;
+                stats.live_allocations += live_allocations;
+                stats.live_bytes += live_bytes;
+                stats.reserved_bytes += counters_.reserved_bytes.load(std::memory_order_relaxed);
+                stats.resets += counters_.resets.load(std::memory_order_relaxed);
+                stats.thread_count++;
+            }
+        };
+
+        NATIVE_HOST_NOINLINE ThreadArena &create()
+        {
+            // 线程退出时析构
+            thread_local ThreadArena arena;
+            current_arena = &arena;
+            return arena;
         }
 
-    public:
-        static Runtime &instance()
+        inline ThreadArena &current()
         {
-            static Runtime runtime;
-            return runtime;
+            ThreadArena *arena = current_arena;
+            return arena ? *arena : create();
         }
 
-        bool initialize()
+        inline bool valid_request(size_t size, size_t alignment)
         {
-            if (initialized_)
-                return true;
-            if (!load_hostfxr())
-                return false;
-            initialized_ = true;
-            return true;
+            return alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= MAX_ALIGNMENT &&
+                   size <= PTRDIFF_MAX - BLOCK_SIZE;
         }
 
-        load_assembly_and_get_function_pointer_fn get_load_fn() const { return load_assembly_fn_; }
-        bool is_initialized() const { return initialized_; }
-    };
+        void *allocate(size_t size, size_t alignment)
+        {
+            if (!valid_request(size, alignment))
+            {
+                return nullptr;
+            }
+            return current().allocate(size, alignment);
+        }
 
-    /**
-     * @brief 程序集
-     *
-     * 处理单个.NET程序集的加载和管理。
+        /**
+         * @brief 供托管代码以 SuppressGCTransition 调用的快速路径
+         *
+         * 不创建分配区、不加锁也不申请内存：当前线程还没有分配区或当前块空间不足时返回 nullptr，
+         * 托管代码随后经普通的 GC 转换调用 allocate_for_managed。
+         */
+        void *CORECLR_DELEGATE_CALLTYPE try_allocate_for_managed(size_t size, size_t alignment)
+        {
+            ThreadArena *arena = current_arena;
+            if (!arena || !valid_request(size, alignment))
+            {
+                return nullptr;
+            }
+            return arena->try_allocate(size, alignment);
+        }
+
+        /**
+         * @brief 供托管代码调用的完整分配入口，可能创建并登记分配区（加锁）或申请新块
+         */
+        void *CORECLR_DELEGATE_CALLTYPE allocate_for_managed(size_t size, size_t alignment)
+        {
+            return allocate(size, alignment);
+        }
+
+        void reset()
+        {
+            // 没有分配过的线程不创建分配区
+            if (current_arena)
+            {
+                current_arena->reset();
+            }
+        }
+
+        native_arena_stats_t stats()
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            native_arena_stats_t result = r.exited;
+            for (const auto *arena : r.arenas)
+            {
+                arena->collect(result);
+            }
+            return result;
+        }
+
+        /**
+         * @brief 报告尚未重置的分配，主机销毁时调用
+         */
+        void check_leaks()
+        {
+            auto result = stats();
+            if (result.live_allocations > 0 || result.leaked_allocations > 0)
+            {
+                log_error("Host arena leak: " + std::to_string(result.live_bytes) + " bytes in " +
+                          std::to_string(result.live_allocations) + " allocations not reset, " +
+                          std::to_string(result.leaked_bytes) + " bytes released at thread exit");
+            }
+        }
+    }
+
+    /**
+     * @brief .NET主机库的RAII包装器
      *
-     * 主要功能：
-     * - 路径验证和存在性检查
-     * - 程序集加载和卸载
-     * - 方法解析和委托创建
+     * 确保.NET主机框架解析器库的正确加载和卸载。
      */
-    class Assembly
+    class HostFxrLibrary
     {
-        std::string path_;
-        bool loaded_ = false;
+        lib_handle handle_;
 
     public:
-        explicit Assembly(const char *path) : path_(path)
+        explicit HostFxrLibrary(const char_t *path) : handle_(nullptr)
         {
-            log_info("Created assembly for path: " + path_);
+            handle_ = load_library(path);
+            if (handle_)
+            {
+#ifdef _WIN32
+                int size = WideCharToMultiByte(CP_UTF8, 0, path, -1, nullptr, 0, nullptr, nullptr);
+                std::string path_str;
+                if (size > 0)
+                {
+                    path_str.resize(size - 1); // -1 because size includes null terminator
+                    WideCharToMultiByte(CP_UTF8, 0, path, -1, &path_str[0], size, nullptr, nullptr);
+                }
+#else
+                std::string path_str(path);
+#endif
+                log_info("Loaded library: " + path_str);
+            }
+        }
+
+        ~HostFxrLibrary()
+        {
+            if (handle_)
+            {
+                free_library(handle_);
+                log_info("Unloaded library");
+            }
+        }
+
+        lib_handle get() const { return handle_; }
+        operator bool() const { return handle_ != nullptr; }
+    };
+
+    /**
+     * @brief 主机操作的时间线
+     *
+     * 开启后把运行时初始化的各阶段、程序集加载、入口点解析和主机锁的等待记录为时间段，
+     * 按需写成 Chrome trace JSON，可以直接在 ui.perfetto.dev 或 chrome://tracing 中打开。
+     * 每个线程写入自己的环形缓冲区，写满后覆盖最早的记录；缓冲区的锁只在导出时才有竞争。
+     * 关闭时每个记录点只多一次原子读。
+     */
+    namespace Timeline
+    {
+        constexpr uint32_t DEFAULT_EVENTS_PER_THREAD = 4096;
+        constexpr size_t MAX_ARGS = 2;
+        constexpr size_t MAX_ARG_LENGTH = 96;
+
+        using clock = std::chrono::steady_clock;
+
+        struct Event
+        {
+            const char *name;
+            int64_t start_ns;
+            int64_t duration_ns;
+            const char *arg_keys[MAX_ARGS];
+            char arg_values[MAX_ARGS][MAX_ARG_LENGTH];
+        };
+
+        struct ThreadBuffer
+        {
+            uint32_t tid = 0;
+            std::mutex mutex;
+            std::vector<Event> events;
+            uint64_t written = 0;
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            uint32_t capacity = DEFAULT_EVENTS_PER_THREAD;
+            // 每次开始时递增，线程据此换用新的缓冲区
+            std::atomic<uint64_t> generation{0};
+            std::atomic<bool> enabled{false};
+            std::atomic<uint32_t> next_tid{1};
+            clock::time_point epoch = clock::now();
+        };
+
+        // 不析构：进程退出时其他线程仍可能在记录
+        Registry &registry()
+        {
+            static auto *instance = new Registry();
+            return *instance;
+        }
+
+        bool enabled()
+        {
+            return registry().enabled.load(std::memory_order_relaxed);
+        }
+
+        ThreadBuffer *thread_buffer()
+        {
+            struct Local
+            {
+                std::shared_ptr<ThreadBuffer> buffer;
+                uint64_t generation = 0;
+                uint32_t tid = 0;
+            };
+            thread_local Local local;
+
+            auto &r = registry();
+            uint64_t generation = r.generation.load(std::memory_order_acquire);
+            if (!local.buffer || local.generation != generation)
+            {
+                if (local.tid == 0)
+                {
+                    local.tid = r.next_tid.fetch_add(1, std::memory_order_relaxed);
+                }
+                auto buffer = std::make_shared<ThreadBuffer>();
+                buffer->tid = local.tid;
+                std::lock_guard<std::mutex> lock(r.mutex);
+                buffer->events.resize(r.capacity);
+                r.buffers.push_back(buffer);
+                local.buffer = std::move(buffer);
+                local.generation = r.generation.load(std::memory_order_relaxed);
+            }
+            return local.buffer.get();
+        }
+
+        /**
+         * @brief 记录从 start 到现在的时间段，参数值超长时保留末尾
+         */
+        void record(const char *name, clock::time_point start,
+                    const char *key0 = nullptr, const char *value0 = nullptr,
+                    const char *key1 = nullptr, const char *value1 = nullptr)
+        {
+            if (!enabled())
+            {
+                return;
+            }
+
+            auto end = clock::now();
+            auto *buffer = thread_buffer();
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            auto &event = buffer->events[buffer->written % buffer->events.size()];
+            event.name = name;
+            event.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start - registry().epoch).count();
+            event.duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+            const char *keys[MAX_ARGS] = {key0, key1};
+            const char *values[MAX_ARGS] = {value0, value1};
+            for (size_t i = 0; i < MAX_ARGS; ++i)
+            {
+                event.arg_keys[i] = values[i] ? keys[i] : nullptr;
+                if (event.arg_keys[i])
+                {
+                    size_t length = std::strlen(values[i]);
+                    const char *tail = values[i] + (length >= MAX_ARG_LENGTH ? length - (MAX_ARG_LENGTH - 1) : 0);
+                    std::strncpy(event.arg_values[i], tail, MAX_ARG_LENGTH - 1);
+                    event.arg_values[i][MAX_ARG_LENGTH - 1] = '\0';
+                }
+            }
+            buffer->written++;
+        }
+
+        /**
+         * @brief 作用域内的时间段，参数在作用域结束时复制，调用方需保证其有效
+         */
+        class Span
+        {
+            const char *name_;
+            const char *keys_[MAX_ARGS];
+            const char *values_[MAX_ARGS];
+            clock::time_point start_;
+            bool active_;
+
+        public:
+            explicit Span(const char *name,
+                          const char *key0 = nullptr, const char *value0 = nullptr,
+                          const char *key1 = nullptr, const char *value1 = nullptr)
+                : name_(name), keys_{key0, key1}, values_{value0, value1}, active_(enabled())
+            {
+                if (active_)
+                {
+                    start_ = clock::now();
+                }
+            }
+
+            ~Span()
+            {
+                if (active_)
+                {
+                    record(name_, start_, keys_[0], values_[0], keys_[1], values_[1]);
+                }
+            }
+
+            Span(const Span &) = delete;
+            Span &operator=(const Span &) = delete;
+        };
+
+        /**
+         * @brief 获取主机锁，开启时间线且锁被占用时记录等待时间
+         */
+        class HostLock
+        {
+            std::mutex &mutex_;
+
+        public:
+            HostLock(std::mutex &mutex, const char *caller) : mutex_(mutex)
+            {
+                if (!enabled())
+                {
+                    mutex_.lock();
+                    return;
+                }
+                if (mutex_.try_lock())
+                {
+                    return;
+                }
+
+                auto start = clock::now();
+                mutex_.lock();
+                record("host_lock_wait", start, "caller", caller);
+            }
+
+            ~HostLock() { mutex_.unlock(); }
+
+            HostLock(const HostLock &) = delete;
+            HostLock &operator=(const HostLock &) = delete;
+        };
+
+        /**
+         * @brief 清空已有的记录并开始记录
+         */
+        void start(uint32_t events_per_thread)
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.buffers.clear();
+            r.capacity = events_per_thread ? events_per_thread : DEFAULT_EVENTS_PER_THREAD;
+            r.generation.fetch_add(1, std::memory_order_release);
+            r.enabled.store(true, std::memory_order_relaxed);
+        }
+
+        void stop()
+        {
+            registry().enabled.store(false, std::memory_order_relaxed);
+        }
+
+        void write_json_string(std::ostream &out, const char *text)
+        {
+            out << '"';
+            for (const char *p = text; *p; ++p)
+            {
+                unsigned char c = static_cast<unsigned char>(*p);
+                if (c == '"' || c == '\\')
+                {
+                    out << '\\' << *p;
+                }
+                else if (c < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                }
+                else
+                {
+                    out << *p;
+                }
+            }
+            out << '"';
+        }
+
+        /**
+         * @brief 把各线程缓冲区中的记录写成 Chrome trace JSON，时间戳单位为微秒
+         */
+        bool write(const std::filesystem::path &path)
+        {
+            auto &r = registry();
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            {
+                std::lock_guard<std::mutex> lock(r.mutex);
+                buffers = r.buffers;
+            }
+
+#ifdef _WIN32
+            auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+            auto pid = static_cast<unsigned long>(getpid());
+#endif
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+                << ",\"tid\":0,\"args\":{\"name\":\"native_host\"}}";
+
+            uint64_t dropped = 0;
+            char number[64];
+            for (auto &buffer : buffers)
+            {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                    << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+
+                uint64_t capacity = buffer->events.size();
+                uint64_t first = buffer->written > capacity ? buffer->written - capacity : 0;
+                dropped += first;
+                for (uint64_t i = first; i < buffer->written; ++i)
+                {
+                    const auto &event = buffer->events[i % capacity];
+                    out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"native_host\",\"ph\":\"X\",\"pid\":" << pid
+                        << ",\"tid\":" << buffer->tid;
+                    std::snprintf(number, sizeof(number), "%.3f", event.start_ns / 1000.0);
+                    out << ",\"ts\":" << number;
+                    std::snprintf(number, sizeof(number), "%.3f", event.duration_ns / 1000.0);
+                    out << ",\"dur\":" << number << ",\"args\":{";
+                    bool first_arg = true;
+                    for (size_t a = 0; a < MAX_ARGS; ++a)
+                    {
+                        if (event.arg_keys[a])
+                        {
+                            out << (first_arg ? "\"" : ",\"") << event.arg_keys[a] << "\":";
+                            write_json_string(out, event.arg_values[a]);
+                            first_arg = false;
+                        }
+                    }
+                    out << "}}";
+                }
+            }
+            out << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+            return static_cast<bool>(out);
+        }
+    }
+
+    /**
+     * @brief .NET运行时管理
+     *
+     * 管理.NET运行时初始化并提供核心运行时功能的单例类。
+     *
+     * 主要职责：
+     * - 加载和初始化 .NET 运行时
+     * - 管理运行时配置
+     * - 提供程序集加载能力
+     */
+    class Runtime
+    {
+        /**
+         * @brief 运行时解析选项，路径均为 UTF-8
+         */
+        struct Options
+        {
+            std::string dotnet_root;
+            std::string hostfxr_path;
+            std::string runtime_config_path;
+            std::string dependency_cache_dir;
+            native_runtime_attach_mode_t attach_mode = NATIVE_RUNTIME_ATTACH_AUTO;
+        };
+
+        /**
+         * @brief 运行时配置与已运行的运行时取值不同的属性，UTF-8
+         */
+        struct PropertyMismatch
+        {
+            std::string name;
+            std::string requested;
+            std::string active;
+            bool has_active = false;
+        };
+
+        /**
+         * @brief 支持程序集中的插件加载入口，返回值为 NativeHostStatus
+         */
+        struct PluginLoader
+        {
+            using load_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(const char *path, int32_t *plugin_id);
+            using get_function_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(
+                int32_t plugin_id, const char *type_name, const char *method_name, void **function);
+            /** 按简单名称查找依赖镜像，找到时返回 0 */
+            using resolve_image_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(
+                void *context, const char *name, const void **image, int64_t *size);
+            using load_from_memory_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(
+                const char *name, const char *key, const void *image, int64_t size,
+                resolve_image_fn resolve, void *resolve_context, int32_t *plugin_id);
+
+            load_fn load = nullptr;
+            get_function_fn get_function = nullptr;
+            load_from_memory_fn load_from_memory = nullptr;
+        };
+
+        /**
+         * @brief 支持程序集中的插件对象入口，返回值为 NativeHostStatus
+         */
+        struct PluginObjects
+        {
+            using create_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(int32_t plugin_id, const char *type_name, void **object);
+            using release_fn = void(CORECLR_DELEGATE_CALLTYPE *)(void *const *objects, int32_t count);
+
+            create_fn create = nullptr;
+            release_fn release = nullptr;
+        };
+
+        bool initialized_ = false;
+        bool attached_ = false;
+        Options options_;
+        native_runtime_init_timings_t timings_{};
+        std::vector<PropertyMismatch> property_mismatches_;
+        std::vector<native_runtime_property_mismatch_t> property_mismatch_views_;
+        load_assembly_and_get_function_pointer_fn load_assembly_fn_ = nullptr;
+        load_assembly_fn load_default_fn_ = nullptr;
+        get_function_pointer_fn get_function_fn_ = nullptr;
+        bool support_loaded_ = false;
+        bool plugin_loader_resolved_ = false;
+        PluginLoader plugin_loader_;
+        bool plugin_objects_resolved_ = false;
+        PluginObjects plugin_objects_;
+        std::list<std::vector<const void *>> service_tables_;
+        hostfxr_close_fn close_fn_ = nullptr;
+        std::unique_ptr<HostFxrLibrary> hostfxr_lib_;
+        static constexpr const char *config_path = "init.runtimeconfig.json";
+        static constexpr const char *support_assembly_path = "PluginSupport.dll";
+        static constexpr const char *support_assembly_name = "PluginSupport";
+#ifdef NATIVE_HOST_MOCK_HOSTFXR
+        static constexpr const char *loaded_hostfxr_name = NATIVE_HOST_MOCK_HOSTFXR;
+#else
+        static constexpr const char *loaded_hostfxr_name = hostfxr_library_name;
+#endif
+
+        // hostfxr 的状态码
+        static constexpr int32_t success_host_already_initialized = 0x00000001;
+        static constexpr int32_t success_different_runtime_properties = 0x00000002;
+        static constexpr int32_t host_api_buffer_too_small = static_cast<int32_t>(0x80008098);
+        static constexpr int32_t host_invalid_state = static_cast<int32_t>(0x800080a3);
+        static constexpr int32_t host_incompatible_config = static_cast<int32_t>(0x800080a5);
+
+        static uint64_t elapsed_ns(std::chrono::steady_clock::time_point start)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now() - start)
+                                             .count());
+        }
+
+        /**
+         * @brief 已加载的 hostfxr 是否就是显式选项指定的那个
+         *
+         * 设置 hostfxr_path 时要求是同一个文件，只设置 dotnet_root 时要求位于该目录下
+         * （私有安装在 host/fxr/<版本>/ 下，自包含布局直接在根目录下）。两者都未设置时总是一致。
+         */
+        bool matches_explicit_hostfxr(const std::filesystem::path &loaded) const
+        {
+            std::error_code ec;
+            if (!options_.hostfxr_path.empty())
+            {
+                return std::filesystem::equivalent(resolve_module_relative(options_.hostfxr_path), loaded, ec) && !ec;
+            }
+            if (options_.dotnet_root.empty())
+            {
+                return true;
+            }
+
+            auto root = std::filesystem::weakly_canonical(resolve_module_relative(options_.dotnet_root), ec);
+            if (ec)
+            {
+                return false;
+            }
+            auto file = std::filesystem::weakly_canonical(loaded, ec);
+            if (ec)
+            {
+                return false;
+            }
+            if (!root.has_filename())
+            {
+                root = root.parent_path();
+            }
+            return std::mismatch(root.begin(), root.end(), file.begin(), file.end()).first == root.end();
+        }
+
+        /**
+         * @brief 确定 hostfxr 的路径
+         *
+         * 优先级：进程中已加载的 hostfxr（附加模式不为 NEVER 时）> 显式 hostfxr 路径 >
+         * dotnet_root 下的自包含布局 > 以 dotnet_root 调用 nethost > nethost 默认探测（环境变量和全局安装位置）。
+         * 以 NATIVE_HOST_MOCK_HOSTFXR 构建时不链接 nethost，最后两步改为使用本库所在目录下的模拟 hostfxr。
+         * 显式指定的 hostfxr 不存在时失败，不回退到探测。
+         * AUTO 模式下已加载的 hostfxr 与显式指定的 hostfxr_path 或 dotnet_root 不一致时失败，
+         * 不会悄悄改用已加载的那个；REQUIRED 模式忽略显式路径。
+         *
+         * @param[out] source 采用的来源，记录在时间线中
+         */
+        bool resolve_hostfxr_path(std::filesystem::path &hostfxr_path, const char *&source)
+        {
+            // 已有运行时只能通过启动它的 hostfxr 访问，另外加载的 hostfxr 会尝试再启动一个运行时
+            if (options_.attach_mode != NATIVE_RUNTIME_ATTACH_NEVER &&
+                find_loaded_module(loaded_hostfxr_name, hostfxr_path))
+            {
+                if (options_.attach_mode == NATIVE_RUNTIME_ATTACH_AUTO && !matches_explicit_hostfxr(hostfxr_path))
+                {
+                    log_error("hostfxr already loaded in the process (" + hostfxr_path.u8string() +
+                              ") conflicts with the explicit " +
+                              (options_.hostfxr_path.empty() ? "dotnet_root " + options_.dotnet_root
+                                                             : "hostfxr_path " + options_.hostfxr_path) +
+                              "; use NATIVE_RUNTIME_ATTACH_REQUIRED to attach to it or NATIVE_RUNTIME_ATTACH_NEVER to load the explicit one");
+                    return false;
+                }
+                log_info("Using hostfxr already loaded in the process: " + hostfxr_path.u8string());
+                source = "loaded";
+                return true;
+            }
+            if (options_.attach_mode == NATIVE_RUNTIME_ATTACH_REQUIRED)
+            {
+                log_error("No hostfxr loaded in the process to attach to");
+                return false;
+            }
+
+            if (!options_.hostfxr_path.empty())
+            {
+                hostfxr_path = resolve_module_relative(options_.hostfxr_path);
+                if (!std::filesystem::exists(hostfxr_path))
+                {
+                    log_error("hostfxr not found: " + hostfxr_path.u8string());
+                    return false;
+                }
+                source = "hostfxr_path";
+                return true;
+            }
+
+            std::basic_string<char_t> dotnet_root;
+            if (!options_.dotnet_root.empty())
+            {
+                auto root = resolve_module_relative(options_.dotnet_root);
+                auto local_hostfxr = root / hostfxr_library_name;
+                if (std::filesystem::exists(local_hostfxr))
+                {
+                    hostfxr_path = local_hostfxr;
+                    source = "dotnet_root";
+                    return true;
+                }
+                dotnet_root = root.native();
+            }
+
+#ifdef NATIVE_HOST_MOCK_HOSTFXR
+            hostfxr_path = resolve_module_relative(NATIVE_HOST_MOCK_HOSTFXR);
+            source = "mock";
+            return true;
+#else
+            char_t buffer[MAX_PATH_LENGTH];
+            size_t buffer_size = sizeof(buffer) / sizeof(char_t);
+            get_hostfxr_parameters params{sizeof(get_hostfxr_parameters), nullptr, nullptr};
+            if (!dotnet_root.empty())
+            {
+                params.dotnet_root = dotnet_root.c_str();
+            }
+
+            int rc = get_hostfxr_path(buffer, &buffer_size, dotnet_root.empty() ? nullptr : &params);
+            if (rc != 0)
+            {
+                log_error("Failed to get hostfxr path", rc);
+                return false;
+            }
+            hostfxr_path = buffer;
+            source = "nethost";
+            return true;
+#endif
         }
 
-        ~Assembly()
+        bool load_hostfxr()
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto phase_start = start;
+
+            std::filesystem::path hostfxr_path;
+            const char *source = nullptr;
+            if (!resolve_hostfxr_path(hostfxr_path, source))
+            {
+                return false;
+            }
+            timings_.resolve_hostfxr_ns = elapsed_ns(phase_start);
+            Timeline::record("resolve_hostfxr", phase_start, "source", source, "path", hostfxr_path.u8string().c_str());
+
+            phase_start = std::chrono::steady_clock::now();
+            hostfxr_lib_ = std::make_unique<HostFxrLibrary>(hostfxr_path.c_str());
+            if (!hostfxr_lib_ || !*hostfxr_lib_)
+            {
+                log_error("Failed to load hostfxr library");
+                return false;
+            }
+
+            auto init_fn = (hostfxr_initialize_for_runtime_config_fn)
+                get_function(hostfxr_lib_->get(), "hostfxr_initialize_for_runtime_config");
+            auto get_delegate_fn = (hostfxr_get_runtime_delegate_fn)
+                get_function(hostfxr_lib_->get(), "hostfxr_get_runtime_delegate");
+            close_fn_ = (hostfxr_close_fn)
+                get_function(hostfxr_lib_->get(), "hostfxr_close");
+
+            if (!init_fn || !get_delegate_fn || !close_fn_)
+            {
+                log_error("Failed to get required functions");
+                return false;
+            }
+            timings_.load_hostfxr_ns = elapsed_ns(phase_start);
+            Timeline::record("load_hostfxr", phase_start);
+
+            // 显式指定 dotnet_root 时，框架解析也限定在该目录下，不再回退到全局安装位置
+            std::basic_string<char_t> dotnet_root;
+            hostfxr_initialize_parameters init_params{sizeof(hostfxr_initialize_parameters), nullptr, nullptr};
+            if (!options_.dotnet_root.empty())
+            {
+                dotnet_root = resolve_module_relative(options_.dotnet_root).native();
+                init_params.dotnet_root = dotnet_root.c_str();
+            }
+
+            phase_start = std::chrono::steady_clock::now();
+            if (options_.attach_mode == NATIVE_RUNTIME_ATTACH_REQUIRED && !runtime_active())
+            {
+                log_error("No runtime is running in the process to attach to");
+                return false;
+            }
+
+            hostfxr_handle ctx = nullptr;
+            int rc = init_fn(
+                runtime_config_path().c_str(),
+                dotnet_root.empty() ? nullptr : &init_params,
+                &ctx);
+
+            // 进程中已有运行时时返回正的成功码，ctx 是次级宿主上下文，同样可以获取委托
+            if (rc == host_incompatible_config)
+            {
+                log_error("Runtime config is incompatible with the runtime already running in the process", rc);
+                return false;
+            }
+            if (rc < 0 || !ctx)
+            {
+                log_error("Failed to initialize runtime", rc);
+                return false;
+            }
+            attached_ = rc == success_host_already_initialized || rc == success_different_runtime_properties;
+            if (rc == success_different_runtime_properties)
+            {
+                collect_property_mismatches(ctx);
+            }
+
+            rc = get_delegate_fn(
+                ctx,
+                hdt_load_assembly_and_get_function_pointer,
+                (void **)&load_assembly_fn_);
+
+            if (rc != 0 || !load_assembly_fn_)
+            {
+                close_fn_(ctx);
+                log_error("Failed to get load assembly function", rc);
+                return false;
+            }
+
+            // 以下委托只用于加载宿主支持程序集，获取失败时相关的可选功能不可用
+            if (get_delegate_fn(ctx, hdt_load_assembly, (void **)&load_default_fn_) != 0 ||
+                get_delegate_fn(ctx, hdt_get_function_pointer, (void **)&get_function_fn_) != 0)
+            {
+                load_default_fn_ = nullptr;
+                get_function_fn_ = nullptr;
+                log_info("Support assembly delegates are not available");
+            }
+
+            close_fn_(ctx);
+            timings_.initialize_runtime_ns = elapsed_ns(phase_start);
+            Timeline::record("initialize_runtime", phase_start);
+            timings_.total_ns = elapsed_ns(start);
+            log_info(attached_ ? "Attached to the runtime already running in the process"
+                               : "Runtime initialized successfully");
+            return true;
+        }
+
+        hostfxr_get_runtime_properties_fn get_properties_fn()
+        {
+            return (hostfxr_get_runtime_properties_fn)
+                get_function(hostfxr_lib_->get(), "hostfxr_get_runtime_properties");
+        }
+
+        /**
+         * @brief 读取宿主上下文的全部运行时属性，ctx 为 nullptr 时读取已运行的运行时
+         */
+        bool read_properties(hostfxr_handle ctx, std::unordered_map<std::basic_string<char_t>, std::basic_string<char_t>> &properties)
+        {
+            auto get_properties = get_properties_fn();
+            if (!get_properties)
+            {
+                return false;
+            }
+
+            std::vector<const char_t *> keys;
+            std::vector<const char_t *> values;
+            size_t count = 0;
+            int rc = get_properties(ctx, &count, nullptr, nullptr);
+            if (rc == host_api_buffer_too_small)
+            {
+                keys.resize(count);
+                values.resize(count);
+                rc = get_properties(ctx, &count, keys.data(), values.data());
+            }
+            if (rc != 0)
+            {
+                log_error("Failed to get runtime properties", rc);
+                return false;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                properties.emplace(keys[i], values[i]);
+            }
+            return true;
+        }
+
+        /**
+         * @brief 进程中是否已有由 hostfxr 启动的运行时
+         */
+        bool runtime_active()
+        {
+            auto get_properties = get_properties_fn();
+            if (!get_properties)
+            {
+                return false;
+            }
+            size_t count = 0;
+            return get_properties(nullptr, &count, nullptr, nullptr) != host_invalid_state;
+        }
+
+        /**
+         * @brief 比较次级宿主上下文请求的属性和已运行的运行时的属性
+         *
+         * 运行时属性只在启动时生效，这里只记录差异供调用方检查。
+         */
+        void collect_property_mismatches(hostfxr_handle ctx)
+        {
+            std::unordered_map<std::basic_string<char_t>, std::basic_string<char_t>> requested;
+            std::unordered_map<std::basic_string<char_t>, std::basic_string<char_t>> active;
+            if (!read_properties(ctx, requested) || !read_properties(nullptr, active))
+            {
+                return;
+            }
+
+            auto to_utf8 = [](const std::basic_string<char_t> &value)
+            { return std::filesystem::path(value).u8string(); };
+            for (const auto &[name, value] : requested)
+            {
+                auto it = active.find(name);
+                if (it != active.end() && it->second == value)
+                {
+                    continue;
+                }
+
+                PropertyMismatch mismatch;
+                mismatch.name = to_utf8(name);
+                mismatch.requested = to_utf8(value);
+                mismatch.has_active = it != active.end();
+                if (mismatch.has_active)
+                {
+                    mismatch.active = to_utf8(it->second);
+                }
+                log_error("Runtime property " + mismatch.name + " differs from the running runtime: requested '" +
+                          mismatch.requested + "', active " +
+                          (mismatch.has_active ? "'" + mismatch.active + "'" : std::string("unset")));
+                property_mismatches_.push_back(std::move(mismatch));
+            }
+
+            std::sort(property_mismatches_.begin(), property_mismatches_.end(),
+                      [](const PropertyMismatch &a, const PropertyMismatch &b)
+                      { return a.name < b.name; });
+            for (const auto &mismatch : property_mismatches_)
+            {
+                property_mismatch_views_.push_back({mismatch.name.c_str(), mismatch.requested.c_str(),
+                                                    mismatch.has_active ? mismatch.active.c_str() : nullptr});
+            }
+        }
+
+    public:
+        static Runtime &instance()
+        {
+            static Runtime runtime;
+            return runtime;
+        }
+
+        /**
+         * @brief 初始化运行时
+         *
+         * 运行时每个进程只能初始化一次，之后传入的选项被忽略。
+         */
+        bool initialize(const native_host_runtime_options_t *options = nullptr)
+        {
+            if (initialized_)
+            {
+                if (options)
+                {
+                    log_info("Runtime already initialized, ignoring runtime options");
+                }
+                return true;
+            }
+
+            options_ = Options{};
+            attached_ = false;
+            property_mismatches_.clear();
+            property_mismatch_views_.clear();
+            if (options)
+            {
+                options_.dotnet_root = options->dotnet_root ? options->dotnet_root : "";
+                options_.hostfxr_path = options->hostfxr_path ? options->hostfxr_path : "";
+                options_.runtime_config_path = options->runtime_config_path ? options->runtime_config_path : "";
+                options_.dependency_cache_dir = options->dependency_cache_dir ? options->dependency_cache_dir : "";
+                options_.attach_mode = options->attach_mode;
+            }
+
+            if (!load_hostfxr())
+                return false;
+            initialized_ = true;
+            return true;
+        }
+
+        /**
+         * @brief 运行时配置文件路径，未指定时为本库所在目录下的 init.runtimeconfig.json
+         */
+        std::filesystem::path runtime_config_path() const
+        {
+            return resolve_module_relative(options_.runtime_config_path.empty() ? config_path
+                                                                                 : options_.runtime_config_path);
+        }
+
+        /**
+         * @brief 获取宿主支持程序集中的 UnmanagedCallersOnly 方法
+         *
+         * 支持程序集与 init.runtimeconfig.json 位于同一目录，并被加载到默认加载上下文，
+         * 插件以不复制到输出目录的方式引用它时，会与宿主共享同一份静态状态。
+         * 调用方需持有主机锁。
+         *
+         * @return 函数指针，支持程序集不可用时返回 nullptr
+         */
+        void *get_support_function(const char *type_name, const char *method_name)
+        {
+            if (!initialized_ || !load_default_fn_ || !get_function_fn_)
+            {
+                return nullptr;
+            }
+
+            if (!support_loaded_)
+            {
+                auto config_dir = std::filesystem::absolute(runtime_config_path()).parent_path();
+                auto path = (config_dir / support_assembly_path).string();
+                if (!std::filesystem::exists(path))
+                {
+                    log_info("Support assembly not found: " + path);
+                    return nullptr;
+                }
+
+                int rc = load_default_fn_(to_native_path(path.c_str()).c_str(), nullptr, nullptr);
+                if (rc != 0)
+                {
+                    log_error("Failed to load support assembly", rc);
+                    return nullptr;
+                }
+                support_loaded_ = true;
+            }
+
+            std::string qualified_name = std::string(type_name) + ", " + support_assembly_name;
+            void *fn = nullptr;
+            int rc = get_function_fn_(
+                to_native_path(qualified_name.c_str()).c_str(),
+                to_native_path(method_name).c_str(),
+                UNMANAGEDCALLERSONLY_METHOD,
+                nullptr,
+                nullptr,
+                &fn);
+            if (rc != 0 || !fn)
+            {
+                log_error("Failed to get support function " + qualified_name + "." + method_name, rc);
+                return nullptr;
+            }
+            return fn;
+        }
+
+        /**
+         * @brief 获取支持程序集中的插件加载入口
+         *
+         * 插件通过按 .deps.json 解析依赖并缓存解析结果的加载上下文加载。
+         * 支持程序集不可用时返回空入口，调用方退回运行时的组件加载。
+         * 调用方需持有主机锁。
+         */
+        const PluginLoader &plugin_loader()
+        {
+            if (plugin_loader_resolved_ || !initialized_)
+            {
+                return plugin_loader_;
+            }
+            plugin_loader_resolved_ = true;
+
+            using configure_fn = void(CORECLR_DELEGATE_CALLTYPE *)(const char *cache_dir);
+            auto configure = (configure_fn)get_support_function("PluginSupport.PluginLoader", "Configure");
+            auto load = (PluginLoader::load_fn)get_support_function("PluginSupport.PluginLoader", "LoadPlugin");
+            auto get_function = (PluginLoader::get_function_fn)get_support_function("PluginSupport.PluginLoader", "GetFunctionPointer");
+            if (!configure || !load || !get_function)
+            {
+                log_info("Plugin loader unavailable, falling back to component loading");
+                return plugin_loader_;
+            }
+
+            std::string cache_dir;
+            if (!options_.dependency_cache_dir.empty())
+            {
+                cache_dir = resolve_module_relative(options_.dependency_cache_dir).u8string();
+            }
+            configure(cache_dir.empty() ? nullptr : cache_dir.c_str());
+
+            plugin_loader_.load = load;
+            plugin_loader_.get_function = get_function;
+            plugin_loader_.load_from_memory = (PluginLoader::load_from_memory_fn)
+                get_support_function("PluginSupport.PluginLoader", "LoadPluginFromMemory");
+            return plugin_loader_;
+        }
+
+        /**
+         * @brief 获取支持程序集中创建和释放插件对象的入口
+         *
+         * 支持程序集不可用时返回空入口。调用方需持有主机锁。
+         */
+        const PluginObjects &plugin_objects()
+        {
+            if (plugin_objects_resolved_ || !initialized_)
+            {
+                return plugin_objects_;
+            }
+            plugin_objects_resolved_ = true;
+
+            auto create = (PluginObjects::create_fn)get_support_function("PluginSupport.PluginObjects", "CreateObject");
+            auto release = (PluginObjects::release_fn)get_support_function("PluginSupport.PluginObjects", "ReleaseObjects");
+            if (!create || !release)
+            {
+                log_info("Plugin objects unavailable without the support assembly");
+                return plugin_objects_;
+            }
+
+            plugin_objects_.create = create;
+            plugin_objects_.release = release;
+            return plugin_objects_;
+        }
+
+        /**
+         * @brief 向支持程序集注册宿主服务表
+         *
+         * 托管代码可能仍持有旧表的指针，旧表在进程生命周期内保留。
+         * 调用方需持有主机锁。
+         */
+        bool register_services(const void *const *services, uint32_t count)
+        {
+            using register_fn = void(CORECLR_DELEGATE_CALLTYPE *)(const void *const *, int32_t);
+            auto fn = (register_fn)get_support_function("PluginSupport.HostServices", "Register");
+            if (!fn)
+            {
+                log_error("Host services require the support assembly");
+                return false;
+            }
+
+            service_tables_.emplace_back(services, services + count);
+            fn(service_tables_.back().data(), static_cast<int32_t>(count));
+            log_info("Registered " + std::to_string(count) + " host services");
+            return true;
+        }
+
+        load_assembly_and_get_function_pointer_fn get_load_fn() const { return load_assembly_fn_; }
+        const Options &options() const { return options_; }
+        const native_runtime_init_timings_t &timings() const { return timings_; }
+
+        native_runtime_attach_info_t attach_info() const
+        {
+            native_runtime_attach_info_t info{};
+            info.attached = attached_ ? 1 : 0;
+            info.mismatch_count = static_cast<uint32_t>(property_mismatch_views_.size());
+            info.mismatches = property_mismatch_views_.empty() ? nullptr : property_mismatch_views_.data();
+            return info;
+        }
+        bool is_initialized() const { return initialized_; }
+    };
+
+    /**
+     * @brief 按签名调用
+     *
+     * 签名在解析方法时校验一次，调用时按参数类型逐个展开为具体的函数指针类型，
+     * 不依赖整数和浮点参数在调用约定上的偶然兼容。
+     */
+    namespace Signatures
+    {
+        constexpr size_t MAX_ARGS = 4;
+
+        struct Signature
+        {
+            char ret = 'v';
+            bool async = false; ///< 异步方法：参数之后追加完成回调和状态，返回类型是任务结果的类型
+            uint32_t argc = 0;
+            char args[MAX_ARGS] = {};
+        };
+
+        bool parse(const char *text, Signature &signature)
+        {
+            if (!text || !*text)
+            {
+                return false;
+            }
+
+            if (text[0] == 'T')
+            {
+                signature.async = true;
+                ++text;
+            }
+
+            size_t length = std::strlen(text);
+            if (length == 0 || length - 1 > MAX_ARGS || !std::strchr("vild", text[0]))
+            {
+                return false;
+            }
+
+            signature.ret = text[0];
+            signature.argc = static_cast<uint32_t>(length - 1);
+            for (size_t i = 1; i < length; ++i)
+            {
+                if (!std::strchr("ild", text[i]))
+                {
+                    return false;
+                }
+                signature.args[i - 1] = text[i];
+            }
+            return true;
+        }
+
+        template <typename Ret, typename... Args>
+        Ret call(void *fn, Args... args)
+        {
+            return reinterpret_cast<Ret(CORECLR_DELEGATE_CALLTYPE *)(Args...)>(fn)(args...);
+        }
+
+        /**
+         * @brief 按签名把参数数组展开为实参，再交给 finish 发起调用
+         */
+        template <size_t Depth, typename Finish, typename... Args>
+        void unpack(const Signature &signature, const native_value_t *args, Finish &&finish, Args... values)
+        {
+            if constexpr (Depth < MAX_ARGS)
+            {
+                if (Depth < signature.argc)
+                {
+                    switch (signature.args[Depth])
+                    {
+                    case 'i':
+                        return unpack<Depth + 1>(signature, args, finish, values..., args[Depth].i32);
+                    case 'l':
+                        return unpack<Depth + 1>(signature, args, finish, values..., args[Depth].i64);
+                    default:
+                        return unpack<Depth + 1>(signature, args, finish, values..., args[Depth].f64);
+                    }
+                }
+            }
+            finish(values...);
+        }
+
+        void dispatch(void *fn, const Signature &signature, const native_value_t *args, native_value_t *result)
+        {
+            unpack<0>(signature, args, [&](auto... values)
+                      {
+                          switch (signature.ret)
+                          {
+                          case 'v':
+                              call<void>(fn, values...);
+                              break;
+                          case 'i':
+                              result->i32 = call<int32_t>(fn, values...);
+                              break;
+                          case 'l':
+                              result->i64 = call<int64_t>(fn, values...);
+                              break;
+                          default:
+                              result->f64 = call<double>(fn, values...);
+                              break;
+                          }
+                      });
+        }
+
+        void dispatch_async(
+            void *fn,
+            const Signature &signature,
+            const native_value_t *args,
+            native_async_callback_t callback,
+            void *state)
+        {
+            unpack<0>(signature, args, [&](auto... values)
+                      { call<void>(fn, values..., reinterpret_cast<void *>(callback), state); });
+        }
+    }
+
+#ifdef __linux__
+    /**
+     * @brief 隔离模式的辅助进程
+     *
+     * 每个辅助进程实例（代）拥有独立的共享内存区域。辅助进程退出后启动新的一代，
+     * 并按原编号重放已加载的程序集和已解析的方法，调用方持有的句柄保持有效。
+     * 旧的一代在对象销毁前不释放，仍在等待的调用线程可以安全地访问其共享内存。
+     */
+    class IsolatedProcess
+    {
+        struct Generation
+        {
+            IsolationChannel::Region *region = nullptr;
+            pid_t pid = -1;
+            std::atomic<bool> exited{false};
+
+            ~Generation()
+            {
+                if (region)
+                {
+                    munmap(region, sizeof(IsolationChannel::Region));
+                }
+            }
+        };
+
+        struct AssemblyRecord
+        {
+            std::string path;
+            bool loaded;
+        };
+
+        struct MethodRecord
+        {
+            uint32_t assembly_id;
+            std::string payload;
+        };
+
+        std::mutex mutex_; ///< 保护重启和重放记录
+        std::vector<std::unique_ptr<Generation>> generations_;
+        std::atomic<Generation *> current_{nullptr};
+        std::vector<AssemblyRecord> assemblies_;
+        std::vector<MethodRecord> methods_;
+        uint32_t restarts_ = 0;
+
+        static constexpr const char *worker_name = "native_host_worker";
+        static constexpr auto wait_timeout = std::chrono::milliseconds(100);
+
+        /** 辅助进程中共享内存区和宿主退出管道的描述符 */
+        static constexpr int worker_region_fd = 3;
+        static constexpr int worker_parent_fd = 4;
+
+        /**
+         * @brief 把描述符移到辅助进程使用的编号之上
+         *
+         * spawn 的文件操作依次 dup2 到固定编号，源描述符不能占用这些编号，否则会被前一步覆盖。
+         * @return 新的描述符（保持 CLOEXEC），失败时关闭原描述符并返回 -1
+         */
+        static int above_worker_fds(int fd)
+        {
+            if (fd > worker_parent_fd)
+            {
+                return fd;
+            }
+            int moved = fcntl(fd, F_DUPFD_CLOEXEC, worker_parent_fd + 1);
+            if (moved < 0)
+            {
+                log_error("fcntl(F_DUPFD_CLOEXEC) failed", errno);
+            }
+            close(fd);
+            return moved;
+        }
+
+        /**
+         * @brief 获取辅助进程用于感知宿主退出的管道读端
+         *
+         * 写端由宿主进程持有直到进程结束，宿主退出后辅助进程读到 EOF 即退出。
+         * 与 PR_SET_PDEATHSIG 不同，它不受启动辅助进程的线程先行退出的影响。
+         * 两端都带 CLOEXEC，嵌入应用启动的其他子进程不会继承，读端只通过 spawn 的文件操作交给辅助进程。
+         * @return 管道读端，失败时返回 -1
+         */
+        static int parent_watch_fd()
+        {
+            static const int fd = []
+            {
+                int fds[2];
+                if (pipe2(fds, O_CLOEXEC) != 0)
+                {
+                    log_error("pipe2 failed", errno);
+                    return -1;
+                }
+                return above_worker_fds(fds[0]);
+            }();
+            return fd;
+        }
+
+        std::unique_ptr<Generation> spawn()
+        {
+            using IsolationChannel::Region;
+
+            int parent_fd = parent_watch_fd();
+            if (parent_fd < 0)
+            {
+                return nullptr;
+            }
+
+            // 带 CLOEXEC，其他线程同时 fork/exec 的子进程不会继承共享区
+            int fd = memfd_create("native_host_isolation", MFD_CLOEXEC);
+            if (fd >= 0)
+            {
+                fd = above_worker_fds(fd);
+            }
+            if (fd < 0)
+            {
+                log_error("memfd_create failed", errno);
+                return nullptr;
+            }
+            if (ftruncate(fd, sizeof(Region)) != 0)
+            {
+                log_error("ftruncate failed", errno);
+                close(fd);
+                return nullptr;
+            }
+
+            void *memory = mmap(nullptr, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (memory == MAP_FAILED)
+            {
+                log_error("mmap failed", errno);
+                close(fd);
+                return nullptr;
+            }
+
+            auto generation = std::make_unique<Generation>();
+            generation->region = new (memory) Region;
+            generation->region->init();
+
+            // 辅助进程使用与宿主相同的运行时解析选项
+            const auto &options = Runtime::instance().options();
+            auto worker = (module_directory() / worker_name).string();
+            std::vector<std::string> arguments = {
+                worker,
+                "--fd", std::to_string(worker_region_fd),
+                "--parent-fd", std::to_string(worker_parent_fd),
+                "--runtime-config", std::filesystem::absolute(Runtime::instance().runtime_config_path()).string()};
+            if (!options.dotnet_root.empty())
+            {
+                arguments.insert(arguments.end(), {"--dotnet-root", resolve_module_relative(options.dotnet_root).string()});
+            }
+            if (!options.hostfxr_path.empty())
+            {
+                arguments.insert(arguments.end(), {"--hostfxr", resolve_module_relative(options.hostfxr_path).string()});
+            }
+
+            std::vector<char *> argv;
+            for (auto &argument : arguments)
+            {
+                argv.push_back(argument.data());
+            }
+            argv.push_back(nullptr);
+
+            // 只有辅助进程在固定编号上得到这两个描述符，dup2 出的副本不带 CLOEXEC
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_adddup2(&actions, fd, worker_region_fd);
+            posix_spawn_file_actions_adddup2(&actions, parent_fd, worker_parent_fd);
+            int rc = posix_spawn(&generation->pid, worker.c_str(), &actions, nullptr, argv.data(), environ);
+            posix_spawn_file_actions_destroy(&actions);
+            close(fd);
+            if (rc != 0)
+            {
+                log_error("Failed to start isolation worker " + worker, rc);
+                return nullptr;
+            }
+
+            log_info("Started isolation worker " + std::to_string(generation->pid));
+            return generation;
+        }
+
+        static bool has_exited(Generation *generation)
+        {
+            if (generation->exited.load(std::memory_order_acquire))
+            {
+                return true;
+            }
+
+            int status = 0;
+            pid_t rc = waitpid(generation->pid, &status, WNOHANG);
+            if (rc == generation->pid || (rc < 0 && errno == ECHILD))
+            {
+                generation->exited.store(true, std::memory_order_release);
+                return true;
+            }
+            return false;
+        }
+
+        static uint32_t claim_slot(Generation *generation)
+        {
+            using namespace IsolationChannel;
+
+            thread_local uint32_t hint = 0;
+            for (;;)
+            {
+                for (uint32_t i = 0; i < SLOT_COUNT; ++i)
+                {
+                    uint32_t index = (hint + i) & (SLOT_COUNT - 1);
+                    uint32_t expected = SLOT_FREE;
+                    if (generation->region->slots[index].state.compare_exchange_strong(
+                            expected, SLOT_CLAIMED, std::memory_order_acquire))
+                    {
+                        hint = index;
+                        return index;
+                    }
+                }
+                if (has_exited(generation))
+                {
+                    return SLOT_COUNT;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        static bool wait_done(Generation *generation, IsolationChannel::Slot &slot)
+        {
+            using namespace IsolationChannel;
+
+            // 短调用在自旋阶段完成，不进入内核
+            auto deadline = std::chrono::steady_clock::now() + spin_time();
+            uint32_t spins = 0;
+            while (slot.state.load(std::memory_order_acquire) != SLOT_DONE)
+            {
+                if ((++spins & 63) == 0 && std::chrono::steady_clock::now() >= deadline)
+                {
+                    break;
+                }
+                cpu_relax();
+            }
+
+            while (slot.state.load(std::memory_order_acquire) != SLOT_DONE)
+            {
+                slot.waiting.store(1, std::memory_order_seq_cst);
+                if (slot.state.load(std::memory_order_seq_cst) != SLOT_DONE)
+                {
+                    futex_wait(&slot.state, SLOT_PENDING, wait_timeout);
+                }
+                slot.waiting.store(0, std::memory_order_relaxed);
+
+                if (slot.state.load(std::memory_order_acquire) != SLOT_DONE && has_exited(generation))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static NativeHostStatus call(
+            Generation *generation,
+            IsolationChannel::Op op,
+            uint32_t target,
+            uint32_t aux,
+            const native_value_t *args,
+            uint32_t argc,
+            const std::string &payload,
+            native_value_t *result)
+        {
+            using namespace IsolationChannel;
+
+            // 只检查已记录的退出状态，尚未发现的崩溃由 claim_slot 和 wait_done 的慢路径检测
+            if (!generation || generation->exited.load(std::memory_order_acquire))
+            {
+                return NativeHostStatus::ERROR_PLUGIN_CRASHED;
+            }
+            if (payload.size() >= PAYLOAD_SIZE)
+            {
+                log_error("Isolated request payload too large");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto *region = generation->region;
+            uint32_t index = claim_slot(generation);
+            if (index == SLOT_COUNT)
+            {
+                return NativeHostStatus::ERROR_PLUGIN_CRASHED;
+            }
+
+            Slot &slot = region->slots[index];
+            slot.op = op;
+            slot.target = target;
+            slot.aux = aux;
+            for (uint32_t i = 0; i < argc; ++i)
+            {
+                slot.args[i] = args[i];
+            }
+            std::memcpy(slot.payload, payload.c_str(), payload.size() + 1);
+            slot.state.store(SLOT_PENDING, std::memory_order_release);
+
+            region->queue.push(index);
+            region->doorbell.fetch_add(1, std::memory_order_seq_cst);
+            if (region->worker_sleeping.load(std::memory_order_seq_cst))
+            {
+                futex_wake(&region->doorbell);
+            }
+
+            if (!wait_done(generation, slot))
+            {
+                // 槽随崩溃的一代一起废弃
+                log_error("Isolation worker exited during call");
+                return NativeHostStatus::ERROR_PLUGIN_CRASHED;
+            }
+
+            auto status = static_cast<NativeHostStatus>(slot.status);
+            if (result)
+            {
+                *result = slot.result;
+            }
+            slot.state.store(SLOT_FREE, std::memory_order_release);
+            return status;
+        }
+
+        /**
+         * @brief 在持有 mutex_ 时向当前一代发送请求，辅助进程退出时重启
+         */
+        NativeHostStatus request(IsolationChannel::Op op, uint32_t target, uint32_t aux, const std::string &payload)
+        {
+            auto *generation = current_.load(std::memory_order_acquire);
+            auto status = call(generation, op, target, aux, nullptr, 0, payload, nullptr);
+            if (status == NativeHostStatus::ERROR_PLUGIN_CRASHED)
+            {
+                restart(generation);
+            }
+            return status;
+        }
+
+        /**
+         * @brief 重启辅助进程并重放状态，调用方需持有 mutex_
+         */
+        void restart(Generation *crashed)
+        {
+            using IsolationChannel::Op;
+
+            if (current_.load(std::memory_order_acquire) != crashed)
+            {
+                return;
+            }
+
+            ++restarts_;
+            log_error("Isolation worker exited, restart #" + std::to_string(restarts_));
+            auto generation = spawn();
+            if (!generation)
+            {
+                return;
+            }
+
+            auto *next = generation.get();
+            generations_.push_back(std::move(generation));
+            for (uint32_t id = 0; id < assemblies_.size(); ++id)
+            {
+                if (assemblies_[id].loaded &&
+                    call(next, Op::LoadAssembly, id, 0, nullptr, 0, assemblies_[id].path, nullptr) != NativeHostStatus::SUCCESS)
+                {
+                    log_error("Failed to reload isolated assembly: " + assemblies_[id].path);
+                }
+            }
+            for (uint32_t id = 0; id < methods_.size(); ++id)
+            {
+                const auto &method = methods_[id];
+                if (assemblies_[method.assembly_id].loaded &&
+                    call(next, Op::GetMethod, method.assembly_id, id, nullptr, 0, method.payload, nullptr) != NativeHostStatus::SUCCESS)
+                {
+                    log_error("Failed to resolve isolated method " + method.payload.substr(0, method.payload.find('\0')));
+                }
+            }
+            current_.store(next, std::memory_order_release);
+        }
+
+    public:
+        static bool supported() { return true; }
+
+        ~IsolatedProcess()
+        {
+            // 辅助进程不持有宿主需要的状态，直接结束
+            for (auto &generation : generations_)
+            {
+                if (!has_exited(generation.get()))
+                {
+                    kill(generation->pid, SIGKILL);
+                    waitpid(generation->pid, nullptr, 0);
+                }
+            }
+        }
+
+        bool start()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto generation = spawn();
+            if (!generation)
+            {
+                return false;
+            }
+            current_.store(generation.get(), std::memory_order_release);
+            generations_.push_back(std::move(generation));
+            return true;
+        }
+
+        NativeHostStatus load_assembly(const std::string &path, uint32_t *id)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto assembly_id = static_cast<uint32_t>(assemblies_.size());
+            auto status = request(IsolationChannel::Op::LoadAssembly, assembly_id, 0, path);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+            assemblies_.push_back({path, true});
+            *id = assembly_id;
+            return status;
+        }
+
+        NativeHostStatus unload_assembly(uint32_t id)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            assemblies_[id].loaded = false;
+            return request(IsolationChannel::Op::UnloadAssembly, id, 0, std::string());
+        }
+
+        NativeHostStatus get_method(
+            uint32_t assembly_id,
+            const char *type_name,
+            const char *method_name,
+            const char *signature,
+            uint32_t *id)
+        {
+            std::string payload = std::string(type_name) + '\0' + method_name + '\0' + signature;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto method_id = static_cast<uint32_t>(methods_.size());
+            auto status = request(IsolationChannel::Op::GetMethod, assembly_id, method_id, payload);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+            methods_.push_back({assembly_id, std::move(payload)});
+            *id = method_id;
+            return status;
+        }
+
+        /**
+         * @brief 调用隔离的方法，不获取 mutex_，只有辅助进程退出时才进入重启路径
+         */
+        NativeHostStatus invoke(uint32_t method_id, const native_value_t *args, uint32_t argc, native_value_t *result)
+        {
+            static const std::string empty_payload;
+            auto *generation = current_.load(std::memory_order_acquire);
+            auto status = call(generation, IsolationChannel::Op::Invoke, method_id, 0, args, argc, empty_payload, result);
+            if (status == NativeHostStatus::ERROR_PLUGIN_CRASHED)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                restart(generation);
+            }
+            return status;
+        }
+    };
+#else
+    class IsolatedProcess
+    {
+    public:
+        static bool supported() { return false; }
+        bool start() { return false; }
+
+        NativeHostStatus load_assembly(const std::string &, uint32_t *)
+        {
+            return NativeHostStatus::ERROR_NOT_SUPPORTED;
+        }
+
+        NativeHostStatus unload_assembly(uint32_t)
+        {
+            return NativeHostStatus::ERROR_NOT_SUPPORTED;
+        }
+
+        NativeHostStatus get_method(uint32_t, const char *, const char *, const char *, uint32_t *)
+        {
+            return NativeHostStatus::ERROR_NOT_SUPPORTED;
+        }
+
+        NativeHostStatus invoke(uint32_t, const native_value_t *, uint32_t, native_value_t *)
+        {
+            return NativeHostStatus::ERROR_NOT_SUPPORTED;
+        }
+    };
+#endif
+
+    /**
+     * @brief 映射到内存的插件包
+     *
+     * 打开时映射整个文件并建立名称索引，之后按名称返回映射中的镜像，不再访问文件系统。
+     * 索引在打开后不再修改，依赖解析回调可以在任意线程上查找。
+     *
+     * 从插件包加载的托管插件在进程生命周期内保持加载，加载上下文保存插件包指针并可能随时按需解析依赖，
+     * 因此插件包一旦提供过镜像（pinned）就不再销毁，关闭时由 Host::release_bundle 移入进程级列表。
+     */
+    class Bundle
+    {
+        struct Image
+        {
+            const void *data;
+            uint64_t size;
+        };
+
+        std::string path_;
+        const uint8_t *data_ = nullptr;
+        uint64_t size_ = 0;
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, Image> index_;
+        std::atomic<bool> pinned_{false};
+#ifdef _WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#endif
+
+        static std::string key(std::string name)
+        {
+            // 程序集名称不区分大小写
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return name;
+        }
+
+        bool map()
+        {
+#ifdef _WIN32
+            file_ = CreateFileW(to_native_path(path_.c_str()).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size{};
+            if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+            {
+                return false;
+            }
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_)
+            {
+                return false;
+            }
+            data_ = static_cast<const uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            size_ = static_cast<uint64_t>(size.QuadPart);
+            return data_ != nullptr;
+#else
+            int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            struct stat info{};
+            if (fstat(fd, &info) != 0 || info.st_size == 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED)
+            {
+                return false;
+            }
+            data_ = static_cast<const uint8_t *>(data);
+            size_ = static_cast<uint64_t>(info.st_size);
+            return true;
+#endif
+        }
+
+        void unmap()
+        {
+#ifdef _WIN32
+            if (data_)
+                UnmapViewOfFile(data_);
+            if (mapping_)
+                CloseHandle(mapping_);
+            if (file_ != INVALID_HANDLE_VALUE)
+                CloseHandle(file_);
+#else
+            if (data_)
+                munmap(const_cast<uint8_t *>(data_), static_cast<size_t>(size_));
+#endif
+            data_ = nullptr;
+        }
+
+    public:
+        explicit Bundle(const char *path) : path_(path) {}
+
+        ~Bundle()
+        {
+            unmap();
+        }
+
+        Bundle(const Bundle &) = delete;
+        Bundle &operator=(const Bundle &) = delete;
+
+        NativeHostStatus open()
+        {
+            if (!map())
+            {
+                log_error("Failed to map bundle: " + path_);
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            std::string error;
+            if (!PluginBundle::validate(data_, size_, error))
+            {
+                log_error("Invalid bundle " + path_ + ": " + error);
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            PluginBundle::Header header;
+            std::memcpy(&header, data_, sizeof(header));
+            const char *names = reinterpret_cast<const char *>(data_ + header.names_offset);
+            names_.reserve(header.entry_count);
+            for (uint32_t i = 0; i < header.entry_count; ++i)
+            {
+                PluginBundle::Entry entry;
+                std::memcpy(&entry, data_ + sizeof(header) + i * sizeof(entry), sizeof(entry));
+                names_.emplace_back(names + entry.name_offset, entry.name_size);
+                index_.emplace(key(names_.back()), Image{data_ + entry.offset, entry.size});
+            }
+
+            log_info("Opened bundle " + path_ + " with " + std::to_string(names_.size()) + " images");
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 按条目名称查找镜像
+         */
+        bool find(const std::string &name, const void **image, uint64_t *size) const
+        {
+            auto it = index_.find(key(name));
+            if (it == index_.end())
+            {
+                return false;
+            }
+            *image = it->second.data;
+            *size = it->second.size;
+            return true;
+        }
+
+        /**
+         * @brief 托管插件解析依赖时的回调，按程序集简单名称查找同一插件包中的镜像
+         */
+        static int32_t CORECLR_DELEGATE_CALLTYPE resolve(
+            void *context, const char *name, const void **image, int64_t *size)
+        {
+            uint64_t image_size = 0;
+            if (!static_cast<Bundle *>(context)->find(std::string(name) + ".dll", image, &image_size))
+            {
+                return static_cast<int32_t>(NativeHostStatus::ERROR_ASSEMBLY_LOAD);
+            }
+            *size = static_cast<int64_t>(image_size);
+            return 0;
+        }
+
+        /**
+         * @brief 标记插件包已向运行时提供镜像，之后保持映射
+         */
+        void pin() { pinned_.store(true, std::memory_order_relaxed); }
+        bool pinned() const { return pinned_.load(std::memory_order_relaxed); }
+
+        const std::vector<std::string> &names() const { return names_; }
+        const std::string &path() const { return path_; }
+    };
+
+    /**
+     * @brief 插件发现的结果
+     *
+     * 扫描目录时直接读取各文件的元数据（见 plugin_metadata.h），不经过运行时。
+     * 索引文件按文件路径、大小和修改时间记录每个文件的结果，布局（小端）：
+     * 魔数、版本、记录数，之后每条记录依次是路径、大小、修改时间、是否为托管程序集和导出列表，
+     * 字符串以 u32 长度开头。
+     */
+    class Catalog
+    {
+        static constexpr char INDEX_MAGIC[8] = {'N', 'H', 'P', 'L', 'G', 'I', 'D', 'X'};
+        static constexpr uint32_t INDEX_VERSION = 1;
+
+        struct Record
+        {
+            std::string path; ///< 绝对路径，同时是索引的键
+            uint64_t size = 0;
+            int64_t modified = 0;
+            bool managed = false;
+            std::vector<PluginMetadata::Export> exports;
+        };
+
+        /**
+         * @brief 顺序读取索引内容，越界后所有读取都失败
+         */
+        struct IndexReader
+        {
+            const std::string &data;
+            size_t position = 0;
+            bool ok = true;
+
+            template <typename T>
+            T value()
+            {
+                T result{};
+                if (data.size() - position < sizeof(T))
+                {
+                    ok = false;
+                    return result;
+                }
+                std::memcpy(&result, data.data() + position, sizeof(T));
+                position += sizeof(T);
+                return result;
+            }
+
+            std::string string()
+            {
+                auto length = value<uint32_t>();
+                if (!ok || data.size() - position < length)
+                {
+                    ok = false;
+                    return {};
+                }
+                std::string result(data, position, length);
+                position += length;
+                return result;
+            }
+        };
+
+        template <typename T>
+        static void append(std::string &out, T value)
+        {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        static void append(std::string &out, const std::string &value)
+        {
+            append(out, static_cast<uint32_t>(value.size()));
+            out.append(value);
+        }
+
+        std::vector<Record> records_;
+        std::vector<native_plugin_export_t> views_;
+        uint32_t scanned_ = 0;
+        uint32_t cached_ = 0;
+
+        static bool load_index(const std::filesystem::path &path, std::unordered_map<std::string, Record> &index)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+            {
+                return false;
+            }
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            IndexReader reader{data, sizeof(INDEX_MAGIC)};
+            if (data.compare(0, sizeof(INDEX_MAGIC), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+                reader.value<uint32_t>() != INDEX_VERSION)
+            {
+                log_error("Ignoring plugin index with bad header: " + path.u8string());
+                return false;
+            }
+
+            auto count = reader.value<uint32_t>();
+            for (uint32_t i = 0; i < count && reader.ok; ++i)
+            {
+                Record record;
+                record.path = reader.string();
+                record.size = reader.value<uint64_t>();
+                record.modified = reader.value<int64_t>();
+                record.managed = reader.value<uint8_t>() != 0;
+                auto exports = reader.value<uint32_t>();
+                for (uint32_t j = 0; j < exports && reader.ok; ++j)
+                {
+                    PluginMetadata::Export export_;
+                    export_.type_name = reader.string();
+                    export_.method_name = reader.string();
+                    export_.has_entry_point = reader.value<uint8_t>() != 0;
+                    export_.entry_point = reader.string();
+                    export_.signature = reader.string();
+                    record.exports.push_back(std::move(export_));
+                }
+                index[record.path] = std::move(record);
+            }
+
+            if (!reader.ok || reader.position != data.size())
+            {
+                log_error("Ignoring truncated plugin index: " + path.u8string());
+                index.clear();
+                return false;
+            }
+            return true;
+        }
+
+        void save_index(const std::filesystem::path &path) const
+        {
+            std::string data(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+            append(data, INDEX_VERSION);
+            append(data, static_cast<uint32_t>(records_.size()));
+            for (const auto &record : records_)
+            {
+                append(data, record.path);
+                append(data, record.size);
+                append(data, record.modified);
+                append(data, static_cast<uint8_t>(record.managed));
+                append(data, static_cast<uint32_t>(record.exports.size()));
+                for (const auto &export_ : record.exports)
+                {
+                    append(data, export_.type_name);
+                    append(data, export_.method_name);
+                    append(data, static_cast<uint8_t>(export_.has_entry_point));
+                    append(data, export_.entry_point);
+                    append(data, export_.signature);
+                }
+            }
+
+            // 写入临时文件后替换，并发的发现不会读到写了一半的索引。临时文件名带进程号和序号，
+            // 多个进程或线程同时重写同一索引时各写各的文件，最后一次替换生效
+            static std::atomic<uint64_t> sequence{0};
+#ifdef _WIN32
+            auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+            auto pid = static_cast<unsigned long>(getpid());
+#endif
+            auto temporary = path;
+            temporary += "." + std::to_string(pid) + "." +
+                         std::to_string(sequence.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                if (!file.write(data.data(), static_cast<std::streamsize>(data.size())))
+                {
+                    log_error("Failed to write plugin index: " + temporary.u8string());
+                    return;
+                }
+            }
+            std::error_code ec;
+            std::filesystem::rename(temporary, path, ec);
+            if (ec)
+            {
+                log_error("Failed to replace plugin index " + path.u8string() + ": " + ec.message());
+                std::filesystem::remove(temporary, ec);
+            }
+        }
+
+        static bool is_plugin_file(const std::filesystem::directory_entry &entry)
+        {
+            std::error_code ec;
+            if (!entry.is_regular_file(ec))
+            {
+                return false;
+            }
+            auto extension = entry.path().extension().u8string();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return extension == ".dll";
+        }
+
+        /**
+         * @brief 读取文件的元数据，不是托管程序集的文件记录为没有导出
+         */
+        static bool scan(const std::filesystem::path &path, Record &record)
+        {
+            std::ifstream file(path, std::ios::binary);
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (!file.good() && !file.eof())
+            {
+                log_error("Failed to read plugin candidate: " + record.path);
+                return false;
+            }
+
+            PluginMetadata::Assembly assembly;
+            std::string error;
+            record.managed = PluginMetadata::read_exports(
+                reinterpret_cast<const uint8_t *>(data.data()), data.size(), assembly, error);
+            if (record.managed)
+            {
+                record.exports = std::move(assembly.exports);
+            }
+            else
+            {
+                log_info("No managed exports in " + record.path + ": " + error);
+            }
+            return true;
+        }
+
+    public:
+        NativeHostStatus discover(const native_discovery_options_t &options)
+        {
+            std::error_code ec;
+            std::filesystem::path directory(to_native_path(options.directory));
+            if (!std::filesystem::is_directory(directory, ec))
+            {
+                log_error("Plugin directory not found: " + std::string(options.directory));
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            std::vector<std::filesystem::path> files;
+            auto collect = [&](auto iterator)
+            {
+                for (const auto &entry : iterator)
+                {
+                    if (is_plugin_file(entry))
+                    {
+                        files.push_back(std::filesystem::absolute(entry.path(), ec).lexically_normal());
+                    }
+                }
+            };
+            auto directory_options = std::filesystem::directory_options::skip_permission_denied;
+            if (options.recursive)
+            {
+                collect(std::filesystem::recursive_directory_iterator(directory, directory_options, ec));
+            }
+            else
+            {
+                collect(std::filesystem::directory_iterator(directory, directory_options, ec));
+            }
+            std::sort(files.begin(), files.end());
+
+            std::unordered_map<std::string, Record> index;
+            std::filesystem::path index_path;
+            bool index_loaded = false;
+            if (options.index_path)
+            {
+                index_path = to_native_path(options.index_path);
+                index_loaded = load_index(index_path, index);
+            }
+
+            for (const auto &file : files)
+            {
+                Record record;
+                record.path = file.u8string();
+                record.size = std::filesystem::file_size(file, ec);
+                if (ec)
+                {
+                    continue;
+                }
+                record.modified = static_cast<int64_t>(std::filesystem::last_write_time(file, ec).time_since_epoch().count());
+
+                auto it = index.find(record.path);
+                if (it != index.end() && it->second.size == record.size && it->second.modified == record.modified)
+                {
+                    records_.push_back(std::move(it->second));
+                    cached_++;
+                }
+                else if (scan(file, record))
+                {
+                    records_.push_back(std::move(record));
+                    scanned_++;
+                }
+            }
+
+            // 有文件被重新读取，或索引中有本次没有找到的文件时重写索引
+            if (options.index_path && (!index_loaded || scanned_ > 0 || cached_ != index.size()))
+            {
+                save_index(index_path);
+            }
+
+            for (const auto &record : records_)
+            {
+                for (const auto &export_ : record.exports)
+                {
+                    views_.push_back(native_plugin_export_t{
+                        record.path.c_str(),
+                        export_.type_name.c_str(),
+                        export_.method_name.c_str(),
+                        export_.has_entry_point ? export_.entry_point.c_str() : nullptr,
+                        export_.signature.c_str()});
+                }
+            }
+
+            log_info("Discovered " + std::to_string(views_.size()) + " plugin exports in " + options.directory + " (" +
+                     std::to_string(scanned_) + " scanned, " + std::to_string(cached_) + " from index)");
+            return NativeHostStatus::SUCCESS;
+        }
+
+        void info(native_plugin_catalog_info_t *info) const
+        {
+            info->exports = views_.empty() ? nullptr : views_.data();
+            info->export_count = static_cast<uint32_t>(views_.size());
+            info->assembly_count = static_cast<uint32_t>(
+                std::count_if(records_.begin(), records_.end(), [](const Record &record) { return record.managed; }));
+            info->scanned_count = scanned_;
+            info->cached_count = cached_;
+        }
+    };
+
+    /**
+     * @brief 非对称内存屏障
+     *
+     * 调用路径只需编译器屏障；卸载路径通过 membarrier / FlushProcessWriteBuffers
+     * 让进程内所有正在运行的线程各执行一次完整屏障，两者配对等价于双方都使用完整屏障。
+     * 系统不支持时调用路径退回完整屏障。
+     */
+    namespace AsymmetricBarrier
+    {
+        bool register_heavy()
+        {
+#ifdef _WIN32
+            return true;
+#elif defined(__linux__) && defined(__NR_membarrier)
+            return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#else
+            return false;
+#endif
+        }
+
+        // 在库加载时确定，之后只读
+        const bool heavy_supported = register_heavy();
+
+        inline void light()
+        {
+            if (heavy_supported)
+            {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+            else
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        void heavy()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!heavy_supported)
+            {
+                return;
+            }
+#ifdef _WIN32
+            FlushProcessWriteBuffers();
+#elif defined(__linux__) && defined(__NR_membarrier)
+            syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+#endif
+        }
+    }
+
+    /**
+     * @brief 线程独占的计数分片编号
+     *
+     * 每个线程在首次调用时领取一个编号，线程退出时归还。同时存在的线程超过 COUNT 个时，
+     * 多出的线程共用编号 SHARED，对该分片改用原子读改写。
+     */
+    namespace ThreadSlots
+    {
+        constexpr uint32_t COUNT = 64;
+        constexpr uint32_t SHARED = COUNT;
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<uint32_t> free;
+            uint32_t next = 0;
+        };
+
+        // 不析构：进程退出时仍可能有线程归还编号
+        Registry &registry()
+        {
+            static auto *instance = new Registry();
+            return *instance;
+        }
+
+        struct Owner
+        {
+            uint32_t index = SHARED;
+
+            Owner()
+            {
+                auto &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                if (!r.free.empty())
+                {
+                    index = r.free.back();
+                    r.free.pop_back();
+                }
+                else if (r.next < COUNT)
+                {
+                    index = r.next++;
+                }
+            }
+
+            ~Owner()
+            {
+                if (index != SHARED)
+                {
+                    auto &r = registry();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    r.free.push_back(index);
+                }
+            }
+        };
+
+        constexpr uint32_t UNASSIGNED = UINT32_MAX;
+        thread_local uint32_t assigned = UNASSIGNED;
+
+        uint32_t assign()
+        {
+            // 析构时归还编号
+            thread_local Owner owner;
+            assigned = owner.index;
+            return assigned;
+        }
+
+        inline uint32_t current()
+        {
+            uint32_t index = assigned;
+            return index != UNASSIGNED ? index : assign();
+        }
+    }
+
+    /**
+     * @brief 程序集的在途调用计数
+     *
+     * 每个线程只写自己的分片，进入和退出都是普通的加一和写回，不加锁、不使用原子读改写，
+     * 也不与其他线程争用缓存行。卸载时先标记退役并执行重屏障，之后的进入都会看到退役标记；
+     * 各分片的进入次数之和等于退出次数之和时，没有线程仍在调用该程序集。
+     */
+    class CallTracker
+    {
+        struct alignas(64) Shard
+        {
+            std::atomic<uint64_t> enters{0};
+            std::atomic<uint64_t> leaves{0};
+        };
+
+        Shard shards_[ThreadSlots::COUNT + 1];
+        std::atomic<bool> retiring_{false};
+
+        static void increment(std::atomic<uint64_t> &counter, uint32_t index, std::memory_order order)
+        {
+            if (index == ThreadSlots::SHARED)
+            {
+                counter.fetch_add(1, std::memory_order_seq_cst);
+            }
+            else
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + 1, order);
+            }
+        }
+
+    public:
+        /**
+         * @param index 当前线程的分片编号
+         * @return 程序集已退役时返回 false，调用方不得继续调用
+         */
+        bool enter(uint32_t index)
+        {
+            increment(shards_[index].enters, index, std::memory_order_relaxed);
+            // 与 retire 中的重屏障配对：进入计数和退役标记至少有一方被对方看到
+            AsymmetricBarrier::light();
+            if (retiring_.load(std::memory_order_relaxed))
+            {
+                leave(index);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @param index 当前线程的分片编号，不一定是进入时的线程
+         */
+        void leave(uint32_t index)
+        {
+            increment(shards_[index].leaves, index, std::memory_order_release);
+        }
+
+        bool enter() { return enter(ThreadSlots::current()); }
+
+        /**
+         * @brief 退出可以发生在与进入不同的线程上，只有总和参与判断
+         */
+        void leave() { leave(ThreadSlots::current()); }
+
+        void retire()
+        {
+            retiring_.store(true, std::memory_order_relaxed);
+            AsymmetricBarrier::heavy();
+        }
+
+        /**
+         * @brief 是否没有在途调用，只在 retire 之后有意义
+         *
+         * 两个计数都只增不减，先读退出再读进入：读到的进入总数不超过读到的退出总数时，
+         * 两轮读取之间存在一个没有在途调用的时刻，此后的进入都会看到退役标记。
+         */
+        bool quiescent() const
+        {
+            uint64_t leaves = 0;
+            for (const auto &shard : shards_)
+            {
+                leaves += shard.leaves.load(std::memory_order_acquire);
+            }
+            uint64_t enters = 0;
+            for (const auto &shard : shards_)
+            {
+                enters += shard.enters.load(std::memory_order_relaxed);
+            }
+            return enters <= leaves;
+        }
+    };
+
+    /**
+     * @brief 托管代码向本机代码推送事件的单生产者单消费者通道
+     *
+     * 通道是一块本机内存：头部之后是容量为 2 的幂的环形缓冲区，托管生产者（PluginSupport.HostChannel）
+     * 直接按下面的布局写入，写入不离开托管代码。记录为 [uint32 长度][数据]，按 8 字节对齐，不跨越缓冲区末尾；
+     * 末尾放不下时写一个长度为 PADDING 的填充记录，跳到缓冲区开头。
+     *
+     * 1. 生产者写入记录后以 release 语义推进 head，随后只需编译器屏障即可检查 consumer_waiting，
+     *    消费者休眠前以 AsymmetricBarrier::heavy() 配对，因此唤醒只在消费者休眠时发生
+     * 2. 消费者一次处理调用时已可见的全部记录，每批只以 release 语义推进一次 tail
+     * 3. 缓冲区满时生产者先自旋，再置 producer_waiting 并调用头部中的 wait_for_space 休眠，
+     *    消费者推进 tail 后发现该标志时唤醒它
+     *
+     * 只有休眠和唤醒经过本机函数，其余都是对共享内存的普通读写。
+     * 布局与 src/PluginSupport/HostChannel.cs 一致，修改时两边同步。
+     */
+    namespace EventChannel
+    {
+        constexpr uint32_t MAGIC = 0x4E484543; // "NHEC"
+        constexpr uint32_t PADDING = 0xFFFFFFFF;
+        constexpr uint32_t RECORD_ALIGNMENT = 8;
+        constexpr uint32_t DEFAULT_CAPACITY = 1u << 20;
+        constexpr uint32_t MIN_CAPACITY = 1u << 12;
+        constexpr uint32_t MAX_CAPACITY = 1u << 30;
+
+        struct Header;
+        using wake_fn = void (*)(Header *header);
+        using wait_for_space_fn = int32_t (*)(Header *header, uint64_t tail, uint32_t timeout_ms);
+
+        /**
+         * @brief 通道头部，生产者和消费者各自修改的字段位于不同的缓存行
+         */
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t capacity;              ///< 缓冲区字节数，2 的幂
+            uint32_t max_event_size;        ///< 单条记录的最大数据长度
+            uint32_t producer_fence;        ///< 为 1 时生产者发布后需要完整屏障（系统不支持非对称屏障）
+            wake_fn wake;                   ///< 唤醒休眠的消费者
+            wait_for_space_fn wait_for_space; ///< 等待 tail 推进到指定位置，返回 1 表示有空间，0 表示超时
+            void *owner;
+
+            alignas(64) std::atomic<uint64_t> head;     ///< 生产者已发布的字节位置，只增不减
+            std::atomic<uint32_t> producer_waiting;     ///< 生产者是否在等待空间
+            std::atomic<uint32_t> completed;            ///< 生产者是否已结束
+
+            alignas(64) std::atomic<uint64_t> tail;     ///< 消费者已释放的字节位置
+            std::atomic<uint32_t> consumer_waiting;     ///< 消费者是否在等待记录
+        };
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "channel atomics must be lock free");
+        static_assert(offsetof(Header, wake) == 16 && offsetof(Header, wait_for_space) == 24,
+                      "HostChannel.cs reads the header at fixed offsets");
+        static_assert(offsetof(Header, head) == 64 && offsetof(Header, producer_waiting) == 72 &&
+                          offsetof(Header, completed) == 76 && offsetof(Header, tail) == 128 &&
+                          offsetof(Header, consumer_waiting) == 136 && sizeof(Header) == 192,
+                      "HostChannel.cs reads the header at fixed offsets");
+
+        inline uint32_t record_size(uint32_t size)
+        {
+            return (sizeof(uint32_t) + size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+        }
+
+        /**
+         * @brief 通道本体：头部和缓冲区之外，还有只在本机使用的休眠状态和两端各自的缓存位置
+         */
+        class Channel
+        {
+            Header *header_;
+            unsigned char *data_;
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            // 消费者本地的读取位置，等于已释放的 tail
+            alignas(64) uint64_t read_position_ = 0;
+            // 本机生产者最近读到的 tail，只在空间不足时重新读取
+            alignas(64) uint64_t cached_tail_ = 0;
+
+            static void wake(Header *header)
+            {
+                auto *channel = static_cast<Channel *>(header->owner);
+                {
+                    // 对方在锁内检查条件，持锁一次保证通知不会落在检查和休眠之间
+                    std::lock_guard<std::mutex> lock(channel->mutex_);
+                }
+                channel->cv_.notify_all();
+            }
+
+            static int32_t wait_for_space(Header *header, uint64_t tail, uint32_t timeout_ms)
+            {
+                auto *channel = static_cast<Channel *>(header->owner);
+                auto has_space = [&]()
+                { return header->tail.load(std::memory_order_acquire) >= tail; };
+
+                std::unique_lock<std::mutex> lock(channel->mutex_);
+                if (timeout_ms == UINT32_MAX)
+                {
+                    channel->cv_.wait(lock, has_space);
+                }
+                else
+                {
+                    channel->cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), has_space);
+                }
+                header->producer_waiting.store(0, std::memory_order_relaxed);
+                return has_space() ? 1 : 0;
+            }
+
+            /**
+             * @brief 消费者等待记录或结束，超时返回 false
+             */
+            bool wait_for_events(uint32_t timeout_ms)
+            {
+                auto ready = [&]()
+                {
+                    return header_->head.load(std::memory_order_acquire) != read_position_ ||
+                           header_->completed.load(std::memory_order_acquire) != 0;
+                };
+                if (ready())
+                {
+                    return true;
+                }
+                if (timeout_ms == 0)
+                {
+                    return false;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                auto spin = std::min<std::chrono::steady_clock::duration>(IsolationChannel::spin_time(),
+                                                                          std::chrono::milliseconds(timeout_ms));
+                while (std::chrono::steady_clock::now() - start < spin)
+                {
+                    if (ready())
+                    {
+                        return true;
+                    }
+                    IsolationChannel::cpu_relax();
+                }
+
+                // 与生产者发布后的轻量屏障配对：要么生产者看到标志并唤醒，要么这里看到新的 head
+                header_->consumer_waiting.store(1, std::memory_order_relaxed);
+                AsymmetricBarrier::heavy();
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                bool result = true;
+                if (timeout_ms == UINT32_MAX)
+                {
+                    cv_.wait(lock, ready);
+                }
+                else
+                {
+                    result = cv_.wait_until(lock, start + std::chrono::milliseconds(timeout_ms), ready);
+                }
+                header_->consumer_waiting.store(0, std::memory_order_relaxed);
+                return result;
+            }
+
+        public:
+            explicit Channel(uint32_t capacity)
+            {
+                void *memory = ::operator new(sizeof(Header) + capacity, std::align_val_t(64));
+                header_ = new (memory) Header{};
+                data_ = static_cast<unsigned char *>(memory) + sizeof(Header);
+                header_->magic = MAGIC;
+                header_->capacity = capacity;
+                header_->max_event_size = capacity / 2 - sizeof(uint32_t);
+                header_->producer_fence = AsymmetricBarrier::heavy_supported ? 0 : 1;
+                header_->wake = &Channel::wake;
+                header_->wait_for_space = &Channel::wait_for_space;
+                header_->owner = this;
+            }
+
+            ~Channel()
+            {
+                header_->magic = 0;
+                header_->~Header();
+                ::operator delete(static_cast<void *>(header_), std::align_val_t(64));
+            }
+
+            Channel(const Channel &) = delete;
+            Channel &operator=(const Channel &) = delete;
+
+            /**
+             * @brief 句柄即头部地址，托管生产者直接使用
+             */
+            void *handle() const { return header_; }
+
+            static Channel *from_handle(void *handle)
+            {
+                auto *header = static_cast<Header *>(handle);
+                return header && header->magic == MAGIC ? static_cast<Channel *>(header->owner) : nullptr;
+            }
+
+            /**
+             * @brief 本机生产者写入一条记录，与 HostChannel.Write 的算法相同
+             */
+            NativeHostStatus write(const void *data, uint32_t size, uint32_t timeout_ms)
+            {
+                if (size > header_->max_event_size || (!data && size > 0))
+                {
+                    return NativeHostStatus::ERROR_INVALID_ARG;
+                }
+
+                const uint32_t capacity = header_->capacity;
+                const uint32_t length = record_size(size);
+                uint64_t position = header_->head.load(std::memory_order_relaxed);
+                uint32_t offset = static_cast<uint32_t>(position) & (capacity - 1);
+                uint32_t padding = capacity - offset < length ? capacity - offset : 0;
+                uint64_t required_tail = position + padding + length - capacity;
+
+                if (position + padding + length - cached_tail_ > capacity)
+                {
+                    cached_tail_ = header_->tail.load(std::memory_order_acquire);
+                    if (position + padding + length - cached_tail_ > capacity)
+                    {
+                        if (timeout_ms == 0)
+                        {
+                            return NativeHostStatus::ERROR_TIMEOUT;
+                        }
+                        auto start = std::chrono::steady_clock::now();
+                        while (cached_tail_ < required_tail &&
+                               std::chrono::steady_clock::now() - start < IsolationChannel::spin_time())
+                        {
+                            IsolationChannel::cpu_relax();
+                            cached_tail_ = header_->tail.load(std::memory_order_acquire);
+                        }
+                        if (cached_tail_ < required_tail)
+                        {
+                            header_->producer_waiting.store(1, std::memory_order_relaxed);
+                            std::atomic_thread_fence(std::memory_order_seq_cst);
+                            if (header_->tail.load(std::memory_order_acquire) < required_tail &&
+                                wait_for_space(header_, required_tail, timeout_ms) == 0)
+                            {
+                                return NativeHostStatus::ERROR_TIMEOUT;
+                            }
+                            header_->producer_waiting.store(0, std::memory_order_relaxed);
+                            cached_tail_ = header_->tail.load(std::memory_order_acquire);
+                        }
+                    }
+                }
+
+                if (padding != 0)
+                {
+                    std::memcpy(data_ + offset, &PADDING, sizeof(uint32_t));
+                    offset = 0;
+                }
+                std::memcpy(data_ + offset, &size, sizeof(uint32_t));
+                if (size > 0)
+                {
+                    std::memcpy(data_ + offset + sizeof(uint32_t), data, size);
+                }
+                publish(position + padding + length);
+                return NativeHostStatus::SUCCESS;
+            }
+
+            /**
+             * @brief 发布到 position，消费者休眠时唤醒它
+             */
+            void publish(uint64_t position)
+            {
+                header_->head.store(position, std::memory_order_release);
+                AsymmetricBarrier::light();
+                if (header_->consumer_waiting.load(std::memory_order_relaxed) != 0)
+                {
+                    wake(header_);
+                }
+            }
+
+            void complete()
+            {
+                header_->completed.store(1, std::memory_order_release);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (header_->consumer_waiting.load(std::memory_order_relaxed) != 0)
+                {
+                    wake(header_);
+                }
+            }
+
+            /**
+             * @brief 处理调用时已发布的记录，最多 max_events 条（0 表示不限），处理完后一次释放空间
+             */
+            NativeHostStatus drain(native_channel_event_fn on_event, void *user_data, uint32_t max_events,
+                                   uint32_t timeout_ms, uint32_t *drained)
+            {
+                *drained = 0;
+                if (!wait_for_events(timeout_ms))
+                {
+                    return NativeHostStatus::ERROR_TIMEOUT;
+                }
+
+                const uint32_t capacity = header_->capacity;
+                const uint64_t head = header_->head.load(std::memory_order_acquire);
+                uint64_t position = read_position_;
+                uint32_t count = 0;
+                while (position != head && (max_events == 0 || count < max_events))
+                {
+                    uint32_t offset = static_cast<uint32_t>(position) & (capacity - 1);
+                    uint32_t size;
+                    std::memcpy(&size, data_ + offset, sizeof(uint32_t));
+                    if (size == PADDING)
+                    {
+                        position += capacity - offset;
+                        continue;
+                    }
+                    on_event(user_data, data_ + offset + sizeof(uint32_t), size);
+                    position += record_size(size);
+                    ++count;
+                }
+
+                if (position != read_position_)
+                {
+                    read_position_ = position;
+                    header_->tail.store(position, std::memory_order_release);
+                    // 与生产者置 producer_waiting 后的完整屏障配对
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (header_->producer_waiting.load(std::memory_order_relaxed) != 0)
+                    {
+                        wake(header_);
+                    }
+                }
+                *drained = count;
+                return NativeHostStatus::SUCCESS;
+            }
+        };
+    }
+
+    /**
+     * @brief 按入口点的跳转桩，由计时跳板和延迟绑定共用
+     *
+     * 桩本身不携带状态，从紧随代码页的数据页的同一偏移处读取上下文和跳转目标，
+     * 改变行为只需原子地写入跳转目标。
+     */
+    namespace Trampolines
+    {
+        /**
+         * @brief 跳转桩读取的数据，与桩在各自页中的偏移相同
+         */
+        struct Slot
+        {
+            void *context;            ///< 跳转前载入 r10，由跳转目标解释
+            std::atomic<void *> jump; ///< 跳转目标
+        };
+
+        static_assert(sizeof(Slot) == 16, "slot layout is read by the jump stubs");
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+        /**
+         * @brief 跳转桩的分配
+         *
+         * 每次映射一页代码和一页数据。代码页中的桩完全相同：
+         *   mov r10, [rip + 页大小 - 7]   ; Slot::context
+         *   jmp [rip + 页大小 - 5]        ; Slot::jump
+         * 写满后改为只读可执行，之后只写数据页，不需要在运行中修改代码。
+         * 跳板与入口点的函数指针一样在进程生命周期内有效，页不会释放。
+         */
+        class Thunks
+        {
+            static constexpr size_t THUNK_SIZE = 16;
+
+            uint8_t *code_ = nullptr;
+            size_t page_size_ = 0;
+            size_t used_ = 0;
+
+            bool map_pages()
+            {
+                size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                void *memory = mmap(nullptr, 2 * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED)
+                {
+                    return false;
+                }
+
+                auto *code = static_cast<uint8_t *>(memory);
+                int32_t entry_offset = static_cast<int32_t>(page_size) - 7;
+                int32_t jump_offset = static_cast<int32_t>(page_size) + 8 - 13;
+                for (size_t offset = 0; offset < page_size; offset += THUNK_SIZE)
+                {
+                    uint8_t *thunk = code + offset;
+                    std::memset(thunk, 0xCC, THUNK_SIZE);
+                    thunk[0] = 0x4C; // mov r10, [rip + disp32]
+                    thunk[1] = 0x8B;
+                    thunk[2] = 0x15;
+                    std::memcpy(thunk + 3, &entry_offset, sizeof(entry_offset));
+                    thunk[7] = 0xFF; // jmp [rip + disp32]
+                    thunk[8] = 0x25;
+                    std::memcpy(thunk + 9, &jump_offset, sizeof(jump_offset));
+                }
+
+                if (mprotect(memory, page_size, PROT_READ | PROT_EXEC) != 0)
+                {
+                    munmap(memory, 2 * page_size);
+                    return false;
+                }
+
+                code_ = code;
+                page_size_ = page_size;
+                used_ = 0;
+                return true;
+            }
+
+        public:
+            /**
+             * @return 跳转桩的地址，无法映射内存时返回 nullptr
+             */
+            void *allocate(Slot *&slot)
+            {
+                if ((!code_ || used_ == page_size_ / THUNK_SIZE) && !map_pages())
+                {
+                    return nullptr;
+                }
+                uint8_t *thunk = code_ + used_ * THUNK_SIZE;
+                slot = reinterpret_cast<Slot *>(thunk + page_size_);
+                ++used_;
+                return thunk;
+            }
+        };
+#endif
+    }
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+    // 定义在下方的汇编中
+    extern "C" void native_host_profiling_stub();
+    extern "C" void native_host_profiling_return();
+#endif
+
+    /**
+     * @brief 按入口点采样调用延迟
+     *
+     * 开启后 native_host_get_delegate 返回计时跳板而不是入口本身，不需要修改插件。跳板分两部分：
+     * - 每个入口点一个 16 字节的跳转桩：代码页创建时一次写满后只读可执行，
+     *   桩从紧随其后的数据页的同一偏移处读取入口点记录和跳转目标
+     * - 所有入口点共用的计时桩：保存参数寄存器后调用 enter，采样的调用把返回地址换成返回桩，
+     *   方法返回到返回桩，由 leave 记录耗时并取回原返回地址
+     *
+     * 计时不依赖方法签名。关闭时跳转目标直接改写为入口本身，已发出的跳板只多一次间接跳转。
+     * 被替换的返回地址保存在线程本地的影子栈中，因此与 CET 硬件影子栈不兼容。
+     *
+     * 采样的调用在栈上的返回地址指向返回桩，真实返回地址只在影子栈中，展开信息无法描述：
+     * 回溯和异常展开到返回桩即停止（返回桩的 CFI 把返回地址标为未定义）。托管入口点和 NativeAOT 导出
+     * 都是 [UnmanagedCallersOnly]，异常本来就不能越过，因此不需要跳过这类入口。
+     * 影子栈的每一帧记录被替换的返回地址所在的栈位置，longjmp 等越过采样调用后，
+     * 下一次经过计时桩或返回桩时按栈位置丢弃已失效的帧，嵌套深度不会一直停留在上限。
+     */
+    namespace Profiling
+    {
+#ifdef NATIVE_HOST_TRAMPOLINES
+        constexpr bool supported = true;
+#else
+        constexpr bool supported = false;
+#endif
+
+        inline uint32_t highest_bit(uint64_t value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+            uint32_t bit = 0;
+            while (value >>= 1)
+            {
+                ++bit;
+            }
+            return bit;
+#endif
+        }
+
+        /**
+         * @brief 对数线性分桶的延迟直方图，以时钟计数记录，相对误差不超过 1/32
+         *
+         * 只由所属线程写入，使用普通的读取和写回；汇总时由其他线程读取。
+         */
+        struct Histogram
+        {
+            static constexpr uint32_t SUB_BITS = 5;
+            static constexpr uint32_t SUB_COUNT = 1u << SUB_BITS;
+            static constexpr uint32_t MAX_SHIFT = 31; // 超过 2^36 个时钟计数的耗时计入最后一个桶
+            static constexpr uint32_t BUCKETS = (MAX_SHIFT + 2) * SUB_COUNT;
+
+            std::atomic<uint64_t> total{0};
+            std::atomic<uint64_t> min{UINT64_MAX};
+            std::atomic<uint64_t> max{0};
+            std::atomic<uint64_t> buckets[BUCKETS]{};
+
+            static uint32_t bucket_index(uint64_t value)
+            {
+                if (value < 2 * SUB_COUNT)
+                {
+                    return static_cast<uint32_t>(value);
+                }
+                uint32_t shift = highest_bit(value) - SUB_BITS;
+                if (shift > MAX_SHIFT)
+                {
+                    return BUCKETS - 1;
+                }
+                return (shift + 1) * SUB_COUNT + static_cast<uint32_t>((value >> shift) - SUB_COUNT);
+            }
+
+            /**
+             * @brief 桶中可能的最大值
+             */
+            static uint64_t bucket_upper(uint32_t index)
+            {
+                if (index < 2 * SUB_COUNT)
+                {
+                    return index;
+                }
+                uint32_t shift = index / SUB_COUNT - 1;
+                uint64_t lower = static_cast<uint64_t>(SUB_COUNT + index % SUB_COUNT) << shift;
+                return lower + (uint64_t(1) << shift) - 1;
+            }
+
+            static void add(std::atomic<uint64_t> &counter, uint64_t value)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            void record(uint64_t ticks)
+            {
+                add(buckets[bucket_index(ticks)], 1);
+                add(total, ticks);
+                if (ticks < min.load(std::memory_order_relaxed))
+                {
+                    min.store(ticks, std::memory_order_relaxed);
+                }
+                if (ticks > max.load(std::memory_order_relaxed))
+                {
+                    max.store(ticks, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @brief 并入另一个直方图，调用方保证两者都没有并发写入
+             */
+            void merge(const Histogram &other)
+            {
+                for (uint32_t i = 0; i < BUCKETS; ++i)
+                {
+                    add(buckets[i], other.buckets[i].load(std::memory_order_relaxed));
+                }
+                add(total, other.total.load(std::memory_order_relaxed));
+                min.store(std::min(min.load(std::memory_order_relaxed), other.min.load(std::memory_order_relaxed)),
+                          std::memory_order_relaxed);
+                max.store(std::max(max.load(std::memory_order_relaxed), other.max.load(std::memory_order_relaxed)),
+                          std::memory_order_relaxed);
+            }
+
+            void clear()
+            {
+                for (auto &bucket : buckets)
+                {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                total.store(0, std::memory_order_relaxed);
+                min.store(UINT64_MAX, std::memory_order_relaxed);
+                max.store(0, std::memory_order_relaxed);
+            }
+        };
+
+        struct Entry
+        {
+            void *target = nullptr;
+            native_assembly_handle_t assembly = nullptr;
+            std::string type_name;
+            std::string method_name;
+            uint32_t id = 0;
+            void *thunk = nullptr;
+            Trampolines::Slot *slot = nullptr; ///< 跳转目标开启时为计时桩，关闭时为入口本身
+            // 存活线程各自的直方图和已退出线程并入的直方图，由 Registry::mutex 保护
+            std::vector<std::unique_ptr<Histogram>> histograms;
+            Histogram retired;
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            // 跳板可能在主机销毁后仍被调用，记录不释放
+            std::vector<std::unique_ptr<Entry>> entries;
+            // 当前主机的入口点
+            std::vector<Entry *> current;
+            std::unordered_map<std::string, Entry *> lookup;
+#ifdef NATIVE_HOST_TRAMPOLINES
+            Trampolines::Thunks thunks;
+#endif
+        };
+
+        // 不析构：进程退出时其他线程仍可能经过跳板
+        Registry &registry()
+        {
+            static auto *instance = new Registry();
+            return *instance;
+        }
+
+        /**
+         * @brief 计时时钟
+         *
+         * CPU 提供不变 TSC 时直接读取时间戳计数器，比 steady_clock 少一次 vDSO 调用；
+         * 计数到纳秒的比例在汇总时按库加载以来的计数和 steady_clock 校准。
+         */
+        namespace Clock
+        {
+            uint64_t steady_ns()
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 std::chrono::steady_clock::now().time_since_epoch())
+                                                 .count());
+            }
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+            bool detect_invariant_tsc()
+            {
+                unsigned int eax, ebx, ecx, edx;
+                return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8)) != 0;
+            }
+
+            const bool use_tsc = detect_invariant_tsc();
+#else
+            const bool use_tsc = false;
+#endif
+
+            inline uint64_t ticks()
+            {
+#ifdef NATIVE_HOST_TRAMPOLINES
+                if (use_tsc)
+                {
+                    return __rdtsc();
+                }
+#endif
+                return steady_ns();
+            }
+
+            // 校准的起点，在库加载时确定
+            const uint64_t origin_ns = steady_ns();
+            const uint64_t origin_ticks = ticks();
+
+            /**
+             * @brief 每个计数对应的纳秒数，校准区间不足 10 毫秒时先等待
+             */
+            double ns_per_tick()
+            {
+                if (!use_tsc)
+                {
+                    return 1.0;
+                }
+                uint64_t now_ns = steady_ns();
+                if (now_ns - origin_ns < 10000000)
+                {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(10000000 - (now_ns - origin_ns)));
+                    now_ns = steady_ns();
+                }
+                uint64_t now_ticks = ticks();
+                return now_ticks > origin_ticks ? static_cast<double>(now_ns - origin_ns) / (now_ticks - origin_ticks) : 1.0;
+            }
+        }
+
+        struct Frame
+        {
+            void *return_address;
+            void **slot; ///< 被替换的返回地址所在的栈位置
+            Entry *entry;
+            uint64_t start;
+        };
+
+        // 超过此嵌套深度的调用不采样
+        constexpr uint32_t MAX_DEPTH = 64;
+
+        /**
+         * @brief 线程本地状态
+         *
+         * 零初始化且没有析构函数，共享库中每次访问只需一次 TLS 地址查询，不经过初始化包装。
+         */
+        struct ThreadState
+        {
+            uint32_t sample_countdown;
+            uint32_t depth;
+            uint32_t histogram_count;
+            bool histograms_released; ///< thread_histograms 已析构
+            Histogram **histograms; ///< 按入口点编号索引，存储归 thread_histograms 所有，线程退出时清空
+            Frame frames[MAX_DEPTH];
+        };
+
+        std::atomic<uint32_t> sample_rate{0};
+        thread_local ThreadState thread_state;
+
+        /**
+         * @brief 线程的直方图表，按入口点编号索引
+         *
+         * 只在线程第一次记录某个入口点时访问。线程退出时把各直方图并入入口点的 retired 并释放，
+         * 频繁创建线程的宿主不会积累已退出线程的直方图。
+         */
+        struct ThreadHistograms
+        {
+            std::vector<Histogram *> table;
+
+            ~ThreadHistograms()
+            {
+                auto &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (uint32_t id = 0; id < table.size(); ++id)
+                {
+                    if (!table[id])
+                    {
+                        continue;
+                    }
+                    auto &entry = *r.entries[id];
+                    entry.retired.merge(*table[id]);
+                    auto it = std::find_if(entry.histograms.begin(), entry.histograms.end(),
+                                           [&](const std::unique_ptr<Histogram> &histogram) { return histogram.get() == table[id]; });
+                    std::swap(*it, entry.histograms.back());
+                    entry.histograms.pop_back();
+                }
+                thread_state.histograms = nullptr;
+                thread_state.histogram_count = 0;
+                thread_state.histograms_released = true;
+            }
+        };
+
+        thread_local ThreadHistograms thread_histograms;
+
+        bool enabled()
+        {
+            return sample_rate.load(std::memory_order_relaxed) != 0;
+        }
+
+        bool should_sample(ThreadState &state)
+        {
+            uint32_t rate = sample_rate.load(std::memory_order_relaxed);
+            if (rate == 0)
+            {
+                return false;
+            }
+            if (state.sample_countdown == 0 || state.sample_countdown > rate)
+            {
+                state.sample_countdown = rate;
+            }
+            return --state.sample_countdown == 0;
+        }
+
+        NATIVE_HOST_NOINLINE Histogram &add_thread_histogram(ThreadState &state, Entry *entry)
+        {
+            if (state.histograms_released)
+            {
+                // 线程退出过程中的调用不再计入统计
+                static Histogram discarded;
+                return discarded;
+            }
+            auto &owner = thread_histograms;
+
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            entry->histograms.push_back(std::make_unique<Histogram>());
+            if (owner.table.size() <= entry->id)
+            {
+                owner.table.resize(entry->id + 1);
+            }
+            owner.table[entry->id] = entry->histograms.back().get();
+            state.histograms = owner.table.data();
+            state.histogram_count = static_cast<uint32_t>(owner.table.size());
+            return *owner.table[entry->id];
+        }
+
+        inline Histogram &thread_histogram(ThreadState &state, Entry *entry)
+        {
+            if (entry->id < state.histogram_count && state.histograms[entry->id])
+            {
+                return *state.histograms[entry->id];
+            }
+            return add_thread_histogram(state, entry);
+        }
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+        /**
+         * @brief 丢弃返回地址位置不高于 slot 的帧
+         *
+         * 栈向低地址增长，这些帧的调用已被 longjmp 或异常越过，不会再返回到返回桩。
+         */
+        inline void discard_unwound(ThreadState &state, void **slot)
+        {
+            while (state.depth > 0 && state.frames[state.depth - 1].slot <= slot)
+            {
+                --state.depth;
+            }
+        }
+
+        /**
+         * @brief 计时桩在调用入口之前调用
+         *
+         * @param return_address 栈上调用方返回地址的位置，采样时改为返回桩
+         * @return 计时桩随后跳转的入口
+         */
+        void *enter(Entry *entry, void **return_address)
+        {
+            auto &state = thread_state;
+            discard_unwound(state, return_address);
+            if (state.depth < MAX_DEPTH && should_sample(state))
+            {
+                auto &frame = state.frames[state.depth++];
+                frame.return_address = *return_address;
+                frame.slot = return_address;
+                frame.entry = entry;
+                *return_address = reinterpret_cast<void *>(&native_host_profiling_return);
+                // 最后读取时钟，使本函数的开销不计入被测调用
+                frame.start = Clock::ticks();
+            }
+            return entry->target;
+        }
+
+        /**
+         * @brief 采样的调用返回到返回桩时调用
+         *
+         * @param slot 返回前栈上返回地址的位置，用于跳过影子栈顶已失效的帧
+         * @return 调用方原来的返回地址
+         */
+        void *leave(void **slot)
+        {
+            uint64_t end = Clock::ticks();
+            auto &state = thread_state;
+            discard_unwound(state, slot - 1);
+            if (state.depth == 0 || state.frames[state.depth - 1].slot != slot)
+            {
+                // 没有记录原返回地址，无法继续执行
+                log_error("Profiling shadow stack does not match the returning call");
+                std::abort();
+            }
+            auto &frame = state.frames[--state.depth];
+            thread_histogram(state, frame.entry).record(end - frame.start);
+            return frame.return_address;
+        }
+#endif
+
+        void *jump_target(const Entry &entry, bool active)
+        {
+#ifdef NATIVE_HOST_TRAMPOLINES
+            if (active)
+            {
+                return reinterpret_cast<void *>(&native_host_profiling_stub);
+            }
+#endif
+            return entry.target;
+        }
+
+        /**
+         * @brief 返回入口点的计时跳板，同一入口点多次获取时返回同一个跳板
+         *
+         * @return 跳板地址，无法分配跳板时返回入口本身
+         */
+        void *instrument(native_assembly_handle_t assembly, const char *type_name, const char *method_name, void *target)
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+
+            std::ostringstream key;
+            key << assembly << '\n' << type_name << '\n' << method_name;
+            auto it = r.lookup.find(key.str());
+            if (it != r.lookup.end() && it->second->target == target)
+            {
+                return it->second->thunk;
+            }
+
+            auto entry = std::make_unique<Entry>();
+            entry->target = target;
+            entry->assembly = assembly;
+            entry->type_name = type_name;
+            entry->method_name = method_name;
+            entry->id = static_cast<uint32_t>(r.entries.size());
+#ifdef NATIVE_HOST_TRAMPOLINES
+            entry->thunk = r.thunks.allocate(entry->slot);
+#endif
+            if (!entry->thunk)
+            {
+                log_error("Failed to allocate profiling trampoline for " + entry->method_name);
+                return target;
+            }
+
+            entry->slot->context = entry.get();
+            entry->slot->jump.store(jump_target(*entry, enabled()), std::memory_order_release);
+            r.lookup[key.str()] = entry.get();
+            r.current.push_back(entry.get());
+            r.entries.push_back(std::move(entry));
+            return r.current.back()->thunk;
+        }
+
+        /**
+         * @param rate 每个线程每 rate 次调用计时一次，0 表示关闭
+         */
+        NativeHostStatus set_sample_rate(uint32_t rate)
+        {
+            if (rate != 0 && !supported)
+            {
+                log_error("Profiling trampolines are not supported on this platform");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            sample_rate.store(rate, std::memory_order_relaxed);
+            for (auto *entry : r.current)
+            {
+                entry->slot->jump.store(jump_target(*entry, rate != 0), std::memory_order_release);
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 汇总各线程的直方图，调用方持有 Registry::mutex
+         */
+        void summarize(const Entry &entry, double ns_per_tick, native_latency_stats_t *stats)
+        {
+            std::vector<uint64_t> counts(Histogram::BUCKETS);
+            uint64_t count = 0;
+            uint64_t min_ns = UINT64_MAX;
+            *stats = {};
+            auto accumulate = [&](const Histogram &histogram)
+            {
+                for (uint32_t i = 0; i < Histogram::BUCKETS; ++i)
+                {
+                    uint64_t n = histogram.buckets[i].load(std::memory_order_relaxed);
+                    counts[i] += n;
+                    count += n;
+                }
+                stats->total_ns += histogram.total.load(std::memory_order_relaxed);
+                min_ns = std::min(min_ns, histogram.min.load(std::memory_order_relaxed));
+                stats->max_ns = std::max(stats->max_ns, histogram.max.load(std::memory_order_relaxed));
+            };
+            accumulate(entry.retired);
+            for (const auto &histogram : entry.histograms)
+            {
+                accumulate(*histogram);
+            }
+
+            stats->count = count;
+            if (count == 0)
+            {
+                stats->total_ns = 0;
+                stats->max_ns = 0;
+                return;
+            }
+
+            // 百分位以万分之一为单位
+            const uint64_t quantiles[] = {5000, 9000, 9900, 9990};
+            uint64_t *results[] = {&stats->p50_ns, &stats->p90_ns, &stats->p99_ns, &stats->p999_ns};
+            uint64_t seen = 0;
+            size_t next = 0;
+            for (uint32_t i = 0; i < Histogram::BUCKETS && next < 4; ++i)
+            {
+                seen += counts[i];
+                while (next < 4 && seen * 10000 >= quantiles[next] * count)
+                {
+                    *results[next++] = std::max(min_ns, std::min(Histogram::bucket_upper(i), stats->max_ns));
+                }
+            }
+
+            // 直方图以时钟计数记录，导出时换算为纳秒
+            auto to_ns = [ns_per_tick](uint64_t ticks) { return static_cast<uint64_t>(ticks * ns_per_tick + 0.5); };
+            stats->total_ns = to_ns(stats->total_ns);
+            stats->min_ns = to_ns(min_ns);
+            stats->max_ns = to_ns(stats->max_ns);
+            for (auto *result : results)
+            {
+                *result = to_ns(*result);
+            }
+        }
+
+        /**
+         * @param ns_per_tick Clock::ns_per_tick 的结果，由调用方在加锁之前取得
+         * @param[out] count 入口点总数，可能大于 capacity
+         */
+        void get_profiles(native_latency_profile_t *profiles, uint32_t capacity, double ns_per_tick, uint32_t *count)
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            *count = static_cast<uint32_t>(r.current.size());
+            for (uint32_t i = 0; i < capacity && i < r.current.size(); ++i)
+            {
+                const auto &entry = *r.current[i];
+                profiles[i].assembly = entry.assembly;
+                profiles[i].type_name = entry.type_name.c_str();
+                profiles[i].method_name = entry.method_name.c_str();
+                summarize(entry, ns_per_tick, &profiles[i].stats);
+            }
+        }
+
+        /**
+         * @brief 清空统计；与正在记录的调用并发时，个别样本可能丢失
+         */
+        void reset()
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (auto *entry : r.current)
+            {
+                entry->retired.clear();
+                for (auto &histogram : entry->histograms)
+                {
+                    histogram->clear();
+                }
+            }
+        }
+
+        /**
+         * @brief 主机销毁时关闭剖析，已发出的跳板直接跳转到入口
+         */
+        void detach()
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            sample_rate.store(0, std::memory_order_relaxed);
+            for (auto *entry : r.current)
+            {
+                entry->slot->jump.store(entry->target, std::memory_order_release);
+            }
+            r.current.clear();
+            r.lookup.clear();
+        }
+    }
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+    extern "C" __attribute__((visibility("hidden"), used)) void *native_host_profiling_enter(void *entry, void **return_address) noexcept
+    {
+        return Profiling::enter(static_cast<Profiling::Entry *>(entry), return_address);
+    }
+
+    extern "C" __attribute__((visibility("hidden"), used)) void *native_host_profiling_leave(void **slot) noexcept
+    {
+        return Profiling::leave(slot);
+    }
+
+    // 计时桩：r10 为入口点记录，栈顶为调用方的返回地址，参数仍在寄存器和栈上。
+    // 保存全部参数寄存器（rax 为变参调用的向量寄存器个数）后调用 enter，恢复后跳转到入口。
+    // 返回桩：保存返回值寄存器，调用 leave 取回原返回地址写回原位置后返回。
+    // 返回桩由 ret 进入，展开器按返回地址减一查找 FDE，因此 FDE 从入口前的 nop 开始；
+    // 原返回地址写回之前 rip 标为未定义，展开到此停止，之后按普通的栈帧描述。
+    asm(R"(
+    .text
+    .p2align 4
+    .globl native_host_profiling_stub
+    .hidden native_host_profiling_stub
+    .type native_host_profiling_stub, @function
+native_host_profiling_stub:
+    .cfi_startproc
+    pushq %rbp
+    .cfi_def_cfa_offset 16
+    .cfi_offset %rbp, -16
+    movq %rsp, %rbp
+    .cfi_def_cfa_register %rbp
+    subq $192, %rsp
+    movq %rdi, 0(%rsp)
+    movq %rsi, 8(%rsp)
+    movq %rdx, 16(%rsp)
+    movq %rcx, 24(%rsp)
+    movq %r8, 32(%rsp)
+    movq %r9, 40(%rsp)
+    movq %rax, 48(%rsp)
+    movaps %xmm0, 64(%rsp)
+    movaps %xmm1, 80(%rsp)
+    movaps %xmm2, 96(%rsp)
+    movaps %xmm3, 112(%rsp)
+    movaps %xmm4, 128(%rsp)
+    movaps %xmm5, 144(%rsp)
+    movaps %xmm6, 160(%rsp)
+    movaps %xmm7, 176(%rsp)
+    movq %r10, %rdi
+    leaq 8(%rbp), %rsi
+    call native_host_profiling_enter@PLT
+    movq %rax, %r11
+    movq 0(%rsp), %rdi
+    movq 8(%rsp), %rsi
+    movq 16(%rsp), %rdx
+    movq 24(%rsp), %rcx
+    movq 32(%rsp), %r8
+    movq 40(%rsp), %r9
+    movq 48(%rsp), %rax
+    movaps 64(%rsp), %xmm0
+    movaps 80(%rsp), %xmm1
+    movaps 96(%rsp), %xmm2
+    movaps 112(%rsp), %xmm3
+    movaps 128(%rsp), %xmm4
+    movaps 144(%rsp), %xmm5
+    movaps 160(%rsp), %xmm6
+    movaps 176(%rsp), %xmm7
+    leave
+    .cfi_def_cfa %rsp, 8
+    jmpq *%r11
+    .cfi_endproc
+    .size native_host_profiling_stub, .-native_host_profiling_stub
+
+    .p2align 4
+    .globl native_host_profiling_return
+    .hidden native_host_profiling_return
+    .type native_host_profiling_return, @function
+    .cfi_startproc
+    .cfi_def_cfa_offset 0
+    .cfi_undefined %rip
+    nop
+native_host_profiling_return:
+    subq $8, %rsp
+    .cfi_adjust_cfa_offset 8
+    pushq %rax
+    .cfi_adjust_cfa_offset 8
+    pushq %rdx
+    .cfi_adjust_cfa_offset 8
+    subq $40, %rsp
+    .cfi_adjust_cfa_offset 40
+    movaps %xmm0, 0(%rsp)
+    movaps %xmm1, 16(%rsp)
+    leaq 56(%rsp), %rdi
+    call native_host_profiling_leave@PLT
+    movq %rax, 56(%rsp)
+    .cfi_offset %rip, -8
+    movaps 0(%rsp), %xmm0
+    movaps 16(%rsp), %xmm1
+    addq $40, %rsp
+    .cfi_adjust_cfa_offset -40
+    popq %rdx
+    .cfi_adjust_cfa_offset -8
+    popq %rax
+    .cfi_adjust_cfa_offset -8
+    ret
+    .cfi_endproc
+    .size native_host_profiling_return, .-native_host_profiling_return
+)");
+#endif
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+    // 定义在下方的汇编中
+    extern "C" void native_host_lazy_stub();
+    extern "C" void native_host_lazy_unresolved();
+#endif
+
+    /**
+     * @brief 托管入口点的延迟绑定
+     *
+     * 开启后 native_host_get_delegate 立即返回一个跳转桩（与计时跳板相同），跳转目标最初是所有绑定共用的解析桩。
+     * 首次调用时解析桩保存参数寄存器后调用 resolve 取得入口，resolve 原子地写入跳转目标，
+     * 解析桩恢复寄存器后跳转到入口；之后的调用直接从跳转桩转到入口，只多一次间接跳转。
+     *
+     * 解析失败时调用获取委托时的处理函数。处理函数返回的替代函数同样写入跳转目标；
+     * 没有替代函数时本次调用转到 native_host_lazy_unresolved 直接返回，跳转目标不变，下次调用重新解析。
+     */
+    namespace LazyBinding
+    {
+#ifdef NATIVE_HOST_TRAMPOLINES
+        constexpr bool supported = true;
+#else
+        constexpr bool supported = false;
+#endif
+
+        struct Binding
+        {
+            native_assembly_handle_t assembly = nullptr; ///< 程序集卸载或主机销毁后为空，由 g_mutex 保护
+            std::string type_name;
+            std::string method_name;
+            native_lazy_binding_options_t options{};
+            std::mutex mutex; ///< 串行化同一入口点的并发首次调用
+            void *thunk = nullptr;
+            Trampolines::Slot *slot = nullptr;
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            // 桩与函数指针一样在进程生命周期内有效，绑定不释放
+            std::vector<std::unique_ptr<Binding>> bindings;
+            std::unordered_map<std::string, Binding *> lookup;
+#ifdef NATIVE_HOST_TRAMPOLINES
+            Trampolines::Thunks thunks;
+#endif
+        };
+
+        // 不析构：进程退出时其他线程仍可能经过桩
+        Registry &registry()
+        {
+            static auto *instance = new Registry();
+            return *instance;
+        }
+
+        void *resolver()
+        {
+#ifdef NATIVE_HOST_TRAMPOLINES
+            return reinterpret_cast<void *>(&native_host_lazy_stub);
+#else
+            return nullptr;
+#endif
+        }
+
+        /**
+         * @brief 返回入口点的延迟绑定桩，同一入口点多次获取时返回同一个桩；调用方持有 g_mutex
+         *
+         * @return 桩地址，无法分配时返回 nullptr
+         */
+        void *bind(native_assembly_handle_t assembly, const char *type_name, const char *method_name,
+                   const native_lazy_binding_options_t &options)
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+
+            std::ostringstream key;
+            key << assembly << '\n' << type_name << '\n' << method_name;
+            auto it = r.lookup.find(key.str());
+            if (it != r.lookup.end())
+            {
+                return it->second->thunk;
+            }
+
+            auto binding = std::make_unique<Binding>();
+            binding->assembly = assembly;
+            binding->type_name = type_name;
+            binding->method_name = method_name;
+            binding->options = options;
+#ifdef NATIVE_HOST_TRAMPOLINES
+            binding->thunk = r.thunks.allocate(binding->slot);
+#endif
+            if (!binding->thunk)
+            {
+                log_error("Failed to allocate lazy binding stub for " + binding->method_name);
+                return nullptr;
+            }
+
+            binding->slot->context = binding.get();
+            binding->slot->jump.store(resolver(), std::memory_order_release);
+            r.lookup[key.str()] = binding.get();
+            r.bindings.push_back(std::move(binding));
+            return r.bindings.back()->thunk;
+        }
+
+        /**
+         * @brief 程序集卸载后其未解析的桩不再解析；调用方持有 g_mutex
+         *
+         * @param assembly 卸载的程序集，为空时表示主机销毁，所有桩都不再解析
+         */
+        void orphan(native_assembly_handle_t assembly)
+        {
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (auto &binding : r.bindings)
+            {
+                if (binding->assembly && (!assembly || binding->assembly == assembly))
+                {
+                    binding->assembly = nullptr;
+                }
+            }
+            // 句柄地址可能被之后加载的程序集重用
+            for (auto it = r.lookup.begin(); it != r.lookup.end();)
+            {
+                it = it->second->assembly ? std::next(it) : r.lookup.erase(it);
+            }
+        }
+
+        void *resolve(Binding *binding);
+    }
+
+#ifdef NATIVE_HOST_TRAMPOLINES
+    extern "C" __attribute__((visibility("hidden"), used)) void *native_host_lazy_resolve(void *binding) noexcept
+    {
+        return LazyBinding::resolve(static_cast<LazyBinding::Binding *>(binding));
+    }
+
+    // 解析桩：r10 为绑定记录，参数仍在寄存器和栈上。保存全部参数寄存器后调用 resolve，恢复后跳转到其结果。
+    // 未解析桩：清零整数和浮点返回值寄存器后返回调用方。
+    asm(R"(
+    .text
+    .p2align 4
+    .globl native_host_lazy_stub
+    .hidden native_host_lazy_stub
+    .type native_host_lazy_stub, @function
+native_host_lazy_stub:
+    .cfi_startproc
+    pushq %rbp
+    .cfi_def_cfa_offset 16
+    .cfi_offset %rbp, -16
+    movq %rsp, %rbp
+    .cfi_def_cfa_register %rbp
+    subq $192, %rsp
+    movq %rdi, 0(%rsp)
+    movq %rsi, 8(%rsp)
+    movq %rdx, 16(%rsp)
+    movq %rcx, 24(%rsp)
+    movq %r8, 32(%rsp)
+    movq %r9, 40(%rsp)
+    movq %rax, 48(%rsp)
+    movaps %xmm0, 64(%rsp)
+    movaps %xmm1, 80(%rsp)
+    movaps %xmm2, 96(%rsp)
+    movaps %xmm3, 112(%rsp)
+    movaps %xmm4, 128(%rsp)
+    movaps %xmm5, 144(%rsp)
+    movaps %xmm6, 160(%rsp)
+    movaps %xmm7, 176(%rsp)
+    movq %r10, %rdi
+    call native_host_lazy_resolve@PLT
+    movq %rax, %r11
+    movq 0(%rsp), %rdi
+    movq 8(%rsp), %rsi
+    movq 16(%rsp), %rdx
+    movq 24(%rsp), %rcx
+    movq 32(%rsp), %r8
+    movq 40(%rsp), %r9
+    movq 48(%rsp), %rax
+    movaps 64(%rsp), %xmm0
+    movaps 80(%rsp), %xmm1
+    movaps 96(%rsp), %xmm2
+    movaps 112(%rsp), %xmm3
+    movaps 128(%rsp), %xmm4
+    movaps 144(%rsp), %xmm5
+    movaps 160(%rsp), %xmm6
+    movaps 176(%rsp), %xmm7
+    leave
+    .cfi_def_cfa %rsp, 8
+    jmpq *%r11
+    .cfi_endproc
+    .size native_host_lazy_stub, .-native_host_lazy_stub
+
+    .p2align 4
+    .globl native_host_lazy_unresolved
+    .hidden native_host_lazy_unresolved
+    .type native_host_lazy_unresolved, @function
+native_host_lazy_unresolved:
+    xorl %eax, %eax
+    xorl %edx, %edx
+    xorps %xmm0, %xmm0
+    xorps %xmm1, %xmm1
+    ret
+    .size native_host_lazy_unresolved, .-native_host_lazy_unresolved
+)");
+#endif
+
+    /**
+     * @brief 按签名解析的方法
+     */
+    struct Method
+    {
+        Signatures::Signature signature;
+        void *fn = nullptr;                 ///< 进程内方法的函数指针
+        IsolatedProcess *process = nullptr; ///< 隔离方法所在的辅助进程
+        uint32_t remote_id = 0;             ///< 隔离方法在辅助进程中的编号
+        CallTracker *calls = nullptr;       ///< 所属程序集的在途调用计数
+    };
+
+    /**
+     * @brief 程序集
+     *
+     * 处理单个.NET程序集的加载和管理。
+     *
+     * 主要功能：
+     * - 路径验证和存在性检查
+     * - 程序集加载和卸载
+     * - 方法解析和委托创建
+     */
+    class Assembly
+    {
+        /**
+         * @brief 单个程序集的调用统计，独占缓存行以避免与其他程序集伪共享
+         */
+        struct alignas(64) Stats
+        {
+            std::atomic<uint64_t> invocations{0};
+            std::atomic<uint64_t> sampled_invocations{0};
+            std::atomic<uint64_t> cpu_time_ns{0};
+            std::atomic<uint64_t> allocated_bytes{0};
+        };
+
+        std::string path_;
+        AssemblyKind kind_;
+        lib_handle native_lib_ = nullptr;
+        IsolatedProcess *process_ = nullptr;
+        uint32_t remote_id_ = 0;
+        int32_t plugin_id_ = -1; ///< 支持程序集中的插件编号，-1 表示使用运行时的组件加载
+        bool loaded_ = false;
+        Stats stats_;
+        CallTracker calls_;
+        std::vector<std::unique_ptr<Method>> methods_;
+
+        NativeHostStatus get_native_export(const char *method_name, void **delegate)
+        {
+            // NativeAOT 库按 UnmanagedCallersOnly(EntryPoint=...) 导出，类型名不参与解析
+            *delegate = get_function(native_lib_, method_name);
+            if (!*delegate)
+            {
+                log_error("Export not found in native library: " + std::string(method_name));
+                return NativeHostStatus::ERROR_METHOD_LOAD;
+            }
+
+            log_info("Successfully resolved native export");
+            return NativeHostStatus::SUCCESS;
+        }
+
+    public:
+        explicit Assembly(const char *path, AssemblyKind kind = AssemblyKind::Managed)
+            : path_(path), kind_(kind)
+        {
+            log_info("Created assembly for path: " + path_);
+        }
+
+        /**
+         * @brief 加载 NativeAOT 本机库
+         *
+         * 与托管程序集一样，本机库在进程生命周期内保持加载：NativeAOT 运行时不支持卸载，
+         * 同一路径的多次加载共享库引用计数。
+         */
+        bool load_native_library()
+        {
+            native_lib_ = load_library(to_native_path(path_.c_str()).c_str());
+            if (!native_lib_)
+            {
+                log_error("Failed to load native library: " + path_);
+                return false;
+            }
+            loaded_ = true;
+            return true;
+        }
+
+        /**
+         * @brief 把托管程序集加载到按 .deps.json 解析依赖的加载上下文
+         *
+         * 支持程序集不可用时保持原有行为，由运行时的组件加载在首次获取委托时加载程序集。
+         */
+        NativeHostStatus load_managed()
+        {
+            const auto &loader = Runtime::instance().plugin_loader();
+            if (!loader.load)
+            {
+                return NativeHostStatus::SUCCESS;
+            }
+
+            int32_t rc = loader.load(path_.c_str(), &plugin_id_);
+            if (rc != 0)
+            {
+                log_error("Failed to load plugin: " + path_, rc);
+                plugin_id_ = -1;
+                return static_cast<NativeHostStatus>(rc);
+            }
+
+            loaded_ = true;
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 从内存镜像把托管程序集加载到独立的加载上下文
+         *
+         * 运行时在加载时复制镜像，返回后镜像内存不再被引用；依赖通过 bundle 按需解析。
+         *
+         * @param key 去重键，相同键的加载共享同一插件；为空时每次加载都创建新的插件
+         * @param bundle 解析依赖的插件包，为空时依赖回退到默认加载上下文
+         */
+        NativeHostStatus load_managed_image(const void *image, size_t size, const std::string &key, Bundle *bundle)
+        {
+            const auto &loader = Runtime::instance().plugin_loader();
+            if (!loader.load_from_memory)
+            {
+                log_error("Loading from memory requires the plugin support assembly");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            int32_t rc = loader.load_from_memory(
+                path_.c_str(),
+                key.empty() ? nullptr : key.c_str(),
+                image,
+                static_cast<int64_t>(size),
+                bundle ? &Bundle::resolve : nullptr,
+                bundle,
+                &plugin_id_);
+            if (rc != 0)
+            {
+                log_error("Failed to load plugin image: " + path_, rc);
+                plugin_id_ = -1;
+                return static_cast<NativeHostStatus>(rc);
+            }
+
+            loaded_ = true;
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 关联已在辅助进程中加载的程序集
+         */
+        void attach_isolated(IsolatedProcess *process, uint32_t remote_id)
+        {
+            process_ = process;
+            remote_id_ = remote_id;
+            loaded_ = true;
+        }
+
+        ~Assembly()
+        {
+            close();
+        }
+
+        /**
+         * @brief 释放程序集占用的资源，对象本身可以继续保留
+         *
+         * 卸载后的句柄仍可能被并发调用方传给 native_host_call_enter，对象保留到主机销毁，
+         * 这类调用得到 ERROR_ASSEMBLY_NOT_FOUND 而不是访问已释放的内存。
+         */
+        void close()
+        {
+            if (!loaded_)
+            {
+                return;
+            }
+            log_info("Destroying assembly: " + path_);
+            if (kind_ == AssemblyKind::Isolated)
+            {
+                process_->unload_assembly(remote_id_);
+            }
+            loaded_ = false;
+        }
+
+        NativeHostStatus get_delegate(const char *type_name, const char *method_name, void **delegate)
+        {
+            Timeline::Span span("resolve_delegate", "type", type_name, "method", method_name);
+
+            if (kind_ == AssemblyKind::NativeAot)
+            {
+                return get_native_export(method_name, delegate);
+            }
+
+            if (kind_ == AssemblyKind::Isolated)
+            {
+                // 函数指针不能跨进程使用
+                log_error("Isolated assemblies must be called through native_host_get_method");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            if (!Runtime::instance().is_initialized())
+            {
+                log_error("Runtime not initialized");
+                return NativeHostStatus::ERROR_RUNTIME_INIT;
+            }
+
+            *delegate = nullptr;
+            if (plugin_id_ >= 0)
+            {
+                int32_t rc = Runtime::instance().plugin_loader().get_function(plugin_id_, type_name, method_name, delegate);
+                if (rc != 0 || !*delegate)
+                {
+                    log_error("Failed to get delegate " + std::string(type_name) + "." + method_name, rc);
+                    return rc != 0 ? static_cast<NativeHostStatus>(rc) : NativeHostStatus::ERROR_DELEGATE_NOT_FOUND;
+                }
+                return NativeHostStatus::SUCCESS;
+            }
+
+            auto load_fn = Runtime::instance().get_load_fn();
+
+            // Check if assembly file exists
+            if (!std::filesystem::exists(path_))
+            {
+                log_error("Assembly file not found: " + path_);
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            log_info("Loading type: " + std::string(type_name));
+            log_info("Loading method: " + std::string(method_name));
+
+            // The runtime helper can be called multiple times for different assemblies/methods.
+            // The implementation caches loaded assemblies internally - loading the same assembly
+            // multiple times will only load it once and reuse it.
+            // However, components should avoid relying on this caching behavior and should not
+            // maintain global state, as this can lead to ordering issues and side effects.
+
+            // The returned function pointer has process lifetime and can be called multiple times.
+            // Currently there is no way to unload components or free the function pointer.
+            // This capability may be added in future releases.
+
+            int rc = load_fn(
+                to_native_path(path_.c_str()).c_str(),
+                to_native_path(type_name).c_str(),
+                to_native_path(method_name).c_str(),
+                UNMANAGEDCALLERSONLY_METHOD,
+                nullptr,
+                delegate);
+
+            if (rc != 0 || !*delegate)
+            {
+                log_error("Failed to load assembly and get delegate", rc);
+                return DotNetErrors::map_error(rc);
+            }
+
+            loaded_ = true;
+            log_info("Successfully loaded delegate");
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 在插件的加载上下文中构造类型的实例，返回固定它的 GCHandle
+         */
+        NativeHostStatus create_object(const char *type_name, void **object)
+        {
+            if (kind_ != AssemblyKind::Managed)
+            {
+                log_error("Plugin objects require an in-process managed assembly");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+            if (!Runtime::instance().is_initialized())
+            {
+                log_error("Runtime not initialized");
+                return NativeHostStatus::ERROR_RUNTIME_INIT;
+            }
+
+            auto create = Runtime::instance().plugin_objects().create;
+            if (!create)
+            {
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            *object = nullptr;
+            int32_t rc = create(plugin_id_, type_name, object);
+            if (rc != 0 || !*object)
+            {
+                log_error("Failed to create object of type " + std::string(type_name), rc);
+                return rc != 0 ? static_cast<NativeHostStatus>(rc) : NativeHostStatus::ERROR_TYPE_LOAD;
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus get_method(
+            const char *type_name,
+            const char *method_name,
+            const char *signature_text,
+            const Signatures::Signature &signature,
+            Method **method)
+        {
+            Timeline::Span span("resolve_method", "type", type_name, "method", method_name);
+
+            auto result = std::make_unique<Method>();
+            result->signature = signature;
+            result->calls = &calls_;
+
+            NativeHostStatus status;
+            if (kind_ == AssemblyKind::Isolated && signature.async)
+            {
+                // 完成回调不能跨进程调用
+                log_error("Isolated assemblies do not support async methods");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+            if (kind_ == AssemblyKind::Isolated)
+            {
+                result->process = process_;
+                status = process_->get_method(remote_id_, type_name, method_name, signature_text, &result->remote_id);
+            }
+            else
+            {
+                status = get_delegate(type_name, method_name, &result->fn);
+            }
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            *method = result.get();
+            methods_.push_back(std::move(result));
+            return NativeHostStatus::SUCCESS;
+        }
+
+        void record_call(bool sampled, uint64_t cpu_time_ns, uint64_t allocated_bytes)
+        {
+            stats_.invocations.fetch_add(1, std::memory_order_relaxed);
+            if (sampled)
+            {
+                stats_.sampled_invocations.fetch_add(1, std::memory_order_relaxed);
+                stats_.cpu_time_ns.fetch_add(cpu_time_ns, std::memory_order_relaxed);
+                stats_.allocated_bytes.fetch_add(allocated_bytes, std::memory_order_relaxed);
+            }
+        }
+
+        void get_stats(native_assembly_stats_t *stats) const
+        {
+            stats->invocations = stats_.invocations.load(std::memory_order_relaxed);
+            stats->sampled_invocations = stats_.sampled_invocations.load(std::memory_order_relaxed);
+            stats->cpu_time_ns = stats_.cpu_time_ns.load(std::memory_order_relaxed);
+            stats->allocated_bytes = stats_.allocated_bytes.load(std::memory_order_relaxed);
+            // 运行时不提供按加载上下文划分的堆占用
+            stats->retained_bytes = -1;
+        }
+
+        CallTracker &calls() { return calls_; }
+        bool is_loaded() const { return loaded_; }
+        AssemblyKind kind() const { return kind_; }
+        const std::string &path() const { return path_; }
+    };
+
+    /**
+     * @brief 进程内的运行时事件跟踪
+     *
+     * 事件由支持程序集中的监听器订阅并按方法汇总；需要 .nettrace 文件时，
+     * 另外通过诊断端口启动一个录制会话。调用方需持有主机锁。
+     */
+    class Tracing
+    {
+        using start_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(uint32_t keywords);
+        using stop_fn = void(CORECLR_DELEGATE_CALLTYPE *)();
+        using get_method_stats_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(
+            const char *type_name, const char *method_name, native_method_trace_stats_t *stats);
+        using get_summary_fn = int32_t(CORECLR_DELEGATE_CALLTYPE *)(native_trace_summary_t *summary);
+
+        static constexpr const char *trace_type = "PluginSupport.RuntimeTrace";
+        static constexpr const char *runtime_provider = "Microsoft-Windows-DotNETRuntime";
+        static constexpr uint32_t verbose_level = 5;
+
+        start_fn start_ = nullptr;
+        stop_fn stop_ = nullptr;
+        get_method_stats_fn get_method_stats_ = nullptr;
+        get_summary_fn get_summary_ = nullptr;
+        std::unique_ptr<DiagnosticsIpc::TraceSession> recording_;
+        bool started_ = false;
+
+        NativeHostStatus resolve()
+        {
+            if (start_)
+            {
+                return NativeHostStatus::SUCCESS;
+            }
+
+            auto &runtime = Runtime::instance();
+            if (!runtime.is_initialized())
+            {
+                log_error("Runtime not initialized");
+                return NativeHostStatus::ERROR_RUNTIME_INIT;
+            }
+
+            auto start = (start_fn)runtime.get_support_function(trace_type, "Start");
+            auto stop = (stop_fn)runtime.get_support_function(trace_type, "Stop");
+            auto get_method_stats = (get_method_stats_fn)runtime.get_support_function(trace_type, "GetMethodStats");
+            auto get_summary = (get_summary_fn)runtime.get_support_function(trace_type, "GetSummary");
+            if (!start || !stop || !get_method_stats || !get_summary)
+            {
+                log_error("Runtime tracing requires the support assembly");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            start_ = start;
+            stop_ = stop;
+            get_method_stats_ = get_method_stats;
+            get_summary_ = get_summary;
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 录制文件使用与监听器相同的运行时关键字
+         */
+        static uint64_t runtime_keywords(uint32_t keywords)
+        {
+            uint64_t result = 0;
+            if (keywords & NATIVE_TRACE_JIT)
+            {
+                result |= 0x10 | 0x1000000000; // Jit | TieredCompilation
+            }
+            if (keywords & NATIVE_TRACE_LOADER)
+            {
+                result |= 0x8 | 0x8000000000; // Loader | TypeDiagnostic
+            }
+            if (keywords & NATIVE_TRACE_GC)
+            {
+                result |= 0x1; // GC
+            }
+            return result;
+        }
+
+    public:
+        ~Tracing() { stop(); }
+
+        NativeHostStatus start(const native_trace_options_t *options)
+        {
+            auto status = resolve();
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            uint32_t keywords = options && options->keywords ? options->keywords
+                                                             : NATIVE_TRACE_JIT | NATIVE_TRACE_LOADER | NATIVE_TRACE_GC;
+            stop();
+
+            if (options && options->output_path)
+            {
+                auto recording = std::make_unique<DiagnosticsIpc::TraceSession>();
+                std::string error;
+                if (!recording->start({{runtime_provider, runtime_keywords(keywords), verbose_level}},
+                                      std::filesystem::absolute(options->output_path), error))
+                {
+                    log_error("Failed to start trace recording: " + error);
+                    return NativeHostStatus::ERROR_NOT_SUPPORTED;
+                }
+                recording_ = std::move(recording);
+            }
+
+            start_(keywords);
+            started_ = true;
+            log_info("Runtime tracing started");
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus stop()
+        {
+            if (stop_)
+            {
+                stop_();
+            }
+            // 等待运行时写完剩余事件（含 rundown），文件在返回时完整
+            recording_.reset();
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus get_method_stats(const char *type_name, const char *method_name, native_method_trace_stats_t *stats)
+        {
+            if (!started_)
+            {
+                log_error("No runtime trace has been started");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+            return get_method_stats_(type_name, method_name, stats) == 0 ? NativeHostStatus::SUCCESS
+                                                                          : NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        NativeHostStatus get_summary(native_trace_summary_t *summary)
+        {
+            if (!started_)
+            {
+                log_error("No runtime trace has been started");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+            return get_summary_(summary) == 0 ? NativeHostStatus::SUCCESS : NativeHostStatus::ERROR_INVALID_ARG;
+        }
+    };
+
+    /**
+     * @brief 数据并行调用的工作线程池
+     *
+     * 每次调用的区间先按参与线程数均分到各线程的槽位。线程从自己槽位的头部取剩余量的 1/8 作为分块
+     * （不小于最小分块），开始时调用次数少，接近结束时分块变小；自己的槽位取完后从剩余最多的槽位尾部
+     * 窃取一半，慢线程剩下的工作由空闲线程分担。槽位只在取分块和窃取时短暂加锁，内核调用不持有锁。
+     */
+    class ParallelPool
+    {
+    public:
+        using kernel_fn = void(CORECLR_DELEGATE_CALLTYPE *)(int64_t begin, int64_t end, void *context);
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::mutex mutex;
+            // 在 mutex 下修改；窃取方选择目标时不加锁读取
+            std::atomic<int64_t> begin{0};
+            std::atomic<int64_t> end{0};
+
+            int64_t remaining() const
+            {
+                return end.load(std::memory_order_relaxed) - begin.load(std::memory_order_relaxed);
+            }
+        };
+
+        struct Job
+        {
+            kernel_fn kernel = nullptr;
+            void *context = nullptr;
+            int64_t grain = 1;
+            Assembly *assembly = nullptr;
+            native_parallel_callback_t on_completed = nullptr;
+            void *user_data = nullptr;
+            uint32_t first_worker_slot = 0; ///< 同步调用时槽位 0 属于调用线程
+            uint32_t worker_count = 0;      ///< 参与的工作线程数，编号更大的工作线程跳过此调用
+            uint32_t slot_count = 0;
+            std::unique_ptr<Slot[]> slots;
+            std::atomic<int64_t> pending{0}; ///< 尚未处理完的下标个数
+
+            std::mutex done_mutex;
+            std::condition_variable done_cv;
+            bool done = false;
+        };
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable idle_;
+        std::deque<std::shared_ptr<Job>> jobs_;
+        uint32_t incomplete_ = 0;
+        bool stopping_ = false;
+        std::vector<std::thread> threads_;
+
+        static bool take_chunk(Job &job, Slot &slot, int64_t &begin, int64_t &end)
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            int64_t first = slot.begin.load(std::memory_order_relaxed);
+            int64_t remaining = slot.end.load(std::memory_order_relaxed) - first;
+            if (remaining <= 0)
+            {
+                return false;
+            }
+            int64_t length = std::min(remaining, std::max(job.grain, remaining / 8));
+            begin = first;
+            end = first + length;
+            slot.begin.store(end, std::memory_order_relaxed);
+            return true;
+        }
+
+        static bool steal(Job &job, uint32_t self)
+        {
+            for (;;)
+            {
+                uint32_t victim = job.slot_count;
+                int64_t most = 0;
+                for (uint32_t i = 0; i < job.slot_count; ++i)
+                {
+                    int64_t remaining = job.slots[i].remaining();
+                    if (i != self && remaining > most)
+                    {
+                        victim = i;
+                        most = remaining;
+                    }
+                }
+                if (victim == job.slot_count)
+                {
+                    return false;
+                }
+
+                int64_t begin = 0;
+                int64_t end = 0;
+                {
+                    Slot &slot = job.slots[victim];
+                    std::lock_guard<std::mutex> lock(slot.mutex);
+                    end = slot.end.load(std::memory_order_relaxed);
+                    int64_t remaining = end - slot.begin.load(std::memory_order_relaxed);
+                    if (remaining <= 0)
+                    {
+                        continue;
+                    }
+                    begin = end - (remaining > job.grain ? remaining / 2 : remaining);
+                    slot.end.store(begin, std::memory_order_relaxed);
+                }
+
+                Slot &own = job.slots[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.begin.store(begin, std::memory_order_relaxed);
+                own.end.store(end, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        /**
+         * @brief 处理自己槽位中的分块并窃取其他槽位，直到所有槽位都已取完
+         *
+         * 返回时已取走的分块可能仍在其他线程上处理。
+         */
+        void run(Job &job, uint32_t self)
+        {
+            Slot &own = job.slots[self];
+            for (;;)
+            {
+                int64_t begin = 0;
+                int64_t end = 0;
+                if (take_chunk(job, own, begin, end))
+                {
+                    job.kernel(begin, end, job.context);
+                    if (job.pending.fetch_sub(end - begin, std::memory_order_acq_rel) == end - begin)
+                    {
+                        complete(job);
+                    }
+                }
+                else if (!steal(job, self))
+                {
+                    return;
+                }
+            }
+        }
+
+        static bool &worker_thread()
+        {
+            thread_local bool value = false;
+            return value;
+        }
+
+        void complete(Job &job)
+        {
+            // 先退出在途调用并结束计数，回调中可以卸载程序集，析构也不必等待回调返回
+            job.assembly->record_call(false, 0, 0);
+            job.assembly->calls().leave();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--incomplete_ == 0)
+                {
+                    idle_.notify_all();
+                }
+            }
+
+            // 之后不再访问线程池的成员，调用方只通过 job 的共享所有权访问 job
+            if (job.on_completed)
+            {
+                job.on_completed(job.user_data);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(job.done_mutex);
+                job.done = true;
+                job.done_cv.notify_all();
+            }
+        }
+
+        void worker_main(uint32_t index)
+        {
+            // 线程第一次调用托管代码时附加到运行时，在这里先付出这次开销
+            Accounting::current_allocated_bytes();
+            worker_thread() = true;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;)
+            {
+                std::shared_ptr<Job> job;
+                wake_.wait(lock, [&]()
+                           {
+                               for (const auto &candidate : jobs_)
+                               {
+                                   if (index < candidate->worker_count)
+                                   {
+                                       job = candidate;
+                                       return true;
+                                   }
+                               }
+                               return stopping_; });
+                if (!job)
+                {
+                    return;
+                }
+
+                lock.unlock();
+                run(*job, job->first_worker_slot + index);
+                lock.lock();
+
+                // 所有槽位都已取完，之后醒来的线程不再参与
+                auto it = std::find(jobs_.begin(), jobs_.end(), job);
+                if (it != jobs_.end())
+                {
+                    jobs_.erase(it);
+                }
+            }
+        }
+
+    public:
+        explicit ParallelPool(uint32_t thread_count)
+        {
+            for (uint32_t i = 0; i < thread_count; ++i)
+            {
+                try
+                {
+                    threads_.emplace_back(&ParallelPool::worker_main, this, i);
+                }
+                catch (const std::system_error &)
+                {
+                    break;
+                }
+            }
+            log_info("Parallel pool started with " + std::to_string(threads_.size()) + " threads");
+        }
+
+        /**
+         * @brief 等待未完成的调用后停止工作线程
+         */
+        ~ParallelPool()
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                idle_.wait(lock, [&]()
+                           { return incomplete_ == 0; });
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto &thread : threads_)
+            {
+                thread.join();
+            }
+        }
+
+        uint32_t thread_count() const { return static_cast<uint32_t>(threads_.size()); }
+
+        /**
+         * @brief 当前线程是否为线程池的工作线程，完成回调在工作线程上不能销毁线程池
+         */
+        static bool on_worker_thread() { return worker_thread(); }
+
+        /**
+         * @brief 登记一次即将开始的并行调用，析构等待它完成
+         *
+         * 调用方持有主机锁，与销毁主机互斥，之后必须调用 parallel_for。
+         */
+        void reserve()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++incomplete_;
+        }
+
+        /**
+         * @brief 执行一次已通过 reserve 登记的并行调用
+         *
+         * 调用方已进入 assembly 的在途调用，最后一个分块处理完后由本函数退出。
+         */
+        void parallel_for(
+            Assembly *assembly,
+            kernel_fn kernel,
+            int64_t begin,
+            int64_t end,
+            void *context,
+            const native_parallel_options_t *options)
+        {
+            native_parallel_options_t defaults{};
+            if (!options)
+            {
+                options = &defaults;
+            }
+
+            auto job = std::make_shared<Job>();
+            job->kernel = kernel;
+            job->context = context;
+            job->assembly = assembly;
+            job->on_completed = options->on_completed;
+            job->user_data = options->user_data;
+
+            // 同步调用时调用线程占一个槽位；参与的线程不超过最小分块的个数。
+            // 没有工作线程时异步调用也在调用线程上完成
+            bool async = options->on_completed != nullptr && thread_count() > 0;
+            int64_t count = end - begin;
+            uint64_t limit = options->max_threads ? options->max_threads : thread_count() + 1;
+            uint64_t participants = std::min<uint64_t>(limit, async ? thread_count() : thread_count() + 1);
+            if (options->min_chunk > 0)
+            {
+                participants = std::min<uint64_t>(participants, (count + options->min_chunk - 1) / options->min_chunk);
+            }
+            participants = std::max<uint64_t>(participants, 1);
+            job->grain = options->min_chunk > 0
+                             ? options->min_chunk
+                             : std::max<int64_t>(1, count / static_cast<int64_t>(participants * 128));
+
+            job->first_worker_slot = async ? 0 : 1;
+            job->worker_count = static_cast<uint32_t>(participants) - job->first_worker_slot;
+            job->slot_count = static_cast<uint32_t>(participants);
+            job->slots.reset(new Slot[job->slot_count]);
+            int64_t share = count / job->slot_count;
+            int64_t extra = count % job->slot_count;
+            int64_t next = begin;
+            for (uint32_t i = 0; i < job->slot_count; ++i)
+            {
+                job->slots[i].begin.store(next, std::memory_order_relaxed);
+                next += share + (static_cast<int64_t>(i) < extra ? 1 : 0);
+                job->slots[i].end.store(next, std::memory_order_relaxed);
+            }
+            job->pending.store(count, std::memory_order_relaxed);
+
+            bool enqueue = count > 0 && job->worker_count > 0;
+            if (enqueue)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                jobs_.push_back(job);
+            }
+
+            if (count == 0)
+            {
+                // 空区间直接完成，异步调用在此处回调
+                complete(*job);
+                return;
+            }
+            if (enqueue)
+            {
+                wake_.notify_all();
+            }
+            if (async)
+            {
+                return;
+            }
+
+            run(*job, 0);
+            if (job->on_completed)
+            {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(job->done_mutex);
+            job->done_cv.wait(lock, [&]()
+                              { return job->done; });
+        }
+    };
+
+    /**
+     * @brief 本机主机实现
+     *
+     * 本机托管接口的核心实现。管理.NET运行时和已加载程序集的生命周期。
+     *
+     * 设计模式：
+     * - 单例模式用于全局主机实例
+     */
+    class Host
+    {
+        // 辅助进程必须比其中加载的程序集活得更久
+        std::unique_ptr<IsolatedProcess> isolated_;
+        std::unordered_map<native_assembly_handle_t, std::unique_ptr<Assembly>> assemblies_;
+        // 已卸载但仍有在途调用的程序集，静止后关闭
+        std::vector<std::unique_ptr<Assembly>> retired_;
+        // 已关闭的程序集，保留到主机销毁，使已卸载的句柄仍可安全地进入调用作用域
+        std::vector<std::unique_ptr<Assembly>> closed_;
+        std::unordered_map<native_bundle_handle_t, std::unique_ptr<Bundle>> bundles_;
+        std::unordered_map<native_catalog_handle_t, std::unique_ptr<Catalog>> catalogs_;
+        native_isolation_mode_t isolation_ = NATIVE_ISOLATION_NONE;
+        Tracing tracing_;
+        bool initialized_ = false;
+        bool lazy_binding_ = false;
+        native_lazy_binding_options_t lazy_options_{};
+        // 尚未释放的插件对象及其所属程序集，释放时校验，避免把无效或已释放的句柄交给运行时
+        std::unordered_map<native_object_handle_t, native_assembly_handle_t> objects_;
+        std::unordered_map<native_channel_handle_t, std::unique_ptr<EventChannel::Channel>> channels_;
+        // 在首次并行调用时创建，先于程序集销毁
+        std::unique_ptr<ParallelPool> parallel_;
+
+        NativeHostStatus start_isolated_process()
+        {
+            if (isolated_)
+            {
+                return NativeHostStatus::SUCCESS;
+            }
+
+            auto process = std::make_unique<IsolatedProcess>();
+            if (!process->start())
+            {
+                log_error("Failed to start isolation worker");
+                return NativeHostStatus::ERROR_RUNTIME_INIT;
+            }
+            isolated_ = std::move(process);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 检查路径并加载程序集，不修改程序集表
+         *
+         * 只读取主机状态，批量加载时在多个工作线程上并发调用。
+         * 隔离模式下调用前需要先启动辅助进程。
+         */
+        NativeHostStatus open_assembly(const char *path, std::unique_ptr<Assembly> &result)
+        {
+            Timeline::Span span("load_assembly", "path", path);
+
+            // Check if assembly file exists
+            if (!std::filesystem::exists(path))
+            {
+                log_error("Assembly file not found: " + std::string(path));
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            if (isolation_ == NATIVE_ISOLATION_PROCESS)
+            {
+                uint32_t remote_id = 0;
+                auto status = isolated_->load_assembly(std::filesystem::absolute(path).string(), &remote_id);
+                if (status != NativeHostStatus::SUCCESS)
+                {
+                    log_error("Failed to load isolated assembly: " + std::string(path));
+                    return status;
+                }
+
+                result = std::make_unique<Assembly>(path, AssemblyKind::Isolated);
+                result->attach_isolated(isolated_.get(), remote_id);
+                return NativeHostStatus::SUCCESS;
+            }
+
+            // NativeAOT 库自带运行时，不需要初始化 CoreCLR
+            auto kind = detect_assembly_kind(to_native_path(path));
+            if (kind == AssemblyKind::Managed && !initialized_)
+            {
+                log_error("Runtime not initialized");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_INITIALIZED;
+            }
+
+            auto assembly = std::make_unique<Assembly>(path, kind);
+            if (kind == AssemblyKind::NativeAot && !assembly->load_native_library())
+            {
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+            if (kind == AssemblyKind::Managed)
+            {
+                auto status = assembly->load_managed();
+                if (status != NativeHostStatus::SUCCESS)
+                {
+                    return status;
+                }
+            }
+
+            result = std::move(assembly);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 解析批量加载中属于同一程序集的入口点
+         */
+        static void resolve_entry_points(
+            Assembly &assembly,
+            native_entry_point_t *entry_points,
+            const std::vector<uint32_t> &indices)
+        {
+            for (auto index : indices)
+            {
+                auto &entry = entry_points[index];
+                entry.function = nullptr;
+                if (!entry.type_name || !entry.method_name)
+                {
+                    entry.status = NativeHostStatus::ERROR_INVALID_ARG;
+                    continue;
+                }
+                entry.status = assembly.get_delegate(entry.type_name, entry.method_name, &entry.function);
+                if (entry.status == NativeHostStatus::SUCCESS && Profiling::enabled())
+                {
+                    entry.function = Profiling::instrument(&assembly, entry.type_name, entry.method_name, entry.function);
+                }
+            }
+        }
+
+    public:
+        NativeHostStatus initialize_runtime(const native_host_runtime_options_t *options = nullptr)
+        {
+            Timeline::Span span("initialize");
+            if (initialized_)
+            {
+                log_info("Runtime already initialized");
+                return register_services(options);
+            }
+
+            if (!Runtime::instance().initialize(options))
+            {
+                log_error("Failed to initialize runtime");
+                return NativeHostStatus::ERROR_RUNTIME_INIT;
+            }
+
+            auto status = register_services(options);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            auto support_start = Timeline::clock::now();
+            // 分配字节统计依赖支持程序集，不可用时只统计调用次数和 CPU 时间
+            auto allocated_bytes_fn = (Accounting::allocated_bytes_fn)
+                Runtime::instance().get_support_function("PluginSupport.HostDiagnostics", "GetAllocatedBytesForCurrentThread");
+            Accounting::allocated_bytes.store(allocated_bytes_fn, std::memory_order_release);
+
+            // 插件通过 PluginSupport.HostArena 从宿主分配区返回变长结果
+            using register_arena_fn = void(CORECLR_DELEGATE_CALLTYPE *)(void *try_allocate, void *allocate);
+            auto register_arena = (register_arena_fn)
+                Runtime::instance().get_support_function("PluginSupport.HostArena", "Register");
+            if (register_arena)
+            {
+                register_arena(reinterpret_cast<void *>(&Arena::try_allocate_for_managed),
+                               reinterpret_cast<void *>(&Arena::allocate_for_managed));
+            }
+            Timeline::record("register_support", support_start);
+
+            initialized_ = true;
+            log_info("Host runtime initialized successfully");
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus register_services(const native_host_runtime_options_t *options)
+        {
+            if (!options || options->service_count == 0)
+            {
+                return NativeHostStatus::SUCCESS;
+            }
+            if (!Runtime::instance().register_services(options->services, options->service_count))
+            {
+                return NativeHostStatus::ERROR_RUNTIME_INIT;
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus load_assembly(const char *path, native_assembly_handle_t *handle)
+        {
+            if (!path || !handle)
+            {
+                log_error("Invalid arguments for load_assembly");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            if (isolation_ == NATIVE_ISOLATION_PROCESS)
+            {
+                auto status = start_isolated_process();
+                if (status != NativeHostStatus::SUCCESS)
+                {
+                    return status;
+                }
+            }
+
+            std::unique_ptr<Assembly> assembly;
+            auto status = open_assembly(path, assembly);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            *handle = assembly.get();
+            assemblies_[*handle] = std::move(assembly);
+            log_info("Assembly loaded successfully: " + std::string(path));
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 在工作线程池上并发加载多个程序集
+         *
+         * 调用方持有主机锁，工作线程之间只通过 table_mutex 共享程序集表。
+         * 惰性解析的共享状态（辅助进程、支持程序集中的加载入口）在启动工作线程前准备好。
+         */
+        NativeHostStatus load_assemblies(
+            const char *const *paths,
+            uint32_t count,
+            native_assembly_handle_t *handles,
+            NativeHostStatus *statuses,
+            const native_bulk_load_options_t *options)
+        {
+            native_bulk_load_options_t defaults{};
+            if (!options)
+            {
+                options = &defaults;
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                handles[i] = nullptr;
+                statuses[i] = NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            if (isolation_ == NATIVE_ISOLATION_PROCESS)
+            {
+                auto status = start_isolated_process();
+                if (status != NativeHostStatus::SUCCESS)
+                {
+                    std::fill(statuses, statuses + count, status);
+                    return status;
+                }
+            }
+            if (initialized_)
+            {
+                Runtime::instance().plugin_loader();
+            }
+
+            // 按程序集分组入口点，每个工作线程只写入自己程序集的入口点
+            std::vector<std::vector<uint32_t>> entry_points(count);
+            for (uint32_t i = 0; i < options->entry_point_count; ++i)
+            {
+                auto &entry = options->entry_points[i];
+                entry.function = nullptr;
+                if (entry.assembly_index < count)
+                {
+                    entry.status = NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+                    entry_points[entry.assembly_index].push_back(i);
+                }
+                else
+                {
+                    entry.status = NativeHostStatus::ERROR_INVALID_ARG;
+                }
+            }
+
+            std::atomic<uint32_t> next{0};
+            std::mutex table_mutex;
+            auto work = [&]()
+            {
+                for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+                {
+                    std::unique_ptr<Assembly> assembly;
+                    auto status = paths[i] ? open_assembly(paths[i], assembly) : NativeHostStatus::ERROR_INVALID_ARG;
+                    native_assembly_handle_t handle = nullptr;
+                    if (status == NativeHostStatus::SUCCESS)
+                    {
+                        resolve_entry_points(*assembly, options->entry_points, entry_points[i]);
+                        handle = assembly.get();
+                        std::lock_guard<std::mutex> lock(table_mutex);
+                        assemblies_[handle] = std::move(assembly);
+                    }
+
+                    handles[i] = handle;
+                    statuses[i] = status;
+                    if (options->on_loaded)
+                    {
+                        options->on_loaded(options->user_data, i, handle, status);
+                    }
+                }
+            };
+
+            uint32_t thread_count = options->max_threads ? options->max_threads : std::thread::hardware_concurrency();
+            thread_count = std::max(1u, std::min(thread_count, count));
+
+            // 调用线程也参与加载；创建线程失败时由已有线程完成剩余的程序集
+            std::vector<std::thread> workers;
+            for (uint32_t i = 1; i < thread_count; ++i)
+            {
+                try
+                {
+                    workers.emplace_back(work);
+                }
+                catch (const std::system_error &)
+                {
+                    break;
+                }
+            }
+            work();
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+
+            log_info("Bulk load finished: " + std::to_string(count) + " assemblies on " +
+                     std::to_string(workers.size() + 1) + " threads");
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (statuses[i] != NativeHostStatus::SUCCESS)
+                {
+                    return statuses[i];
+                }
+            }
+            for (uint32_t i = 0; i < options->entry_point_count; ++i)
+            {
+                if (options->entry_points[i].status != NativeHostStatus::SUCCESS)
+                {
+                    return options->entry_points[i].status;
+                }
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 从内存镜像加载托管程序集
+         *
+         * @param name 程序集的显示名称，用于日志和加载上下文的名称
+         * @param key 去重键，可以为空
+         * @param bundle 镜像所在的插件包，可以为空
+         */
+        NativeHostStatus load_image(
+            const void *image,
+            size_t size,
+            const std::string &name,
+            const std::string &key,
+            Bundle *bundle,
+            native_assembly_handle_t *handle)
+        {
+            Timeline::Span span("load_assembly", "name", name.c_str());
+
+            if (isolation_ == NATIVE_ISOLATION_PROCESS)
+            {
+                log_error("Isolated assemblies must be loaded from a path");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+            if (detect_assembly_kind(image, size) != AssemblyKind::Managed)
+            {
+                // 本机库只能由系统加载器从文件加载
+                log_error("NativeAOT libraries cannot be loaded from memory: " + name);
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+            if (!initialized_)
+            {
+                log_error("Runtime not initialized");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_INITIALIZED;
+            }
+
+            if (bundle)
+            {
+                bundle->pin();
+            }
+
+            auto assembly = std::make_unique<Assembly>(name.c_str(), AssemblyKind::Managed);
+            auto status = assembly->load_managed_image(image, size, key, bundle);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            *handle = assembly.get();
+            assemblies_[*handle] = std::move(assembly);
+            log_info("Assembly loaded from memory: " + name);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus open_bundle(const char *path, native_bundle_handle_t *handle)
+        {
+            auto bundle = std::make_unique<Bundle>(path);
+            auto status = bundle->open();
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            *handle = bundle.get();
+            bundles_[*handle] = std::move(bundle);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 释放插件包，已提供过镜像的插件包保留到进程结束
+         *
+         * 加载上下文不可卸载，且相同键的插件在主机之间共享，依赖解析回调可能在主机销毁后仍被调用。
+         * 调用方持有 g_mutex。
+         */
+        static void release_bundle(std::unique_ptr<Bundle> bundle)
+        {
+            if (bundle->pinned())
+            {
+                static auto *retained = new std::vector<std::unique_ptr<Bundle>>();
+                retained->push_back(std::move(bundle));
+            }
+        }
+
+        NativeHostStatus close_bundle(native_bundle_handle_t handle)
+        {
+            auto it = bundles_.find(handle);
+            if (it == bundles_.end())
+            {
+                log_error("Bundle not found for close");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+            release_bundle(std::move(it->second));
+            bundles_.erase(it);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 登记已完成发现的目录，扫描本身在主机锁外进行
+         */
+        native_catalog_handle_t add_catalog(std::unique_ptr<Catalog> catalog)
+        {
+            native_catalog_handle_t handle = catalog.get();
+            catalogs_[handle] = std::move(catalog);
+            return handle;
+        }
+
+        NativeHostStatus get_catalog_info(native_catalog_handle_t handle, native_plugin_catalog_info_t *info)
+        {
+            auto it = catalogs_.find(handle);
+            if (it == catalogs_.end())
+            {
+                log_error("Catalog not found for get_catalog_info");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+            it->second->info(info);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus close_catalog(native_catalog_handle_t handle)
+        {
+            if (catalogs_.erase(handle) == 0)
+            {
+                log_error("Catalog not found for close");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus get_bundle_entries(
+            native_bundle_handle_t handle,
+            const char **names,
+            uint32_t capacity,
+            uint32_t *count)
+        {
+            auto it = bundles_.find(handle);
+            if (it == bundles_.end())
+            {
+                log_error("Bundle not found for get_bundle_entries");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            const auto &entries = it->second->names();
+            *count = static_cast<uint32_t>(entries.size());
+            for (uint32_t i = 0; names && i < capacity && i < entries.size(); ++i)
+            {
+                names[i] = entries[i].c_str();
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus load_assembly_from_bundle(
+            native_bundle_handle_t handle,
+            const char *name,
+            native_assembly_handle_t *assembly)
+        {
+            auto it = bundles_.find(handle);
+            if (it == bundles_.end())
+            {
+                log_error("Bundle not found for load_assembly_from_bundle");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            auto *bundle = it->second.get();
+            const void *image = nullptr;
+            uint64_t size = 0;
+            if (!bundle->find(name, &image, &size))
+            {
+                log_error("Image not found in bundle " + bundle->path() + ": " + name);
+                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
+            }
+
+            // 同一插件包中的同一条目只加载一次，与按路径加载的行为一致
+            auto display_name = bundle->path() + "!" + name;
+            auto key = std::filesystem::absolute(bundle->path()).u8string() + "!" + name;
+            return load_image(image, static_cast<size_t>(size), display_name, key, bundle, assembly);
+        }
+
+        /**
+         * @brief 关闭已退役且没有在途调用的程序集
+         *
+         * 先释放该程序集创建的、调用方仍未释放的插件对象：程序集卸载后这些对象已无法使用，
+         * 它们的 GCHandle 却会让对象及其持有的资源一直存活到主机销毁。加载上下文本身不会被卸载。
+         */
+        void close_retired(std::unique_ptr<Assembly> assembly)
+        {
+            std::vector<native_object_handle_t> owned;
+            for (auto it = objects_.begin(); it != objects_.end();)
+            {
+                if (it->second == assembly.get())
+                {
+                    owned.push_back(it->first);
+                    it = objects_.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            if (!owned.empty())
+            {
+                log_info("Releasing " + std::to_string(owned.size()) + " plugin objects of unloaded assembly: " + assembly->path());
+                Runtime::instance().plugin_objects().release(owned.data(), static_cast<int32_t>(owned.size()));
+            }
+            assembly->close();
+            closed_.push_back(std::move(assembly));
+        }
+
+        /**
+         * @brief 关闭已没有在途调用的退役程序集
+         */
+        void reclaim_retired()
+        {
+            auto quiescent = std::stable_partition(retired_.begin(), retired_.end(),
+                                                   [](const std::unique_ptr<Assembly> &assembly)
+                                                   { return !assembly->calls().quiescent(); });
+            for (auto it = quiescent; it != retired_.end(); ++it)
+            {
+                close_retired(std::move(*it));
+            }
+            retired_.erase(quiescent, retired_.end());
+        }
+
+        NativeHostStatus unload_assembly(native_assembly_handle_t handle)
+        {
+            if (!handle)
+            {
+                log_error("Invalid handle for unload_assembly");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto it = assemblies_.find(handle);
+            if (it == assemblies_.end())
+            {
+                log_error("Assembly not found for unload");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            auto assembly = std::move(it->second);
+            assemblies_.erase(it);
+            LazyBinding::orphan(handle);
+            assembly->calls().retire();
+            if (assembly->calls().quiescent())
+            {
+                close_retired(std::move(assembly));
+            }
+            else
+            {
+                log_info("Assembly has calls in flight, deferring destruction: " + assembly->path());
+                retired_.push_back(std::move(assembly));
+            }
+            reclaim_retired();
+
+            log_info("Assembly unloaded successfully");
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 退役程序集是否已关闭，仍未静止时尝试关闭
+         */
+        bool try_reclaim(native_assembly_handle_t handle)
+        {
+            reclaim_retired();
+            return std::none_of(retired_.begin(), retired_.end(),
+                                [handle](const std::unique_ptr<Assembly> &assembly) { return assembly.get() == handle; });
+        }
+
+        NativeHostStatus get_delegate(
+            native_assembly_handle_t handle,
+            const char *type_name,
+            const char *method_name,
+            void **delegate)
+        {
+            if (!handle || !type_name || !method_name)
+            {
+                log_error("Invalid arguments for get_delegate");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto it = assemblies_.find(handle);
+            if (it == assemblies_.end())
+            {
+                log_error("Assembly not found for get_delegate");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            // 进程内托管程序集延迟到首次调用才解析；NativeAOT 导出的查找本身只是一次符号查找
+            if (lazy_binding_ && it->second->kind() == AssemblyKind::Managed)
+            {
+                if (void *stub = LazyBinding::bind(handle, type_name, method_name, lazy_options_))
+                {
+                    *delegate = stub;
+                    return NativeHostStatus::SUCCESS;
+                }
+            }
+
+            return resolve_delegate(it->second.get(), type_name, method_name, delegate);
+        }
+
+        /**
+         * @brief 立即解析入口点，延迟绑定桩首次调用时也经由此处
+         */
+        NativeHostStatus resolve_delegate(
+            Assembly *assembly,
+            const char *type_name,
+            const char *method_name,
+            void **delegate)
+        {
+            auto status = assembly->get_delegate(type_name, method_name, delegate);
+            if (status == NativeHostStatus::SUCCESS && Profiling::enabled())
+            {
+                *delegate = Profiling::instrument(assembly, type_name, method_name, *delegate);
+            }
+            return status;
+        }
+
+        /**
+         * @brief 查找仍在加载中的程序集，已卸载时返回 nullptr
+         */
+        Assembly *find_assembly(native_assembly_handle_t handle)
+        {
+            auto it = assemblies_.find(handle);
+            return it == assemblies_.end() ? nullptr : it->second.get();
+        }
+
+        NativeHostStatus create_object(
+            native_assembly_handle_t handle,
+            const char *type_name,
+            native_object_handle_t *object)
+        {
+            if (!handle || !type_name || !object)
+            {
+                log_error("Invalid arguments for create_object");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto it = assemblies_.find(handle);
+            if (it == assemblies_.end())
+            {
+                log_error("Assembly not found for create_object");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            void *created = nullptr;
+            auto status = it->second->create_object(type_name, &created);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                return status;
+            }
+
+            objects_.emplace(created, handle);
+            *object = created;
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 释放一批插件对象，只要有一个句柄无效就都不释放
+         */
+        NativeHostStatus release_objects(const native_object_handle_t *objects, uint32_t count)
+        {
+            if (!objects && count > 0)
+            {
+                log_error("Invalid arguments for release_objects");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            // 逐个摘除，同一批中重复的句柄第二次摘除时失败
+            std::vector<native_assembly_handle_t> owners(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                auto it = objects_.find(objects[i]);
+                if (it == objects_.end())
+                {
+                    for (uint32_t j = 0; j < i; ++j)
+                    {
+                        objects_.emplace(objects[j], owners[j]);
+                    }
+                    log_error("Unknown or already released object in release_objects");
+                    return NativeHostStatus::ERROR_INVALID_ARG;
+                }
+                owners[i] = it->second;
+                objects_.erase(it);
+            }
+
+            if (count > 0)
+            {
+                Runtime::instance().plugin_objects().release(objects, static_cast<int32_t>(count));
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus create_channel(const native_channel_options_t *options, native_channel_handle_t *channel)
+        {
+            if (!channel)
+            {
+                log_error("Invalid arguments for create_channel");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            uint32_t capacity = options && options->capacity != 0 ? options->capacity : EventChannel::DEFAULT_CAPACITY;
+            if (capacity < EventChannel::MIN_CAPACITY || capacity > EventChannel::MAX_CAPACITY ||
+                (capacity & (capacity - 1)) != 0)
+            {
+                log_error("Channel capacity must be a power of two between 4 KiB and 1 GiB");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto created = std::make_unique<EventChannel::Channel>(capacity);
+            *channel = created->handle();
+            channels_.emplace(*channel, std::move(created));
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus close_channel(native_channel_handle_t channel)
+        {
+            if (channels_.erase(channel) == 0)
+            {
+                log_error("Unknown or already closed channel in close_channel");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus set_lazy_binding(const native_lazy_binding_options_t *options)
+        {
+            if (options && !LazyBinding::supported)
+            {
+                log_error("Lazy binding stubs are not supported on this platform");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            lazy_binding_ = options != nullptr;
+            lazy_options_ = options ? *options : native_lazy_binding_options_t{};
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus set_isolation(native_isolation_mode_t mode)
+        {
+            if (mode != NATIVE_ISOLATION_NONE && mode != NATIVE_ISOLATION_PROCESS)
+            {
+                log_error("Invalid isolation mode");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+            if (mode == NATIVE_ISOLATION_PROCESS && !IsolatedProcess::supported())
+            {
+                log_error("Process isolation is not supported on this platform");
+                return NativeHostStatus::ERROR_NOT_SUPPORTED;
+            }
+
+            isolation_ = mode;
+            return NativeHostStatus::SUCCESS;
+        }
+
+        NativeHostStatus get_method(
+            native_assembly_handle_t handle,
+            const char *type_name,
+            const char *method_name,
+            const char *signature_text,
+            native_method_handle_t *method)
+        {
+            Signatures::Signature signature;
+            if (!Signatures::parse(signature_text, signature))
+            {
+                log_error("Invalid method signature: " + std::string(signature_text));
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto it = assemblies_.find(handle);
+            if (it == assemblies_.end())
+            {
+                log_error("Assembly not found for get_method");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            Method *result = nullptr;
+            auto status = it->second->get_method(type_name, method_name, signature_text, signature, &result);
+            if (status == NativeHostStatus::SUCCESS)
+            {
+                *method = result;
+            }
+            return status;
+        }
+
+        NativeHostStatus get_assembly_stats(native_assembly_handle_t handle, native_assembly_stats_t *stats)
+        {
+            if (!handle || !stats)
+            {
+                log_error("Invalid arguments for get_assembly_stats");
+                return NativeHostStatus::ERROR_INVALID_ARG;
+            }
+
+            auto it = assemblies_.find(handle);
+            if (it == assemblies_.end())
+            {
+                log_error("Assembly not found for get_assembly_stats");
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            it->second->get_stats(stats);
+            return NativeHostStatus::SUCCESS;
+        }
+
+        /**
+         * @brief 销毁主机时仍在调用中的程序集不再释放，避免返回的线程访问已释放的计数
+         */
+        ~Host()
+        {
+            parallel_.reset();
+            if (!objects_.empty())
+            {
+                log_info("Releasing " + std::to_string(objects_.size()) + " plugin objects at host destruction");
+                std::vector<native_object_handle_t> remaining;
+                remaining.reserve(objects_.size());
+                for (const auto &entry : objects_)
+                {
+                    remaining.push_back(entry.first);
+                }
+                Runtime::instance().plugin_objects().release(remaining.data(), static_cast<int32_t>(remaining.size()));
+            }
+            for (auto &entry : assemblies_)
+            {
+                entry.second->calls().retire();
+                retired_.push_back(std::move(entry.second));
+            }
+            assemblies_.clear();
+            for (auto &entry : bundles_)
+            {
+                release_bundle(std::move(entry.second));
+            }
+
+            for (auto &assembly : retired_)
+            {
+                if (!assembly->calls().quiescent())
+                {
+                    log_error("Assembly still has calls in flight at host destruction, leaking: " + assembly->path());
+                    assembly.release();
+                }
+            }
+        }
+
+        Tracing &tracing() { return tracing_; }
+
+        ParallelPool &parallel_pool()
+        {
+            if (!parallel_)
+            {
+                // 同步调用时调用线程也参与
+                uint32_t hardware_threads = std::thread::hardware_concurrency();
+                parallel_ = std::make_unique<ParallelPool>(hardware_threads > 1 ? hardware_threads - 1 : 1);
+            }
+            return *parallel_;
+        }
+
+        size_t assembly_count() const { return assemblies_.size(); }
+        bool is_initialized() const { return initialized_; }
+    };
+
+    // 全局状态管理
+    std::unique_ptr<Host> g_host;
+    std::mutex g_mutex;
+
+    void *LazyBinding::resolve(Binding *binding)
+    {
+        std::unique_lock<std::mutex> binding_lock(binding->mutex);
+        // 并发的首次调用中只有一个解析，其余直接使用其结果
+        void *target = binding->slot->jump.load(std::memory_order_acquire);
+        if (target != resolver())
+        {
+            return target;
+        }
+
+        NativeHostStatus status;
+        native_assembly_handle_t handle;
+        {
+            Timeline::HostLock lock(g_mutex, "lazy_binding");
+            handle = binding->assembly;
+            Assembly *assembly = g_host && binding->assembly ? g_host->find_assembly(binding->assembly) : nullptr;
+            if (!g_host)
+            {
+                status = NativeHostStatus::ERROR_HOST_NOT_FOUND;
+            }
+            else if (!assembly)
+            {
+                status = NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+            else
+            {
+                status = g_host->resolve_delegate(assembly, binding->type_name.c_str(), binding->method_name.c_str(),
+                                                  &target);
+            }
+        }
+
+        if (status == NativeHostStatus::SUCCESS && target)
+        {
+            binding->slot->jump.store(target, std::memory_order_release);
+            return target;
+        }
+
+        log_error("Lazy binding failed for " + binding->type_name + "::" + binding->method_name);
+        // 处理函数可能再次调用主机接口，不持有任何锁
+        binding_lock.unlock();
+        void *replacement = nullptr;
+        if (binding->options.on_failure)
+        {
+            replacement = binding->options.on_failure(binding->options.user_data, handle,
+                                                      binding->type_name.c_str(), binding->method_name.c_str(),
+                                                      status == NativeHostStatus::SUCCESS
+                                                          ? NativeHostStatus::ERROR_DELEGATE_NOT_FOUND
+                                                          : status);
+        }
+        if (!replacement)
+        {
+            return reinterpret_cast<void *>(&native_host_lazy_unresolved);
+        }
+
+        void *expected = resolver();
+        binding->slot->jump.compare_exchange_strong(expected, replacement, std::memory_order_acq_rel);
+        return expected == resolver() ? replacement : expected;
+    }
+}
+
+/**
+ * @brief 公共API实现
+ *
+ * C风格接口实现，包装C++实现。
+ */
+extern "C"
+{
+    NATIVE_HOST_API NativeHostStatus native_host_create(native_host_handle_t *out_handle)
+    {
+        if (!out_handle)
+        {
+            log_error("Invalid out_handle for create");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (g_host)
+        {
+            log_error("Host already exists");
+            return NativeHostStatus::ERROR_HOST_ALREADY_EXISTS;
+        }
+
+        g_host = std::make_unique<Host>();
+        *out_handle = g_host.get();
+        log_info("Host created successfully");
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_destroy(native_host_handle_t handle)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for destroy");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        if (ParallelPool::on_worker_thread())
+        {
+            // 析构线程池需要等待并回收当前线程
+            log_error("Host cannot be destroyed from a parallel worker thread");
+            return NativeHostStatus::ERROR_NOT_SUPPORTED;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for destroy");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        g_host.reset();
+        Arena::check_leaks();
+        Profiling::detach();
+        LazyBinding::orphan(nullptr);
+        log_info("Host destroyed successfully");
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_initialize(native_host_handle_t handle)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for initialize");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for initialize");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->initialize_runtime();
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_initialize_with_options(
+        native_host_handle_t handle,
+        const native_host_runtime_options_t *caller_options)
+    {
+        // 按旧头文件编译的调用方传入较短的结构体，只复制其中的字段，其余保持默认
+        constexpr size_t min_options_size =
+            offsetof(native_host_runtime_options_t, runtime_config_path) + sizeof(const char *);
+        if (!handle || !caller_options || caller_options->struct_size < min_options_size)
+        {
+            log_error("Invalid arguments for initialize_with_options");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+        native_host_runtime_options_t copied{};
+        std::memcpy(&copied, caller_options, std::min<size_t>(caller_options->struct_size, sizeof(copied)));
+        copied.struct_size = sizeof(copied);
+        const auto *options = &copied;
+
+        if ((options->service_count > 0 && !options->services) ||
+            static_cast<uint32_t>(options->attach_mode) > NATIVE_RUNTIME_ATTACH_NEVER)
+        {
+            log_error("Invalid arguments for initialize_with_options");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for initialize_with_options");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->initialize_runtime(options);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_runtime_init_timings(
+        native_host_handle_t handle,
+        native_runtime_init_timings_t *timings)
+    {
+        if (!handle || !timings)
+        {
+            log_error("Invalid arguments for get_runtime_init_timings");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_runtime_init_timings");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        if (!g_host->is_initialized())
+        {
+            log_error("Runtime not initialized");
+            return NativeHostStatus::ERROR_RUNTIME_INIT;
+        }
+
+        *timings = Runtime::instance().timings();
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_runtime_attach_info(
+        native_host_handle_t handle,
+        native_runtime_attach_info_t *info)
+    {
+        if (!handle || !info)
+        {
+            log_error("Invalid arguments for get_runtime_attach_info");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_runtime_attach_info");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        if (!g_host->is_initialized())
+        {
+            log_error("Runtime not initialized");
+            return NativeHostStatus::ERROR_RUNTIME_INIT;
+        }
+
+        *info = Runtime::instance().attach_info();
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_load_assembly(
+        native_host_handle_t handle,
+        const char *path,
+        native_assembly_handle_t *assembly_handle)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for load");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for load");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->load_assembly(path, assembly_handle);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_load_assemblies(
+        native_host_handle_t handle,
+        const char *const *paths,
+        uint32_t count,
+        native_assembly_handle_t *assembly_handles,
+        NativeHostStatus *statuses,
+        const native_bulk_load_options_t *options)
+    {
+        if (!handle || (count > 0 && (!paths || !assembly_handles || !statuses)) ||
+            (options && options->entry_point_count > 0 && !options->entry_points))
+        {
+            log_error("Invalid arguments for load_assemblies");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for load_assemblies");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->load_assemblies(paths, count, assembly_handles, statuses, options);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_load_assembly_from_memory(
+        native_host_handle_t handle,
+        const void *image,
+        size_t size,
+        const char *name,
+        native_assembly_handle_t *assembly_handle)
+    {
+        if (!handle || !image || size == 0 || !name || !assembly_handle)
+        {
+            log_error("Invalid arguments for load_assembly_from_memory");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for load_assembly_from_memory");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->load_image(image, size, name, std::string(), nullptr, assembly_handle);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_open_bundle(
+        native_host_handle_t handle,
+        const char *path,
+        native_bundle_handle_t *bundle)
+    {
+        if (!handle || !path || !bundle)
+        {
+            log_error("Invalid arguments for open_bundle");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for open_bundle");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->open_bundle(path, bundle);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_bundle_entries(
+        native_host_handle_t handle,
+        native_bundle_handle_t bundle,
+        const char **names,
+        uint32_t capacity,
+        uint32_t *count)
+    {
+        if (!handle || !bundle || !count || (capacity > 0 && !names))
+        {
+            log_error("Invalid arguments for get_bundle_entries");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_bundle_entries");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->get_bundle_entries(bundle, names, capacity, count);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_load_assembly_from_bundle(
+        native_host_handle_t handle,
+        native_bundle_handle_t bundle,
+        const char *name,
+        native_assembly_handle_t *assembly_handle)
+    {
+        if (!handle || !bundle || !name || !assembly_handle)
+        {
+            log_error("Invalid arguments for load_assembly_from_bundle");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for load_assembly_from_bundle");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->load_assembly_from_bundle(bundle, name, assembly_handle);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_close_bundle(
+        native_host_handle_t handle,
+        native_bundle_handle_t bundle)
+    {
+        if (!handle || !bundle)
+        {
+            log_error("Invalid arguments for close_bundle");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for close_bundle");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->close_bundle(bundle);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_discover_plugins(
+        native_host_handle_t handle,
+        const native_discovery_options_t *options,
+        native_catalog_handle_t *catalog)
+    {
+        if (!handle || !options || !options->directory || !catalog)
+        {
+            log_error("Invalid arguments for discover_plugins");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        // 扫描目录、读取元数据和重写索引都不涉及主机状态，不持有主机锁，只在登记句柄时加锁
+        auto discovered = std::make_unique<Catalog>();
+        auto status = discovered->discover(*options);
+        if (status != NativeHostStatus::SUCCESS)
+        {
+            return status;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for discover_plugins");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        *catalog = g_host->add_catalog(std::move(discovered));
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_catalog_info(
+        native_host_handle_t handle,
+        native_catalog_handle_t catalog,
+        native_plugin_catalog_info_t *info)
+    {
+        if (!handle || !catalog || !info)
+        {
+            log_error("Invalid arguments for get_catalog_info");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_catalog_info");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->get_catalog_info(catalog, info);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_close_catalog(
+        native_host_handle_t handle,
+        native_catalog_handle_t catalog)
+    {
+        if (!handle || !catalog)
+        {
+            log_error("Invalid arguments for close_catalog");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for close_catalog");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->close_catalog(catalog);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_unload_assembly(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for unload");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for unload");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->unload_assembly(assembly);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_unload_assembly_wait(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly,
+        uint32_t timeout_ms)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for unload_assembly_wait");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        {
+            Timeline::HostLock lock(g_mutex, __func__);
+            if (!g_host || handle != g_host.get())
+            {
+                log_error("Host not found for unload_assembly_wait");
+                return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+            }
+
+            auto status = g_host->unload_assembly(assembly);
+            if (status != NativeHostStatus::SUCCESS || g_host->try_reclaim(assembly))
+            {
+                return status;
+            }
+        }
+
+        // 等待期间不持有主机锁，在途调用可以继续调用宿主接口
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        auto backoff = std::chrono::microseconds(50);
+        for (;;)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                log_error("Timed out waiting for calls in flight to finish");
+                return NativeHostStatus::ERROR_TIMEOUT;
+            }
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, std::chrono::microseconds(5000));
+
+            Timeline::HostLock lock(g_mutex, __func__);
+            // 主机已销毁时退役程序集随之处理
+            if (!g_host || handle != g_host.get() || g_host->try_reclaim(assembly))
+            {
+                return NativeHostStatus::SUCCESS;
+            }
+        }
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_delegate(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly,
+        const char *type_name,
+        const char *method_name,
+        void **delegate)
+    {
+        if (!handle || !assembly || !type_name || !method_name)
+        {
+            log_error("Invalid handle for get_delegate");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_delegate");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->get_delegate(assembly, type_name, method_name, delegate);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_set_lazy_binding(
+        native_host_handle_t handle,
+        const native_lazy_binding_options_t *options)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for set_lazy_binding");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for set_lazy_binding");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->set_lazy_binding(options);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_create_object(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly,
+        const char *type_name,
+        native_object_handle_t *object)
+    {
+        if (!handle || !assembly || !type_name || !object)
+        {
+            log_error("Invalid arguments for create_object");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for create_object");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->create_object(assembly, type_name, object);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_release_object(
+        native_host_handle_t handle,
+        native_object_handle_t object)
+    {
+        if (!handle || !object)
+        {
+            log_error("Invalid arguments for release_object");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for release_object");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->release_objects(&object, 1);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_release_objects(
+        native_host_handle_t handle,
+        const native_object_handle_t *objects,
+        uint32_t count)
+    {
+        if (!handle || (!objects && count > 0))
+        {
+            log_error("Invalid arguments for release_objects");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for release_objects");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->release_objects(objects, count);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_create_channel(
+        native_host_handle_t handle,
+        const native_channel_options_t *options,
+        native_channel_handle_t *channel)
+    {
+        if (!handle || !channel)
+        {
+            log_error("Invalid arguments for create_channel");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for create_channel");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->create_channel(options, channel);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_close_channel(
+        native_host_handle_t handle,
+        native_channel_handle_t channel)
+    {
+        if (!handle || !channel)
+        {
+            log_error("Invalid arguments for close_channel");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for close_channel");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->close_channel(channel);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_channel_write(
+        native_channel_handle_t channel,
+        const void *data,
+        uint32_t size,
+        uint32_t timeout_ms)
+    {
+        // 生产者和消费者两端都不获取主机锁
+        auto *target = EventChannel::Channel::from_handle(channel);
+        if (!target)
+        {
+            log_error("Invalid channel for channel_write");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+        return target->write(data, size, timeout_ms);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_channel_complete(native_channel_handle_t channel)
+    {
+        auto *target = EventChannel::Channel::from_handle(channel);
+        if (!target)
+        {
+            log_error("Invalid channel for channel_complete");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+        target->complete();
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_channel_drain(
+        native_channel_handle_t channel,
+        native_channel_event_fn on_event,
+        void *user_data,
+        uint32_t max_events,
+        uint32_t timeout_ms,
+        uint32_t *drained)
+    {
+        auto *target = EventChannel::Channel::from_handle(channel);
+        if (!target || !on_event || !drained)
+        {
+            log_error("Invalid arguments for channel_drain");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+        return target->drain(on_event, user_data, max_events, timeout_ms, drained);
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_call_enter(
+        native_assembly_handle_t assembly,
+        native_call_scope_t *scope)
+    {
+        if (!assembly || !scope)
+        {
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        if (!static_cast<Assembly *>(assembly)->calls().enter())
+        {
+            scope->assembly = nullptr;
+            return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+        }
+
+        scope->assembly = assembly;
+        scope->sampled = Accounting::should_sample() ? 1 : 0;
+        if (scope->sampled)
+        {
+            // 最后读取 CPU 时间，使分配计数的调用开销不计入被测调用
+            scope->allocated_start = Accounting::current_allocated_bytes();
+            scope->cpu_start_ns = Accounting::thread_cpu_time_ns();
+        }
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_call_leave(native_call_scope_t *scope)
+    {
+        if (!scope || !scope->assembly)
+        {
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        uint64_t cpu_time_ns = 0;
+        uint64_t allocated_bytes = 0;
+        if (scope->sampled)
+        {
+            uint64_t cpu_end_ns = Accounting::thread_cpu_time_ns();
+            int64_t allocated_end = Accounting::current_allocated_bytes();
+            cpu_time_ns = cpu_end_ns > scope->cpu_start_ns ? cpu_end_ns - scope->cpu_start_ns : 0;
+            allocated_bytes = allocated_end > scope->allocated_start
+                                  ? static_cast<uint64_t>(allocated_end - scope->allocated_start)
+                                  : 0;
+        }
+
+        // 退出后程序集可能随时被销毁，统计必须在退出前记录
+        auto *assembly = static_cast<Assembly *>(scope->assembly);
+        assembly->record_call(scope->sampled != 0, cpu_time_ns, allocated_bytes);
+        assembly->calls().leave();
+        scope->assembly = nullptr;
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_set_stats_sample_rate(
+        native_host_handle_t handle,
+        uint32_t rate)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for set_stats_sample_rate");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for set_stats_sample_rate");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        Accounting::sample_rate.store(rate, std::memory_order_relaxed);
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_assembly_stats(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly,
+        native_assembly_stats_t *stats)
+    {
+        if (!handle || !assembly || !stats)
+        {
+            log_error("Invalid handle for get_assembly_stats");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_assembly_stats");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        return g_host->get_assembly_stats(assembly, stats);
+    }
+
+    NATIVE_HOST_API void *native_host_arena_alloc(size_t size, size_t alignment)
+    {
+        return Arena::allocate(size, alignment);
+    }
+
+    NATIVE_HOST_API void native_host_arena_reset(void)
+    {
+        Arena::reset();
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_get_arena_stats(
+        native_host_handle_t handle,
+        native_arena_stats_t *stats)
+    {
+        if (!handle || !stats)
+        {
+            log_error("Invalid handle for get_arena_stats");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
+
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_arena_stats");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
+
+        *stats = Arena::stats();
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_set_profiling(
+        native_host_handle_t handle,
+        uint32_t sample_rate)
+    {
+        if (!handle)
         {
-            log_info("Destroying assembly: " + path_);
+            log_error("Invalid handle for set_profiling");
+            return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        NativeHostStatus get_delegate(const char *type_name, const char *method_name, void **delegate)
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
         {
-            if (!Runtime::instance().is_initialized())
-            {
-                log_error("Runtime not initialized");
-                return NativeHostStatus::ERROR_RUNTIME_INIT;
-            }
-
-            auto load_fn = Runtime::instance().get_load_fn();
-            *delegate = nullptr;
+            log_error("Host not found for set_profiling");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
 
-            // Check if assembly file exists
-            if (!std::filesystem::exists(path_))
-            {
-                log_error("Assembly file not found: " + path_);
-                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
-            }
+        return Profiling::set_sample_rate(sample_rate);
+    }
 
-            log_info("Loading type: " + std::string(type_name));
-            log_info("Loading method: " + std::string(method_name));
+    NATIVE_HOST_API NativeHostStatus native_host_get_latency_profiles(
+        native_host_handle_t handle,
+        native_latency_profile_t *profiles,
+        uint32_t capacity,
+        uint32_t *count)
+    {
+        if (!handle || !count || (!profiles && capacity > 0))
+        {
+            log_error("Invalid arguments for get_latency_profiles");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
 
-            // The runtime helper can be called multiple times for different assemblies/methods.
-            // The implementation caches loaded assemblies internally - loading the same assembly
-            // multiple times will only load it once and reuse it.
-            // However, components should avoid relying on this caching behavior and should not
-            // maintain global state, as this can lead to ordering issues and side effects.
+        // 校准时钟可能等待约 10 毫秒，在获取主机锁之前完成
+        double ns_per_tick = capacity > 0 ? Profiling::Clock::ns_per_tick() : 1.0;
 
-            // The returned function pointer has process lifetime and can be called multiple times.
-            // Currently there is no way to unload components or free the function pointer.
-            // This capability may be added in future releases.
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for get_latency_profiles");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
 
-            int rc = load_fn(
-                to_native_path(path_.c_str()).c_str(),
-                to_native_path(type_name).c_str(),
-                to_native_path(method_name).c_str(),
-                UNMANAGEDCALLERSONLY_METHOD,
-                nullptr,
-                delegate);
+        Profiling::get_profiles(profiles, capacity, ns_per_tick, count);
+        return NativeHostStatus::SUCCESS;
+    }
 
-            if (rc != 0 || !*delegate)
-            {
-                log_error("Failed to load assembly and get delegate", rc);
-                return DotNetErrors::map_error(rc);
-            }
+    NATIVE_HOST_API NativeHostStatus native_host_reset_latency_profiles(native_host_handle_t handle)
+    {
+        if (!handle)
+        {
+            log_error("Invalid handle for reset_latency_profiles");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
 
-            loaded_ = true;
-            log_info("Successfully loaded delegate");
-            return NativeHostStatus::SUCCESS;
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
+        {
+            log_error("Host not found for reset_latency_profiles");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
         }
 
-        bool is_loaded() const { return loaded_; }
-        const std::string &path() const { return path_; }
-    };
+        Profiling::reset();
+        return NativeHostStatus::SUCCESS;
+    }
 
-    /**
-     * @brief 本机主机实现
-     *
-     * 本机托管接口的核心实现。管理.NET运行时和已加载程序集的生命周期。
-     *
-     * 设计模式：
-     * - 单例模式用于全局主机实例
-     */
-    class Host
+    NATIVE_HOST_API NativeHostStatus native_host_set_isolation(
+        native_host_handle_t handle,
+        native_isolation_mode_t mode)
     {
-        std::unordered_map<native_assembly_handle_t, std::unique_ptr<Assembly>> assemblies_;
-        bool initialized_ = false;
+        if (!handle)
+        {
+            log_error("Invalid handle for set_isolation");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
 
-    public:
-        NativeHostStatus initialize_runtime()
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
         {
-            if (initialized_)
-            {
-                log_info("Runtime already initialized");
-                return NativeHostStatus::SUCCESS;
-            }
+            log_error("Host not found for set_isolation");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
 
-            if (!Runtime::instance().initialize())
-            {
-                log_error("Failed to initialize runtime");
-                return NativeHostStatus::ERROR_RUNTIME_INIT;
-            }
+        return g_host->set_isolation(mode);
+    }
 
-            initialized_ = true;
-            log_info("Host runtime initialized successfully");
-            return NativeHostStatus::SUCCESS;
+    NATIVE_HOST_API NativeHostStatus native_host_get_method(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly_handle,
+        const char *type_name,
+        const char *method_name,
+        const char *signature,
+        native_method_handle_t *method)
+    {
+        if (!handle || !assembly_handle || !type_name || !method_name || !signature || !method ||
+            !*type_name || !*method_name)
+        {
+            log_error("Invalid arguments for get_method");
+            return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        NativeHostStatus load_assembly(const char *path, native_assembly_handle_t *handle)
+        Timeline::HostLock lock(g_mutex, __func__);
+        if (!g_host || handle != g_host.get())
         {
-            if (!path || !handle)
-            {
-                log_error("Invalid arguments for load_assembly");
-                return NativeHostStatus::ERROR_INVALID_ARG;
-            }
+            log_error("Host not found for get_method");
+            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+        }
 
-            if (!initialized_)
-            {
-                log_error("Runtime not initialized");
-                return NativeHostStatus::ERROR_ASSEMBLY_NOT_INITIALIZED;
-            }
+        return g_host->get_method(assembly_handle, type_name, method_name, signature, method);
+    }
 
-            // Check if assembly file exists
-            if (!std::filesystem::exists(path))
-            {
-                log_error("Assembly file not found: " + std::string(path));
-                return NativeHostStatus::ERROR_ASSEMBLY_LOAD;
-            }
+    NATIVE_HOST_API NativeHostStatus native_host_invoke(
+        native_method_handle_t method,
+        const native_value_t *args,
+        native_value_t *result)
+    {
+        auto *target = static_cast<Method *>(method);
+        if (!target || target->signature.async || (target->signature.argc > 0 && !args) ||
+            (target->signature.ret != 'v' && !result))
+        {
+            log_error("Invalid arguments for invoke");
+            return NativeHostStatus::ERROR_INVALID_ARG;
+        }
 
-            auto assembly = std::make_unique<Assembly>(path);
-            *handle = assembly.get();
-            assemblies_[*handle] = std::move(assembly);
-            log_info("Assembly loaded successfully: " + std::string(path));
-            return NativeHostStatus::SUCCESS;
+        uint32_t slot = ThreadSlots::current();
+        if (!target->calls->enter(slot))
+        {
+            return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
         }
 
-        NativeHostStatus unload_assembly(native_assembly_handle_t handle)
+        auto status = NativeHostStatus::SUCCESS;
+        if (target->process)
         {
-            if (!handle)
-            {
-                log_error("Invalid handle for unload_assembly");
-                return NativeHostStatus::ERROR_INVALID_ARG;
-            }
+            status = target->process->invoke(target->remote_id, args, target->signature.argc, result);
+        }
+        else
+        {
+            Signatures::dispatch(target->fn, target->signature, args, result);
+        }
 
-            auto count = assemblies_.erase(handle);
-            if (count == 0)
-            {
-                log_error("Assembly not found for unload");
-                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
-            }
+        target->calls->leave(slot);
+        return status;
+    }
 
-            log_info("Assembly unloaded successfully");
-            return NativeHostStatus::SUCCESS;
+    NATIVE_HOST_API NativeHostStatus native_host_parallel_for(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly_handle,
+        void *kernel,
+        int64_t begin,
+        int64_t end,
+        void *context,
+        const native_parallel_options_t *options)
+    {
+        if (!handle || !assembly_handle || !kernel || begin > end || (options && options->min_chunk < 0))
+        {
+            log_error("Invalid arguments for parallel_for");
+            return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        NativeHostStatus get_delegate(
-            native_assembly_handle_t handle,
-            const char *type_name,
-            const char *method_name,
-            void **delegate)
+        // 在主机锁内进入在途调用并登记到线程池，销毁主机时等待这次调用完成
+        ParallelPool *pool = nullptr;
+        Assembly *assembly = nullptr;
         {
-            if (!handle || !type_name || !method_name)
+            Timeline::HostLock lock(g_mutex, __func__);
+            if (!g_host || handle != g_host.get())
             {
-                log_error("Invalid arguments for get_delegate");
-                return NativeHostStatus::ERROR_INVALID_ARG;
+                log_error("Host not found for parallel_for");
+                return NativeHostStatus::ERROR_HOST_NOT_FOUND;
             }
-
-            auto it = assemblies_.find(handle);
-            if (it == assemblies_.end())
+            assembly = g_host->find_assembly(assembly_handle);
+            if (!assembly || !assembly->calls().enter())
             {
-                log_error("Assembly not found for get_delegate");
+                log_error("Assembly not found for parallel_for");
                 return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
             }
-
-            return it->second->get_delegate(type_name, method_name, delegate);
+            pool = &g_host->parallel_pool();
+            pool->reserve();
         }
 
-        size_t assembly_count() const { return assemblies_.size(); }
-        bool is_initialized() const { return initialized_; }
-    };
-
-    // 全局状态管理
-    std::unique_ptr<Host> g_host;
-    std::mutex g_mutex;
-}
+        pool->parallel_for(assembly, reinterpret_cast<ParallelPool::kernel_fn>(kernel), begin, end, context, options);
+        return NativeHostStatus::SUCCESS;
+    }
 
-/**
- * @brief 公共API实现
- *
- * C风格接口实现，包装C++实现。
- */
-extern "C"
-{
-    NATIVE_HOST_API NativeHostStatus native_host_create(native_host_handle_t *out_handle)
+    NATIVE_HOST_API NativeHostStatus native_host_invoke_async(
+        native_method_handle_t method,
+        const native_value_t *args,
+        native_async_callback_t callback,
+        void *state)
     {
-        if (!out_handle)
+        auto *target = static_cast<Method *>(method);
+        if (!target || !target->signature.async || (target->signature.argc > 0 && !args) || !callback)
         {
-            log_error("Invalid out_handle for create");
+            log_error("Invalid arguments for invoke_async");
             return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        std::lock_guard<std::mutex> lock(g_mutex);
-        if (g_host)
+        // 只跟踪发起调用的同步部分，完成回调不访问程序集
+        uint32_t slot = ThreadSlots::current();
+        if (!target->calls->enter(slot))
         {
-            log_error("Host already exists");
-            return NativeHostStatus::ERROR_HOST_ALREADY_EXISTS;
+            return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
         }
-
-        g_host = std::make_unique<Host>();
-        *out_handle = g_host.get();
-        log_info("Host created successfully");
+        Signatures::dispatch_async(target->fn, target->signature, args, callback, state);
+        target->calls->leave(slot);
         return NativeHostStatus::SUCCESS;
     }
 
-    NATIVE_HOST_API NativeHostStatus native_host_destroy(native_host_handle_t handle)
+    NATIVE_HOST_API void *native_host_method_pointer(native_method_handle_t method)
+    {
+        return method ? static_cast<Method *>(method)->fn : nullptr;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_trace_start(
+        native_host_handle_t handle,
+        const native_trace_options_t *options)
     {
         if (!handle)
         {
-            log_error("Invalid handle for destroy");
+            log_error("Invalid handle for trace_start");
             return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        std::lock_guard<std::mutex> lock(g_mutex);
+        Timeline::HostLock lock(g_mutex, __func__);
         if (!g_host || handle != g_host.get())
         {
-            log_error("Host not found for destroy");
+            log_error("Host not found for trace_start");
             return NativeHostStatus::ERROR_HOST_NOT_FOUND;
         }
 
-        g_host.reset();
-        log_info("Host destroyed successfully");
-        return NativeHostStatus::SUCCESS;
+        return g_host->tracing().start(options);
     }
 
-    NATIVE_HOST_API NativeHostStatus native_host_initialize(native_host_handle_t handle)
+    NATIVE_HOST_API NativeHostStatus native_host_trace_stop(native_host_handle_t handle)
     {
         if (!handle)
         {
-            log_error("Invalid handle for initialize");
+            log_error("Invalid handle for trace_stop");
             return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        std::lock_guard<std::mutex> lock(g_mutex);
+        Timeline::HostLock lock(g_mutex, __func__);
         if (!g_host || handle != g_host.get())
         {
-            log_error("Host not found for initialize");
+            log_error("Host not found for trace_stop");
             return NativeHostStatus::ERROR_HOST_NOT_FOUND;
         }
 
-        return g_host->initialize_runtime();
+        return g_host->tracing().stop();
     }
 
-    NATIVE_HOST_API NativeHostStatus native_host_load_assembly(
+    NATIVE_HOST_API NativeHostStatus native_host_trace_get_method_stats(
         native_host_handle_t handle,
-        const char *path,
-        native_assembly_handle_t *assembly_handle)
+        const char *type_name,
+        const char *method_name,
+        native_method_trace_stats_t *stats)
     {
-        if (!handle)
+        if (!handle || !type_name || !method_name || !stats)
         {
-            log_error("Invalid handle for load");
+            log_error("Invalid arguments for trace_get_method_stats");
             return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        std::lock_guard<std::mutex> lock(g_mutex);
+        Timeline::HostLock lock(g_mutex, __func__);
         if (!g_host || handle != g_host.get())
         {
-            log_error("Host not found for load");
+            log_error("Host not found for trace_get_method_stats");
             return NativeHostStatus::ERROR_HOST_NOT_FOUND;
         }
 
-        return g_host->load_assembly(path, assembly_handle);
+        return g_host->tracing().get_method_stats(type_name, method_name, stats);
     }
 
-    NATIVE_HOST_API NativeHostStatus native_host_unload_assembly(
+    NATIVE_HOST_API NativeHostStatus native_host_trace_get_summary(
         native_host_handle_t handle,
-        native_assembly_handle_t assembly)
+        native_trace_summary_t *summary)
     {
-        if (!handle)
+        if (!handle || !summary)
         {
-            log_error("Invalid handle for unload");
+            log_error("Invalid arguments for trace_get_summary");
             return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        std::lock_guard<std::mutex> lock(g_mutex);
+        Timeline::HostLock lock(g_mutex, __func__);
         if (!g_host || handle != g_host.get())
         {
-            log_error("Host not found for unload");
+            log_error("Host not found for trace_get_summary");
             return NativeHostStatus::ERROR_HOST_NOT_FOUND;
         }
 
-        return g_host->unload_assembly(assembly);
+        return g_host->tracing().get_summary(summary);
     }
 
-    NATIVE_HOST_API NativeHostStatus native_host_get_delegate(
-        native_host_handle_t handle,
-        native_assembly_handle_t assembly,
-        const char *type_name,
-        const char *method_name,
-        void **delegate)
+    NATIVE_HOST_API NativeHostStatus native_host_timeline_start(const native_timeline_options_t *options)
     {
-        if (!handle || !assembly || !type_name || !method_name)
+        Timeline::start(options ? options->events_per_thread : 0);
+        log_info("Timeline recording started");
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_timeline_stop(void)
+    {
+        Timeline::stop();
+        return NativeHostStatus::SUCCESS;
+    }
+
+    NATIVE_HOST_API NativeHostStatus native_host_timeline_write(const char *path)
+    {
+        if (!path || !*path)
         {
-            log_error("Invalid handle for get_delegate");
+            log_error("Invalid path for timeline_write");
             return NativeHostStatus::ERROR_INVALID_ARG;
         }
 
-        std::lock_guard<std::mutex> lock(g_mutex);
-        if (!g_host || handle != g_host.get())
+        if (!Timeline::write(std::filesystem::path(to_native_path(path))))
         {
-            log_error("Host not found for get_delegate");
-            return NativeHostStatus::ERROR_HOST_NOT_FOUND;
+            log_error("Failed to write timeline: " + std::string(path));
+            return NativeHostStatus::ERROR_INVALID_ARG;
         }
-
-        return g_host->get_delegate(assembly, type_name, method_name, delegate);
+        return NativeHostStatus::SUCCESS;
     }
 }
@@ -13,8 +13,13 @@
 
 #pragma once
 
-// 平台特定的DLL导出/导入宏
-#ifdef _WIN32
+#include <stddef.h>
+#include <stdint.h>
+
+// 平台特定的DLL导出/导入宏；静态库（native_host_static）的接口不导出，由链接器直接绑定
+#if defined(NATIVE_HOST_STATIC)
+#define NATIVE_HOST_API
+#elif defined(_WIN32)
 #ifdef NATIVE_HOST_EXPORTS
 #define NATIVE_HOST_API __declspec(dllexport)
 #else
@@ -53,10 +58,14 @@ extern "C"
         ERROR_RUNTIME_INIT = -300,             ///< .NET运行时初始化失败
         ERROR_HOSTFXR_NOT_FOUND = -302,        ///< 无法找到或加载.NET主机解析器
         ERROR_DELEGATE_NOT_FOUND = -303,       ///< 获取指定方法的委托失败
+        ERROR_PLUGIN_CRASHED = -304,           ///< 隔离模式下辅助进程在调用期间退出
+        ERROR_TASK_FAULTED = -305,             ///< 异步调用的任务以异常结束或被取消
         ERROR_ASSEMBLY_LOAD = -400,            ///< 加载指定程序集失败
         ERROR_TYPE_LOAD = -401,                ///< 加载指定类型失败
         ERROR_METHOD_LOAD = -402,              ///< 加载指定方法失败
-        ERROR_INVALID_ARG = -500               ///< 提供了无效参数
+        ERROR_INVALID_ARG = -500,              ///< 提供了无效参数
+        ERROR_NOT_SUPPORTED = -501,            ///< 当前平台或程序集类型不支持该操作
+        ERROR_TIMEOUT = -502                   ///< 操作在超时前未完成
     };
 
     /**
@@ -68,6 +77,11 @@ extern "C"
     typedef void *native_handle_t;
     typedef native_handle_t native_host_handle_t;     ///< 本机主机实例的句柄
     typedef native_handle_t native_assembly_handle_t; ///< 已加载程序集的句柄
+    typedef native_handle_t native_method_handle_t;   ///< 按签名解析的方法句柄
+    typedef native_handle_t native_bundle_handle_t;   ///< 已打开的插件包的句柄
+    typedef native_handle_t native_catalog_handle_t;  ///< 插件发现结果的句柄
+    typedef native_handle_t native_object_handle_t;   ///< 插件对象的句柄，即固定托管对象的 GCHandle
+    typedef native_handle_t native_channel_handle_t;  ///< 事件通道的句柄，即通道共享内存的地址
 
     /**
      * @brief 创建新的本机主机实例
@@ -102,11 +116,152 @@ extern "C"
      */
     NATIVE_HOST_API enum NativeHostStatus native_host_initialize(native_host_handle_t handle);
 
+    /**
+     * @brief 进程中已有 .NET 运行时时的初始化方式
+     *
+     * 宿主进程本身是 .NET 应用（通过 P/Invoke 使用本库）或其他组件已经通过 hostfxr 启动了运行时时，
+     * 进程中不能再启动第二个运行时。附加时使用进程中已加载的 hostfxr，
+     * 通过它返回的次级宿主上下文获取委托，跳过 hostfxr 探测、框架解析和运行时启动。
+     */
+    typedef enum native_runtime_attach_mode
+    {
+        NATIVE_RUNTIME_ATTACH_AUTO = 0,     ///< 进程中已加载 hostfxr 时使用它，已有运行时则附加；与显式路径冲突时失败（默认）
+        NATIVE_RUNTIME_ATTACH_REQUIRED = 1, ///< 只附加到已运行的运行时，没有时返回 ERROR_RUNTIME_INIT
+        NATIVE_RUNTIME_ATTACH_NEVER = 2,    ///< 总是按解析选项加载 hostfxr
+    } native_runtime_attach_mode_t;
+
+    /**
+     * @brief 运行时解析选项
+     *
+     * 所有路径均为 UTF-8，相对路径以 native_host 库所在目录为基准，
+     * 便于随二进制文件一起部署应用本地的运行时。未设置的字段使用默认行为。
+     *
+     * 结构体只在末尾追加字段。调用方必须把 struct_size 设为编译时的 sizeof(native_host_runtime_options_t)，
+     * 库据此只读取调用方提供的字段，按旧头文件编译的调用方得到新字段的默认行为：
+     * @code
+     * native_host_runtime_options_t options = {sizeof(options)};
+     * @endcode
+     */
+    typedef struct native_host_runtime_options
+    {
+        /** 结构体大小，必须设置；小于第一版的大小（到 runtime_config_path 为止）时返回 ERROR_INVALID_ARG */
+        uint32_t struct_size;
+        /**
+         * .NET 根目录。可以是包含 host/fxr 和 shared 的私有安装目录，
+         * 也可以是 hostfxr 直接位于其中的自包含运行时目录。
+         * 设置后不再探测环境变量和全局安装位置，框架也只在该目录下解析。
+         */
+        const char *dotnet_root;
+        /** hostfxr 库的完整路径，设置后跳过 nethost 的全部探测，文件不存在时初始化失败 */
+        const char *hostfxr_path;
+        /** 运行时配置文件路径，为 NULL 时使用 native_host 库所在目录下的 init.runtimeconfig.json */
+        const char *runtime_config_path;
+        /**
+         * 宿主服务表：供插件回调宿主的本机函数指针数组，可以为 NULL。
+         * 插件通过 PluginSupport.HostServices.GetTable<T>() 以 delegate* unmanaged 结构体访问，
+         * 回调是直接的间接调用，不经过 DllImport 的库探测和封送。数组内容在调用时被复制。
+         */
+        const void *const *services;
+        /** 服务表中函数指针的个数 */
+        uint32_t service_count;
+        /**
+         * 插件依赖解析结果的持久化目录，可以为 NULL（只在进程内缓存）。
+         * 托管插件按各自的 .deps.json 解析依赖，解析结果按程序集名缓存；
+         * 设置后解析到的路径写入该目录，插件、.deps.json 和依赖文件本身未变化时后续进程直接复用；
+         * 未命中只在进程内缓存。
+         */
+        const char *dependency_cache_dir;
+        /**
+         * 进程中已有运行时时的处理方式，框架与已运行的运行时不兼容时初始化失败。
+         * AUTO 只在已加载的 hostfxr 就是 hostfxr_path 指定的文件或位于 dotnet_root 下时附加，
+         * 不一致时初始化失败并返回 ERROR_RUNTIME_INIT；REQUIRED 忽略 dotnet_root 和 hostfxr_path。
+         */
+        native_runtime_attach_mode_t attach_mode;
+    } native_host_runtime_options_t;
+
+    /**
+     * @brief 运行时初始化各阶段耗时（纳秒）
+     */
+    typedef struct native_runtime_init_timings
+    {
+        uint64_t resolve_hostfxr_ns;    ///< 定位 hostfxr
+        uint64_t load_hostfxr_ns;       ///< 加载 hostfxr 并解析导出函数
+        uint64_t initialize_runtime_ns; ///< 解析运行时配置、框架并启动运行时
+        uint64_t total_ns;              ///< 运行时初始化总耗时
+    } native_runtime_init_timings_t;
+
+    /**
+     * @brief 使用显式的运行时解析选项初始化主机的.NET运行时
+     *
+     * 与 native_host_initialize 相同，但允许指定 dotnet_root 或 hostfxr 路径以跳过探测，
+     * 使每个节点加载完全相同的运行时。运行时每个进程只能初始化一次，之后的解析选项被忽略。
+     *
+     * 服务表不受此限制：每次传入都会注册到支持程序集并替换之前的表，之前的表保持有效。
+     * 支持程序集不可用时注册服务表失败，返回 ERROR_RUNTIME_INIT。
+     *
+     * @param handle 主机实例句柄
+     * @param options 运行时解析选项
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_initialize_with_options(
+        native_host_handle_t handle,
+        const native_host_runtime_options_t *options);
+
+    /**
+     * @brief 获取运行时初始化各阶段的耗时
+     *
+     * @param handle 主机实例句柄
+     * @param[out] timings 接收耗时信息的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_runtime_init_timings(
+        native_host_handle_t handle,
+        /*out*/ native_runtime_init_timings_t *timings);
+
+    /**
+     * @brief 运行时配置中与已运行的运行时取值不同的属性
+     */
+    typedef struct native_runtime_property_mismatch
+    {
+        const char *name;      ///< 属性名
+        const char *requested; ///< 运行时配置文件中的值
+        const char *active;    ///< 已运行的运行时中的值，未设置该属性时为 NULL
+    } native_runtime_property_mismatch_t;
+
+    /**
+     * @brief 附加到已运行的运行时的结果
+     */
+    typedef struct native_runtime_attach_info
+    {
+        int32_t attached;        ///< 非 0 表示附加到了已运行的运行时，而不是由本库启动
+        uint32_t mismatch_count; ///< 取值不同的属性个数
+        /** 取值不同的属性，有效期到进程退出 */
+        const native_runtime_property_mismatch_t *mismatches;
+    } native_runtime_attach_info_t;
+
+    /**
+     * @brief 获取运行时是否为附加的，以及运行时配置与已运行的运行时的属性差异
+     *
+     * 运行时属性只在启动时生效，附加时运行时配置中的属性被忽略，插件看到的是已运行的运行时的属性。
+     * 属性不同不视为初始化失败，由调用方决定是否继续使用。
+     *
+     * @param handle 主机实例句柄
+     * @param[out] info 接收附加结果的指针
+     * @return NativeHostStatus 表示成功或失败的状态码，运行时未初始化时为 ERROR_RUNTIME_INIT
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_runtime_attach_info(
+        native_host_handle_t handle,
+        /*out*/ native_runtime_attach_info_t *info);
+
     /**
      * @brief 将.NET程序集加载到主机中
      *
      * 从指定路径加载程序集，并保持加载状态直到显式卸载或主机被销毁。
      *
+     * 路径也可以指向 NativeAOT 编译的本机共享库（根据文件头自动识别）。
+     * 本机库自带运行时，加载它不需要先调用 native_host_initialize，
+     * 同一主机中可以同时加载托管程序集和 NativeAOT 库。
+     *
      * @param handle 主机实例句柄
      * @param assembly_path 要加载的程序集文件路径
      * @param[out] assembly_handle 接收程序集句柄的指针
@@ -117,12 +272,253 @@ extern "C"
         const char *assembly_path,
         /*out*/ native_assembly_handle_t *assembly_handle);
 
+    /**
+     * @brief 从内存镜像加载托管程序集
+     *
+     * 镜像通过 AssemblyLoadContext.LoadFromStream 加载到独立的加载上下文，不访问文件系统。
+     * 运行时在加载时复制镜像，调用返回后缓冲区即可释放。程序集的依赖回退到默认加载上下文；
+     * 需要随插件分发依赖时使用插件包。需要先初始化运行时，NativeAOT 库和隔离模式不支持从内存加载。
+     *
+     * @param handle 主机实例句柄
+     * @param image 程序集镜像
+     * @param size 镜像字节数
+     * @param name 程序集的显示名称，用于日志和加载上下文的名称
+     * @param[out] assembly_handle 接收程序集句柄的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_load_assembly_from_memory(
+        native_host_handle_t handle,
+        const void *image,
+        size_t size,
+        const char *name,
+        /*out*/ native_assembly_handle_t *assembly_handle);
+
+    /**
+     * @brief 打开插件包
+     *
+     * 插件包由 native_host_pack 工具把一个目录中的程序集打包而成。打开时映射整个文件并读取索引，
+     * 之后从插件包加载程序集和解析其依赖都直接使用映射中的镜像，不再打开和查询单个文件。
+     *
+     * @param handle 主机实例句柄
+     * @param path 插件包文件路径
+     * @param[out] bundle 接收插件包句柄的指针
+     * @return NativeHostStatus 表示成功或失败的状态码，文件不是有效的插件包时为 ERROR_ASSEMBLY_LOAD
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_open_bundle(
+        native_host_handle_t handle,
+        const char *path,
+        /*out*/ native_bundle_handle_t *bundle);
+
+    /**
+     * @brief 列出插件包中的条目名称
+     *
+     * 名称即打包时的文件名（如 Plugin.dll），在插件包关闭前有效。
+     *
+     * @param handle 主机实例句柄
+     * @param bundle 插件包句柄
+     * @param[out] names 接收条目名称的数组，可以为 NULL（只查询个数）
+     * @param capacity names 数组的容量
+     * @param[out] count 接收条目总数的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_bundle_entries(
+        native_host_handle_t handle,
+        native_bundle_handle_t bundle,
+        /*out*/ const char **names,
+        uint32_t capacity,
+        /*out*/ uint32_t *count);
+
+    /**
+     * @brief 从插件包加载托管程序集
+     *
+     * 与 native_host_load_assembly_from_memory 相同，但程序集的依赖按简单名称在同一插件包中解析，
+     * 同一插件包中的同一条目只加载一次。插件包提供过镜像后在进程生命周期内保持映射。
+     *
+     * @param handle 主机实例句柄
+     * @param bundle 插件包句柄
+     * @param name 条目名称（如 Plugin.dll），不区分大小写
+     * @param[out] assembly_handle 接收程序集句柄的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_load_assembly_from_bundle(
+        native_host_handle_t handle,
+        native_bundle_handle_t bundle,
+        const char *name,
+        /*out*/ native_assembly_handle_t *assembly_handle);
+
+    /**
+     * @brief 关闭插件包
+     *
+     * 已从插件包加载的程序集不受影响。已向运行时提供过镜像的插件包仍保持映射直到进程结束，
+     * 以便这些程序集之后按需从中解析依赖；关闭只释放句柄。
+     *
+     * @param handle 主机实例句柄
+     * @param bundle 插件包句柄
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_close_bundle(
+        native_host_handle_t handle,
+        native_bundle_handle_t bundle);
+
+    /**
+     * @brief 插件发现的选项
+     */
+    typedef struct native_discovery_options
+    {
+        const char *directory;  ///< 要扫描的目录，扫描其中的 *.dll
+        const char *index_path; ///< 索引文件路径，为 NULL 时不读写索引
+        int32_t recursive;      ///< 非 0 时同时扫描子目录
+    } native_discovery_options_t;
+
+    /**
+     * @brief 插件导出的 [UnmanagedCallersOnly] 方法
+     *
+     * 签名的第一个字符是返回类型，其后依次是参数类型：'v' 无返回值，'i' int32/uint32，'l' int64/uint64，
+     * 'd' double，'f' float，'b' 单字节整数或 bool，'s' 双字节整数或 char，'p' 指针、nint、nuint 或函数指针，
+     * 'x' 其他类型（如按值传递的结构体）。只由 'v'、'i'、'l'、'd' 组成且最多 4 个参数的签名
+     * 可以直接传给 native_host_get_method。
+     */
+    typedef struct native_plugin_export
+    {
+        const char *assembly_path; ///< 程序集文件路径（UTF-8）
+        const char *type_name;     ///< 程序集限定的类型名，如 Ns.Type,Assembly，可直接传给 native_host_get_delegate
+        const char *method_name;   ///< 方法名
+        const char *entry_point;   ///< 特性的 EntryPoint，未指定时为 NULL
+        const char *signature;     ///< 方法签名
+    } native_plugin_export_t;
+
+    /**
+     * @brief 插件发现的结果
+     */
+    typedef struct native_plugin_catalog_info
+    {
+        const native_plugin_export_t *exports; ///< 所有导出，按文件路径排序，在结果关闭前有效
+        uint32_t export_count;                 ///< 导出个数
+        uint32_t assembly_count;               ///< 扫描到的托管程序集个数
+        uint32_t scanned_count;                ///< 本次读取了元数据的文件个数
+        uint32_t cached_count;                 ///< 直接使用索引中记录的文件个数
+    } native_plugin_catalog_info_t;
+
+    /**
+     * @brief 发现目录中的插件导出，不把程序集加载到运行时
+     *
+     * 直接读取每个文件的元数据表，列出带 [UnmanagedCallersOnly] 的方法及其签名；
+     * 不是托管程序集的文件（如 NativeAOT 库）也记录下来，只是没有导出。不需要初始化运行时。
+     *
+     * 指定索引文件时，按文件路径、大小和修改时间在索引中查找，未变化的文件直接使用记录的结果；
+     * 有文件被重新读取或已删除时重写索引。索引损坏或版本不符时视为不存在，索引写入失败不影响结果。
+     * 多个进程可以共用同一个索引文件，各自写入独立的临时文件后替换。
+     *
+     * 扫描期间不持有主机锁，不会阻塞其他线程对主机的调用，只在登记结果句柄时加锁。
+     *
+     * @param handle 主机实例句柄
+     * @param options 发现选项
+     * @param[out] catalog 接收结果句柄的指针
+     * @return NativeHostStatus 表示成功或失败的状态码，目录不存在时为 ERROR_ASSEMBLY_LOAD
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_discover_plugins(
+        native_host_handle_t handle,
+        const native_discovery_options_t *options,
+        /*out*/ native_catalog_handle_t *catalog);
+
+    /**
+     * @brief 获取插件发现的结果
+     *
+     * @param handle 主机实例句柄
+     * @param catalog 结果句柄
+     * @param[out] info 接收结果的指针，其中的指针在结果关闭前有效
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_catalog_info(
+        native_host_handle_t handle,
+        native_catalog_handle_t catalog,
+        /*out*/ native_plugin_catalog_info_t *info);
+
+    /**
+     * @brief 关闭插件发现的结果
+     *
+     * @param handle 主机实例句柄
+     * @param catalog 结果句柄
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_close_catalog(
+        native_host_handle_t handle,
+        native_catalog_handle_t catalog);
+
+    /**
+     * @brief 批量加载时需要解析的入口点
+     *
+     * 所属程序集加载成功后，在同一工作线程上立即解析，结果写回 function 和 status。
+     */
+    typedef struct native_entry_point
+    {
+        uint32_t assembly_index;      ///< 所属程序集在 paths 中的下标
+        const char *type_name;        ///< 类型名
+        const char *method_name;      ///< 方法名
+        void *function;               ///< [out] 解析得到的函数指针
+        enum NativeHostStatus status; ///< [out] 解析结果
+    } native_entry_point_t;
+
+    /**
+     * @brief 单个程序集加载完成的回调
+     *
+     * 在工作线程上调用，此时该程序集的入口点已解析完毕。批量加载期间主机锁被持有，
+     * 回调中只能调用 native_host_invoke 和 native_host_call_enter/leave 等不加锁的接口。
+     */
+    typedef void (*native_assembly_loaded_fn)(
+        void *user_data,
+        uint32_t index,
+        native_assembly_handle_t assembly,
+        enum NativeHostStatus status);
+
+    /**
+     * @brief 批量加载选项，未设置的字段使用默认行为
+     */
+    typedef struct native_bulk_load_options
+    {
+        uint32_t max_threads;                ///< 工作线程数上限，0 表示使用硬件线程数
+        native_entry_point_t *entry_points;  ///< 需要解析的入口点，可以为 NULL
+        uint32_t entry_point_count;          ///< 入口点个数
+        native_assembly_loaded_fn on_loaded; ///< 逐个报告加载完成，可以为 NULL
+        void *user_data;                     ///< 传给 on_loaded 的用户数据
+    } native_bulk_load_options_t;
+
+    /**
+     * @brief 并发加载多个程序集
+     *
+     * 与逐个调用 native_host_load_assembly 结果相同，但只获取一次主机锁，
+     * 路径检查、文件头识别、程序集加载和入口点解析在工作线程池上并发执行。
+     * 所有程序集处理完毕后返回；需要尽早使用已就绪的程序集时通过 on_loaded 逐个接收。
+     *
+     * @param handle 主机实例句柄
+     * @param paths 程序集文件路径数组
+     * @param count 路径个数
+     * @param[out] assembly_handles 接收各程序集句柄的数组，失败的位置为 NULL
+     * @param[out] statuses 接收各程序集加载结果的数组
+     * @param options 批量加载选项，可以为 NULL
+     * @return NativeHostStatus 全部程序集和入口点成功时为 SUCCESS，否则为按下标顺序的第一个失败状态
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_load_assemblies(
+        native_host_handle_t handle,
+        const char *const *paths,
+        uint32_t count,
+        /*out*/ native_assembly_handle_t *assembly_handles,
+        /*out*/ enum NativeHostStatus *statuses,
+        const native_bulk_load_options_t *options);
+
     /**
      * @brief 卸载之前加载的程序集
      *
      * 此函数卸载指定的程序集并使其句柄无效。
      * 从该程序集获取的所有委托都将变为无效。
      *
+     * 卸载不等待在途调用：之后的 native_host_call_enter 和 native_host_invoke 返回 ERROR_ASSEMBLY_NOT_FOUND，
+     * 已通过 native_host_call_enter 进入或正在 native_host_invoke 中的调用结束后，程序集才被销毁。
+     * 已卸载的程序集句柄和方法句柄在主机销毁前仍可传给上述两个函数，每个已卸载的程序集为此保留约 4 KB。
+     * 不经调用作用域直接调用的委托不在跟踪范围内。
+     * 在途调用结束、程序集被销毁时，由它创建且仍未释放的插件对象一并释放，这些对象此后已无法使用；
+     * 在此之前这些对象句柄仍可使用和释放，之后传给 native_host_release_objects 返回 ERROR_INVALID_ARG。
+     *
      * @param handle 主机实例句柄
      * @param assembly_handle 要卸载的程序集句柄
      * @return NativeHostStatus 表示成功或失败的状态码
@@ -131,11 +527,31 @@ extern "C"
         native_host_handle_t handle,
         native_assembly_handle_t assembly_handle);
 
+    /**
+     * @brief 卸载程序集并等待在途调用结束
+     *
+     * 与 native_host_unload_assembly 相同，但在返回前等待程序集被销毁。等待期间不持有主机锁，
+     * 在途调用可以继续调用宿主接口。超时返回 ERROR_TIMEOUT，此时程序集已卸载，在途调用结束后再销毁。
+     * 不能在该程序集的调用作用域内调用，否则总是超时。
+     *
+     * @param handle 主机实例句柄
+     * @param assembly_handle 要卸载的程序集句柄
+     * @param timeout_ms 最长等待时间（毫秒）
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_unload_assembly_wait(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly_handle,
+        uint32_t timeout_ms);
+
     /**
      * @brief 从已加载的程序集获取函数委托
      *
      * 此函数在指定的程序集中查找方法，并返回一个可从本机代码调用的函数指针。
      *
+     * 对于 NativeAOT 本机库，method_name 是 [UnmanagedCallersOnly(EntryPoint = ...)]
+     * 声明的导出符号名，type_name 不参与解析。
+     *
      * @param handle 主机实例句柄
      * @param assembly_handle 已加载程序集的句柄
      * @param type_name 包含方法的类型的完全限定名
@@ -150,6 +566,748 @@ extern "C"
         const char *method_name,
         void **delegate);
 
+    /**
+     * @brief 延迟绑定的入口点在首次调用时解析失败的处理函数
+     *
+     * 在发起调用的线程上调用，不持有主机锁。
+     *
+     * @param user_data 设置延迟绑定时传入的用户数据
+     * @param assembly 获取委托时的程序集句柄
+     * @param type_name 类型名称
+     * @param method_name 方法名称
+     * @param status 解析失败的状态码，程序集已卸载时为 ERROR_ASSEMBLY_NOT_FOUND
+     * @return 签名相同的替代函数，本次及之后的调用都转到该函数；返回 NULL 时本次调用直接返回
+     *         （整数和浮点返回值为 0），下次调用重新解析
+     */
+    typedef void *(*native_lazy_bind_failed_fn)(
+        void *user_data,
+        native_assembly_handle_t assembly,
+        const char *type_name,
+        const char *method_name,
+        enum NativeHostStatus status);
+
+    /**
+     * @brief 延迟绑定选项
+     */
+    typedef struct native_lazy_binding_options
+    {
+        native_lazy_bind_failed_fn on_failure; ///< 解析失败的处理函数，可以为 NULL
+        void *user_data;                       ///< 传给处理函数的用户数据
+    } native_lazy_binding_options_t;
+
+    /**
+     * @brief 开启或关闭托管入口点的延迟绑定
+     *
+     * 开启后 native_host_get_delegate 对进程内的托管程序集不再解析入口，而是立即返回一个跳转桩，
+     * 与 PLT 的延迟绑定相同：首次调用时桩解析真正的入口，原子地改写自己的跳转目标后转到入口，
+     * 之后的调用只多一次间接跳转。同一入口点多次获取得到同一个桩，桩在进程生命周期内有效。
+     * 获取时的选项随桩保存，之后修改选项不影响已发出的桩。
+     *
+     * NativeAOT 库的导出和批量加载的入口点仍立即解析。首次调用会获取主机锁，
+     * 不能发生在持有主机锁的回调（如批量加载的 on_loaded）中。
+     * 目前只支持 x86-64 Linux，其他平台开启时返回 ERROR_NOT_SUPPORTED。
+     *
+     * @param handle 主机实例句柄
+     * @param options 延迟绑定选项，为 NULL 时关闭
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_set_lazy_binding(
+        native_host_handle_t handle,
+        const native_lazy_binding_options_t *options);
+
+    /**
+     * @brief 构造插件类型的实例，返回指向它的句柄
+     *
+     * 类型在插件的加载上下文中解析，必须有公共无参构造函数；构造函数在持有主机锁时运行，
+     * 不能调用加锁的主机接口。句柄来自支持程序集中复用的 GCHandle 池，在释放之前对象不会被回收。
+     * 卸载程序集时其仍未释放的对象随之释放，见 native_host_unload_assembly。
+     *
+     * 实例方法通过以句柄为第一个参数的静态 [UnmanagedCallersOnly] 方法导出，
+     * 用 PluginObjects.Get 取得对象只需一次解引用，不需要查找静态字典：
+     * @code
+     * [UnmanagedCallersOnly]
+     * public static int Log(nint self, int level) => PluginObjects.Get<Session>(self).Log(level);
+     * @endcode
+     * 照常用 native_host_get_delegate 获取入口，调用时传入对象句柄。
+     * 只支持进程内的托管程序集，NativeAOT 和隔离的程序集返回 ERROR_NOT_SUPPORTED。
+     *
+     * @param handle 主机实例句柄
+     * @param assembly 程序集句柄
+     * @param type_name 类型名称，格式为"命名空间.类型名,程序集名"
+     * @param object 返回的对象句柄
+     * @return NativeHostStatus 表示成功或失败的状态码，找不到类型或构造函数、构造函数抛出异常时为 ERROR_TYPE_LOAD
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_create_object(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly,
+        const char *type_name,
+        native_object_handle_t *object);
+
+    /**
+     * @brief 释放插件对象，句柄归还到池中，之后不能再使用
+     *
+     * @param handle 主机实例句柄
+     * @param object 对象句柄
+     * @return NativeHostStatus 表示成功或失败的状态码，句柄未知或已释放时为 ERROR_INVALID_ARG
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_release_object(
+        native_host_handle_t handle,
+        native_object_handle_t object);
+
+    /**
+     * @brief 一次释放一批插件对象，只进入一次托管代码
+     *
+     * 只要有一个句柄未知、已释放或在同一批中重复，就都不释放。主机销毁时释放尚未释放的对象。
+     *
+     * @param handle 主机实例句柄
+     * @param objects 对象句柄数组
+     * @param count 数组长度
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_release_objects(
+        native_host_handle_t handle,
+        const native_object_handle_t *objects,
+        uint32_t count);
+
+    /**
+     * @brief 事件通道的选项
+     */
+    typedef struct native_channel_options
+    {
+        uint32_t capacity; ///< 环形缓冲区字节数，2 的幂，介于 4 KiB 和 1 GiB 之间，0 表示 1 MiB
+    } native_channel_options_t;
+
+    /**
+     * @brief 通道中每条事件的回调
+     *
+     * @param user_data 传给 native_host_channel_drain 的用户数据
+     * @param data 事件数据，直接指向通道缓冲区，只在本次 drain 返回前有效
+     * @param size 数据字节数
+     */
+    typedef void (*native_channel_event_fn)(void *user_data, const void *data, uint32_t size);
+
+    /**
+     * @brief 创建单生产者单消费者的事件通道，用于托管代码向本机代码推送大量小事件
+     *
+     * 通道是一块本机内存中的环形缓冲区。把句柄传给插件入口，插件用 PluginSupport.HostChannel.FromHandle
+     * 打开后以 Span 写入，写入不经过托管到本机的转换：
+     * @code
+     * [UnmanagedCallersOnly]
+     * public static void Start(nint channel) => s_events = HostChannel.FromHandle(channel);
+     * // 热路径
+     * s_events.TryWrite(in sample);
+     * @endcode
+     * 本机消费者用 native_host_channel_drain 成批取出。只有消费者休眠时生产者才调用本机函数唤醒它；
+     * 缓冲区满时生产者先自旋，再休眠到消费者释放空间为止（背压）。
+     * 每个通道只能有一个生产者线程和一个消费者线程，需要多个生产者时为每个生产者创建一个通道。
+     *
+     * @param handle 主机实例句柄
+     * @param options 通道选项，可为 NULL
+     * @param channel 返回的通道句柄
+     * @return NativeHostStatus 表示成功或失败的状态码，容量无效时为 ERROR_INVALID_ARG
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_create_channel(
+        native_host_handle_t handle,
+        const native_channel_options_t *options,
+        native_channel_handle_t *channel);
+
+    /**
+     * @brief 关闭事件通道并释放其内存
+     *
+     * 调用前生产者和消费者都必须已经停止使用该通道。主机销毁时关闭尚未关闭的通道。
+     *
+     * @param handle 主机实例句柄
+     * @param channel 通道句柄
+     * @return NativeHostStatus 表示成功或失败的状态码，句柄未知或已关闭时为 ERROR_INVALID_ARG
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_close_channel(
+        native_host_handle_t handle,
+        native_channel_handle_t channel);
+
+    /**
+     * @brief 从本机代码向通道写入一条事件，与托管的 HostChannel.Write 等价
+     *
+     * 不获取主机锁。与托管生产者一样，同一时刻只能有一个线程写入。
+     *
+     * @param channel 通道句柄
+     * @param data 事件数据
+     * @param size 数据字节数，不能超过容量的一半减 4
+     * @param timeout_ms 缓冲区满时最多等待的毫秒数，0 表示不等待，UINT32_MAX 表示一直等待
+     * @return NativeHostStatus 表示成功或失败的状态码，等待空间超时时为 ERROR_TIMEOUT
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_channel_write(
+        native_channel_handle_t channel,
+        const void *data,
+        uint32_t size,
+        uint32_t timeout_ms);
+
+    /**
+     * @brief 从本机代码结束通道，与托管的 HostChannel.Complete 等价
+     *
+     * 结束后消费者取完剩余事件，下一次 drain 立即以 SUCCESS 返回且 drained 为 0。
+     *
+     * @param channel 通道句柄
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_channel_complete(native_channel_handle_t channel);
+
+    /**
+     * @brief 成批取出通道中的事件
+     *
+     * 依次对调用时已写入的事件调用 on_event，全部处理完后才一次性把空间还给生产者。
+     * 通道为空时先自旋，再休眠等待事件或结束。不获取主机锁，同一时刻只能有一个线程取出。
+     *
+     * @param channel 通道句柄
+     * @param on_event 每条事件的回调，不能调用写入同一通道的接口
+     * @param user_data 传给回调的用户数据
+     * @param max_events 本次最多处理的事件数，0 表示不限
+     * @param timeout_ms 通道为空时最多等待的毫秒数，0 表示不等待，UINT32_MAX 表示一直等待
+     * @param[out] drained 本次处理的事件数；返回 SUCCESS 且为 0 表示生产者已结束且事件已取完
+     * @return NativeHostStatus 表示成功或失败的状态码，等待超时时为 ERROR_TIMEOUT
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_channel_drain(
+        native_channel_handle_t channel,
+        native_channel_event_fn on_event,
+        void *user_data,
+        uint32_t max_events,
+        uint32_t timeout_ms,
+        /*out*/ uint32_t *drained);
+
+    /**
+     * @brief 程序集隔离模式
+     */
+    typedef enum native_isolation_mode
+    {
+        NATIVE_ISOLATION_NONE = 0,    ///< 程序集加载到宿主进程中（默认）
+        NATIVE_ISOLATION_PROCESS = 1, ///< 程序集加载到本地辅助进程中，崩溃后辅助进程自动重启
+    } native_isolation_mode_t;
+
+    /**
+     * @brief 设置之后加载的程序集的隔离模式
+     *
+     * 隔离的程序集运行在 native_host_worker 辅助进程中（与 native_host 库位于同一目录），
+     * 插件崩溃或内存泄漏不会影响宿主进程。调用通过共享内存环形队列传递，
+     * 辅助进程退出时正在进行的调用返回 ERROR_PLUGIN_CRASHED，之后的调用由重启的辅助进程处理。
+     *
+     * 隔离的程序集不能获取函数指针，需通过 native_host_get_method 和 native_host_invoke 调用。
+     * 目前仅支持 Linux，其他平台返回 ERROR_NOT_SUPPORTED。
+     *
+     * @param handle 主机实例句柄
+     * @param mode 隔离模式
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_set_isolation(
+        native_host_handle_t handle,
+        native_isolation_mode_t mode);
+
+    /**
+     * @brief 按签名调用时的参数和返回值
+     */
+    typedef union native_value
+    {
+        int32_t i32;
+        int64_t i64;
+        double f64;
+    } native_value_t;
+
+    /**
+     * @brief 按签名解析方法，进程内和隔离的程序集均可使用
+     *
+     * 签名字符串第一个字符是返回类型，其后依次是参数类型，最多 4 个参数：
+     * 'i' 表示 int32，'l' 表示 int64，'d' 表示 double，返回类型还可以是 'v'（无返回值）。
+     * 例如 int AddNumbers(int, int) 的签名是 "iii"。
+     *
+     * 以 'T' 开头的签名表示异步方法，其后是任务结果类型和参数类型，例如 Task<int> F(int, int) 的签名是 "Tiii"。
+     * 异步方法只能通过 native_host_invoke_async 调用，隔离的程序集不支持异步方法。
+     *
+     * @param handle 主机实例句柄
+     * @param assembly_handle 已加载程序集的句柄
+     * @param type_name 包含方法的类型的完全限定名
+     * @param method_name 方法名
+     * @param signature 方法签名
+     * @param[out] method 接收方法句柄的指针，程序集卸载后失效
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_method(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly_handle,
+        const char *type_name,
+        const char *method_name,
+        const char *signature,
+        /*out*/ native_method_handle_t *method);
+
+    /**
+     * @brief 调用按签名解析的方法
+     *
+     * 此函数不获取主机锁，可从多个线程并发调用。调用计入程序集的在途调用，卸载在调用结束后才销毁程序集；
+     * 程序集卸载后返回 ERROR_ASSEMBLY_NOT_FOUND。
+     *
+     * @param method 方法句柄
+     * @param args 参数数组，元素个数与签名一致，无参数时可以为 NULL
+     * @param[out] result 接收返回值，返回类型为 'v' 时可以为 NULL
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_invoke(
+        native_method_handle_t method,
+        const native_value_t *args,
+        /*out*/ native_value_t *result);
+
+    /**
+     * @brief 异步调用完成的回调
+     *
+     * 在完成任务的线程上调用；任务在调用前已完成时，在 native_host_invoke_async 内部直接调用。
+     *
+     * @param state 调用 native_host_invoke_async 时传入的状态
+     * @param status SUCCESS，或任务以异常结束、被取消时的 ERROR_TASK_FAULTED
+     * @param result 任务结果，仅在 status 为 SUCCESS 且结果类型不是 'v' 时有意义，只在回调期间有效
+     */
+    typedef void (*native_async_callback_t)(void *state, enum NativeHostStatus status, const native_value_t *result);
+
+    /**
+     * @brief 调用按异步签名解析的方法
+     *
+     * 托管方法需通过 PluginSupport.AsyncBridge 暴露：在参数之后接收回调和状态两个指针参数，
+     * 启动任务后立即返回，任务完成时调用 callback。调用线程不会等待任务完成。
+     *
+     * 与 native_host_invoke 一样不获取主机锁，调用方需保证回调之前程序集未被卸载。
+     * 返回值不是 SUCCESS 时回调不会被调用。
+     *
+     * @param method 方法句柄，签名以 'T' 开头
+     * @param args 参数数组，元素个数与签名一致，无参数时可以为 NULL
+     * @param callback 完成回调
+     * @param state 传给回调的状态
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_invoke_async(
+        native_method_handle_t method,
+        const native_value_t *args,
+        native_async_callback_t callback,
+        void *state);
+
+    /**
+     * @brief 获取按签名解析的方法的函数指针，用于在热路径上直接调用
+     *
+     * 不加锁、只检查句柄是否为 NULL，也不计入在途调用：调用方需自行保证程序集未被卸载，
+     * 例如在 native_host_call_enter/leave 的作用域内调用。以 native_host_static 链接并启用 LTO 时，
+     * 此函数内联为一次判空和一次内存读取。
+     *
+     * @param method 有效的方法句柄，或 NULL
+     * @return 函数指针；句柄为 NULL 或方法位于隔离的程序集中时返回 NULL
+     */
+    NATIVE_HOST_API void *native_host_method_pointer(native_method_handle_t method);
+
+    /**
+     * @brief 数据并行调用完成的回调
+     *
+     * 在处理完最后一个分块的工作线程上调用，此时并行调用已不再计入程序集的在途调用。
+     * 在工作线程上不能销毁主机，native_host_destroy 返回 ERROR_NOT_SUPPORTED。
+     *
+     * @param user_data native_parallel_options_t.user_data
+     */
+    typedef void (*native_parallel_callback_t)(void *user_data);
+
+    /**
+     * @brief 数据并行调用选项
+     */
+    typedef struct native_parallel_options
+    {
+        uint32_t max_threads; ///< 参与的线程数上限（同步调用时包括调用线程），0 表示线程池的全部线程
+        int64_t min_chunk;    ///< 单次调用内核处理的最小区间长度，0 表示按区间长度和线程数选择
+        /** 不为 NULL 时 native_host_parallel_for 立即返回，调用线程不参与，全部区间处理完后回调 */
+        native_parallel_callback_t on_completed;
+        void *user_data; ///< 传给 on_completed
+    } native_parallel_options_t;
+
+    /**
+     * @brief 在宿主的工作线程池上并行处理下标区间
+     *
+     * kernel 是通过 native_host_get_delegate 获取的内核，每次调用处理一个子区间 [begin, end)：
+     * 托管实现为 [UnmanagedCallersOnly] static void Kernel(long begin, long end, nint context)。
+     * 各子区间互不重叠，合起来恰好覆盖整个区间，同一子区间只在一个线程上处理。
+     *
+     * 区间先均分给参与的线程，每个线程从自己的区间头部取分块，分块大小随剩余量递减；
+     * 自己的区间处理完后从剩余最多的线程的区间尾部窃取一半，使各线程几乎同时结束。
+     * 线程池有硬件线程数减一个常驻工作线程，在首次并行调用时创建，并在启动时附加到运行时。
+     *
+     * 只在开始时短暂获取主机锁，可从多个线程并发调用。调用期间计入程序集的在途调用；
+     * 程序集已卸载或句柄无效时返回 ERROR_ASSEMBLY_NOT_FOUND。销毁主机时持有主机锁
+     * 等待已开始的调用完成，内核不应依赖主机锁才能结束。
+     *
+     * @param handle 主机实例句柄
+     * @param assembly_handle 内核所属的程序集句柄
+     * @param kernel 内核函数指针
+     * @param begin 区间起点
+     * @param end 区间终点（不含），不小于 begin
+     * @param context 传给每次内核调用的上下文
+     * @param options 并行选项，可以为 NULL
+     * @return NativeHostStatus 表示成功或失败的状态码；同步调用返回时整个区间已处理完
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_parallel_for(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly_handle,
+        void *kernel,
+        int64_t begin,
+        int64_t end,
+        void *context,
+        const native_parallel_options_t *options);
+
+    /**
+     * @brief 程序集资源统计信息
+     *
+     * 调用次数是精确值；CPU 时间和托管分配字节数只在被采样的调用中测量，
+     * 估算总量可按 value * invocations / sampled_invocations 外推。
+     */
+    typedef struct native_assembly_stats
+    {
+        uint64_t invocations;         ///< 通过调用作用域记录的调用次数
+        uint64_t sampled_invocations; ///< 被采样测量的调用次数
+        uint64_t cpu_time_ns;         ///< 采样调用消耗的线程 CPU 时间（纳秒）
+        uint64_t allocated_bytes;     ///< 采样调用中当前线程的托管分配字节数
+        int64_t retained_bytes;       ///< 加载上下文保留的托管堆大小，-1 表示运行时未提供
+    } native_assembly_stats_t;
+
+    /**
+     * @brief 调用作用域
+     *
+     * 由调用方在栈上分配，在 native_host_call_enter 和 native_host_call_leave 之间保持有效。
+     * 字段仅供内部使用。
+     */
+    typedef struct native_call_scope
+    {
+        native_assembly_handle_t assembly;
+        uint64_t cpu_start_ns;
+        int64_t allocated_start;
+        int32_t sampled;
+    } native_call_scope_t;
+
+    /**
+     * @brief 标记对程序集委托调用的开始
+     *
+     * 与 native_host_call_leave 成对使用，将两者之间的调用计入程序集的资源统计和在途调用。
+     * 作用域结束前程序集即使被卸载也不会被销毁，因此并发卸载不需要在每次调用外加锁。
+     * 此函数不获取主机锁，也不使用原子读改写，稳态开销为对本线程独占计数分片的一次写入。
+     * 程序集已卸载时返回 ERROR_ASSEMBLY_NOT_FOUND，此时不得调用委托，也不调用 native_host_call_leave。
+     * native_host_call_leave 可以在其他线程上调用。
+     *
+     * @param assembly_handle 被调用委托所属的程序集句柄
+     * @param[out] scope 调用作用域
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_call_enter(
+        native_assembly_handle_t assembly_handle,
+        /*out*/ native_call_scope_t *scope);
+
+    /**
+     * @brief 标记对程序集委托调用的结束
+     *
+     * @param scope 由 native_host_call_enter 填充的调用作用域
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_call_leave(native_call_scope_t *scope);
+
+    /**
+     * @brief 设置资源统计的采样率
+     *
+     * 每个线程每 rate 次调用测量一次 CPU 时间和分配字节数，1 表示测量所有调用，
+     * 0 表示只统计调用次数。默认值为 64。
+     *
+     * @param handle 主机实例句柄
+     * @param rate 采样间隔
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_set_stats_sample_rate(
+        native_host_handle_t handle,
+        uint32_t rate);
+
+    /**
+     * @brief 查询程序集的资源统计信息
+     *
+     * @param handle 主机实例句柄
+     * @param assembly_handle 已加载程序集的句柄
+     * @param[out] stats 接收统计信息的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_assembly_stats(
+        native_host_handle_t handle,
+        native_assembly_handle_t assembly_handle,
+        /*out*/ native_assembly_stats_t *stats);
+
+    /**
+     * @brief 宿主分配区的统计信息
+     *
+     * 分配区按线程划分，统计为进程内全部线程的汇总，包含已退出线程的累计值。
+     */
+    typedef struct native_arena_stats
+    {
+        uint64_t allocations;        ///< 累计分配次数
+        uint64_t allocated_bytes;    ///< 累计分配字节数
+        uint64_t live_allocations;   ///< 尚未重置的分配次数
+        uint64_t live_bytes;         ///< 尚未重置的分配字节数
+        uint64_t reserved_bytes;     ///< 各线程持有的块总大小，包括重置后保留复用的块
+        uint64_t resets;             ///< 重置次数
+        uint64_t leaked_allocations; ///< 线程退出时仍未重置的分配次数
+        uint64_t leaked_bytes;       ///< 线程退出时仍未重置的分配字节数
+        uint32_t thread_count;       ///< 当前持有分配区的线程数
+    } native_arena_stats_t;
+
+    /**
+     * @brief 从当前线程的宿主分配区分配内存
+     *
+     * 用于托管代码向本机调用方返回变长结果：插件通过 PluginSupport.HostArena 以函数指针调用此函数，
+     * 结果留在分配区中，调用方在请求结束时调用 native_host_arena_reset 一次性释放，不需要逐个释放。
+     * 分配只是在线程本地的块中移动指针，不加锁；块用完时向系统申请新的 64 KB 块，
+     * 超过块大小的分配独占一个块。
+     *
+     * 分配区属于调用线程：结果只在该线程重置之前有效。异步方法的完成回调运行在托管线程上，
+     * 在其中分配的内存属于该托管线程，不应由发起调用的线程重置。
+     * 不需要运行时即可调用，NativeAOT 插件可以直接导入此函数。
+     *
+     * @param size 字节数
+     * @param alignment 对齐，2 的幂且不超过 4096
+     * @return 分配的内存，参数无效或内存不足时返回 NULL
+     */
+    NATIVE_HOST_API void *native_host_arena_alloc(size_t size, size_t alignment);
+
+    /**
+     * @brief 释放当前线程宿主分配区中的全部分配
+     *
+     * 之前从本线程分配的指针全部失效。最多 1 MB 的标准块保留给后续分配复用，其余归还系统。
+     */
+    NATIVE_HOST_API void native_host_arena_reset(void);
+
+    /**
+     * @brief 查询宿主分配区的统计信息
+     *
+     * native_host_destroy 时仍有未重置的分配会被报告为泄漏。
+     *
+     * @param handle 主机实例句柄
+     * @param[out] stats 接收统计信息的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_arena_stats(
+        native_host_handle_t handle,
+        /*out*/ native_arena_stats_t *stats);
+
+    /**
+     * @brief 单个入口点采样的调用延迟
+     *
+     * 百分位来自对数线性分桶的直方图，相对误差不超过 1/32。
+     */
+    typedef struct native_latency_stats
+    {
+        uint64_t count;    ///< 采样的调用次数
+        uint64_t total_ns; ///< 采样调用的总耗时（纳秒）
+        uint64_t min_ns;   ///< 最短耗时（纳秒）
+        uint64_t max_ns;   ///< 最长耗时（纳秒）
+        uint64_t p50_ns;   ///< 中位数（纳秒）
+        uint64_t p90_ns;   ///< 90 百分位（纳秒）
+        uint64_t p99_ns;   ///< 99 百分位（纳秒）
+        uint64_t p999_ns;  ///< 99.9 百分位（纳秒）
+    } native_latency_stats_t;
+
+    /**
+     * @brief 一个计时跳板对应的入口点及其延迟
+     */
+    typedef struct native_latency_profile
+    {
+        native_assembly_handle_t assembly; ///< 获取委托时的程序集句柄
+        const char *type_name;             ///< 类型名称，有效期到主机销毁
+        const char *method_name;           ///< 方法名称，有效期到主机销毁
+        native_latency_stats_t stats;
+    } native_latency_profile_t;
+
+    /**
+     * @brief 开启或关闭按入口点的调用延迟剖析
+     *
+     * 开启后 native_host_get_delegate 和批量加载返回的不再是入口本身，而是按入口点生成的计时跳板，
+     * 同一入口点多次获取得到同一个跳板。跳板不依赖方法签名，插件不需要修改；
+     * 每个线程每 sample_rate 次经过跳板的调用计时一次，记录到线程独占的直方图中。
+     *
+     * 关闭后新获取的委托是入口本身，已发出的跳板直接跳转到入口、不再计时；再次开启后恢复计时。
+     * native_host_invoke 和 native_host_get_method 不经过跳板。
+     * 目前只支持 x86-64 Linux，其他平台开启时返回 ERROR_NOT_SUPPORTED。
+     *
+     * @param handle 主机实例句柄
+     * @param sample_rate 采样间隔，1 表示每次调用都计时，0 表示关闭
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_set_profiling(
+        native_host_handle_t handle,
+        uint32_t sample_rate);
+
+    /**
+     * @brief 导出各计时跳板的延迟快照
+     *
+     * 入口点按首次获取跳板的顺序排列，程序集卸载后其入口点仍保留。
+     * profiles 为 NULL 或容量不足时只填写前 capacity 项，count 总是返回入口点总数。
+     *
+     * @param handle 主机实例句柄
+     * @param[out] profiles 接收快照的数组，capacity 为 0 时可为 NULL
+     * @param capacity 数组容量
+     * @param[out] count 入口点总数
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_get_latency_profiles(
+        native_host_handle_t handle,
+        /*out*/ native_latency_profile_t *profiles,
+        uint32_t capacity,
+        /*out*/ uint32_t *count);
+
+    /**
+     * @brief 清空各计时跳板的延迟统计
+     *
+     * 与正在计时的调用并发时，个别样本可能丢失。
+     *
+     * @param handle 主机实例句柄
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_reset_latency_profiles(native_host_handle_t handle);
+
+    /**
+     * @brief 运行时事件跟踪的事件类别，可按位组合
+     */
+    typedef enum native_trace_keywords
+    {
+        NATIVE_TRACE_JIT = 0x1,    ///< JIT 编译和分层编译
+        NATIVE_TRACE_LOADER = 0x2, ///< 程序集和类型加载
+        NATIVE_TRACE_GC = 0x4,     ///< 垃圾回收和暂停
+    } native_trace_keywords_t;
+
+    /**
+     * @brief 运行时事件跟踪选项
+     */
+    typedef struct native_trace_options
+    {
+        uint32_t keywords;       ///< native_trace_keywords_t 的组合，0 表示全部
+        const char *output_path; ///< 可选，同时把事件录制为 .nettrace 文件，可用 PerfView 或 dotnet-trace 分析
+    } native_trace_options_t;
+
+    /**
+     * @brief 单个方法在跟踪期间的 JIT 统计，同名的重载和泛型实例合并统计
+     */
+    typedef struct native_method_trace_stats
+    {
+        uint32_t jit_count;             ///< JIT 编译次数
+        uint32_t tier_up_count;         ///< 已编译后再以 Tier1 重新编译的次数
+        uint32_t ready_to_run_rejected; ///< ReadyToRun 代码被拒绝而改为 JIT 的次数
+        int32_t optimization_tier;      ///< 最近一次编译的优化级别：1 MinOpts，2 完全优化，3 Tier0，4 Tier1
+        uint64_t jit_time_ns;           ///< JIT 编译总耗时（纳秒）
+        uint64_t max_jit_time_ns;       ///< 单次 JIT 编译的最长耗时（纳秒）
+    } native_method_trace_stats_t;
+
+    /**
+     * @brief 跟踪期间的进程级汇总
+     */
+    typedef struct native_trace_summary
+    {
+        uint64_t jit_count;           ///< JIT 编译的方法数
+        uint64_t jit_time_ns;         ///< JIT 编译总耗时（纳秒）
+        uint64_t type_load_count;     ///< 类型加载次数
+        uint64_t type_load_time_ns;   ///< 类型加载总耗时（纳秒）
+        uint64_t assembly_load_count; ///< 程序集加载次数
+        uint64_t gc_count;            ///< 垃圾回收次数
+        uint64_t gc_pause_count;      ///< 运行时暂停次数
+        uint64_t gc_pause_time_ns;    ///< 暂停总时长（纳秒）
+        uint64_t gc_max_pause_ns;     ///< 最长暂停（纳秒）
+    } native_trace_summary_t;
+
+    /**
+     * @brief 开始进程内的运行时事件跟踪
+     *
+     * 在进程内订阅运行时的 EventPipe 事件并按方法汇总，不需要附加外部工具。
+     * 新的跟踪会清空上一次的统计。事件由运行时分批派发，统计相对实际执行有短暂延迟。
+     * 需要支持程序集；设置 output_path 时还需要运行时的诊断端口可用。
+     * 隔离模式下的程序集运行在辅助进程中，不在跟踪范围内。
+     *
+     * @param handle 主机实例句柄
+     * @param options 跟踪选项，可为 NULL，表示跟踪全部类别且不录制文件
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_trace_start(
+        native_host_handle_t handle,
+        const native_trace_options_t *options);
+
+    /**
+     * @brief 停止运行时事件跟踪
+     *
+     * 统计保留到下一次开始跟踪，录制文件在返回前写完。
+     *
+     * @param handle 主机实例句柄
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_trace_stop(native_host_handle_t handle);
+
+    /**
+     * @brief 查询方法在跟踪期间的 JIT 统计
+     *
+     * 跟踪期间未编译的方法（如使用 ReadyToRun 代码或在跟踪开始前已编译）返回全零统计。
+     *
+     * @param handle 主机实例句柄
+     * @param type_name 类型名称，可带程序集限定
+     * @param method_name 方法名称
+     * @param[out] stats 接收统计信息的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_trace_get_method_stats(
+        native_host_handle_t handle,
+        const char *type_name,
+        const char *method_name,
+        /*out*/ native_method_trace_stats_t *stats);
+
+    /**
+     * @brief 查询跟踪期间的进程级汇总
+     *
+     * @param handle 主机实例句柄
+     * @param[out] summary 接收汇总的指针
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_trace_get_summary(
+        native_host_handle_t handle,
+        /*out*/ native_trace_summary_t *summary);
+
+    /**
+     * @brief 主机操作时间线的选项
+     */
+    typedef struct native_timeline_options
+    {
+        uint32_t events_per_thread; ///< 每个线程保留的最近记录数，0 表示 4096
+    } native_timeline_options_t;
+
+    /**
+     * @brief 开始记录主机操作的时间线
+     *
+     * 记录运行时初始化的各阶段（initialize、resolve_hostfxr、load_hostfxr、initialize_runtime、register_support，
+     * resolve_hostfxr 带 hostfxr 的来源和路径）、
+     * 每次程序集加载（load_assembly）、每次入口点解析（resolve_delegate、resolve_method，带类型和方法名）
+     * 以及等待主机锁的时间（host_lock_wait，带等待的接口名），按线程分开。
+     * 每个线程写入自己的环形缓冲区，写满后覆盖最早的记录。开始时清空之前的记录。
+     *
+     * 时间线是进程级的，不需要主机句柄，可以在 native_host_create 之前开始以覆盖整个启动过程；
+     * 开始、停止和写出都不获取主机锁。
+     *
+     * @param options 时间线选项，可为 NULL
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_timeline_start(const native_timeline_options_t *options);
+
+    /**
+     * @brief 停止记录时间线，已有的记录保留到下一次开始
+     *
+     * @return NativeHostStatus 表示成功或失败的状态码
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_timeline_stop(void);
+
+    /**
+     * @brief 把时间线写成 Chrome trace JSON 文件
+     *
+     * 文件可以直接在 ui.perfetto.dev 或 chrome://tracing 中打开，每个线程一条轨道。
+     * 记录期间也可以写出，写出不影响正在记录的线程。被覆盖的记录数写在 otherData.dropped_events 中。
+     *
+     * @param path 输出文件路径，UTF-8，已存在时覆盖
+     * @return NativeHostStatus 表示成功或失败的状态码，文件无法写入时为 ERROR_INVALID_ARG
+     */
+    NATIVE_HOST_API enum NativeHostStatus native_host_timeline_write(const char *path);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
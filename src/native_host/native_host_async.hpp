@@ -0,0 +1,172 @@
+/**
+ * @file native_host_async.hpp
+ * @brief 异步托管方法的 C++20 协程接口
+ *
+ * 在协程中等待按异步签名（'T' 开头）解析的方法，等待期间不占用线程：
+ *
+ * @code
+ * native_method_handle_t fetch;
+ * native_host_get_method(host, assembly, "Plugin.Api,Plugin", "FetchAsync", "Tii", &fetch);
+ *
+ * task handle(int id)
+ * {
+ *     int32_t value = co_await native_host::invoke_async<int32_t>(fetch, id);
+ * }
+ * @endcode
+ *
+ * 协程在完成任务的托管线程上恢复（任务已完成时在当前线程上直接继续），
+ * 需要回到自己的执行器时，由调用方在 co_await 之后自行调度。
+ */
+
+#pragma once
+
+#include "native_host.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace native_host
+{
+    /**
+     * @brief 异步调用失败时抛出的异常
+     */
+    class async_error : public std::runtime_error
+    {
+        NativeHostStatus status_;
+
+    public:
+        explicit async_error(NativeHostStatus status)
+            : std::runtime_error("native_host async call failed: " + std::to_string(static_cast<int>(status))),
+              status_(status)
+        {
+        }
+
+        NativeHostStatus status() const noexcept { return status_; }
+    };
+
+    inline native_value_t arg(native_value_t value)
+    {
+        return value;
+    }
+
+    inline native_value_t arg(int32_t value)
+    {
+        native_value_t result{};
+        result.i32 = value;
+        return result;
+    }
+
+    inline native_value_t arg(int64_t value)
+    {
+        native_value_t result{};
+        result.i64 = value;
+        return result;
+    }
+
+    inline native_value_t arg(double value)
+    {
+        native_value_t result{};
+        result.f64 = value;
+        return result;
+    }
+
+    /**
+     * @brief 等待一次异步调用的 awaitable
+     *
+     * @tparam T 任务结果类型：void、int32_t、int64_t 或 double
+     */
+    template <typename T>
+    class invoke_awaitable
+    {
+        static_assert(std::is_void_v<T> || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+                          std::is_same_v<T, double>,
+                      "result type must match a native_value_t member");
+
+    public:
+        static constexpr size_t max_args = 4;
+
+    private:
+        native_method_handle_t method_;
+        std::array<native_value_t, max_args> args_{};
+        std::coroutine_handle<> continuation_;
+        NativeHostStatus status_ = NativeHostStatus::SUCCESS;
+        native_value_t result_{};
+        // 回调和 await_suspend 中后到的一方负责恢复协程
+        std::atomic<bool> completed_{false};
+
+        static void on_complete(void *state, NativeHostStatus status, const native_value_t *result)
+        {
+            auto *self = static_cast<invoke_awaitable *>(state);
+            self->status_ = status;
+            if (result)
+            {
+                self->result_ = *result;
+            }
+            if (self->completed_.exchange(true, std::memory_order_acq_rel))
+            {
+                self->continuation_.resume();
+            }
+        }
+
+    public:
+        invoke_awaitable(native_method_handle_t method, const std::array<native_value_t, max_args> &args)
+            : method_(method), args_(args)
+        {
+        }
+
+        invoke_awaitable(const invoke_awaitable &) = delete;
+        invoke_awaitable &operator=(const invoke_awaitable &) = delete;
+
+        bool await_ready() const noexcept { return completed_.load(std::memory_order_relaxed); }
+
+        bool await_suspend(std::coroutine_handle<> continuation)
+        {
+            continuation_ = continuation;
+            auto status = native_host_invoke_async(method_, args_.data(), &on_complete, this);
+            if (status != NativeHostStatus::SUCCESS)
+            {
+                status_ = status;
+                return false;
+            }
+            // 回调已在调用内完成时不挂起
+            return !completed_.exchange(true, std::memory_order_acq_rel);
+        }
+
+        T await_resume() const
+        {
+            if (status_ != NativeHostStatus::SUCCESS)
+            {
+                throw async_error(status_);
+            }
+            if constexpr (std::is_same_v<T, int32_t>)
+                return result_.i32;
+            else if constexpr (std::is_same_v<T, int64_t>)
+                return result_.i64;
+            else if constexpr (std::is_same_v<T, double>)
+                return result_.f64;
+        }
+    };
+
+    /**
+     * @brief 发起异步调用，返回可在协程中等待的对象
+     *
+     * @param method 按异步签名解析的方法句柄
+     * @param args 参数，个数和类型与签名一致，每个参数经 arg() 转换为 native_value_t
+     */
+    template <typename T = void, typename... Args>
+    invoke_awaitable<T> invoke_async(native_method_handle_t method, Args... args)
+    {
+        static_assert(sizeof...(Args) <= invoke_awaitable<T>::max_args, "too many arguments");
+        return invoke_awaitable<T>(method, {arg(args)...});
+    }
+}
+
+#endif
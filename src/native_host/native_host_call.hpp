@@ -0,0 +1,75 @@
+/**
+ * @file native_host_call.hpp
+ * @brief 调用作用域的 C++ 封装
+ *
+ * 在作用域内调用委托，程序集在作用域结束前即使被其他线程卸载也不会被销毁：
+ *
+ * @code
+ * native_host::call_scope scope(assembly);
+ * if (scope)
+ * {
+ *     result = process(data, size);
+ * }
+ * @endcode
+ *
+ * 程序集已卸载时作用域为空，不得调用委托。
+ *
+ * 按签名解析的方法也可以在作用域内通过 method_pointer 直接调用，不经过 native_host_invoke 的参数打包：
+ *
+ * @code
+ * auto add = native_host::method_pointer<int32_t (*)(int32_t, int32_t)>(method);
+ * result = add(a, b);
+ * @endcode
+ */
+
+#pragma once
+
+#include "native_host.h"
+
+#ifdef __cplusplus
+
+namespace native_host
+{
+    class call_scope
+    {
+        native_call_scope_t scope_{};
+        NativeHostStatus status_;
+
+    public:
+        explicit call_scope(native_assembly_handle_t assembly) noexcept
+            : status_(native_host_call_enter(assembly, &scope_))
+        {
+        }
+
+        ~call_scope()
+        {
+            if (status_ == NativeHostStatus::SUCCESS)
+            {
+                native_host_call_leave(&scope_);
+            }
+        }
+
+        call_scope(const call_scope &) = delete;
+        call_scope &operator=(const call_scope &) = delete;
+
+        /**
+         * @brief 是否已进入，为 false 时程序集已卸载或句柄无效
+         */
+        explicit operator bool() const noexcept { return status_ == NativeHostStatus::SUCCESS; }
+
+        NativeHostStatus status() const noexcept { return status_; }
+    };
+
+    /**
+     * @brief 以函数指针类型获取方法的入口，隔离的程序集中的方法返回 nullptr
+     *
+     * 以 native_host_static 链接并启用 LTO 时编译为一次内存读取。
+     */
+    template <typename Fn>
+    Fn method_pointer(native_method_handle_t method) noexcept
+    {
+        return reinterpret_cast<Fn>(native_host_method_pointer(method));
+    }
+}
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file native_host_pack.cpp
+ * @brief 把目录中的程序集打包为插件包
+ *
+ * 用法：native_host_pack <目录> <输出文件>
+ *
+ * 打包目录顶层的全部 .dll 文件，条目按文件名排序，名称即文件名。
+ * 输出先写入临时文件再改名，打包失败不会留下不完整的插件包。
+ */
+
+#include "plugin_bundle.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+    struct Input
+    {
+        std::filesystem::path path;
+        std::string name;
+        uint64_t size = 0;
+    };
+
+    bool is_assembly(const std::filesystem::path &path)
+    {
+        auto extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".dll";
+    }
+
+    bool collect_inputs(const std::filesystem::path &directory, std::vector<Input> &inputs)
+    {
+        std::error_code ec;
+        for (const auto &item : std::filesystem::directory_iterator(directory, ec))
+        {
+            if (item.is_regular_file() && is_assembly(item.path()))
+            {
+                inputs.push_back({item.path(), item.path().filename().u8string(), item.file_size()});
+            }
+        }
+        if (ec)
+        {
+            std::cerr << "Failed to read directory " << directory << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+        std::sort(inputs.begin(), inputs.end(),
+                  [](const Input &a, const Input &b) { return a.name < b.name; });
+        return true;
+    }
+
+    bool write_bundle(const std::vector<Input> &inputs, const std::filesystem::path &output)
+    {
+        using namespace PluginBundle;
+
+        std::string names;
+        std::vector<Entry> entries(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            entries[i].name_offset = static_cast<uint32_t>(names.size());
+            entries[i].name_size = static_cast<uint32_t>(inputs[i].name.size());
+            entries[i].size = inputs[i].size;
+            names += inputs[i].name;
+        }
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.entry_count = static_cast<uint32_t>(entries.size());
+        header.names_offset = sizeof(Header) + entries.size() * sizeof(Entry);
+        header.names_size = names.size();
+
+        uint64_t offset = align(header.names_offset + header.names_size);
+        for (auto &entry : entries)
+        {
+            entry.offset = offset;
+            offset = align(offset + entry.size);
+        }
+
+        std::ofstream file(output, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Entry));
+        file.write(names.data(), names.size());
+
+        std::vector<char> buffer;
+        for (size_t i = 0; i < inputs.size() && file; ++i)
+        {
+            buffer.assign(entries[i].offset - static_cast<uint64_t>(file.tellp()), '\0');
+            file.write(buffer.data(), buffer.size());
+
+            std::ifstream image(inputs[i].path, std::ios::binary);
+            buffer.resize(inputs[i].size);
+            if (!image.read(buffer.data(), buffer.size()))
+            {
+                std::cerr << "Failed to read " << inputs[i].path << std::endl;
+                return false;
+            }
+            file.write(buffer.data(), buffer.size());
+        }
+
+        if (!file.flush())
+        {
+            std::cerr << "Failed to write " << output << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: native_host_pack <directory> <output>" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path directory = argv[1];
+    std::filesystem::path output = argv[2];
+
+    std::vector<Input> inputs;
+    if (!collect_inputs(directory, inputs))
+    {
+        return 1;
+    }
+
+    auto temporary = output;
+    temporary += ".tmp";
+    if (!write_bundle(inputs, temporary))
+    {
+        std::filesystem::remove(temporary);
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, output, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to replace " << output << ": " << ec.message() << std::endl;
+        std::filesystem::remove(temporary);
+        return 1;
+    }
+
+    std::cout << "Packed " << inputs.size() << " assemblies into " << output.u8string() << std::endl;
+    return 0;
+}
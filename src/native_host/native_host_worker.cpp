@@ -0,0 +1,316 @@
+/**
+ * @file native_host_worker.cpp
+ * @brief 隔离模式的辅助进程
+ *
+ * 由 native_host 在隔离模式下启动，通过继承的共享内存描述符接收请求，
+ * 使用进程内的 native_host 接口加载程序集并执行调用。
+ * 插件崩溃只会结束本进程，宿主检测到后启动新的辅助进程。
+ */
+
+#include "native_host.h"
+#include "isolation_channel.h"
+#include <chrono>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    struct Options
+    {
+        int fd = -1;
+        int parent_fd = -1;
+        std::string runtime_config_path;
+        std::string dotnet_root;
+        std::string hostfxr_path;
+    };
+
+    bool parse_arguments(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            std::string name = argv[i];
+            if (name == "--fd")
+            {
+                options.fd = std::atoi(argv[i + 1]);
+            }
+            else if (name == "--parent-fd")
+            {
+                options.parent_fd = std::atoi(argv[i + 1]);
+            }
+            else if (name == "--runtime-config")
+            {
+                options.runtime_config_path = argv[i + 1];
+            }
+            else if (name == "--dotnet-root")
+            {
+                options.dotnet_root = argv[i + 1];
+            }
+            else if (name == "--hostfxr")
+            {
+                options.hostfxr_path = argv[i + 1];
+            }
+            else
+            {
+                std::cerr << "Unknown argument: " << name << std::endl;
+                return false;
+            }
+        }
+        return options.fd >= 0 && options.parent_fd >= 0;
+    }
+
+#ifdef __linux__
+    class Worker
+    {
+        struct MethodEntry
+        {
+            uint32_t assembly_id;
+            native_method_handle_t handle;
+        };
+
+        IsolationChannel::Region *region_;
+        const Options &options_;
+        native_host_handle_t host_ = nullptr;
+        bool runtime_initialized_ = false;
+        std::unordered_map<uint32_t, native_assembly_handle_t> assemblies_;
+        std::unordered_map<uint32_t, MethodEntry> methods_;
+
+        static constexpr auto idle_timeout = std::chrono::milliseconds(1000);
+
+        NativeHostStatus initialize_runtime()
+        {
+            native_host_runtime_options_t runtime_options{sizeof(runtime_options)};
+            runtime_options.runtime_config_path = options_.runtime_config_path.c_str();
+            if (!options_.dotnet_root.empty())
+            {
+                runtime_options.dotnet_root = options_.dotnet_root.c_str();
+            }
+            if (!options_.hostfxr_path.empty())
+            {
+                runtime_options.hostfxr_path = options_.hostfxr_path.c_str();
+            }
+
+            auto status = native_host_initialize_with_options(host_, &runtime_options);
+            runtime_initialized_ = status == NativeHostStatus::SUCCESS;
+            return status;
+        }
+
+        NativeHostStatus load_assembly(IsolationChannel::Slot &slot)
+        {
+            native_assembly_handle_t assembly = nullptr;
+            auto status = native_host_load_assembly(host_, slot.payload, &assembly);
+
+            // CoreCLR 只在第一次加载托管程序集时启动，只加载 NativeAOT 库时不需要
+            if (status == NativeHostStatus::ERROR_ASSEMBLY_NOT_INITIALIZED && !runtime_initialized_)
+            {
+                status = initialize_runtime();
+                if (status == NativeHostStatus::SUCCESS)
+                {
+                    status = native_host_load_assembly(host_, slot.payload, &assembly);
+                }
+            }
+
+            if (status == NativeHostStatus::SUCCESS)
+            {
+                assemblies_[slot.target] = assembly;
+            }
+            return status;
+        }
+
+        NativeHostStatus unload_assembly(IsolationChannel::Slot &slot)
+        {
+            auto it = assemblies_.find(slot.target);
+            if (it == assemblies_.end())
+            {
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            for (auto method = methods_.begin(); method != methods_.end();)
+            {
+                method = method->second.assembly_id == slot.target ? methods_.erase(method) : std::next(method);
+            }
+
+            auto status = native_host_unload_assembly(host_, it->second);
+            assemblies_.erase(it);
+            return status;
+        }
+
+        NativeHostStatus get_method(IsolationChannel::Slot &slot)
+        {
+            auto it = assemblies_.find(slot.target);
+            if (it == assemblies_.end())
+            {
+                return NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND;
+            }
+
+            const char *type_name = slot.payload;
+            const char *method_name = type_name + std::strlen(type_name) + 1;
+            const char *signature = method_name + std::strlen(method_name) + 1;
+
+            native_method_handle_t method = nullptr;
+            auto status = native_host_get_method(host_, it->second, type_name, method_name, signature, &method);
+            if (status == NativeHostStatus::SUCCESS)
+            {
+                methods_[slot.aux] = {slot.target, method};
+            }
+            return status;
+        }
+
+        NativeHostStatus invoke(IsolationChannel::Slot &slot)
+        {
+            auto it = methods_.find(slot.target);
+            if (it == methods_.end())
+            {
+                return NativeHostStatus::ERROR_METHOD_LOAD;
+            }
+            return native_host_invoke(it->second.handle, slot.args, &slot.result);
+        }
+
+        void process(IsolationChannel::Slot &slot)
+        {
+            using IsolationChannel::Op;
+
+            slot.payload[IsolationChannel::PAYLOAD_SIZE - 1] = '\0';
+
+            NativeHostStatus status;
+            switch (slot.op)
+            {
+            case Op::Invoke:
+                status = invoke(slot);
+                break;
+            case Op::LoadAssembly:
+                status = load_assembly(slot);
+                break;
+            case Op::UnloadAssembly:
+                status = unload_assembly(slot);
+                break;
+            case Op::GetMethod:
+                status = get_method(slot);
+                break;
+            default:
+                status = NativeHostStatus::ERROR_INVALID_ARG;
+                break;
+            }
+
+            slot.status = status;
+            slot.state.store(IsolationChannel::SLOT_DONE, std::memory_order_seq_cst);
+            if (slot.waiting.load(std::memory_order_seq_cst))
+            {
+                IsolationChannel::futex_wake(&slot.state);
+            }
+        }
+
+        void wait_for_work()
+        {
+            using namespace IsolationChannel;
+
+            // 连续调用在自旋阶段被取走，不需要宿主敲门铃唤醒
+            auto deadline = std::chrono::steady_clock::now() + spin_time();
+            uint32_t spins = 0;
+            while (!region_->queue.ready())
+            {
+                if ((++spins & 63) == 0 && std::chrono::steady_clock::now() >= deadline)
+                {
+                    break;
+                }
+                cpu_relax();
+            }
+
+            region_->worker_sleeping.store(1, std::memory_order_seq_cst);
+            uint32_t seen = region_->doorbell.load(std::memory_order_seq_cst);
+            if (!region_->queue.ready())
+            {
+                futex_wait(&region_->doorbell, seen, idle_timeout);
+            }
+            region_->worker_sleeping.store(0, std::memory_order_relaxed);
+        }
+
+    public:
+        Worker(IsolationChannel::Region *region, const Options &options)
+            : region_(region), options_(options)
+        {
+        }
+
+        bool start()
+        {
+            return native_host_create(&host_) == NativeHostStatus::SUCCESS;
+        }
+
+        void run()
+        {
+            for (;;)
+            {
+                uint32_t index = 0;
+                if (region_->queue.pop(index))
+                {
+                    process(region_->slots[index]);
+                    continue;
+                }
+                wait_for_work();
+            }
+        }
+    };
+#endif
+}
+
+int main(int argc, char **argv)
+{
+#ifdef __linux__
+    Options options;
+    if (!parse_arguments(argc, argv, options))
+    {
+        std::cerr << "Usage: native_host_worker --fd <shared memory fd> --parent-fd <pipe fd>"
+                     " [--runtime-config <path>] [--dotnet-root <path>] [--hostfxr <path>]"
+                  << std::endl;
+        return 1;
+    }
+
+    // 宿主进程持有管道写端，宿主退出（包括在启动本进程之前已退出）后读到 EOF，随即结束
+    std::thread([fd = options.parent_fd]
+                {
+        char byte;
+        while (read(fd, &byte, 1) < 0 && errno == EINTR)
+        {
+        }
+        _exit(1); })
+        .detach();
+
+    void *memory = mmap(nullptr, sizeof(IsolationChannel::Region), PROT_READ | PROT_WRITE, MAP_SHARED, options.fd, 0);
+    close(options.fd);
+    if (memory == MAP_FAILED)
+    {
+        std::cerr << "Failed to map isolation channel" << std::endl;
+        return 1;
+    }
+
+    auto *region = static_cast<IsolationChannel::Region *>(memory);
+    if (region->magic != IsolationChannel::MAGIC || region->version != IsolationChannel::VERSION)
+    {
+        std::cerr << "Isolation channel version mismatch" << std::endl;
+        return 1;
+    }
+
+    Worker worker(region, options);
+    if (!worker.start())
+    {
+        std::cerr << "Failed to create native host" << std::endl;
+        return 1;
+    }
+    worker.run();
+    return 0;
+#else
+    (void)argc;
+    (void)argv;
+    std::cerr << "Process isolation is not supported on this platform" << std::endl;
+    return 1;
+#endif
+}
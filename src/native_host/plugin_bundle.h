@@ -0,0 +1,102 @@
+/**
+ * @file plugin_bundle.h
+ * @brief 插件包的文件格式（内部头文件）
+ *
+ * 插件包把一个目录中的程序集打包为单个文件，宿主映射一次后直接从映射中提供各程序集的镜像，
+ * 省去逐个文件的打开和状态查询。布局（小端）：
+ *
+ * 1. Header：魔数、版本、条目数和名称表位置
+ * 2. Entry[entry_count]：各镜像的偏移、大小和名称在名称表中的位置
+ * 3. 名称表：UTF-8 文件名，不以 \0 结尾
+ * 4. 镜像数据，每个镜像按 IMAGE_ALIGNMENT 对齐
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace PluginBundle
+{
+    constexpr char MAGIC[8] = {'N', 'H', 'B', 'U', 'N', 'D', 'L', 'E'};
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t IMAGE_ALIGNMENT = 16;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t entry_count;
+        uint64_t names_offset;
+        uint64_t names_size;
+    };
+
+    struct Entry
+    {
+        uint64_t offset;      ///< 镜像相对文件开头的偏移
+        uint64_t size;        ///< 镜像字节数
+        uint32_t name_offset; ///< 名称在名称表中的偏移
+        uint32_t name_size;   ///< 名称字节数
+    };
+
+    static_assert(sizeof(Header) == 32, "bundle header layout is part of the file format");
+    static_assert(sizeof(Entry) == 24, "bundle entry layout is part of the file format");
+
+    inline uint64_t align(uint64_t offset)
+    {
+        return (offset + IMAGE_ALIGNMENT - 1) & ~(IMAGE_ALIGNMENT - 1);
+    }
+
+    /**
+     * @brief 检查映射内容是否为完整的插件包，所有偏移都在文件范围内
+     *
+     * @param data 文件内容
+     * @param size 文件字节数
+     * @param[out] error 失败原因
+     * @return 插件包有效时返回 true
+     */
+    inline bool validate(const uint8_t *data, uint64_t size, std::string &error)
+    {
+        if (size < sizeof(Header))
+        {
+            error = "file too small";
+            return false;
+        }
+
+        Header header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            error = "bad magic";
+            return false;
+        }
+        if (header.version != VERSION)
+        {
+            error = "unsupported version " + std::to_string(header.version);
+            return false;
+        }
+
+        uint64_t entries_end = sizeof(Header) + static_cast<uint64_t>(header.entry_count) * sizeof(Entry);
+        if (entries_end > size || header.names_offset < entries_end ||
+            header.names_offset > size || header.names_size > size - header.names_offset)
+        {
+            error = "index out of range";
+            return false;
+        }
+
+        for (uint32_t i = 0; i < header.entry_count; ++i)
+        {
+            Entry entry;
+            std::memcpy(&entry, data + sizeof(Header) + i * sizeof(Entry), sizeof(entry));
+            if (entry.name_offset > header.names_size || entry.name_size > header.names_size - entry.name_offset ||
+                entry.offset > size || entry.size > size - entry.offset)
+            {
+                error = "entry " + std::to_string(i) + " out of range";
+                return false;
+            }
+        }
+        return true;
+    }
+}
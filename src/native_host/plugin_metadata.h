@@ -0,0 +1,994 @@
+/**
+ * @file plugin_metadata.h
+ * @brief 从程序集元数据中读取 [UnmanagedCallersOnly] 导出（内部头文件）
+ *
+ * 按 ECMA-335 第 II 部分直接解析 PE 镜像中的 CLI 元数据，不经过运行时：
+ *
+ * 1. PE 头和节表：定位 CLI 头（数据目录 14）和元数据根
+ * 2. 元数据根：#~ 表流、#Strings 和 #Blob 堆
+ * 3. 表：按各表的列定义计算行宽和偏移，读取 Assembly、TypeDef、MethodDef、MemberRef、
+ *    TypeRef、CustomAttribute 和 NestedClass
+ *
+ * 构造函数为 System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute 的特性所修饰的方法即为导出，
+ * 方法签名按 native_plugin_export_t::signature 的字母表编码，特性的 EntryPoint 命名参数原样返回。
+ * 所有读取都检查边界，损坏的镜像只返回错误。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace PluginMetadata
+{
+    struct Export
+    {
+        std::string type_name;   ///< 程序集限定的类型名，如 Ns.Type,Assembly；嵌套类型用 + 连接
+        std::string method_name; ///< 方法名
+        bool has_entry_point = false;
+        std::string entry_point; ///< 特性的 EntryPoint 命名参数
+        std::string signature;   ///< 签名，返回类型在前
+    };
+
+    struct Assembly
+    {
+        std::string name; ///< 程序集简单名称
+        std::vector<Export> exports;
+    };
+
+    namespace detail
+    {
+        enum Table : uint8_t
+        {
+            MODULE = 0x00,
+            TYPE_REF = 0x01,
+            TYPE_DEF = 0x02,
+            FIELD_PTR = 0x03,
+            FIELD = 0x04,
+            METHOD_PTR = 0x05,
+            METHOD_DEF = 0x06,
+            PARAM_PTR = 0x07,
+            PARAM = 0x08,
+            INTERFACE_IMPL = 0x09,
+            MEMBER_REF = 0x0a,
+            CONSTANT = 0x0b,
+            CUSTOM_ATTRIBUTE = 0x0c,
+            FIELD_MARSHAL = 0x0d,
+            DECL_SECURITY = 0x0e,
+            CLASS_LAYOUT = 0x0f,
+            FIELD_LAYOUT = 0x10,
+            STAND_ALONE_SIG = 0x11,
+            EVENT_MAP = 0x12,
+            EVENT_PTR = 0x13,
+            EVENT = 0x14,
+            PROPERTY_MAP = 0x15,
+            PROPERTY_PTR = 0x16,
+            PROPERTY = 0x17,
+            METHOD_SEMANTICS = 0x18,
+            METHOD_IMPL = 0x19,
+            MODULE_REF = 0x1a,
+            TYPE_SPEC = 0x1b,
+            IMPL_MAP = 0x1c,
+            FIELD_RVA = 0x1d,
+            ENC_LOG = 0x1e,
+            ENC_MAP = 0x1f,
+            ASSEMBLY = 0x20,
+            ASSEMBLY_PROCESSOR = 0x21,
+            ASSEMBLY_OS = 0x22,
+            ASSEMBLY_REF = 0x23,
+            ASSEMBLY_REF_PROCESSOR = 0x24,
+            ASSEMBLY_REF_OS = 0x25,
+            FILE = 0x26,
+            EXPORTED_TYPE = 0x27,
+            MANIFEST_RESOURCE = 0x28,
+            NESTED_CLASS = 0x29,
+            GENERIC_PARAM = 0x2a,
+            METHOD_SPEC = 0x2b,
+            GENERIC_PARAM_CONSTRAINT = 0x2c,
+            TABLE_COUNT = 0x2d,
+            NONE = 0xff
+        };
+
+        /**
+         * @brief 编码索引：低 bits 位是目标表在 tables 中的下标，NONE 表示未使用的标记值
+         */
+        struct CodedIndex
+        {
+            uint8_t bits;
+            uint8_t count;
+            uint8_t tables[22];
+        };
+
+        enum Coded : uint8_t
+        {
+            TYPE_DEF_OR_REF,
+            HAS_CONSTANT,
+            HAS_CUSTOM_ATTRIBUTE,
+            HAS_FIELD_MARSHAL,
+            HAS_DECL_SECURITY,
+            MEMBER_REF_PARENT,
+            HAS_SEMANTICS,
+            METHOD_DEF_OR_REF,
+            MEMBER_FORWARDED,
+            IMPLEMENTATION,
+            CUSTOM_ATTRIBUTE_TYPE,
+            RESOLUTION_SCOPE,
+            TYPE_OR_METHOD_DEF,
+            CODED_COUNT
+        };
+
+        constexpr CodedIndex CODED_INDICES[CODED_COUNT] = {
+            {2, 3, {TYPE_DEF, TYPE_REF, TYPE_SPEC}},
+            {2, 3, {FIELD, PARAM, PROPERTY}},
+            {5, 22, {METHOD_DEF, FIELD, TYPE_REF, TYPE_DEF, PARAM, INTERFACE_IMPL, MEMBER_REF, MODULE, DECL_SECURITY,
+                     PROPERTY, EVENT, STAND_ALONE_SIG, MODULE_REF, TYPE_SPEC, ASSEMBLY, ASSEMBLY_REF, FILE, EXPORTED_TYPE,
+                     MANIFEST_RESOURCE, GENERIC_PARAM, GENERIC_PARAM_CONSTRAINT, METHOD_SPEC}},
+            {1, 2, {FIELD, PARAM}},
+            {2, 3, {TYPE_DEF, METHOD_DEF, ASSEMBLY}},
+            {3, 5, {TYPE_DEF, TYPE_REF, MODULE_REF, METHOD_DEF, TYPE_SPEC}},
+            {1, 2, {EVENT, PROPERTY}},
+            {1, 2, {METHOD_DEF, MEMBER_REF}},
+            {1, 2, {FIELD, METHOD_DEF}},
+            {2, 3, {FILE, ASSEMBLY_REF, EXPORTED_TYPE}},
+            {3, 5, {NONE, NONE, METHOD_DEF, MEMBER_REF, NONE}},
+            {2, 4, {MODULE, MODULE_REF, ASSEMBLY_REF, TYPE_REF}},
+            {1, 2, {TYPE_DEF, METHOD_DEF}},
+        };
+
+        enum class Kind : uint8_t
+        {
+            End,
+            U16,
+            U32,
+            String,
+            Guid,
+            Blob,
+            Index, ///< 指向 target 表的简单索引
+            Coded  ///< target 种类的编码索引
+        };
+
+        struct Column
+        {
+            Kind kind;
+            uint8_t target;
+        };
+
+        constexpr Column u16{Kind::U16, 0};
+        constexpr Column u32{Kind::U32, 0};
+        constexpr Column str{Kind::String, 0};
+        constexpr Column guid{Kind::Guid, 0};
+        constexpr Column blob{Kind::Blob, 0};
+        constexpr Column index(Table table) { return {Kind::Index, table}; }
+        constexpr Column coded(Coded kind) { return {Kind::Coded, kind}; }
+
+        constexpr size_t MAX_COLUMNS = 9;
+
+        // ECMA-335 II.22 中各表的列，顺序与 Table 一致；Constant 的 Type 列带一个填充字节，按 u16 计
+        constexpr Column SCHEMA[TABLE_COUNT][MAX_COLUMNS] = {
+            {u16, str, guid, guid, guid},                                                            // Module
+            {coded(RESOLUTION_SCOPE), str, str},                                                     // TypeRef
+            {u32, str, str, coded(TYPE_DEF_OR_REF), index(FIELD), index(METHOD_DEF)},                // TypeDef
+            {index(FIELD)},                                                                          // FieldPtr
+            {u16, str, blob},                                                                        // Field
+            {index(METHOD_DEF)},                                                                     // MethodPtr
+            {u32, u16, u16, str, blob, index(PARAM)},                                                // MethodDef
+            {index(PARAM)},                                                                          // ParamPtr
+            {u16, u16, str},                                                                         // Param
+            {index(TYPE_DEF), coded(TYPE_DEF_OR_REF)},                                               // InterfaceImpl
+            {coded(MEMBER_REF_PARENT), str, blob},                                                   // MemberRef
+            {u16, coded(HAS_CONSTANT), blob},                                                        // Constant
+            {coded(HAS_CUSTOM_ATTRIBUTE), coded(CUSTOM_ATTRIBUTE_TYPE), blob},                       // CustomAttribute
+            {coded(HAS_FIELD_MARSHAL), blob},                                                        // FieldMarshal
+            {u16, coded(HAS_DECL_SECURITY), blob},                                                   // DeclSecurity
+            {u16, u32, index(TYPE_DEF)},                                                             // ClassLayout
+            {u32, index(FIELD)},                                                                     // FieldLayout
+            {blob},                                                                                  // StandAloneSig
+            {index(TYPE_DEF), index(EVENT)},                                                         // EventMap
+            {index(EVENT)},                                                                          // EventPtr
+            {u16, str, coded(TYPE_DEF_OR_REF)},                                                      // Event
+            {index(TYPE_DEF), index(PROPERTY)},                                                      // PropertyMap
+            {index(PROPERTY)},                                                                       // PropertyPtr
+            {u16, str, blob},                                                                        // Property
+            {u16, index(METHOD_DEF), coded(HAS_SEMANTICS)},                                          // MethodSemantics
+            {index(TYPE_DEF), coded(METHOD_DEF_OR_REF), coded(METHOD_DEF_OR_REF)},                   // MethodImpl
+            {str},                                                                                   // ModuleRef
+            {blob},                                                                                  // TypeSpec
+            {u16, coded(MEMBER_FORWARDED), str, index(MODULE_REF)},                                  // ImplMap
+            {u32, index(FIELD)},                                                                     // FieldRVA
+            {u32, u32},                                                                              // EncLog
+            {u32},                                                                                   // EncMap
+            {u32, u16, u16, u16, u16, u32, blob, str, str},                                          // Assembly
+            {u32},                                                                                   // AssemblyProcessor
+            {u32, u32, u32},                                                                         // AssemblyOS
+            {u16, u16, u16, u16, u32, blob, str, str, blob},                                         // AssemblyRef
+            {u32, index(ASSEMBLY_REF)},                                                              // AssemblyRefProcessor
+            {u32, u32, u32, index(ASSEMBLY_REF)},                                                    // AssemblyRefOS
+            {u32, str, blob},                                                                        // File
+            {u32, u32, str, str, coded(IMPLEMENTATION)},                                             // ExportedType
+            {u32, u32, str, coded(IMPLEMENTATION)},                                                  // ManifestResource
+            {index(TYPE_DEF), index(TYPE_DEF)},                                                      // NestedClass
+            {u16, u16, coded(TYPE_OR_METHOD_DEF), str},                                              // GenericParam
+            {coded(METHOD_DEF_OR_REF), blob},                                                        // MethodSpec
+            {index(GENERIC_PARAM), coded(TYPE_DEF_OR_REF)},                                          // GenericParamConstraint
+        };
+
+        inline uint32_t read_u16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+        inline uint32_t read_u32(const uint8_t *p)
+        {
+            return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        /**
+         * @brief 带边界检查的顺序读取，用于签名和特性值的 blob
+         */
+        struct Cursor
+        {
+            const uint8_t *p;
+            const uint8_t *end;
+            bool ok = true;
+
+            uint32_t byte()
+            {
+                if (p >= end)
+                {
+                    ok = false;
+                    return 0;
+                }
+                return *p++;
+            }
+
+            void skip(size_t count)
+            {
+                if (static_cast<size_t>(end - p) < count)
+                {
+                    ok = false;
+                    p = end;
+                    return;
+                }
+                p += count;
+            }
+
+            uint32_t u16()
+            {
+                uint32_t low = byte();
+                return low | (byte() << 8);
+            }
+
+            /**
+             * @brief 压缩无符号整数（II.23.2）
+             */
+            uint32_t compressed()
+            {
+                uint32_t first = byte();
+                if ((first & 0x80) == 0)
+                    return first;
+                if ((first & 0xc0) == 0x80)
+                    return ((first & 0x3f) << 8) | byte();
+                if ((first & 0xe0) == 0xc0)
+                {
+                    uint32_t value = (first & 0x1f) << 24;
+                    value |= byte() << 16;
+                    value |= byte() << 8;
+                    return value | byte();
+                }
+                ok = false;
+                return 0;
+            }
+
+            /**
+             * @brief 特性值中的 SerString，0xff 表示 null
+             */
+            bool ser_string(std::string &value, bool &is_null)
+            {
+                is_null = p < end && *p == 0xff;
+                if (is_null)
+                {
+                    ++p;
+                    return true;
+                }
+                uint32_t length = compressed();
+                if (!ok || static_cast<size_t>(end - p) < length)
+                {
+                    ok = false;
+                    return false;
+                }
+                value.assign(reinterpret_cast<const char *>(p), length);
+                p += length;
+                return true;
+            }
+        };
+
+        namespace ElementType
+        {
+            constexpr uint8_t VOID = 0x01, BOOLEAN = 0x02, CHAR = 0x03, I1 = 0x04, U1 = 0x05, I2 = 0x06, U2 = 0x07,
+                              I4 = 0x08, U4 = 0x09, I8 = 0x0a, U8 = 0x0b, R4 = 0x0c, R8 = 0x0d, STRING = 0x0e,
+                              PTR = 0x0f, BYREF = 0x10, VALUETYPE = 0x11, CLASS = 0x12, VAR = 0x13, ARRAY = 0x14,
+                              GENERICINST = 0x15, TYPEDBYREF = 0x16, I = 0x18, U = 0x19, FNPTR = 0x1b,
+                              OBJECT = 0x1c, SZARRAY = 0x1d, MVAR = 0x1e, CMOD_REQD = 0x1f, CMOD_OPT = 0x20,
+                              SENTINEL = 0x41, PINNED = 0x45, SYSTEM_TYPE = 0x50, BOXED = 0x51, ENUM = 0x55;
+        }
+
+        bool skip_method_signature(Cursor &cursor, int depth);
+
+        /**
+         * @brief 跳过签名中的一个类型（II.23.2.12）
+         */
+        inline bool skip_type(Cursor &cursor, int depth)
+        {
+            if (depth > 32)
+                return false;
+
+            uint32_t element = cursor.byte();
+            switch (element)
+            {
+            case ElementType::CMOD_REQD:
+            case ElementType::CMOD_OPT:
+                cursor.compressed();
+                return skip_type(cursor, depth + 1);
+            case ElementType::PTR:
+            case ElementType::BYREF:
+            case ElementType::SZARRAY:
+            case ElementType::PINNED:
+                return skip_type(cursor, depth + 1);
+            case ElementType::VALUETYPE:
+            case ElementType::CLASS:
+            case ElementType::VAR:
+            case ElementType::MVAR:
+                cursor.compressed();
+                return cursor.ok;
+            case ElementType::FNPTR:
+                return skip_method_signature(cursor, depth + 1);
+            case ElementType::GENERICINST:
+            {
+                cursor.byte();
+                cursor.compressed();
+                uint32_t count = cursor.compressed();
+                for (uint32_t i = 0; i < count && cursor.ok; ++i)
+                {
+                    if (!skip_type(cursor, depth + 1))
+                        return false;
+                }
+                return cursor.ok;
+            }
+            case ElementType::ARRAY:
+            {
+                if (!skip_type(cursor, depth + 1))
+                    return false;
+                cursor.compressed(); // rank
+                uint32_t sizes = cursor.compressed();
+                for (uint32_t i = 0; i < sizes && cursor.ok; ++i)
+                    cursor.compressed();
+                uint32_t bounds = cursor.compressed();
+                for (uint32_t i = 0; i < bounds && cursor.ok; ++i)
+                    cursor.compressed();
+                return cursor.ok;
+            }
+            default:
+                return cursor.ok && element != 0;
+            }
+        }
+
+        inline bool skip_method_signature(Cursor &cursor, int depth)
+        {
+            uint32_t convention = cursor.byte();
+            if (convention & 0x10)
+                cursor.compressed(); // 泛型参数个数
+            uint32_t count = cursor.compressed();
+            if (!skip_type(cursor, depth))
+                return false;
+            for (uint32_t i = 0; i < count && cursor.ok; ++i)
+            {
+                if (cursor.p < cursor.end && *cursor.p == ElementType::SENTINEL)
+                    cursor.byte();
+                if (!skip_type(cursor, depth))
+                    return false;
+            }
+            return cursor.ok;
+        }
+
+        /**
+         * @brief 把一个参数或返回值的类型映射为签名字母
+         */
+        inline char encode_type(Cursor &cursor)
+        {
+            while (cursor.p < cursor.end && (*cursor.p == ElementType::CMOD_REQD || *cursor.p == ElementType::CMOD_OPT))
+            {
+                cursor.byte();
+                cursor.compressed();
+            }
+            if (cursor.p >= cursor.end)
+            {
+                cursor.ok = false;
+                return 0;
+            }
+
+            const uint8_t *start = cursor.p;
+            switch (*start)
+            {
+            case ElementType::VOID:
+                cursor.byte();
+                return 'v';
+            case ElementType::BOOLEAN:
+            case ElementType::I1:
+            case ElementType::U1:
+                cursor.byte();
+                return 'b';
+            case ElementType::CHAR:
+            case ElementType::I2:
+            case ElementType::U2:
+                cursor.byte();
+                return 's';
+            case ElementType::I4:
+            case ElementType::U4:
+                cursor.byte();
+                return 'i';
+            case ElementType::I8:
+            case ElementType::U8:
+                cursor.byte();
+                return 'l';
+            case ElementType::R4:
+                cursor.byte();
+                return 'f';
+            case ElementType::R8:
+                cursor.byte();
+                return 'd';
+            case ElementType::I:
+            case ElementType::U:
+                cursor.byte();
+                return 'p';
+            case ElementType::PTR:
+            case ElementType::BYREF:
+            case ElementType::FNPTR:
+                return skip_type(cursor, 0) ? 'p' : 0;
+            default:
+                return skip_type(cursor, 0) ? 'x' : 0;
+            }
+        }
+
+        /**
+         * @brief 特性值中一个 FieldOrPropType 的定长元素字节数，不是定长元素时返回 0
+         */
+        inline size_t fixed_size(uint32_t element)
+        {
+            switch (element)
+            {
+            case ElementType::BOOLEAN:
+            case ElementType::I1:
+            case ElementType::U1:
+                return 1;
+            case ElementType::CHAR:
+            case ElementType::I2:
+            case ElementType::U2:
+                return 2;
+            case ElementType::I4:
+            case ElementType::U4:
+            case ElementType::R4:
+                return 4;
+            case ElementType::I8:
+            case ElementType::U8:
+            case ElementType::R8:
+                return 8;
+            default:
+                return 0;
+            }
+        }
+
+        /**
+         * @brief 从无参构造的特性值中读取 EntryPoint 命名参数（II.23.3）
+         *
+         * UnmanagedCallersOnly 还有 Type[] 类型的 CallConvs 参数，需要跳过；遇到无法跳过的值时停止，
+         * 此时视为没有 EntryPoint。
+         */
+        inline void read_entry_point(Cursor cursor, Export &export_)
+        {
+            if (cursor.u16() != 0x0001)
+                return;
+
+            uint32_t named = cursor.u16();
+            for (uint32_t i = 0; i < named && cursor.ok; ++i)
+            {
+                cursor.byte(); // FIELD 或 PROPERTY
+                uint32_t type = cursor.byte();
+                uint32_t element = type;
+                if (type == ElementType::SZARRAY)
+                    element = cursor.byte();
+                if (element == ElementType::ENUM || element == ElementType::BOXED)
+                    return;
+
+                std::string name;
+                bool is_null = false;
+                if (!cursor.ser_string(name, is_null))
+                    return;
+
+                uint32_t count = 1;
+                if (type == ElementType::SZARRAY)
+                {
+                    uint32_t low = cursor.u16();
+                    count = low | (cursor.u16() << 16);
+                    if (count == 0xffffffff)
+                        count = 0;
+                }
+
+                for (uint32_t j = 0; j < count && cursor.ok; ++j)
+                {
+                    if (element == ElementType::STRING || element == ElementType::SYSTEM_TYPE)
+                    {
+                        std::string value;
+                        if (!cursor.ser_string(value, is_null))
+                            return;
+                        if (type == ElementType::STRING && name == "EntryPoint" && !is_null)
+                        {
+                            export_.has_entry_point = true;
+                            export_.entry_point = std::move(value);
+                        }
+                    }
+                    else if (size_t size = fixed_size(element))
+                    {
+                        cursor.skip(size);
+                    }
+                    else
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        class Reader
+        {
+            const uint8_t *data_;
+            uint64_t size_;
+
+            uint32_t section_count_ = 0;
+            uint64_t sections_ = 0;
+
+            const uint8_t *strings_ = nullptr;
+            uint32_t strings_size_ = 0;
+            const uint8_t *blobs_ = nullptr;
+            uint32_t blobs_size_ = 0;
+            uint32_t string_width_ = 2;
+            uint32_t guid_width_ = 2;
+            uint32_t blob_width_ = 2;
+
+            uint32_t rows_[TABLE_COUNT] = {};
+            const uint8_t *tables_[TABLE_COUNT] = {};
+            uint32_t row_size_[TABLE_COUNT] = {};
+            uint8_t offsets_[TABLE_COUNT][MAX_COLUMNS] = {};
+            uint8_t widths_[TABLE_COUNT][MAX_COLUMNS] = {};
+
+            bool contains(uint64_t offset, uint64_t count) const
+            {
+                return offset <= size_ && count <= size_ - offset;
+            }
+
+            /**
+             * @brief 按节表把 RVA 换算为文件偏移，范围必须落在同一节的原始数据内
+             */
+            bool rva_to_offset(uint32_t rva, uint32_t count, uint64_t &offset) const
+            {
+                for (uint32_t i = 0; i < section_count_; ++i)
+                {
+                    const uint8_t *section = data_ + sections_ + i * 40;
+                    uint32_t address = read_u32(section + 12);
+                    uint32_t raw_size = read_u32(section + 16);
+                    uint32_t raw_offset = read_u32(section + 20);
+                    if (rva >= address && rva - address < raw_size && count <= raw_size - (rva - address))
+                    {
+                        offset = static_cast<uint64_t>(raw_offset) + (rva - address);
+                        return contains(offset, count);
+                    }
+                }
+                return false;
+            }
+
+            uint32_t index_width(uint8_t table) const { return rows_[table] < 0x10000 ? 2 : 4; }
+
+            uint32_t coded_width(uint8_t kind) const
+            {
+                const CodedIndex &coded = CODED_INDICES[kind];
+                uint32_t max_rows = 0;
+                for (uint8_t i = 0; i < coded.count; ++i)
+                {
+                    if (coded.tables[i] != NONE)
+                        max_rows = std::max(max_rows, rows_[coded.tables[i]]);
+                }
+                return max_rows < (1u << (16 - coded.bits)) ? 2 : 4;
+            }
+
+            uint32_t column_width(const Column &column) const
+            {
+                switch (column.kind)
+                {
+                case Kind::U16:
+                    return 2;
+                case Kind::U32:
+                    return 4;
+                case Kind::String:
+                    return string_width_;
+                case Kind::Guid:
+                    return guid_width_;
+                case Kind::Blob:
+                    return blob_width_;
+                case Kind::Index:
+                    return index_width(column.target);
+                case Kind::Coded:
+                    return coded_width(column.target);
+                default:
+                    return 0;
+                }
+            }
+
+            /**
+             * @brief 读取 table 表第 row 行（从 1 开始）的第 column 列
+             */
+            uint32_t cell(uint8_t table, uint32_t row, uint32_t column) const
+            {
+                const uint8_t *p = tables_[table] + static_cast<uint64_t>(row - 1) * row_size_[table] + offsets_[table][column];
+                return widths_[table][column] == 2 ? read_u16(p) : read_u32(p);
+            }
+
+            std::string string(uint32_t offset) const
+            {
+                if (offset >= strings_size_)
+                    return {};
+                auto begin = reinterpret_cast<const char *>(strings_ + offset);
+                auto end = static_cast<const char *>(std::memchr(begin, 0, strings_size_ - offset));
+                return end ? std::string(begin, end) : std::string();
+            }
+
+            bool blob(uint32_t offset, Cursor &cursor) const
+            {
+                if (offset >= blobs_size_)
+                    return false;
+                cursor = Cursor{blobs_ + offset, blobs_ + blobs_size_};
+                uint32_t length = cursor.compressed();
+                if (!cursor.ok || static_cast<size_t>(cursor.end - cursor.p) < length)
+                    return false;
+                cursor.end = cursor.p + length;
+                return true;
+            }
+
+            static uint32_t coded_tag(uint8_t kind, uint32_t value) { return value & ((1u << CODED_INDICES[kind].bits) - 1); }
+            static uint32_t coded_row(uint8_t kind, uint32_t value) { return value >> CODED_INDICES[kind].bits; }
+
+            bool read_headers(const uint8_t *&metadata, uint32_t &metadata_size, std::string &error)
+            {
+                if (!contains(0, 0x40) || data_[0] != 'M' || data_[1] != 'Z')
+                {
+                    error = "not a PE image";
+                    return false;
+                }
+                uint32_t pe_offset = read_u32(data_ + 0x3c);
+                if (!contains(pe_offset, 24) || read_u32(data_ + pe_offset) != 0x00004550)
+                {
+                    error = "not a PE image";
+                    return false;
+                }
+
+                section_count_ = read_u16(data_ + pe_offset + 6);
+                uint32_t optional_size = read_u16(data_ + pe_offset + 20);
+                uint64_t optional_header = pe_offset + 24;
+                sections_ = optional_header + optional_size;
+                if (!contains(optional_header, optional_size) || !contains(sections_, section_count_ * 40ull))
+                {
+                    error = "truncated PE headers";
+                    return false;
+                }
+
+                uint32_t magic = optional_size >= 2 ? read_u16(data_ + optional_header) : 0;
+                uint64_t directory_count_offset = magic == 0x20b ? 108 : 92;
+                constexpr uint32_t CLI_HEADER_DIRECTORY = 14;
+                uint64_t cli_directory = directory_count_offset + 4 + CLI_HEADER_DIRECTORY * 8;
+                if (optional_size < cli_directory + 8 ||
+                    read_u32(data_ + optional_header + directory_count_offset) <= CLI_HEADER_DIRECTORY ||
+                    read_u32(data_ + optional_header + cli_directory) == 0)
+                {
+                    error = "no CLI header";
+                    return false;
+                }
+
+                uint64_t cli_header = 0;
+                if (!rva_to_offset(read_u32(data_ + optional_header + cli_directory), 16, cli_header))
+                {
+                    error = "CLI header out of range";
+                    return false;
+                }
+
+                uint64_t metadata_offset = 0;
+                metadata_size = read_u32(data_ + cli_header + 12);
+                if (!rva_to_offset(read_u32(data_ + cli_header + 8), metadata_size, metadata_offset))
+                {
+                    error = "metadata out of range";
+                    return false;
+                }
+                metadata = data_ + metadata_offset;
+                return true;
+            }
+
+            bool read_streams(const uint8_t *metadata, uint32_t metadata_size, const uint8_t *&tables,
+                              uint32_t &tables_size, std::string &error)
+            {
+                if (metadata_size < 16 || read_u32(metadata) != 0x424a5342)
+                {
+                    error = "bad metadata signature";
+                    return false;
+                }
+                uint32_t version_length = read_u32(metadata + 12);
+                uint64_t position = 16ull + version_length;
+                if (position + 4 > metadata_size)
+                {
+                    error = "truncated metadata root";
+                    return false;
+                }
+                uint32_t stream_count = read_u16(metadata + position + 2);
+                position += 4;
+
+                tables = nullptr;
+                for (uint32_t i = 0; i < stream_count; ++i)
+                {
+                    if (position + 8 > metadata_size)
+                    {
+                        error = "truncated stream header";
+                        return false;
+                    }
+                    uint32_t offset = read_u32(metadata + position);
+                    uint32_t size = read_u32(metadata + position + 4);
+                    auto name = reinterpret_cast<const char *>(metadata + position + 8);
+                    auto name_end = static_cast<const char *>(
+                        std::memchr(name, 0, std::min<uint64_t>(32, metadata_size - position - 8)));
+                    if (!name_end || offset > metadata_size || size > metadata_size - offset)
+                    {
+                        error = "bad stream header";
+                        return false;
+                    }
+                    position += 8 + ((name_end - name + 4) & ~3ull);
+
+                    std::string stream(name, name_end);
+                    if (stream == "#~" || stream == "#-")
+                    {
+                        tables = metadata + offset;
+                        tables_size = size;
+                    }
+                    else if (stream == "#Strings")
+                    {
+                        strings_ = metadata + offset;
+                        strings_size_ = size;
+                    }
+                    else if (stream == "#Blob")
+                    {
+                        blobs_ = metadata + offset;
+                        blobs_size_ = size;
+                    }
+                }
+
+                if (!tables)
+                {
+                    error = "no metadata tables";
+                    return false;
+                }
+                return true;
+            }
+
+            bool read_tables(const uint8_t *tables, uint32_t tables_size, std::string &error)
+            {
+                if (tables_size < 24)
+                {
+                    error = "truncated table stream";
+                    return false;
+                }
+                uint32_t heap_sizes = tables[6];
+                string_width_ = (heap_sizes & 0x01) ? 4 : 2;
+                guid_width_ = (heap_sizes & 0x02) ? 4 : 2;
+                blob_width_ = (heap_sizes & 0x04) ? 4 : 2;
+
+                uint64_t valid = read_u32(tables + 8) | (static_cast<uint64_t>(read_u32(tables + 12)) << 32);
+                if (valid >> TABLE_COUNT)
+                {
+                    error = "unsupported metadata table";
+                    return false;
+                }
+
+                uint64_t position = 24;
+                for (uint32_t table = 0; table < TABLE_COUNT; ++table)
+                {
+                    if (valid & (1ull << table))
+                    {
+                        if (position + 4 > tables_size)
+                        {
+                            error = "truncated row counts";
+                            return false;
+                        }
+                        rows_[table] = read_u32(tables + position);
+                        position += 4;
+                    }
+                }
+                if (heap_sizes & 0x40)
+                {
+                    position += 4; // 未压缩表流中行数之后的额外数据
+                }
+
+                for (uint32_t table = 0; table < TABLE_COUNT; ++table)
+                {
+                    uint32_t offset = 0;
+                    for (size_t column = 0; column < MAX_COLUMNS && SCHEMA[table][column].kind != Kind::End; ++column)
+                    {
+                        offsets_[table][column] = static_cast<uint8_t>(offset);
+                        widths_[table][column] = static_cast<uint8_t>(column_width(SCHEMA[table][column]));
+                        offset += widths_[table][column];
+                    }
+                    row_size_[table] = offset;
+
+                    uint64_t bytes = static_cast<uint64_t>(rows_[table]) * row_size_[table];
+                    if (position + bytes > tables_size)
+                    {
+                        error = "table " + std::to_string(table) + " out of range";
+                        return false;
+                    }
+                    tables_[table] = tables + position;
+                    position += bytes;
+                }
+                return true;
+            }
+
+            /**
+             * @brief 判断 MemberRef 或 MethodDef 所属的类型是否为 UnmanagedCallersOnlyAttribute
+             */
+            bool is_unmanaged_callers_only(uint32_t tag, uint32_t row) const
+            {
+                // MemberRefParent 的标记：0 为 TypeDef，1 为 TypeRef；两张表的名称和命名空间都在第 1、2 列
+                if (tag > 1)
+                    return false;
+                uint8_t table = tag == 0 ? TYPE_DEF : TYPE_REF;
+                if (row == 0 || row > rows_[table])
+                    return false;
+                return string(cell(table, row, 1)) == "UnmanagedCallersOnlyAttribute" &&
+                       string(cell(table, row, 2)) == "System.Runtime.InteropServices";
+            }
+
+            std::string type_name(uint32_t type, const std::unordered_map<uint32_t, uint32_t> &enclosing) const
+            {
+                std::string name;
+                for (int depth = 0; type != 0 && type <= rows_[TYPE_DEF] && depth < 64; ++depth)
+                {
+                    std::string ns = string(cell(TYPE_DEF, type, 2));
+                    std::string part = ns.empty() ? string(cell(TYPE_DEF, type, 1)) : ns + "." + string(cell(TYPE_DEF, type, 1));
+                    name = name.empty() ? part : part + "+" + name;
+
+                    auto it = enclosing.find(type);
+                    type = it == enclosing.end() ? 0 : it->second;
+                }
+                return name;
+            }
+
+        public:
+            Reader(const uint8_t *data, uint64_t size) : data_(data), size_(size) {}
+
+            bool read(Assembly &assembly, std::string &error)
+            {
+                const uint8_t *metadata = nullptr, *tables = nullptr;
+                uint32_t metadata_size = 0, tables_size = 0;
+                if (!read_headers(metadata, metadata_size, error) ||
+                    !read_streams(metadata, metadata_size, tables, tables_size, error) ||
+                    !read_tables(tables, tables_size, error))
+                {
+                    return false;
+                }
+
+                if (rows_[ASSEMBLY] == 0)
+                {
+                    error = "module has no assembly manifest";
+                    return false;
+                }
+                if (rows_[METHOD_PTR] != 0)
+                {
+                    error = "unoptimized metadata is not supported";
+                    return false;
+                }
+                assembly.name = string(cell(ASSEMBLY, 1, 7));
+
+                // 特性构造函数：MemberRef（引用的类型）或 MethodDef（本程序集定义的类型）
+                std::unordered_set<uint32_t> member_refs;
+                for (uint32_t row = 1; row <= rows_[MEMBER_REF]; ++row)
+                {
+                    uint32_t parent = cell(MEMBER_REF, row, 0);
+                    if (string(cell(MEMBER_REF, row, 1)) == ".ctor" &&
+                        is_unmanaged_callers_only(coded_tag(MEMBER_REF_PARENT, parent), coded_row(MEMBER_REF_PARENT, parent)))
+                    {
+                        member_refs.insert(row);
+                    }
+                }
+
+                std::vector<uint32_t> type_methods(rows_[TYPE_DEF]);
+                for (uint32_t row = 1; row <= rows_[TYPE_DEF]; ++row)
+                {
+                    type_methods[row - 1] = cell(TYPE_DEF, row, 5);
+                }
+                auto owner = [&](uint32_t method) -> uint32_t
+                {
+                    // MethodList 单调不减，方法属于起始行不大于它的最后一个类型
+                    auto it = std::upper_bound(type_methods.begin(), type_methods.end(), method);
+                    return static_cast<uint32_t>(it - type_methods.begin());
+                };
+                auto is_attribute_constructor = [&](uint32_t type) -> bool
+                {
+                    uint32_t tag = coded_tag(CUSTOM_ATTRIBUTE_TYPE, type), row = coded_row(CUSTOM_ATTRIBUTE_TYPE, type);
+                    if (tag == 3)
+                        return member_refs.count(row) != 0;
+                    if (tag == 2 && row != 0 && row <= rows_[METHOD_DEF])
+                        return string(cell(METHOD_DEF, row, 3)) == ".ctor" && is_unmanaged_callers_only(0, owner(row));
+                    return false;
+                };
+
+                std::unordered_map<uint32_t, uint32_t> enclosing;
+                for (uint32_t row = 1; row <= rows_[NESTED_CLASS]; ++row)
+                {
+                    enclosing[cell(NESTED_CLASS, row, 0)] = cell(NESTED_CLASS, row, 1);
+                }
+
+                for (uint32_t row = 1; row <= rows_[CUSTOM_ATTRIBUTE]; ++row)
+                {
+                    uint32_t parent = cell(CUSTOM_ATTRIBUTE, row, 0);
+                    uint32_t method = coded_row(HAS_CUSTOM_ATTRIBUTE, parent);
+                    if (coded_tag(HAS_CUSTOM_ATTRIBUTE, parent) != 0 || method == 0 || method > rows_[METHOD_DEF] ||
+                        !is_attribute_constructor(cell(CUSTOM_ATTRIBUTE, row, 1)))
+                    {
+                        continue;
+                    }
+
+                    Export export_;
+                    export_.type_name = type_name(owner(method), enclosing) + "," + assembly.name;
+                    export_.method_name = string(cell(METHOD_DEF, method, 3));
+
+                    Cursor signature{};
+                    if (!blob(cell(METHOD_DEF, method, 4), signature))
+                    {
+                        error = "bad signature for " + export_.method_name;
+                        return false;
+                    }
+                    uint32_t convention = signature.byte();
+                    if (convention & 0x10)
+                        signature.compressed();
+                    uint32_t count = signature.compressed();
+                    for (uint32_t i = 0; i <= count && signature.ok; ++i)
+                    {
+                        if (char c = encode_type(signature))
+                            export_.signature.push_back(c);
+                    }
+                    if (!signature.ok || export_.signature.size() != count + 1ull)
+                    {
+                        error = "bad signature for " + export_.method_name;
+                        return false;
+                    }
+
+                    Cursor value{};
+                    if (blob(cell(CUSTOM_ATTRIBUTE, row, 2), value))
+                    {
+                        read_entry_point(value, export_);
+                    }
+                    assembly.exports.push_back(std::move(export_));
+                }
+                return true;
+            }
+        };
+    }
+
+    /**
+     * @brief 读取镜像中的程序集名称和 [UnmanagedCallersOnly] 导出
+     *
+     * @param data 镜像内容
+     * @param size 镜像字节数
+     * @param[out] assembly 程序集名称和导出，按特性表的顺序（即方法定义的顺序）
+     * @param[out] error 失败原因：不是托管程序集、只是模块或元数据损坏
+     * @return 读取成功时返回 true
+     */
+    inline bool read_exports(const uint8_t *data, uint64_t size, Assembly &assembly, std::string &error)
+    {
+        return detail::Reader(data, size).read(assembly, error);
+    }
+}
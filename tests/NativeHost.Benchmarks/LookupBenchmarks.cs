@@ -0,0 +1,111 @@
+using BenchmarkDotNet.Attributes;
+
+namespace NativeHost.Benchmarks;
+
+/// <summary>
+/// Cached lookup throughput of the wrapper's caches at 1..N threads
+/// </summary>
+/// <remarks>
+/// Each invocation runs <see cref="LookupsPerThread"/> lookups on every thread, so the reported
+/// time per operation is wall time divided by lookups per thread, like the native benchmarks:
+/// it stays flat when lookups scale and grows with the thread count when they contend.
+/// The caches are exercised directly with pre-resolved delegates, so no runtime is hosted and
+/// only the lookup cost is measured. The baselines are the previous unsynchronized dictionary
+/// with an interpolated string key (only safe here because nothing writes during the run) and
+/// the same dictionary behind a lock.
+/// </remarks>
+[MemoryDiagnoser]
+public class LookupBenchmarks
+{
+    private const int LookupsPerThread = 100_000;
+    private const int MethodCount = 32;
+    private const string AssemblyPath = "/plugins/Plugin.dll";
+    private const string TypeName = "Plugin.Api, Plugin";
+
+    private delegate int BinaryDelegate(int a, int b);
+
+    private readonly string[] _methods = Enumerable.Range(0, MethodCount).Select(i => $"Method{i}").ToArray();
+    private readonly Dictionary<string, Delegate> _stringKeyed = new();
+    private readonly object _lock = new();
+    private readonly DelegateCache _delegateCache = new();
+    private readonly Dictionary<IntPtr, object> _handles = new();
+    private readonly CopyOnWriteMap<IntPtr, object> _handleSnapshot = new();
+
+    [Params(1, 2, 4, 8)]
+    public int Threads { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        foreach (var method in _methods)
+        {
+            BinaryDelegate function = (a, b) => a + b;
+            _stringKeyed[$"{AssemblyPath}:{TypeName}.{method}"] = function;
+            _delegateCache.GetOrAdd<BinaryDelegate, BinaryDelegate>(TypeName, method, static (f, _, _) => f, function);
+        }
+
+        for (var i = 1; i <= 16; i++)
+        {
+            _handles[i * 64] = new object();
+            _handleSnapshot.Set(i * 64, _handles[i * 64]);
+        }
+    }
+
+    private void Run(Action<int> lookup)
+    {
+        if (Threads == 1)
+        {
+            for (var i = 0; i < LookupsPerThread; i++)
+            {
+                lookup(i);
+            }
+            return;
+        }
+
+        Parallel.For(0, Threads, new ParallelOptions { MaxDegreeOfParallelism = Threads }, _ =>
+        {
+            for (var i = 0; i < LookupsPerThread; i++)
+            {
+                lookup(i);
+            }
+        });
+    }
+
+    [Benchmark(Baseline = true, OperationsPerInvoke = LookupsPerThread)]
+    public void StringKeyedDictionary() => Run(i =>
+    {
+        var key = $"{AssemblyPath}:{TypeName}.{_methods[i % MethodCount]}";
+        _stringKeyed.TryGetValue(key, out _);
+    });
+
+    [Benchmark(OperationsPerInvoke = LookupsPerThread)]
+    public void LockedStringKeyedDictionary() => Run(i =>
+    {
+        var key = $"{AssemblyPath}:{TypeName}.{_methods[i % MethodCount]}";
+        lock (_lock)
+        {
+            _stringKeyed.TryGetValue(key, out _);
+        }
+    });
+
+    [Benchmark(OperationsPerInvoke = LookupsPerThread)]
+    public void DelegateCache() => Run(i =>
+    {
+        _delegateCache.GetOrAdd<BinaryDelegate, BinaryDelegate?>(TypeName, _methods[i % MethodCount], static (_, _, _) => throw new InvalidOperationException(), null);
+    });
+
+    [Benchmark(OperationsPerInvoke = LookupsPerThread)]
+    public void LockedHandleDictionary() => Run(i =>
+    {
+        lock (_lock)
+        {
+            _handles.ContainsKey((i % 16 + 1) * 64);
+        }
+    });
+
+    [Benchmark(OperationsPerInvoke = LookupsPerThread)]
+    public void HandleSnapshot() => Run(i =>
+    {
+        _handleSnapshot.ContainsKey((i % 16 + 1) * 64);
+    });
+}
@@ -0,0 +1,159 @@
+using Xunit;
+
+namespace NativeHost.Tests;
+
+public class CacheConcurrencyTests
+{
+    private const int ThreadCount = 8;
+    private const int Iterations = 20_000;
+
+    private delegate int BinaryDelegate(int a, int b);
+    private delegate int UnaryDelegate(int a);
+
+    // Runs body on ThreadCount threads released together, so the first lookups actually race
+    private static void RunConcurrently(Action<int> body)
+    {
+        using var start = new Barrier(ThreadCount);
+        var threads = Enumerable.Range(0, ThreadCount)
+            .Select(index => new Thread(() =>
+            {
+                start.SignalAndWait();
+                body(index);
+            }))
+            .ToList();
+
+        threads.ForEach(thread => thread.Start());
+        threads.ForEach(thread => thread.Join());
+    }
+
+    [Fact]
+    public void ConcurrentLookupsShareOneDelegatePerMethod()
+    {
+        var cache = new DelegateCache();
+        var resolved = 0;
+        var results = new BinaryDelegate[ThreadCount, 16];
+
+        RunConcurrently(thread =>
+        {
+            for (var i = 0; i < Iterations; i++)
+            {
+                var method = $"Method{i % 16}";
+                var function = cache.GetOrAdd<BinaryDelegate, object?>(
+                    "Plugin.Api",
+                    method,
+                    (_, _, _) =>
+                    {
+                        Interlocked.Increment(ref resolved);
+                        return (a, b) => a + b;
+                    },
+                    null);
+
+                var previous = results[thread, i % 16];
+                Assert.True(previous == null || ReferenceEquals(previous, function));
+                results[thread, i % 16] = function;
+            }
+        });
+
+        Assert.Equal(16, cache.Count);
+        // Racing first lookups may resolve more than once, but every thread got the kept instance
+        Assert.InRange(resolved, 16, 16 * ThreadCount);
+        for (var method = 0; method < 16; method++)
+        {
+            for (var thread = 1; thread < ThreadCount; thread++)
+            {
+                Assert.Same(results[0, method], results[thread, method]);
+            }
+        }
+    }
+
+    [Fact]
+    public void DelegateTypeIsPartOfTheKey()
+    {
+        var cache = new DelegateCache();
+
+        var binary = cache.GetOrAdd<BinaryDelegate, object?>("Plugin.Api", "Apply", (_, _, _) => (a, b) => a * b, null);
+        var unary = cache.GetOrAdd<UnaryDelegate, object?>("Plugin.Api", "Apply", (_, _, _) => a => -a, null);
+
+        Assert.Equal(6, binary(2, 3));
+        Assert.Equal(-2, unary(2));
+        Assert.Equal(2, cache.Count);
+    }
+
+    [Fact]
+    public void ClearDuringLookupsResolvesAgain()
+    {
+        var cache = new DelegateCache();
+        var failures = 0;
+
+        RunConcurrently(thread =>
+        {
+            for (var i = 0; i < Iterations; i++)
+            {
+                if (thread == 0 && i % 100 == 0)
+                {
+                    cache.Clear();
+                }
+
+                var function = cache.GetOrAdd<BinaryDelegate, object?>("Plugin.Api", "Add", (_, _, _) => (a, b) => a + b, null);
+                if (function(i, 1) != i + 1)
+                {
+                    Interlocked.Increment(ref failures);
+                }
+            }
+        });
+
+        Assert.Equal(0, failures);
+    }
+
+    [Fact]
+    public void ReadersSeeConsistentSnapshotsWhileWritersUpdate()
+    {
+        var map = new CopyOnWriteMap<IntPtr, string>();
+        for (var i = 0; i < 64; i++)
+        {
+            map.Set(i, $"stable-{i}");
+        }
+
+        var failures = 0;
+        RunConcurrently(thread =>
+        {
+            for (var i = 0; i < Iterations; i++)
+            {
+                if (thread == 0)
+                {
+                    // The writer churns keys above the stable range
+                    var key = (IntPtr)(64 + i % 32);
+                    if (i % 2 == 0)
+                    {
+                        map.Set(key, $"churn-{key}");
+                    }
+                    else
+                    {
+                        map.Remove(key);
+                    }
+                    continue;
+                }
+
+                var stable = (IntPtr)(i % 64);
+                if (!map.TryGetValue(stable, out var value) || value != $"stable-{stable}")
+                {
+                    Interlocked.Increment(ref failures);
+                }
+
+                var churned = (IntPtr)(64 + i % 32);
+                if (map.TryGetValue(churned, out value) && value != $"churn-{churned}")
+                {
+                    Interlocked.Increment(ref failures);
+                }
+
+                // Enumerating a snapshot is not disturbed by concurrent writes
+                if (i % 64 == 0 && map.Values.Count(v => v.StartsWith("stable-")) != 64)
+                {
+                    Interlocked.Increment(ref failures);
+                }
+            }
+        });
+
+        Assert.Equal(0, failures);
+    }
+}
@@ -1,27 +1,198 @@
 using System.Runtime.InteropServices;
+using System.Runtime.Loader;
+using System.Text;
 using Microsoft.Extensions.Logging;
+using PluginSupport;
 
 namespace TestLibrary;
 
+[StructLayout(LayoutKind.Sequential)]
+public struct Sample
+{
+    public long Timestamp;
+    public double Value;
+    public int Flags;
+}
+
+public unsafe struct TestHostServices
+{
+    public delegate* unmanaged<int, int, int> Multiply;
+}
+
 public class TestClass
 {
 
-    [UnmanagedCallersOnly]
+    [UnmanagedCallersOnly(EntryPoint = "ReturnConstant")]
     public static int ReturnConstant()
     {
         Console.WriteLine("Returning constant");
         return 42;
     }
 
-    [UnmanagedCallersOnly]
+    [UnmanagedCallersOnly(EntryPoint = "AddNumbers")]
     public static int AddNumbers(int a, int b)
     {
         return a + b;
     }
 
+    // More floating-point and integer arguments than the calling conventions pass in registers,
+    // so a trampoline in front of it has to leave the stack arguments in place
+    [UnmanagedCallersOnly(EntryPoint = "WeightedSum")]
+    public static double WeightedSum(
+        double a, int wa, double b, int wb, double c, int wc, double d, int wd, double e, int we,
+        double f, int wf, double g, int wg, double h, int wh, double i, int wi)
+    {
+        return a * wa + b * wb + c * wc + d * wd + e * we + f * wf + g * wg + h * wh + i * wi;
+    }
+
+    // Only called by the trace tests, so its first call is always JIT-compiled
+    [UnmanagedCallersOnly]
+    public static int TraceTarget(int x)
+    {
+        return x * 3 + 1;
+    }
+
+    [UnmanagedCallersOnly]
+    public static int AllocateBytes(int size)
+    {
+        var buffer = new byte[size];
+        return buffer.Length;
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "SumSamples")]
+    public static unsafe double SumSamples(Sample* samples, int count)
+    {
+        double sum = 0;
+        for (var i = 0; i < count; i++)
+        {
+            sum += samples[i].Value;
+        }
+        return sum;
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "CallHostMultiply")]
+    public static unsafe int CallHostMultiply(int a, int b)
+    {
+        var services = HostServices.GetTable<TestHostServices>();
+        if (services == null)
+        {
+            return -1;
+        }
+        return services->Multiply(a, b);
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "LoadsDependenciesInPluginContext")]
+    public static int LoadsDependenciesInPluginContext()
+    {
+        var pluginContext = AssemblyLoadContext.GetLoadContext(typeof(TestClass).Assembly);
+        var dependencyContext = AssemblyLoadContext.GetLoadContext(typeof(LoggerFactory).Assembly);
+        return pluginContext != AssemblyLoadContext.Default && dependencyContext == pluginContext ? 1 : 0;
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "AddNumbersAsync")]
+    public static void AddNumbersAsync(int a, int b, IntPtr callback, IntPtr state)
+        => AsyncBridge.Complete(AddNumbersCoreAsync(a, b), callback, state);
+
+    private static async Task<int> AddNumbersCoreAsync(int a, int b)
+    {
+        await Task.Delay(10);
+        return a + b;
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "FailAsync")]
+    public static void FailAsync(IntPtr callback, IntPtr state)
+        => AsyncBridge.Complete(FailCoreAsync(), callback, state);
+
+    private static async Task<int> FailCoreAsync()
+    {
+        await Task.Yield();
+        throw new InvalidOperationException("Async failure");
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "FormatRecord")]
+    public static unsafe byte* FormatRecord(int id)
+    {
+        return HostArena.CopyUtf8($"record-{id}");
+    }
+
+    // Same result in AllocHGlobal memory that the caller frees; the baseline of the arena benchmark
+    [UnmanagedCallersOnly(EntryPoint = "FormatRecordHGlobal")]
+    public static unsafe byte* FormatRecordHGlobal(int id)
+    {
+        var value = $"record-{id}";
+        var length = Encoding.UTF8.GetByteCount(value);
+        var memory = (byte*)Marshal.AllocHGlobal(length + 1);
+        Encoding.UTF8.GetBytes(value, new Span<byte>(memory, length));
+        memory[length] = 0;
+        return memory;
+    }
+
+    // Data-parallel kernels for native_host_parallel_for: each call handles the indices [begin, end)
+    [UnmanagedCallersOnly(EntryPoint = "MarkRange")]
+    public static unsafe void MarkRange(long begin, long end, nint context)
+    {
+        var marks = (int*)context;
+        for (var i = begin; i < end; i++)
+        {
+            marks[i]++;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "ComputeRange")]
+    public static unsafe void ComputeRange(long begin, long end, nint context)
+    {
+        var output = (double*)context;
+        for (var i = begin; i < end; i++)
+        {
+            double x = i;
+            for (var k = 0; k < 64; k++)
+            {
+                x = Math.Sqrt(x + k);
+            }
+            output[i] = x;
+        }
+    }
+
     [UnmanagedCallersOnly]
     public static bool ThrowException()
     {
         throw new System.Exception("Test exception");
     }
+
+    // Writes the values 0..count-1 to a host event channel and completes it
+    [UnmanagedCallersOnly]
+    public static void ProduceEvents(nint channel, int count)
+    {
+        var events = HostChannel.FromHandle(channel);
+        for (var i = 0; i < count; i++)
+        {
+            if (!events.TryWrite(in i))
+            {
+                events.Write(BitConverter.GetBytes(i));
+            }
+        }
+        events.Complete();
+    }
+}
+
+// Per-session state behind a handle from native_host_create_object; the static shims are the
+// instance methods' entry points and take the handle as their first argument
+public class Counter
+{
+    private int _total;
+
+    [UnmanagedCallersOnly]
+    public static int Add(nint self, int delta) => PluginObjects.Get<Counter>(self).AddCore(delta);
+
+    [UnmanagedCallersOnly]
+    public static int Total(nint self) => PluginObjects.Get<Counter>(self)._total;
+
+    private int AddCore(int delta) => _total += delta;
+}
+
+public class NoDefaultConstructor
+{
+    public NoDefaultConstructor(int value)
+    {
+    }
 }
\ No newline at end of file
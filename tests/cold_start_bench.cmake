@@ -0,0 +1,33 @@
+# Runs native_host_cold_start_bench repeatedly for the JIT and NativeAOT plugin modes.
+#
+# cmake -DBENCH_EXE=... -DJIT_ASSEMBLY=... -DAOT_LIBRARY=... -DTYPE_NAME=... [-DRUNS=5] -P cold_start_bench.cmake
+
+if(NOT DEFINED RUNS)
+    set(RUNS 5)
+endif()
+
+foreach(MODE jit aot)
+    if(MODE STREQUAL "jit")
+        set(ASSEMBLY "${JIT_ASSEMBLY}")
+    else()
+        set(ASSEMBLY "${AOT_LIBRARY}")
+    endif()
+
+    if(NOT EXISTS "${ASSEMBLY}")
+        message(STATUS "Skipping ${MODE}: ${ASSEMBLY} not found")
+        continue()
+    endif()
+
+    foreach(RUN RANGE 1 ${RUNS})
+        execute_process(
+            COMMAND "${BENCH_EXE}" ${MODE} "${ASSEMBLY}" "${TYPE_NAME}"
+            OUTPUT_VARIABLE OUTPUT
+            OUTPUT_STRIP_TRAILING_WHITESPACE
+            RESULT_VARIABLE RESULT
+        )
+        if(NOT RESULT EQUAL 0)
+            message(FATAL_ERROR "Cold start run ${RUN} failed for ${MODE}: ${RESULT}")
+        endif()
+        message(STATUS "[${RUN}/${RUNS}] ${OUTPUT}")
+    endforeach()
+endforeach()
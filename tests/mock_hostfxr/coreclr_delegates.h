@@ -0,0 +1,40 @@
+// Subset of the .NET hosting header coreclr_delegates.h (Microsoft.NETCore.App.Host pack) for
+// builds against the mock hostfxr: the runtime delegates native_host uses, with the same ABI.
+
+#ifndef __CORECLR_DELEGATES_H__
+#define __CORECLR_DELEGATES_H__
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define CORECLR_DELEGATE_CALLTYPE __stdcall
+typedef wchar_t char_t;
+#else
+#define CORECLR_DELEGATE_CALLTYPE
+typedef char char_t;
+#endif
+
+#define UNMANAGEDCALLERSONLY_METHOD ((const char_t *)-1)
+
+typedef int(CORECLR_DELEGATE_CALLTYPE *load_assembly_and_get_function_pointer_fn)(
+    const char_t *assembly_path,
+    const char_t *type_name,
+    const char_t *method_name,
+    const char_t *delegate_type_name,
+    void *reserved,
+    /*out*/ void **delegate);
+
+typedef int(CORECLR_DELEGATE_CALLTYPE *get_function_pointer_fn)(
+    const char_t *type_name,
+    const char_t *method_name,
+    const char_t *delegate_type_name,
+    void *load_context,
+    void *reserved,
+    /*out*/ void **delegate);
+
+typedef int(CORECLR_DELEGATE_CALLTYPE *load_assembly_fn)(
+    const char_t *assembly_path,
+    void *load_context,
+    void *reserved);
+
+#endif // __CORECLR_DELEGATES_H__
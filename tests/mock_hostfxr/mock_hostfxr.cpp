@@ -0,0 +1,660 @@
+// Mock hostfxr: the hostfxr entry points native_host resolves, backed by native stubs of the
+// test library's exports instead of CoreCLR. See mock_hostfxr.h for the configuration.
+
+#include "mock_hostfxr.h"
+#include <hostfxr.h>
+#include <coreclr_delegates.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define MOCK_HOSTFXR_EXPORT extern "C" __declspec(dllexport)
+#else
+#define MOCK_HOSTFXR_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace
+{
+    // Status codes of the real hosting layer, so the host maps them as it would in production
+    constexpr int32_t SUCCESS_HOST_ALREADY_INITIALIZED = 0x00000001;
+    constexpr int32_t SUCCESS_DIFFERENT_RUNTIME_PROPERTIES = 0x00000002;
+    constexpr int32_t INVALID_ARG_FAILURE = static_cast<int32_t>(0x80008081);
+    constexpr int32_t INVALID_CONFIG_FILE = static_cast<int32_t>(0x80008093);
+    constexpr int32_t HOST_API_BUFFER_TOO_SMALL = static_cast<int32_t>(0x80008098);
+    constexpr int32_t HOST_INVALID_STATE = static_cast<int32_t>(0x800080a3);
+    constexpr int32_t MISSING_METHOD = static_cast<int32_t>(0x80131513);
+    constexpr int32_t ERROR_TASK_FAULTED = -305;
+    constexpr int32_t ERROR_TYPE_LOAD = -401;
+
+    struct Config
+    {
+        std::atomic<uint32_t> initialize_delay_us{0};
+        std::atomic<uint32_t> get_delegate_delay_us{0};
+        std::atomic<uint32_t> load_delay_us{0};
+        std::atomic<int32_t> initialize_result{0};
+        std::atomic<int32_t> get_delegate_result{0};
+        std::atomic<int32_t> load_result{0};
+
+        explicit Config(const mock_hostfxr_config_t &config) { store(config); }
+
+        void store(const mock_hostfxr_config_t &config)
+        {
+            initialize_delay_us.store(config.initialize_delay_us, std::memory_order_relaxed);
+            get_delegate_delay_us.store(config.get_delegate_delay_us, std::memory_order_relaxed);
+            load_delay_us.store(config.load_delay_us, std::memory_order_relaxed);
+            initialize_result.store(config.initialize_result, std::memory_order_relaxed);
+            get_delegate_result.store(config.get_delegate_result, std::memory_order_relaxed);
+            load_result.store(config.load_result, std::memory_order_relaxed);
+        }
+    };
+
+    struct Counters
+    {
+        std::atomic<uint64_t> initialize_calls{0};
+        std::atomic<uint64_t> get_delegate_calls{0};
+        std::atomic<uint64_t> close_calls{0};
+        std::atomic<uint64_t> load_calls{0};
+        std::atomic<uint64_t> open_contexts{0};
+        std::atomic<uint64_t> live_objects{0};
+    };
+
+    int64_t env_value(const char *name)
+    {
+        const char *value = std::getenv(name);
+        return value && *value ? std::strtoll(value, nullptr, 0) : 0;
+    }
+
+    mock_hostfxr_config_t environment_config()
+    {
+        mock_hostfxr_config_t config{};
+        config.initialize_delay_us = static_cast<uint32_t>(env_value("MOCK_HOSTFXR_INIT_DELAY_US"));
+        config.get_delegate_delay_us = static_cast<uint32_t>(env_value("MOCK_HOSTFXR_DELEGATE_DELAY_US"));
+        config.load_delay_us = static_cast<uint32_t>(env_value("MOCK_HOSTFXR_LOAD_DELAY_US"));
+        config.initialize_result = static_cast<int32_t>(env_value("MOCK_HOSTFXR_INIT_RESULT"));
+        config.get_delegate_result = static_cast<int32_t>(env_value("MOCK_HOSTFXR_DELEGATE_RESULT"));
+        config.load_result = static_cast<int32_t>(env_value("MOCK_HOSTFXR_LOAD_RESULT"));
+        return config;
+    }
+
+    Config &config()
+    {
+        static Config instance(environment_config());
+        return instance;
+    }
+
+    Counters counters;
+
+    using string_t = std::basic_string<char_t>;
+    using Properties = std::vector<std::pair<string_t, string_t>>;
+
+    // A host context carries the runtime properties of its configuration file
+    struct Context
+    {
+        Properties properties;
+    };
+
+    // As in hostfxr, the first initialization starts the runtime and later ones get secondary
+    // contexts on it; mock_hostfxr_start_runtime stands in for a .NET app that started it
+    struct Runtime
+    {
+        std::mutex mutex;
+        bool active = false;
+        Properties properties;
+        std::set<Context *> contexts;
+    };
+
+    Runtime runtime;
+
+    string_t widen(const std::string &value)
+    {
+        return string_t(value.begin(), value.end());
+    }
+
+    // The flat "configProperties" object of a runtime config: string, number and boolean values
+    // without escapes, which is all the tests write
+    Properties read_config_properties(const char_t *path)
+    {
+        std::ifstream file{std::filesystem::path(path)};
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Properties properties;
+        auto pos = text.find("\"configProperties\"");
+        if (pos == std::string::npos || (pos = text.find('{', pos)) == std::string::npos)
+        {
+            return properties;
+        }
+        ++pos;
+
+        auto skip_space = [&]()
+        {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+            {
+                ++pos;
+            }
+        };
+        auto read_token = [&]()
+        {
+            skip_space();
+            std::string::size_type end;
+            std::string token;
+            if (pos < text.size() && text[pos] == '"')
+            {
+                end = text.find('"', pos + 1);
+                token = text.substr(pos + 1, end - pos - 1);
+                pos = end == std::string::npos ? end : end + 1;
+            }
+            else
+            {
+                end = text.find_first_of(",} \t\r\n", pos);
+                token = text.substr(pos, end - pos);
+                pos = end;
+            }
+            return token;
+        };
+
+        for (;;)
+        {
+            skip_space();
+            if (pos >= text.size() || text[pos] == '}')
+            {
+                break;
+            }
+            auto name = read_token();
+            skip_space();
+            if (pos >= text.size() || text[pos] != ':')
+            {
+                break;
+            }
+            ++pos;
+            auto value = read_token();
+            properties.emplace_back(widen(name), widen(value));
+            skip_space();
+            if (pos < text.size() && text[pos] == ',')
+            {
+                ++pos;
+            }
+        }
+        return properties;
+    }
+
+    bool contains(const Properties &properties, const std::pair<string_t, string_t> &property)
+    {
+        for (const auto &entry : properties)
+        {
+            if (entry == property)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool is_context(const hostfxr_handle handle)
+    {
+        std::lock_guard<std::mutex> lock(runtime.mutex);
+        return runtime.contexts.count(static_cast<Context *>(handle)) != 0;
+    }
+
+    void delay(const std::atomic<uint32_t> &delay_us)
+    {
+        if (auto us = delay_us.load(std::memory_order_relaxed))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        }
+    }
+
+    bool equals(const char_t *value, const char *expected)
+    {
+        for (; *value && *expected; ++value, ++expected)
+        {
+            if (*value != static_cast<char_t>(*expected))
+            {
+                return false;
+            }
+        }
+        return *value == 0 && *expected == 0;
+    }
+
+    // Native counterparts of the TestLibrary.TestClass exports
+    namespace Stubs
+    {
+        struct Sample
+        {
+            int64_t timestamp;
+            double value;
+            int32_t flags;
+        };
+
+        union Value
+        {
+            int32_t i32;
+            int64_t i64;
+            double f64;
+        };
+
+        using completion_fn = void (*)(void *state, int32_t status, const Value *result);
+
+        int32_t CORECLR_DELEGATE_CALLTYPE return_constant()
+        {
+            return 42;
+        }
+
+        int32_t CORECLR_DELEGATE_CALLTYPE add_numbers(int32_t a, int32_t b)
+        {
+            return a + b;
+        }
+
+        double CORECLR_DELEGATE_CALLTYPE weighted_sum(
+            double a, int32_t wa, double b, int32_t wb, double c, int32_t wc, double d, int32_t wd, double e, int32_t we,
+            double f, int32_t wf, double g, int32_t wg, double h, int32_t wh, double i, int32_t wi)
+        {
+            return a * wa + b * wb + c * wc + d * wd + e * we + f * wf + g * wg + h * wh + i * wi;
+        }
+
+        int32_t CORECLR_DELEGATE_CALLTYPE trace_target(int32_t x)
+        {
+            return x * 3 + 1;
+        }
+
+        int32_t CORECLR_DELEGATE_CALLTYPE allocate_bytes(int32_t size)
+        {
+            return size;
+        }
+
+        double CORECLR_DELEGATE_CALLTYPE sum_samples(const Sample *samples, int32_t count)
+        {
+            double sum = 0;
+            for (int32_t i = 0; i < count; ++i)
+            {
+                sum += samples[i].value;
+            }
+            return sum;
+        }
+
+        // Async stubs complete inline, the path taken by tasks that finish before returning
+        void CORECLR_DELEGATE_CALLTYPE add_numbers_async(int32_t a, int32_t b, completion_fn callback, void *state)
+        {
+            Value result{};
+            result.i32 = a + b;
+            callback(state, 0, &result);
+        }
+
+        void CORECLR_DELEGATE_CALLTYPE fail_async(completion_fn callback, void *state)
+        {
+            Value result{};
+            callback(state, ERROR_TASK_FAULTED, &result);
+        }
+
+        void CORECLR_DELEGATE_CALLTYPE mark_range(int64_t begin, int64_t end, void *context)
+        {
+            auto *marks = static_cast<int32_t *>(context);
+            for (int64_t i = begin; i < end; ++i)
+            {
+                marks[i]++;
+            }
+        }
+
+        void CORECLR_DELEGATE_CALLTYPE compute_range(int64_t begin, int64_t end, void *context)
+        {
+            auto *output = static_cast<double *>(context);
+            for (int64_t i = begin; i < end; ++i)
+            {
+                double x = static_cast<double>(i);
+                for (int k = 0; k < 64; ++k)
+                {
+                    x = std::sqrt(x + k);
+                }
+                output[i] = x;
+            }
+        }
+
+        // Plugin objects: PluginSupport.PluginObjects hands out GCHandles, the mock heap pointers
+        struct Counter
+        {
+            int32_t total = 0;
+        };
+
+        int32_t CORECLR_DELEGATE_CALLTYPE create_object(int32_t /*plugin_id*/, const char *type_name, void **object)
+        {
+            if (std::strstr(type_name, "Counter") == nullptr)
+            {
+                return ERROR_TYPE_LOAD;
+            }
+            *object = new Counter();
+            counters.live_objects.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+
+        void CORECLR_DELEGATE_CALLTYPE release_objects(void *const *objects, int32_t count)
+        {
+            for (int32_t i = 0; i < count; ++i)
+            {
+                delete static_cast<Counter *>(objects[i]);
+            }
+            counters.live_objects.fetch_sub(static_cast<uint64_t>(count), std::memory_order_relaxed);
+        }
+
+        int32_t CORECLR_DELEGATE_CALLTYPE counter_add(void *self, int32_t delta)
+        {
+            return static_cast<Counter *>(self)->total += delta;
+        }
+
+        int32_t CORECLR_DELEGATE_CALLTYPE counter_total(void *self)
+        {
+            return static_cast<Counter *>(self)->total;
+        }
+
+        // Event channel producer: the same reads and writes as PluginSupport.HostChannel, against
+        // the header layout it shares with the host, including the wake and wait callbacks
+        void CORECLR_DELEGATE_CALLTYPE produce_events(unsigned char *header, int32_t count)
+        {
+            using wake_fn = void (*)(unsigned char *);
+            using wait_fn = int32_t (*)(unsigned char *, uint64_t, uint32_t);
+            uint32_t capacity;
+            std::memcpy(&capacity, header + 4, sizeof(capacity));
+            wake_fn wake;
+            wait_fn wait_for_space;
+            std::memcpy(&wake, header + 16, sizeof(wake));
+            std::memcpy(&wait_for_space, header + 24, sizeof(wait_for_space));
+            auto *head = reinterpret_cast<std::atomic<uint64_t> *>(header + 64);
+            auto *producer_waiting = reinterpret_cast<std::atomic<uint32_t> *>(header + 72);
+            auto *completed = reinterpret_cast<std::atomic<uint32_t> *>(header + 76);
+            auto *tail = reinterpret_cast<std::atomic<uint64_t> *>(header + 128);
+            auto *consumer_waiting = reinterpret_cast<std::atomic<uint32_t> *>(header + 136);
+            unsigned char *data = header + 192;
+
+            const uint32_t length = 8; // uint32 length + int32 value
+            uint64_t position = head->load(std::memory_order_relaxed);
+            for (int32_t i = 0; i < count; ++i)
+            {
+                uint64_t required = position + length - capacity;
+                if (position + length - tail->load(std::memory_order_acquire) > capacity)
+                {
+                    producer_waiting->store(1, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (tail->load(std::memory_order_acquire) < required)
+                    {
+                        wait_for_space(header, required, UINT32_MAX);
+                    }
+                    producer_waiting->store(0, std::memory_order_relaxed);
+                }
+
+                uint32_t offset = static_cast<uint32_t>(position) & (capacity - 1);
+                uint32_t size = sizeof(int32_t);
+                std::memcpy(data + offset, &size, sizeof(size));
+                std::memcpy(data + offset + sizeof(size), &i, sizeof(i));
+                position += length;
+                head->store(position, std::memory_order_release);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (consumer_waiting->load(std::memory_order_relaxed) != 0)
+                {
+                    wake(header);
+                }
+            }
+
+            completed->store(1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (consumer_waiting->load(std::memory_order_relaxed) != 0)
+            {
+                wake(header);
+            }
+        }
+
+        struct Export
+        {
+            const char *name;
+            void *function;
+        };
+
+        const Export exports[] = {
+            {"ReturnConstant", reinterpret_cast<void *>(&return_constant)},
+            {"AddNumbers", reinterpret_cast<void *>(&add_numbers)},
+            {"WeightedSum", reinterpret_cast<void *>(&weighted_sum)},
+            {"TraceTarget", reinterpret_cast<void *>(&trace_target)},
+            {"AllocateBytes", reinterpret_cast<void *>(&allocate_bytes)},
+            {"SumSamples", reinterpret_cast<void *>(&sum_samples)},
+            {"AddNumbersAsync", reinterpret_cast<void *>(&add_numbers_async)},
+            {"FailAsync", reinterpret_cast<void *>(&fail_async)},
+            {"MarkRange", reinterpret_cast<void *>(&mark_range)},
+            {"ComputeRange", reinterpret_cast<void *>(&compute_range)},
+            {"CreateObject", reinterpret_cast<void *>(&create_object)},
+            {"ReleaseObjects", reinterpret_cast<void *>(&release_objects)},
+            {"Add", reinterpret_cast<void *>(&counter_add)},
+            {"Total", reinterpret_cast<void *>(&counter_total)},
+            {"ProduceEvents", reinterpret_cast<void *>(&produce_events)},
+        };
+    }
+
+    int lookup(const char_t *method_name, void **delegate)
+    {
+        counters.load_calls.fetch_add(1, std::memory_order_relaxed);
+        delay(config().load_delay_us);
+        if (auto rc = config().load_result.load(std::memory_order_relaxed))
+        {
+            return rc;
+        }
+        if (!method_name || !delegate)
+        {
+            return INVALID_ARG_FAILURE;
+        }
+
+        for (const auto &entry : Stubs::exports)
+        {
+            if (equals(method_name, entry.name))
+            {
+                *delegate = entry.function;
+                return 0;
+            }
+        }
+        return MISSING_METHOD;
+    }
+
+    // Type names are not checked: every type exposes the stubs by method name
+    int CORECLR_DELEGATE_CALLTYPE load_assembly_and_get_function_pointer(
+        const char_t * /*assembly_path*/,
+        const char_t * /*type_name*/,
+        const char_t *method_name,
+        const char_t * /*delegate_type_name*/,
+        void * /*reserved*/,
+        void **delegate)
+    {
+        return lookup(method_name, delegate);
+    }
+
+    int CORECLR_DELEGATE_CALLTYPE get_function_pointer(
+        const char_t * /*type_name*/,
+        const char_t *method_name,
+        const char_t * /*delegate_type_name*/,
+        void * /*load_context*/,
+        void * /*reserved*/,
+        void **delegate)
+    {
+        return lookup(method_name, delegate);
+    }
+
+    int CORECLR_DELEGATE_CALLTYPE load_assembly(const char_t *assembly_path, void * /*load_context*/, void * /*reserved*/)
+    {
+        return assembly_path ? 0 : INVALID_ARG_FAILURE;
+    }
+}
+
+MOCK_HOSTFXR_EXPORT int32_t HOSTFXR_CALLTYPE hostfxr_initialize_for_runtime_config(
+    const char_t *runtime_config_path,
+    const struct hostfxr_initialize_parameters * /*parameters*/,
+    hostfxr_handle *host_context_handle)
+{
+    counters.initialize_calls.fetch_add(1, std::memory_order_relaxed);
+    delay(config().initialize_delay_us);
+    if (auto rc = config().initialize_result.load(std::memory_order_relaxed))
+    {
+        return rc;
+    }
+    if (!runtime_config_path || !host_context_handle)
+    {
+        return INVALID_ARG_FAILURE;
+    }
+
+    // The configuration is not parsed, but a missing file fails as it would with the real host
+    std::error_code ec;
+    if (!std::filesystem::exists(runtime_config_path, ec))
+    {
+        return INVALID_CONFIG_FILE;
+    }
+
+    auto context = new Context{read_config_properties(runtime_config_path)};
+    int32_t rc = 0;
+    {
+        std::lock_guard<std::mutex> lock(runtime.mutex);
+        if (runtime.active)
+        {
+            rc = SUCCESS_HOST_ALREADY_INITIALIZED;
+            for (const auto &property : context->properties)
+            {
+                if (!contains(runtime.properties, property))
+                {
+                    rc = SUCCESS_DIFFERENT_RUNTIME_PROPERTIES;
+                }
+            }
+        }
+        else
+        {
+            runtime.active = true;
+            runtime.properties = context->properties;
+        }
+        runtime.contexts.insert(context);
+    }
+
+    counters.open_contexts.fetch_add(1, std::memory_order_relaxed);
+    *host_context_handle = context;
+    return rc;
+}
+
+MOCK_HOSTFXR_EXPORT int32_t HOSTFXR_CALLTYPE hostfxr_get_runtime_delegate(
+    const hostfxr_handle host_context_handle,
+    enum hostfxr_delegate_type type,
+    void **delegate)
+{
+    counters.get_delegate_calls.fetch_add(1, std::memory_order_relaxed);
+    delay(config().get_delegate_delay_us);
+    if (auto rc = config().get_delegate_result.load(std::memory_order_relaxed))
+    {
+        return rc;
+    }
+    if (!is_context(host_context_handle) || !delegate)
+    {
+        return INVALID_ARG_FAILURE;
+    }
+
+    switch (type)
+    {
+    case hdt_load_assembly_and_get_function_pointer:
+        *delegate = reinterpret_cast<void *>(&load_assembly_and_get_function_pointer);
+        return 0;
+    case hdt_get_function_pointer:
+        *delegate = reinterpret_cast<void *>(&get_function_pointer);
+        return 0;
+    case hdt_load_assembly:
+        *delegate = reinterpret_cast<void *>(&load_assembly);
+        return 0;
+    default:
+        return INVALID_ARG_FAILURE;
+    }
+}
+
+MOCK_HOSTFXR_EXPORT int32_t HOSTFXR_CALLTYPE hostfxr_close(const hostfxr_handle host_context_handle)
+{
+    counters.close_calls.fetch_add(1, std::memory_order_relaxed);
+    auto context = static_cast<Context *>(host_context_handle);
+    {
+        std::lock_guard<std::mutex> lock(runtime.mutex);
+        if (runtime.contexts.erase(context) == 0)
+        {
+            return INVALID_ARG_FAILURE;
+        }
+    }
+    delete context;
+    counters.open_contexts.fetch_sub(1, std::memory_order_relaxed);
+    return 0;
+}
+
+// A null handle reads the running runtime. Pointers stay valid while the context is open, or for
+// the running runtime until mock_hostfxr_start_runtime replaces its properties.
+MOCK_HOSTFXR_EXPORT int32_t HOSTFXR_CALLTYPE hostfxr_get_runtime_properties(
+    const hostfxr_handle host_context_handle,
+    size_t *count,
+    const char_t **keys,
+    const char_t **values)
+{
+    if (!count)
+    {
+        return INVALID_ARG_FAILURE;
+    }
+
+    std::lock_guard<std::mutex> lock(runtime.mutex);
+    const Properties *properties = &runtime.properties;
+    if (host_context_handle)
+    {
+        auto context = static_cast<Context *>(host_context_handle);
+        if (runtime.contexts.count(context) == 0)
+        {
+            return INVALID_ARG_FAILURE;
+        }
+        properties = &context->properties;
+    }
+    else if (!runtime.active)
+    {
+        return HOST_INVALID_STATE;
+    }
+
+    size_t capacity = *count;
+    *count = properties->size();
+    if (capacity < properties->size() || (!properties->empty() && (!keys || !values)))
+    {
+        return HOST_API_BUFFER_TOO_SMALL;
+    }
+    for (size_t i = 0; i < properties->size(); ++i)
+    {
+        keys[i] = (*properties)[i].first.c_str();
+        values[i] = (*properties)[i].second.c_str();
+    }
+    return 0;
+}
+
+MOCK_HOSTFXR_API void mock_hostfxr_configure(const mock_hostfxr_config_t *value)
+{
+    config().store(value ? *value : environment_config());
+}
+
+MOCK_HOSTFXR_API void mock_hostfxr_start_runtime(const char *const *keys, const char *const *values, size_t count)
+{
+    std::lock_guard<std::mutex> lock(runtime.mutex);
+    runtime.active = true;
+    runtime.properties.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        runtime.properties.emplace_back(widen(keys[i]), widen(values[i]));
+    }
+}
+
+MOCK_HOSTFXR_API void mock_hostfxr_get_counters(mock_hostfxr_counters_t *value)
+{
+    value->initialize_calls = counters.initialize_calls.load(std::memory_order_relaxed);
+    value->get_delegate_calls = counters.get_delegate_calls.load(std::memory_order_relaxed);
+    value->close_calls = counters.close_calls.load(std::memory_order_relaxed);
+    value->load_calls = counters.load_calls.load(std::memory_order_relaxed);
+    value->open_contexts = counters.open_contexts.load(std::memory_order_relaxed);
+    value->live_objects = counters.live_objects.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,79 @@
+// Control interface of the mock hostfxr library.
+//
+// The mock exports the hostfxr entry points native_host resolves and hands out native
+// stubs in place of managed entry points, so host overhead (locking, handle validation, path
+// conversion, logging) can be tested and benchmarked without a .NET install. Latency and
+// failures of each hosting call are configurable, either from the environment when the mock
+// is first used or at run time through mock_hostfxr_configure:
+//
+//   MOCK_HOSTFXR_INIT_DELAY_US       delay of hostfxr_initialize_for_runtime_config
+//   MOCK_HOSTFXR_DELEGATE_DELAY_US   delay of hostfxr_get_runtime_delegate
+//   MOCK_HOSTFXR_LOAD_DELAY_US       delay of each function pointer lookup
+//   MOCK_HOSTFXR_INIT_RESULT         result of hostfxr_initialize_for_runtime_config
+//   MOCK_HOSTFXR_DELEGATE_RESULT     result of hostfxr_get_runtime_delegate
+//   MOCK_HOSTFXR_LOAD_RESULT         result of each function pointer lookup
+//
+// Results are decimal or 0x-prefixed hexadecimal HRESULTs; 0 means success.
+//
+// Like hostfxr, the first initialization starts the runtime with the "configProperties" of its
+// runtime config, and later initializations return Success_HostAlreadyInitialized or
+// Success_DifferentRuntimeProperties with a secondary context.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifdef MOCK_HOSTFXR_EXPORTS
+#define MOCK_HOSTFXR_API __declspec(dllexport)
+#else
+#define MOCK_HOSTFXR_API __declspec(dllimport)
+#endif
+#else
+#define MOCK_HOSTFXR_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct mock_hostfxr_config
+    {
+        uint32_t initialize_delay_us;
+        uint32_t get_delegate_delay_us;
+        uint32_t load_delay_us;    ///< Applied to every function pointer lookup
+        int32_t initialize_result; ///< Returned instead of initializing when non-zero
+        int32_t get_delegate_result;
+        int32_t load_result; ///< Returned for every function pointer lookup when non-zero
+    } mock_hostfxr_config_t;
+
+    typedef struct mock_hostfxr_counters
+    {
+        uint64_t initialize_calls;
+        uint64_t get_delegate_calls;
+        uint64_t close_calls;
+        uint64_t load_calls; ///< Function pointer lookups through either runtime delegate
+        uint64_t open_contexts;
+        uint64_t live_objects; ///< Plugin objects created and not yet released
+    } mock_hostfxr_counters_t;
+
+    /**
+     * Replaces the configuration; nullptr restores the one read from the environment.
+     * Counters are not reset.
+     */
+    MOCK_HOSTFXR_API void mock_hostfxr_configure(const mock_hostfxr_config_t *config);
+
+    /**
+     * Marks the runtime as started with the given properties, as a .NET application hosting the
+     * process would have, so the next initialization attaches to it. Replaces the properties of a
+     * runtime that is already running.
+     */
+    MOCK_HOSTFXR_API void mock_hostfxr_start_runtime(const char *const *keys, const char *const *values, size_t count);
+
+    MOCK_HOSTFXR_API void mock_hostfxr_get_counters(mock_hostfxr_counters_t *counters);
+
+#ifdef __cplusplus
+}
+#endif
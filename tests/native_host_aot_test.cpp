@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+
+class NativeHostAotTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        aot_library_path_ = test_utils::get_aot_library_path("TestLibrary");
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        if (!std::filesystem::exists(aot_library_path_))
+        {
+            GTEST_SKIP() << "NativeAOT test library not built: " << aot_library_path_;
+        }
+
+        status_ = native_host_create(&host_handle_);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        EXPECT_NE(host_handle_, nullptr);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            status_ = native_host_destroy(host_handle_);
+            EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        }
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    NativeHostStatus status_ = NativeHostStatus::SUCCESS;
+    std::string aot_library_path_;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostAotTest, LoadWithoutRuntimeInitialization)
+{
+    native_assembly_handle_t assembly = nullptr;
+    auto status = native_host_load_assembly(host_handle_, aot_library_path_.c_str(), &assembly);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_NE(assembly, nullptr);
+
+    void *fn_ptr = nullptr;
+    status = native_host_get_delegate(host_handle_, assembly, type_name_.c_str(), "AddNumbers", &fn_ptr);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    ASSERT_NE(fn_ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(fn_ptr)(40, 2), 42);
+
+    status = native_host_unload_assembly(host_handle_, assembly);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostAotTest, MissingExportFails)
+{
+    native_assembly_handle_t assembly = nullptr;
+    auto status = native_host_load_assembly(host_handle_, aot_library_path_.c_str(), &assembly);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    status = native_host_get_delegate(host_handle_, assembly, type_name_.c_str(), "NoSuchExport", &fn_ptr);
+    EXPECT_EQ(status, NativeHostStatus::ERROR_METHOD_LOAD);
+    EXPECT_EQ(fn_ptr, nullptr);
+
+    native_host_unload_assembly(host_handle_, assembly);
+}
+
+TEST_F(NativeHostAotTest, ManagedLoadRequiresInitialization)
+{
+    native_assembly_handle_t assembly = nullptr;
+    auto status = native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly);
+    EXPECT_EQ(status, NativeHostStatus::ERROR_ASSEMBLY_NOT_INITIALIZED);
+}
+
+TEST_F(NativeHostAotTest, MixedManagedAndAotAssemblies)
+{
+    auto status = native_host_initialize(host_handle_);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    native_assembly_handle_t managed = nullptr;
+    native_assembly_handle_t aot = nullptr;
+    EXPECT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &managed), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_load_assembly(host_handle_, aot_library_path_.c_str(), &aot), NativeHostStatus::SUCCESS);
+
+    void *managed_fn = nullptr;
+    void *aot_fn = nullptr;
+    EXPECT_EQ(native_host_get_delegate(host_handle_, managed, type_name_.c_str(), "AddNumbers", &managed_fn),
+              NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_get_delegate(host_handle_, aot, type_name_.c_str(), "AddNumbers", &aot_fn),
+              NativeHostStatus::SUCCESS);
+    ASSERT_NE(managed_fn, nullptr);
+    ASSERT_NE(aot_fn, nullptr);
+    EXPECT_NE(managed_fn, aot_fn);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(managed_fn)(1, 2), 3);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(aot_fn)(1, 2), 3);
+
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, managed), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, aot), NativeHostStatus::SUCCESS);
+}
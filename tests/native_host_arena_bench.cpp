@@ -0,0 +1,176 @@
+// Host arena benchmark: cost of returning variable-size results. Each request makes a batch of
+// allocations that live until the request ends; the native modes compare malloc/free per
+// allocation with host arena allocation and one reset per request, the managed modes compare a
+// plugin returning AllocHGlobal memory that the caller frees with one returning arena memory.
+// Each mode runs at 1..max threads; the cost is wall time divided by allocations per thread.
+
+#include "native_host.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+using FormatRecordDelegate = char *(*)(int32_t);
+
+constexpr int ALLOCATIONS_PER_REQUEST = 32;
+
+// Sizes of serialized records, 16..496 bytes
+static size_t record_size(int i)
+{
+    return 16 + static_cast<size_t>((i * 37) % 31) * 16;
+}
+
+template <typename Request>
+static bool measure(const char *mode, int threads, int requests, Request request)
+{
+    std::atomic<bool> ok{true};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+
+    auto run = [&]
+    {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        for (int i = 0; i < requests; ++i)
+        {
+            if (!request(i))
+            {
+                ok = false;
+                return;
+            }
+        }
+        native_host_arena_reset();
+    };
+
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(run);
+    while (ready.load() < threads)
+        std::this_thread::yield();
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &worker : workers)
+        worker.join();
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    int allocations = requests * ALLOCATIONS_PER_REQUEST;
+    printf("mode=%s threads=%d allocations=%d ns_per_alloc=%.2f\n", mode, threads, allocations, elapsed_ns / allocations);
+    return ok;
+}
+
+static void free_hglobal(void *memory)
+{
+#ifdef _WIN32
+    LocalFree(memory);
+#else
+    free(memory);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [requests] [max_threads]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int requests = argc > 3 ? atoi(argv[3]) : 100000;
+    const int max_threads = argc > 4 ? atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    void *arena_fn = nullptr;
+    void *hglobal_fn = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "FormatRecord", &arena_fn) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "FormatRecordHGlobal", &hglobal_fn) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    auto format_arena = reinterpret_cast<FormatRecordDelegate>(arena_fn);
+    auto format_hglobal = reinterpret_cast<FormatRecordDelegate>(hglobal_fn);
+
+    auto native_malloc = [](int)
+    {
+        void *results[ALLOCATIONS_PER_REQUEST];
+        for (int i = 0; i < ALLOCATIONS_PER_REQUEST; ++i)
+        {
+            results[i] = malloc(record_size(i));
+            if (!results[i])
+                return false;
+            memset(results[i], i, 8);
+        }
+        for (auto *result : results)
+            free(result);
+        return true;
+    };
+    auto native_arena = [](int)
+    {
+        for (int i = 0; i < ALLOCATIONS_PER_REQUEST; ++i)
+        {
+            void *result = native_host_arena_alloc(record_size(i), 16);
+            if (!result)
+                return false;
+            memset(result, i, 8);
+        }
+        native_host_arena_reset();
+        return true;
+    };
+    auto managed_hglobal = [&](int request)
+    {
+        char *results[ALLOCATIONS_PER_REQUEST];
+        for (int i = 0; i < ALLOCATIONS_PER_REQUEST; ++i)
+        {
+            results[i] = format_hglobal(request + i);
+            if (!results[i] || strncmp(results[i], "record-", 7) != 0)
+                return false;
+        }
+        for (auto *result : results)
+            free_hglobal(result);
+        return true;
+    };
+    auto managed_arena = [&](int request)
+    {
+        for (int i = 0; i < ALLOCATIONS_PER_REQUEST; ++i)
+        {
+            char *result = format_arena(request + i);
+            if (!result || strncmp(result, "record-", 7) != 0)
+                return false;
+        }
+        native_host_arena_reset();
+        return true;
+    };
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        if (!measure("native_malloc", threads, requests, native_malloc) ||
+            !measure("native_arena", threads, requests, native_arena) ||
+            !measure("managed_hglobal", threads, requests, managed_hglobal) ||
+            !measure("managed_arena", threads, requests, managed_arena))
+            return 1;
+    }
+
+    native_arena_stats_t stats{};
+    native_host_get_arena_stats(host, &stats);
+    printf("arena allocations=%llu resets=%llu reserved_bytes=%llu leaked_bytes=%llu\n",
+           static_cast<unsigned long long>(stats.allocations), static_cast<unsigned long long>(stats.resets),
+           static_cast<unsigned long long>(stats.reserved_bytes), static_cast<unsigned long long>(stats.leaked_bytes));
+
+    native_host_destroy(host);
+    return 0;
+}
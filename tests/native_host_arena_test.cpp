@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+class NativeHostArenaTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        status_ = native_host_create(&host_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        // Start every test from an empty arena on this thread
+        native_host_arena_reset();
+    }
+
+    void TearDown() override
+    {
+        native_host_arena_reset();
+        if (host_handle_ != nullptr)
+        {
+            status_ = native_host_destroy(host_handle_);
+            EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        }
+    }
+
+    native_arena_stats_t stats()
+    {
+        native_arena_stats_t result{};
+        EXPECT_EQ(native_host_get_arena_stats(host_handle_, &result), NativeHostStatus::SUCCESS);
+        return result;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    NativeHostStatus status_;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostArenaTest, AllocatesAlignedMemoryAndResets)
+{
+    auto before = stats();
+
+    for (size_t alignment = 1; alignment <= 4096; alignment *= 2)
+    {
+        void *memory = native_host_arena_alloc(24, alignment);
+        ASSERT_NE(memory, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(memory) % alignment, 0u);
+        std::memset(memory, 0xAB, 24);
+    }
+
+    auto during = stats();
+    EXPECT_EQ(during.allocations - before.allocations, 13u);
+    EXPECT_EQ(during.live_allocations, 13u);
+    EXPECT_EQ(during.live_bytes, 13u * 24);
+    EXPECT_GT(during.reserved_bytes, 0u);
+
+    native_host_arena_reset();
+
+    auto after = stats();
+    EXPECT_EQ(after.live_allocations, 0u);
+    EXPECT_EQ(after.live_bytes, 0u);
+    EXPECT_EQ(after.resets - during.resets, 1u);
+    // Standard blocks are kept for the next request
+    EXPECT_GT(after.reserved_bytes, 0u);
+}
+
+TEST_F(NativeHostArenaTest, LargeAllocationsGetTheirOwnBlock)
+{
+    constexpr size_t size = 4 * 1024 * 1024;
+    auto *memory = static_cast<uint8_t *>(native_host_arena_alloc(size, 64));
+    ASSERT_NE(memory, nullptr);
+    memory[0] = 1;
+    memory[size - 1] = 2;
+
+    // Small allocations keep working after the oversized block
+    EXPECT_NE(native_host_arena_alloc(16, 8), nullptr);
+    EXPECT_GE(stats().reserved_bytes, size);
+
+    native_host_arena_reset();
+    EXPECT_LT(stats().reserved_bytes, size);
+}
+
+TEST_F(NativeHostArenaTest, RejectsInvalidAlignment)
+{
+    EXPECT_EQ(native_host_arena_alloc(8, 0), nullptr);
+    EXPECT_EQ(native_host_arena_alloc(8, 3), nullptr);
+    EXPECT_EQ(native_host_arena_alloc(8, 8192), nullptr);
+    EXPECT_EQ(native_host_arena_alloc(SIZE_MAX, 8), nullptr);
+    EXPECT_EQ(stats().live_allocations, 0u);
+}
+
+TEST_F(NativeHostArenaTest, ArenasArePerThread)
+{
+    void *mine = native_host_arena_alloc(32, 8);
+    ASSERT_NE(mine, nullptr);
+    auto before = stats();
+
+    std::thread worker([]()
+                       {
+        // Resetting another thread's arena leaves this thread's allocation alone
+        native_host_arena_reset();
+        EXPECT_NE(native_host_arena_alloc(100, 8), nullptr); });
+    worker.join();
+
+    // The worker exited without resetting; its allocation is reported and released
+    auto after = stats();
+    EXPECT_EQ(after.leaked_allocations - before.leaked_allocations, 1u);
+    EXPECT_EQ(after.leaked_bytes - before.leaked_bytes, 100u);
+    EXPECT_EQ(after.live_allocations, 1u);
+    EXPECT_EQ(after.live_bytes, 32u);
+}
+
+TEST_F(NativeHostArenaTest, ManagedResultsComeFromArena)
+{
+    ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+              NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    status_ = native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "FormatRecord", &fn_ptr);
+    ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+    auto format_record = reinterpret_cast<const char *(*)(int32_t)>(fn_ptr);
+
+    for (int32_t id = 0; id < 100; ++id)
+    {
+        const char *record = format_record(id);
+        ASSERT_NE(record, nullptr);
+        EXPECT_STREQ(record, ("record-" + std::to_string(id)).c_str());
+    }
+
+    auto request = stats();
+    EXPECT_EQ(request.live_allocations, 100u);
+
+    native_host_arena_reset();
+    EXPECT_EQ(stats().live_allocations, 0u);
+}
+
+TEST_F(NativeHostArenaTest, StatsRequireHost)
+{
+    native_arena_stats_t result{};
+    EXPECT_EQ(native_host_get_arena_stats(host_handle_, nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_get_arena_stats(nullptr, &result), NativeHostStatus::ERROR_INVALID_ARG);
+}
+
+TEST_F(NativeHostArenaTest, ManagedResultsOnNewThreadSpanBlocks)
+{
+    ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+              NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    status_ = native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "FormatRecord", &fn_ptr);
+    ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+    auto format_record = reinterpret_cast<const char *(*)(int32_t)>(fn_ptr);
+
+    // The first allocation creates this thread's arena and later ones fill several blocks,
+    // both outside the fast path the managed side calls without a GC transition
+    std::thread worker([&]()
+                       {
+        std::vector<const char *> records;
+        for (int32_t id = 0; id < 20000; ++id)
+        {
+            records.push_back(format_record(id));
+        }
+        for (int32_t id = 0; id < 20000; ++id)
+        {
+            ASSERT_NE(records[id], nullptr);
+            EXPECT_STREQ(records[id], ("record-" + std::to_string(id)).c_str());
+        }
+        EXPECT_GT(stats().reserved_bytes, 64u * 1024);
+        native_host_arena_reset(); });
+    worker.join();
+}
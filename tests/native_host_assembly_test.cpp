@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 #include "native_host.h"
 #include "test_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
 
 class NativeHostAssemblyTest : public ::testing::Test
 {
@@ -113,4 +119,150 @@ TEST_F(NativeHostAssemblyTest, MultipleAssemblyLoading)
         auto status = native_host_unload_assembly(host_handle_, assembly);
         EXPECT_EQ(status, NativeHostStatus::SUCCESS);
     }
-} 
\ No newline at end of file
+}
+
+TEST_F(NativeHostAssemblyTest, BulkLoadResolvesEntryPoints)
+{
+    const char *paths[] = {assembly_path_.c_str(), "nonexistent.dll", assembly_path_.c_str()};
+    native_assembly_handle_t assemblies[3] = {};
+    NativeHostStatus statuses[3] = {};
+
+    native_entry_point_t entry_points[] = {
+        {0, type_name_.c_str(), "AddNumbers", nullptr, NativeHostStatus::SUCCESS},
+        {2, type_name_.c_str(), "AddNumbers", nullptr, NativeHostStatus::SUCCESS},
+        {1, type_name_.c_str(), "AddNumbers", nullptr, NativeHostStatus::SUCCESS},
+    };
+
+    std::atomic<int> completed{0};
+    native_bulk_load_options_t options{};
+    options.max_threads = 2;
+    options.entry_points = entry_points;
+    options.entry_point_count = 3;
+    options.user_data = &completed;
+    options.on_loaded = [](void *user_data, uint32_t, native_assembly_handle_t, NativeHostStatus)
+    {
+        (*static_cast<std::atomic<int> *>(user_data))++;
+    };
+
+    auto status = native_host_load_assemblies(host_handle_, paths, 3, assemblies, statuses, &options);
+    EXPECT_EQ(status, NativeHostStatus::ERROR_ASSEMBLY_LOAD);
+    EXPECT_EQ(completed.load(), 3);
+
+    EXPECT_EQ(statuses[0], NativeHostStatus::SUCCESS);
+    EXPECT_EQ(statuses[1], NativeHostStatus::ERROR_ASSEMBLY_LOAD);
+    EXPECT_EQ(statuses[2], NativeHostStatus::SUCCESS);
+    EXPECT_EQ(assemblies[1], nullptr);
+
+    using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_EQ(entry_points[i].status, NativeHostStatus::SUCCESS);
+        ASSERT_NE(entry_points[i].function, nullptr);
+        EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(entry_points[i].function)(2, 3), 5);
+    }
+    EXPECT_EQ(entry_points[2].status, NativeHostStatus::ERROR_ASSEMBLY_LOAD);
+    EXPECT_EQ(entry_points[2].function, nullptr);
+
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, assemblies[0]), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, assemblies[2]), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostAssemblyTest, BulkLoadFailsWithNullArrays)
+{
+    const char *paths[] = {assembly_path_.c_str()};
+    NativeHostStatus statuses[1] = {};
+    auto status = native_host_load_assemblies(host_handle_, paths, 1, nullptr, statuses, nullptr);
+    EXPECT_EQ(status, NativeHostStatus::ERROR_INVALID_ARG);
+
+    status = native_host_load_assemblies(host_handle_, nullptr, 0, nullptr, nullptr, nullptr);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostAssemblyTest, LoadFromMemorySucceeds)
+{
+    std::vector<char> image;
+    {
+        std::ifstream file(assembly_path_, std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    ASSERT_FALSE(image.empty());
+
+    native_assembly_handle_t assembly = nullptr;
+    auto status = native_host_load_assembly_from_memory(host_handle_, image.data(), image.size(), "TestLibrary", &assembly);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+
+    // The runtime keeps its own copy of the image
+    std::fill(image.begin(), image.end(), '\0');
+
+    using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+    void *fn_ptr = nullptr;
+    status = native_host_get_delegate(host_handle_, assembly, type_name_.c_str(), "AddNumbers", &fn_ptr);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(fn_ptr)(2, 3), 5);
+
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, assembly), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostAssemblyTest, LoadFromMemoryFailsWithNullImage)
+{
+    native_assembly_handle_t assembly = nullptr;
+    auto status = native_host_load_assembly_from_memory(host_handle_, nullptr, 16, "TestLibrary", &assembly);
+    EXPECT_EQ(status, NativeHostStatus::ERROR_INVALID_ARG);
+}
+
+TEST_F(NativeHostAssemblyTest, LoadFromBundleSucceeds)
+{
+    native_bundle_handle_t bundle = nullptr;
+    auto status = native_host_open_bundle(host_handle_, test_utils::get_test_assembly_path("TestLibrary.nhb").c_str(), &bundle);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+
+    uint32_t count = 0;
+    ASSERT_EQ(native_host_get_bundle_entries(host_handle_, bundle, nullptr, 0, &count), NativeHostStatus::SUCCESS);
+    std::vector<const char *> names(count);
+    ASSERT_EQ(native_host_get_bundle_entries(host_handle_, bundle, names.data(), count, &count), NativeHostStatus::SUCCESS);
+    EXPECT_TRUE(std::any_of(names.begin(), names.end(),
+                            [](const char *name) { return std::strcmp(name, "TestLibrary.dll") == 0; }));
+
+    native_assembly_handle_t assembly = nullptr;
+    status = native_host_load_assembly_from_bundle(host_handle_, bundle, "testlibrary.dll", &assembly);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+
+    // Assemblies stay usable after the bundle handle is closed
+    EXPECT_EQ(native_host_close_bundle(host_handle_, bundle), NativeHostStatus::SUCCESS);
+
+    using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+    void *fn_ptr = nullptr;
+    status = native_host_get_delegate(host_handle_, assembly, type_name_.c_str(), "AddNumbers", &fn_ptr);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(fn_ptr)(2, 3), 5);
+
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, assembly), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostAssemblyTest, OpenBundleFailsForAssembly)
+{
+    native_bundle_handle_t bundle = nullptr;
+    auto status = native_host_open_bundle(host_handle_, assembly_path_.c_str(), &bundle);
+    EXPECT_EQ(status, NativeHostStatus::ERROR_ASSEMBLY_LOAD);
+}
+
+TEST_F(NativeHostAssemblyTest, BundledDependenciesResolveAfterBundleClosed)
+{
+    native_bundle_handle_t bundle = nullptr;
+    auto status = native_host_open_bundle(host_handle_, test_utils::get_test_assembly_path("TestLibrary.nhb").c_str(), &bundle);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+
+    native_assembly_handle_t assembly = nullptr;
+    status = native_host_load_assembly_from_bundle(host_handle_, bundle, "TestLibrary.dll", &assembly);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_close_bundle(host_handle_, bundle), NativeHostStatus::SUCCESS);
+
+    // Microsoft.Extensions.Logging is only resolved from the bundle on this first use
+    using LoadsDependenciesDelegate = int32_t (*)();
+    void *fn_ptr = nullptr;
+    status = native_host_get_delegate(host_handle_, assembly, type_name_.c_str(), "LoadsDependenciesInPluginContext", &fn_ptr);
+    ASSERT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(reinterpret_cast<LoadsDependenciesDelegate>(fn_ptr)(), 1);
+
+    EXPECT_EQ(native_host_unload_assembly(host_handle_, assembly), NativeHostStatus::SUCCESS);
+}
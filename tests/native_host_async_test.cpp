@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "native_host_async.hpp"
+#include "test_utils.h"
+#include <chrono>
+#include <future>
+
+class NativeHostAsyncTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        status_ = native_host_create(&host_handle_);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        status_ = native_host_initialize(host_handle_);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        status_ = native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            status_ = native_host_destroy(host_handle_);
+            EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        }
+    }
+
+    native_method_handle_t getMethod(const char *method_name, const char *signature)
+    {
+        native_method_handle_t method = nullptr;
+        status_ = native_host_get_method(host_handle_, assembly_handle_, type_name_.c_str(), method_name, signature, &method);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        return method;
+    }
+
+    struct Completion
+    {
+        std::promise<std::pair<NativeHostStatus, int32_t>> promise;
+
+        static void callback(void *state, NativeHostStatus status, const native_value_t *result)
+        {
+            static_cast<Completion *>(state)->promise.set_value({status, result ? result->i32 : 0});
+        }
+    };
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    NativeHostStatus status_ = NativeHostStatus::SUCCESS;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostAsyncTest, InvokeAsyncCompletesThroughCallback)
+{
+    auto method = getMethod("AddNumbersAsync", "Tiii");
+    ASSERT_NE(method, nullptr);
+
+    Completion completion;
+    auto future = completion.promise.get_future();
+    native_value_t args[2];
+    args[0].i32 = 2;
+    args[1].i32 = 3;
+    ASSERT_EQ(native_host_invoke_async(method, args, &Completion::callback, &completion), NativeHostStatus::SUCCESS);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    auto [status, value] = future.get();
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(value, 5);
+}
+
+TEST_F(NativeHostAsyncTest, InvokeAsyncReportsFaultedTask)
+{
+    auto method = getMethod("FailAsync", "Ti");
+    ASSERT_NE(method, nullptr);
+
+    Completion completion;
+    auto future = completion.promise.get_future();
+    ASSERT_EQ(native_host_invoke_async(method, nullptr, &Completion::callback, &completion), NativeHostStatus::SUCCESS);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(future.get().first, NativeHostStatus::ERROR_TASK_FAULTED);
+}
+
+TEST_F(NativeHostAsyncTest, SyncAndAsyncInvokeAreNotInterchangeable)
+{
+    auto async_method = getMethod("AddNumbersAsync", "Tiii");
+    auto sync_method = getMethod("AddNumbers", "iii");
+    native_value_t args[2] = {};
+    native_value_t result{};
+    Completion completion;
+
+    EXPECT_EQ(native_host_invoke(async_method, args, &result), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_invoke_async(sync_method, args, &Completion::callback, &completion), NativeHostStatus::ERROR_INVALID_ARG);
+}
+
+#ifdef __cpp_impl_coroutine
+namespace
+{
+    // Minimal eagerly started coroutine for driving co_await in tests
+    struct detached
+    {
+        struct promise_type
+        {
+            detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    detached add_async(native_method_handle_t method, std::promise<int32_t> &done)
+    {
+        auto value = co_await native_host::invoke_async<int32_t>(method, 20, 22);
+        done.set_value(value);
+    }
+
+    detached fail_async(native_method_handle_t method, std::promise<NativeHostStatus> &done)
+    {
+        try
+        {
+            co_await native_host::invoke_async<int32_t>(method);
+            done.set_value(NativeHostStatus::SUCCESS);
+        }
+        catch (const native_host::async_error &error)
+        {
+            done.set_value(error.status());
+        }
+    }
+}
+
+TEST_F(NativeHostAsyncTest, CoroutineAwaitsManagedTask)
+{
+    auto method = getMethod("AddNumbersAsync", "Tiii");
+    ASSERT_NE(method, nullptr);
+
+    std::promise<int32_t> done;
+    auto future = done.get_future();
+    add_async(method, done);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST_F(NativeHostAsyncTest, CoroutineThrowsForFaultedTask)
+{
+    auto method = getMethod("FailAsync", "Ti");
+    ASSERT_NE(method, nullptr);
+
+    std::promise<NativeHostStatus> done;
+    auto future = done.get_future();
+    fail_async(method, done);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(future.get(), NativeHostStatus::ERROR_TASK_FAULTED);
+}
+#endif
@@ -93,4 +93,86 @@ TEST_F(NativeHostBasicTest, MultipleInitializationIsSafe)
 
     status = native_host_destroy(handle);
     EXPECT_EQ(status, NativeHostStatus::SUCCESS);
-} 
\ No newline at end of file
+}
+
+TEST_F(NativeHostBasicTest, InitializeWithOptionsFailsWithNullOptions)
+{
+    native_host_handle_t handle = nullptr;
+    auto status = native_host_create(&handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    EXPECT_EQ(native_host_initialize_with_options(handle, nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+
+    status = native_host_destroy(handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostBasicTest, RuntimeInitTimingsAvailableAfterInitialization)
+{
+    native_host_handle_t handle = nullptr;
+    auto status = native_host_create(&handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    native_runtime_init_timings_t timings{};
+    EXPECT_EQ(native_host_get_runtime_init_timings(handle, &timings), NativeHostStatus::ERROR_RUNTIME_INIT);
+
+    native_host_runtime_options_t options{sizeof(options)};
+    status = native_host_initialize_with_options(handle, &options);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    status = native_host_get_runtime_init_timings(handle, &timings);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_GT(timings.total_ns, 0u);
+    EXPECT_GE(timings.total_ns, timings.initialize_runtime_ns);
+
+    status = native_host_destroy(handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+}
+
+static int32_t HostMultiply(int32_t a, int32_t b)
+{
+    return a * b;
+}
+
+TEST_F(NativeHostBasicTest, HostServicesCallableFromPlugin)
+{
+    native_host_handle_t handle = nullptr;
+    auto status = native_host_create(&handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    const void *services[] = {reinterpret_cast<const void *>(&HostMultiply)};
+    native_host_runtime_options_t options{sizeof(options)};
+    options.services = services;
+    options.service_count = 1;
+    status = native_host_initialize_with_options(handle, &options);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    native_assembly_handle_t assembly = nullptr;
+    status = native_host_load_assembly(handle, "../tests/TestLibrary.dll", &assembly);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    status = native_host_get_delegate(handle, assembly, "TestLibrary.TestClass,TestLibrary", "CallHostMultiply", &fn_ptr);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    ASSERT_NE(fn_ptr, nullptr);
+
+    auto call_host_multiply = reinterpret_cast<int32_t (*)(int32_t, int32_t)>(fn_ptr);
+    EXPECT_EQ(call_host_multiply(6, 7), 42);
+
+    status = native_host_destroy(handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostBasicTest, InitializeWithOptionsFailsWithNullServices)
+{
+    native_host_handle_t handle = nullptr;
+    auto status = native_host_create(&handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+
+    native_host_runtime_options_t options{sizeof(options)};
+    options.service_count = 1;
+    EXPECT_EQ(native_host_initialize_with_options(handle, &options), NativeHostStatus::ERROR_INVALID_ARG);
+
+    status = native_host_destroy(handle);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+}
@@ -0,0 +1,122 @@
+// Call tracking benchmark: throughput of a plugin delegate called directly, inside a
+// native_host_call_enter/leave scope (in-flight tracking for safe unload), behind a global
+// mutex (what callers needed before the tracking existed), and through native_host_invoke.
+// Each mode runs at 1..max threads; the per-call cost is wall time divided by calls per thread.
+
+#include "native_host.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+
+template <typename Call>
+static bool measure(const char *mode, int threads, int iterations, Call call)
+{
+    std::atomic<bool> ok{true};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+
+    auto run = [&]
+    {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        for (int i = 0; i < iterations; ++i)
+        {
+            if (!call(i))
+            {
+                ok = false;
+                return;
+            }
+        }
+    };
+
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(run);
+    while (ready.load() < threads)
+        std::this_thread::yield();
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &worker : workers)
+        worker.join();
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("mode=%s threads=%d calls=%d ns_per_call=%.2f\n", mode, threads, iterations, elapsed_ns / iterations);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [iterations] [max_threads]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int iterations = argc > 3 ? atoi(argv[3]) : 2000000;
+    const int max_threads = argc > 4 ? atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    void *fn_ptr = nullptr;
+    native_method_handle_t method = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "AddNumbers", &fn_ptr) != NativeHostStatus::SUCCESS ||
+        native_host_get_method(host, assembly, type_name, "AddNumbers", "iii", &method) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    // Only the tracking cost is of interest, not the sampled CPU time and allocation accounting
+    native_host_set_stats_sample_rate(host, 0);
+
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(fn_ptr);
+    std::mutex call_mutex;
+
+    auto direct = [&](int i) { return add_numbers(i, 1) == i + 1; };
+    auto scoped = [&](int i)
+    {
+        native_call_scope_t scope;
+        if (native_host_call_enter(assembly, &scope) != NativeHostStatus::SUCCESS)
+            return false;
+        bool ok = add_numbers(i, 1) == i + 1;
+        native_host_call_leave(&scope);
+        return ok;
+    };
+    auto locked = [&](int i)
+    {
+        std::lock_guard<std::mutex> lock(call_mutex);
+        return add_numbers(i, 1) == i + 1;
+    };
+    auto invoke = [&](int i)
+    {
+        native_value_t args[2];
+        args[0].i32 = i;
+        args[1].i32 = 1;
+        native_value_t result{};
+        return native_host_invoke(method, args, &result) == NativeHostStatus::SUCCESS && result.i32 == i + 1;
+    };
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        if (!measure("direct", threads, iterations, direct) ||
+            !measure("scoped", threads, iterations, scoped) ||
+            !measure("mutex", threads, iterations, locked) ||
+            !measure("invoke", threads, iterations, invoke))
+            return 1;
+    }
+
+    native_host_destroy(host);
+    return 0;
+}
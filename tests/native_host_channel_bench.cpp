@@ -0,0 +1,107 @@
+// Event channel benchmark: a producer thread streams 4-byte events through a channel to a
+// consumer draining in batches, for several buffer sizes. mode=native writes with
+// native_host_channel_write; mode=managed runs the test library's ProduceEvents, which writes
+// through PluginSupport.HostChannel (a native stub in the mock build). Each configuration is
+// repeated and the fastest run is reported.
+
+#include "native_host.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using ProduceEvents = void (*)(void *, int32_t);
+
+static void sum_event(void *user_data, const void *data, uint32_t)
+{
+    int32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    *static_cast<int64_t *>(user_data) += value;
+}
+
+// Runs one producer against a draining consumer; returns elapsed ms, or -1 if events were lost
+template <typename Produce>
+static double run(native_host_handle_t host, uint32_t capacity, int32_t events, Produce produce)
+{
+    native_channel_options_t options{};
+    options.capacity = capacity;
+    native_channel_handle_t channel = nullptr;
+    if (native_host_create_channel(host, &options, &channel) != NativeHostStatus::SUCCESS)
+        return -1;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]
+                         { produce(channel); });
+    int64_t sum = 0;
+    uint32_t drained = 0;
+    do
+    {
+        if (native_host_channel_drain(channel, sum_event, &sum, 0, UINT32_MAX, &drained) != NativeHostStatus::SUCCESS)
+            break;
+    } while (drained != 0);
+    producer.join();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    native_host_close_channel(host, channel);
+    return sum == static_cast<int64_t>(events) * (events - 1) / 2 ? ms : -1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [events]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int32_t events = argc > 3 ? atoi(argv[3]) : 20000000;
+    const int repeats = 3;
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    void *produce_events = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "ProduceEvents", &produce_events) != NativeHostStatus::SUCCESS)
+        return 1;
+    auto managed = reinterpret_cast<ProduceEvents>(produce_events);
+
+    for (uint32_t capacity : {64u << 10, 1u << 20, 16u << 20})
+    {
+        for (const char *mode : {"native", "managed"})
+        {
+            bool native = std::strcmp(mode, "native") == 0;
+            double best = 0;
+            for (int r = 0; r < repeats; ++r)
+            {
+                double ms = run(host, capacity, events, [&](native_channel_handle_t channel)
+                                {
+                    if (!native)
+                    {
+                        managed(channel, events);
+                        return;
+                    }
+                    for (int32_t i = 0; i < events; ++i)
+                    {
+                        native_host_channel_write(channel, &i, sizeof(i), UINT32_MAX);
+                    }
+                    native_host_channel_complete(channel); });
+                if (ms < 0)
+                    return 1;
+                best = r == 0 ? ms : std::min(best, ms);
+            }
+            printf("mode=%s capacity_kib=%u events=%d ms=%.2f mevents_per_s=%.1f\n", mode, capacity >> 10, events, best,
+                   events / best / 1000.0);
+        }
+    }
+
+    native_host_destroy(host);
+    return 0;
+}
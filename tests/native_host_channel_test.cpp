@@ -0,0 +1,287 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ProduceEventsDelegate = void (*)(void *, int32_t);
+
+class NativeHostChannelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+    }
+
+    native_channel_handle_t create_channel(uint32_t capacity)
+    {
+        native_channel_options_t options{};
+        options.capacity = capacity;
+        native_channel_handle_t channel = nullptr;
+        EXPECT_EQ(native_host_create_channel(host_handle_, &options, &channel), NativeHostStatus::SUCCESS);
+        return channel;
+    }
+
+    static NativeHostStatus write_int(native_channel_handle_t channel, int32_t value, uint32_t timeout_ms = 0)
+    {
+        return native_host_channel_write(channel, &value, sizeof(value), timeout_ms);
+    }
+
+    // Collects every event as a string of its bytes
+    static void collect(void *user_data, const void *data, uint32_t size)
+    {
+        static_cast<std::vector<std::string> *>(user_data)->emplace_back(static_cast<const char *>(data), size);
+    }
+
+    static void sum_ints(void *user_data, const void *data, uint32_t size)
+    {
+        int32_t value = 0;
+        ASSERT_EQ(size, sizeof(value));
+        std::memcpy(&value, data, sizeof(value));
+        *static_cast<int64_t *>(user_data) += value;
+    }
+
+    static int32_t as_int(const std::string &event)
+    {
+        int32_t value = 0;
+        std::memcpy(&value, event.data(), sizeof(value));
+        return value;
+    }
+
+    // Drains until the producer completes, returning the sum of the int events
+    static int64_t drain_ints(native_channel_handle_t channel)
+    {
+        int64_t sum = 0;
+        uint32_t drained = 0;
+        do
+        {
+            EXPECT_EQ(native_host_channel_drain(channel, sum_ints, &sum, 0, UINT32_MAX, &drained),
+                      NativeHostStatus::SUCCESS);
+        } while (drained != 0);
+        return sum;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostChannelTest, DrainsEventsInOrder)
+{
+    auto channel = create_channel(0);
+    ASSERT_NE(channel, nullptr);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(write_int(channel, i), NativeHostStatus::SUCCESS);
+    }
+
+    std::vector<std::string> events;
+    uint32_t drained = 0;
+    ASSERT_EQ(native_host_channel_drain(channel, collect, &events, 0, 0, &drained), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(drained, 100u);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(as_int(events[i]), i);
+    }
+
+    EXPECT_EQ(native_host_channel_drain(channel, collect, &events, 0, 0, &drained), NativeHostStatus::ERROR_TIMEOUT);
+    EXPECT_EQ(drained, 0u);
+    EXPECT_EQ(native_host_close_channel(host_handle_, channel), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostChannelTest, MaxEventsLimitsBatch)
+{
+    auto channel = create_channel(0);
+    for (int32_t i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(write_int(channel, i), NativeHostStatus::SUCCESS);
+    }
+
+    std::vector<std::string> events;
+    uint32_t drained = 0;
+    ASSERT_EQ(native_host_channel_drain(channel, collect, &events, 4, 0, &drained), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(drained, 4u);
+    ASSERT_EQ(native_host_channel_drain(channel, collect, &events, 0, 0, &drained), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(drained, 6u);
+    ASSERT_EQ(events.size(), 10u);
+    EXPECT_EQ(as_int(events[4]), 4) << "The next batch resumes after the last event handed out";
+}
+
+TEST_F(NativeHostChannelTest, VariableSizeEventsWrapAround)
+{
+    auto channel = create_channel(4096);
+    std::vector<std::string> events;
+    size_t expected = 0;
+    for (int round = 0; round < 200; ++round)
+    {
+        // Sizes that leave every possible gap at the end of the buffer, including empty events
+        std::string event(static_cast<size_t>((round * 37) % 1500), static_cast<char>('a' + round % 26));
+        ASSERT_EQ(native_host_channel_write(channel, event.data(), static_cast<uint32_t>(event.size()), 0),
+                  NativeHostStatus::SUCCESS);
+
+        uint32_t drained = 0;
+        ASSERT_EQ(native_host_channel_drain(channel, collect, &events, 0, 0, &drained), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(drained, 1u);
+        ASSERT_EQ(events[expected++], event) << "round " << round;
+    }
+}
+
+TEST_F(NativeHostChannelTest, FullBufferBlocksProducer)
+{
+    auto channel = create_channel(4096);
+    int32_t written = 0;
+    while (write_int(channel, written) == NativeHostStatus::SUCCESS)
+    {
+        ++written;
+    }
+    EXPECT_EQ(written, 4096 / 8) << "Each int event takes an 8-byte record";
+    EXPECT_EQ(write_int(channel, written, 10), NativeHostStatus::ERROR_TIMEOUT);
+
+    std::atomic<bool> done{false};
+    std::thread producer([&]()
+                         {
+        EXPECT_EQ(write_int(channel, written, UINT32_MAX), NativeHostStatus::SUCCESS);
+        done = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(done.load()) << "The producer waits while the buffer is full";
+
+    int64_t sum = 0;
+    uint32_t drained = 0;
+    ASSERT_EQ(native_host_channel_drain(channel, sum_ints, &sum, 1, 0, &drained), NativeHostStatus::SUCCESS);
+    producer.join();
+    EXPECT_TRUE(done.load());
+}
+
+TEST_F(NativeHostChannelTest, WritesWakeSleepingConsumer)
+{
+    auto channel = create_channel(0);
+    std::vector<std::string> events;
+    uint32_t drained = 0;
+    NativeHostStatus status = NativeHostStatus::ERROR_TIMEOUT;
+    std::thread consumer([&]()
+                         { status = native_host_channel_drain(channel, collect, &events, 0, 10000, &drained); });
+
+    // Long enough for the consumer to stop spinning and go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(write_int(channel, 42), NativeHostStatus::SUCCESS);
+    consumer.join();
+
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    ASSERT_EQ(drained, 1u);
+    EXPECT_EQ(as_int(events[0]), 42);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(NativeHostChannelTest, DrainTimesOutWhenEmpty)
+{
+    auto channel = create_channel(0);
+    std::vector<std::string> events;
+    uint32_t drained = 0;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(native_host_channel_drain(channel, collect, &events, 0, 20, &drained), NativeHostStatus::ERROR_TIMEOUT);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_TRUE(events.empty());
+}
+
+TEST_F(NativeHostChannelTest, CompletionEndsStream)
+{
+    auto channel = create_channel(0);
+    for (int32_t i = 1; i <= 3; ++i)
+    {
+        ASSERT_EQ(write_int(channel, i), NativeHostStatus::SUCCESS);
+    }
+    ASSERT_EQ(native_host_channel_complete(channel), NativeHostStatus::SUCCESS);
+
+    EXPECT_EQ(drain_ints(channel), 6);
+    uint32_t drained = 1;
+    int64_t sum = 0;
+    EXPECT_EQ(native_host_channel_drain(channel, sum_ints, &sum, 0, UINT32_MAX, &drained), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(drained, 0u) << "A completed channel does not wait";
+}
+
+TEST_F(NativeHostChannelTest, StreamsBetweenThreads)
+{
+    auto channel = create_channel(4096);
+    constexpr int32_t COUNT = 200000;
+    std::thread producer([&]()
+                         {
+        for (int32_t i = 0; i < COUNT; ++i)
+        {
+            ASSERT_EQ(write_int(channel, i, UINT32_MAX), NativeHostStatus::SUCCESS);
+        }
+        native_host_channel_complete(channel); });
+
+    EXPECT_EQ(drain_ints(channel), static_cast<int64_t>(COUNT) * (COUNT - 1) / 2);
+    producer.join();
+}
+
+TEST_F(NativeHostChannelTest, ManagedProducer)
+{
+    native_assembly_handle_t assembly = nullptr;
+    ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly), NativeHostStatus::SUCCESS);
+    void *fn_ptr = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly, type_name_.c_str(), "ProduceEvents", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+    auto produce = reinterpret_cast<ProduceEventsDelegate>(fn_ptr);
+
+    auto channel = create_channel(4096);
+    constexpr int32_t COUNT = 100000;
+    std::thread producer([&]()
+                         { produce(channel, COUNT); });
+
+    EXPECT_EQ(drain_ints(channel), static_cast<int64_t>(COUNT) * (COUNT - 1) / 2);
+    producer.join();
+}
+
+TEST_F(NativeHostChannelTest, RejectsOversizedEvents)
+{
+    auto channel = create_channel(4096);
+    std::vector<char> event(4096 / 2);
+    EXPECT_EQ(native_host_channel_write(channel, event.data(), static_cast<uint32_t>(event.size() - 4), 0),
+              NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_channel_write(channel, event.data(), static_cast<uint32_t>(event.size() - 3), 0),
+              NativeHostStatus::ERROR_INVALID_ARG);
+}
+
+TEST_F(NativeHostChannelTest, InvalidArguments)
+{
+    native_channel_handle_t channel = nullptr;
+    native_channel_options_t options{};
+    EXPECT_EQ(native_host_create_channel(nullptr, &options, &channel), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_create_channel(host_handle_, &options, nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_create_channel(reinterpret_cast<native_host_handle_t>(0x1), &options, &channel),
+              NativeHostStatus::ERROR_HOST_NOT_FOUND);
+    options.capacity = 5000;
+    EXPECT_EQ(native_host_create_channel(host_handle_, &options, &channel), NativeHostStatus::ERROR_INVALID_ARG);
+    options.capacity = 1024;
+    EXPECT_EQ(native_host_create_channel(host_handle_, &options, &channel), NativeHostStatus::ERROR_INVALID_ARG);
+
+    ASSERT_EQ(native_host_create_channel(host_handle_, nullptr, &channel), NativeHostStatus::SUCCESS);
+    uint32_t drained = 0;
+    EXPECT_EQ(native_host_channel_drain(channel, nullptr, nullptr, 0, 0, &drained), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_channel_drain(nullptr, collect, nullptr, 0, 0, &drained), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_channel_write(nullptr, "x", 1, 0), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_channel_write(channel, nullptr, 1, 0), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_channel_complete(nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+
+    EXPECT_EQ(native_host_close_channel(host_handle_, channel), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_close_channel(host_handle_, channel), NativeHostStatus::ERROR_INVALID_ARG);
+}
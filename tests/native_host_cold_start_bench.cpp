@@ -0,0 +1,75 @@
+// Cold-start benchmark: measures one process start up to the first call into a plugin.
+// The runtime can only be initialized once per process, so each run is a separate process;
+// cold_start_bench.cmake drives repeated runs for the JIT and NativeAOT modes.
+
+#include "native_host.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+
+static long peak_rss_kb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4 || (strcmp(argv[1], "jit") != 0 && strcmp(argv[1], "aot") != 0))
+    {
+        fprintf(stderr, "Usage: %s <jit|aot> <assembly_path> <type_name>\n", argv[0]);
+        return 2;
+    }
+
+    const bool jit = strcmp(argv[1], "jit") == 0;
+    auto start = std::chrono::steady_clock::now();
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS)
+        return 1;
+    if (jit && native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    if (native_host_load_assembly(host, argv[2], &assembly) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    void *fn_ptr = nullptr;
+    if (native_host_get_delegate(host, assembly, argv[3], "AddNumbers", &fn_ptr) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    int32_t result = reinterpret_cast<AddNumbersDelegate>(fn_ptr)(40, 2);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("mode=%s first_call_us=%lld peak_rss_kb=%ld result=%d\n",
+           argv[1],
+           static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+           peak_rss_kb(),
+           result);
+
+    native_host_unload_assembly(host, assembly);
+    native_host_destroy(host);
+    return result == 42 ? 0 : 1;
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "native_host.h"
 #include "test_utils.h"
+#include "native_host_call.hpp"
 #include <thread>
 #include <vector>
 #include <atomic>
@@ -199,4 +200,140 @@ TEST_F(NativeHostConcurrencyTest, ConcurrentAssemblyOperations)
 
     EXPECT_EQ(error_count.load(), 0);
     native_host_destroy(host);
-}
\ No newline at end of file
+}
+
+TEST_F(NativeHostConcurrencyTest, UnloadDefersDestructionWhileCallInFlight)
+{
+    native_host_handle_t host = nullptr;
+    ASSERT_EQ(native_host_create(&host), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_initialize(host), NativeHostStatus::SUCCESS);
+
+    native_assembly_handle_t assembly = nullptr;
+    ASSERT_EQ(native_host_load_assembly(host, assembly_path_.c_str(), &assembly), NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host, assembly, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+    auto add_fn = reinterpret_cast<int32_t (*)(int32_t, int32_t)>(fn_ptr);
+
+    {
+        native_host::call_scope scope(assembly);
+        ASSERT_TRUE(scope);
+
+        // Unloading does not wait, but the assembly stays usable until the scope ends
+        EXPECT_EQ(native_host_unload_assembly(host, assembly), NativeHostStatus::SUCCESS);
+        EXPECT_EQ(add_fn(2, 3), 5);
+
+        native_host::call_scope late(assembly);
+        EXPECT_FALSE(late);
+        EXPECT_EQ(late.status(), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+    }
+
+    // The handle of an unloaded assembly stays safe to pass until the host is destroyed
+    native_call_scope_t scope;
+    EXPECT_EQ(native_host_call_enter(assembly, &scope), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+    EXPECT_EQ(native_host_unload_assembly(host, assembly), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+
+    native_host_destroy(host);
+}
+
+TEST_F(NativeHostConcurrencyTest, UnloadWaitReturnsAfterCallsLeave)
+{
+    native_host_handle_t host = nullptr;
+    ASSERT_EQ(native_host_create(&host), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_initialize(host), NativeHostStatus::SUCCESS);
+
+    native_assembly_handle_t assembly = nullptr;
+    ASSERT_EQ(native_host_load_assembly(host, assembly_path_.c_str(), &assembly), NativeHostStatus::SUCCESS);
+
+    native_call_scope_t scope;
+    ASSERT_EQ(native_host_call_enter(assembly, &scope), NativeHostStatus::SUCCESS);
+
+    std::atomic<bool> left{false};
+    std::thread caller([&]()
+                       {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        left = true;
+        native_host_call_leave(&scope); });
+
+    // Leaving from another thread than the one that entered is allowed
+    EXPECT_EQ(native_host_unload_assembly_wait(host, assembly, 10000), NativeHostStatus::SUCCESS);
+    EXPECT_TRUE(left.load());
+
+    caller.join();
+    native_host_destroy(host);
+}
+
+TEST_F(NativeHostConcurrencyTest, UnloadWaitTimesOutWhileCallInFlight)
+{
+    native_host_handle_t host = nullptr;
+    ASSERT_EQ(native_host_create(&host), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_initialize(host), NativeHostStatus::SUCCESS);
+
+    native_assembly_handle_t assembly = nullptr;
+    ASSERT_EQ(native_host_load_assembly(host, assembly_path_.c_str(), &assembly), NativeHostStatus::SUCCESS);
+
+    native_call_scope_t scope;
+    ASSERT_EQ(native_host_call_enter(assembly, &scope), NativeHostStatus::SUCCESS);
+
+    EXPECT_EQ(native_host_unload_assembly_wait(host, assembly, 20), NativeHostStatus::ERROR_TIMEOUT);
+
+    // The assembly is unloaded all the same; the scope still closes normally
+    EXPECT_EQ(native_host_call_leave(&scope), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_unload_assembly(host, assembly), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+
+    native_host_destroy(host);
+}
+
+TEST_F(NativeHostConcurrencyTest, UnloadRacesWithScopedCalls)
+{
+    native_host_handle_t host = nullptr;
+    ASSERT_EQ(native_host_create(&host), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_initialize(host), NativeHostStatus::SUCCESS);
+
+    constexpr int NUM_THREADS = 4;
+    constexpr int ROUNDS = 20;
+    std::atomic<int> error_count{0};
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        native_assembly_handle_t assembly = nullptr;
+        ASSERT_EQ(native_host_load_assembly(host, assembly_path_.c_str(), &assembly), NativeHostStatus::SUCCESS);
+
+        void *fn_ptr = nullptr;
+        ASSERT_EQ(native_host_get_delegate(host, assembly, type_name_.c_str(), "AddNumbers", &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+        auto add_fn = reinterpret_cast<int32_t (*)(int32_t, int32_t)>(fn_ptr);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back([&, i]()
+                                 {
+                // Each caller stops at its first rejected scope
+                for (int j = 0;; ++j)
+                {
+                    native_host::call_scope scope(assembly);
+                    if (!scope)
+                    {
+                        break;
+                    }
+                    if (add_fn(i, j) != i + j)
+                    {
+                        error_count++;
+                    }
+                } });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_EQ(native_host_unload_assembly_wait(host, assembly, 10000), NativeHostStatus::SUCCESS);
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    EXPECT_EQ(error_count.load(), 0);
+    native_host_destroy(host);
+}
@@ -1,10 +1,12 @@
 #include <gtest/gtest.h>
 #include "native_host.h"
 #include "test_utils.h"
+#include "TestLibrary.bindings.h"
 #include <climits>
 
-using ReturnConstantDelegate = int32_t (*)();
-using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+using ReturnConstantDelegate = TestLibrary_TestClass_ReturnConstant_fn;
+using AddNumbersDelegate = TestLibrary_TestClass_AddNumbers_fn;
+using AllocateBytesDelegate = TestLibrary_TestClass_AllocateBytes_fn;
 
 class NativeHostFunctionTest : public ::testing::Test
 {
@@ -162,4 +164,74 @@ TEST_F(NativeHostFunctionTest, MultipleFunctionCalls)
     {
         EXPECT_EQ(fn(i, i), i * 2);
     }
-} 
\ No newline at end of file
+}
+
+TEST_F(NativeHostFunctionTest, GeneratedStructBindings)
+{
+    auto fn = getFunctionPointer<TestLibrary_TestClass_SumSamples_fn>("SumSamples");
+    EXPECT_NE(fn, nullptr);
+
+    TestLibrary_Sample samples[3] = {{1, 1.5, 0}, {2, 2.5, 1}, {3, 3.0, 0}};
+    EXPECT_DOUBLE_EQ(fn(samples, 3), 7.0);
+    EXPECT_DOUBLE_EQ(fn(samples, 0), 0.0);
+}
+
+TEST_F(NativeHostFunctionTest, DependenciesLoadIntoPluginContext)
+{
+    auto fn = getFunctionPointer<TestLibrary_TestClass_LoadsDependenciesInPluginContext_fn>("LoadsDependenciesInPluginContext");
+    EXPECT_NE(fn, nullptr);
+    EXPECT_EQ(fn(), 1);
+}
+
+TEST_F(NativeHostFunctionTest, CallScopeCountsInvocations)
+{
+    auto fn = getFunctionPointer<AddNumbersDelegate>("AddNumbers");
+    EXPECT_NE(fn, nullptr);
+
+    for (int i = 0; i < 100; i++)
+    {
+        native_call_scope_t scope;
+        EXPECT_EQ(native_host_call_enter(assembly_handle_, &scope), NativeHostStatus::SUCCESS);
+        EXPECT_EQ(fn(i, i), i * 2);
+        EXPECT_EQ(native_host_call_leave(&scope), NativeHostStatus::SUCCESS);
+    }
+
+    native_assembly_stats_t stats;
+    auto status = native_host_get_assembly_stats(host_handle_, assembly_handle_, &stats);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(stats.invocations, 100u);
+    EXPECT_LE(stats.sampled_invocations, stats.invocations);
+}
+
+TEST_F(NativeHostFunctionTest, SampledCallsMeasureAllocations)
+{
+    EXPECT_EQ(native_host_set_stats_sample_rate(host_handle_, 1), NativeHostStatus::SUCCESS);
+    auto fn = getFunctionPointer<AllocateBytesDelegate>("AllocateBytes");
+    EXPECT_NE(fn, nullptr);
+
+    for (int i = 0; i < 10; i++)
+    {
+        native_call_scope_t scope;
+        native_host_call_enter(assembly_handle_, &scope);
+        EXPECT_EQ(fn(4096), 4096);
+        native_host_call_leave(&scope);
+    }
+
+    native_assembly_stats_t stats;
+    auto status = native_host_get_assembly_stats(host_handle_, assembly_handle_, &stats);
+    EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+    EXPECT_EQ(stats.invocations, 10u);
+    EXPECT_EQ(stats.sampled_invocations, 10u);
+    EXPECT_GE(stats.allocated_bytes, 10u * 4096u);
+    EXPECT_EQ(native_host_set_stats_sample_rate(host_handle_, 64), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostFunctionTest, GetAssemblyStatsFailsWithInvalidHandle)
+{
+    native_assembly_stats_t stats;
+    native_assembly_handle_t invalid_assembly = reinterpret_cast<native_assembly_handle_t>(0xDEADBEEF);
+    EXPECT_EQ(native_host_get_assembly_stats(host_handle_, invalid_assembly, &stats),
+              NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+    EXPECT_EQ(native_host_get_assembly_stats(host_handle_, assembly_handle_, nullptr),
+              NativeHostStatus::ERROR_INVALID_ARG);
+}
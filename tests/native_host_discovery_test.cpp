@@ -0,0 +1,573 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct TestMethod
+    {
+        std::string name;
+        std::vector<uint8_t> signature; // MethodDefSig blob
+        bool exported = false;          // carries [UnmanagedCallersOnly]
+        std::string entry_point;        // EntryPoint named argument, empty for none
+        bool call_convs = false;        // also set CallConvs = new[] { typeof(CallConvCdecl) } before EntryPoint
+        bool other_attribute = false;   // carries an unrelated attribute
+    };
+
+    struct TestType
+    {
+        std::string ns;
+        std::string name;
+        std::vector<TestMethod> methods;
+        int enclosing = -1; // index of the enclosing type in the list
+    };
+
+    void put16(std::vector<uint8_t> &out, uint32_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void put32(std::vector<uint8_t> &out, uint32_t value)
+    {
+        put16(out, value & 0xffff);
+        put16(out, value >> 16);
+    }
+
+    void put_ser_string(std::vector<uint8_t> &out, const std::string &value)
+    {
+        out.push_back(static_cast<uint8_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void pad4(std::vector<uint8_t> &out)
+    {
+        while (out.size() % 4)
+            out.push_back(0);
+    }
+
+    // Writes a minimal managed PE image: one section holding the CLI header and ECMA-335 metadata
+    // with an Assembly row, the given types and methods, and custom attribute rows whose
+    // constructors are MemberRefs to TypeRefs, the way the C# compiler emits them
+    std::vector<uint8_t> build_image(const std::string &assembly_name, const std::vector<TestType> &types)
+    {
+        std::vector<uint8_t> strings{0}, blobs{0};
+        auto add_string = [&](const std::string &value)
+        {
+            auto offset = static_cast<uint32_t>(strings.size());
+            strings.insert(strings.end(), value.begin(), value.end());
+            strings.push_back(0);
+            return offset;
+        };
+        auto add_blob = [&](const std::vector<uint8_t> &value)
+        {
+            auto offset = static_cast<uint32_t>(blobs.size());
+            blobs.push_back(static_cast<uint8_t>(value.size()));
+            blobs.insert(blobs.end(), value.begin(), value.end());
+            return offset;
+        };
+
+        std::vector<uint8_t> module, type_refs, type_defs, method_defs, member_refs, attributes, assembly, nested;
+
+        put16(module, 0);
+        put16(module, add_string(assembly_name + ".dll"));
+        put16(module, 1);
+        put16(module, 0);
+        put16(module, 0);
+
+        // TypeRef 1: UnmanagedCallersOnlyAttribute, 2: an unrelated attribute with the same shape
+        put16(type_refs, 0);
+        put16(type_refs, add_string("UnmanagedCallersOnlyAttribute"));
+        put16(type_refs, add_string("System.Runtime.InteropServices"));
+        put16(type_refs, 0);
+        put16(type_refs, add_string("ObsoleteAttribute"));
+        put16(type_refs, add_string("System"));
+
+        uint32_t ctor = add_string(".ctor");
+        uint32_t ctor_signature = add_blob({0x20, 0x00, 0x01});
+        for (uint32_t type_ref = 1; type_ref <= 2; ++type_ref)
+        {
+            put16(member_refs, (type_ref << 3) | 1); // MemberRefParent: TypeRef
+            put16(member_refs, ctor);
+            put16(member_refs, ctor_signature);
+        }
+
+        // TypeDef 1 is <Module>
+        auto add_type = [&](const std::string &ns, const std::string &name, uint32_t method_list)
+        {
+            put32(type_defs, 0);
+            put16(type_defs, add_string(name));
+            put16(type_defs, add_string(ns));
+            put16(type_defs, 0);
+            put16(type_defs, 1);
+            put16(type_defs, method_list);
+        };
+        add_type("", "<Module>", 1);
+
+        uint32_t method_row = 1;
+        for (size_t t = 0; t < types.size(); ++t)
+        {
+            add_type(types[t].ns, types[t].name, method_row);
+            for (const auto &method : types[t].methods)
+            {
+                put32(method_defs, 0);
+                put16(method_defs, 0);
+                put16(method_defs, 0x16); // public static
+                put16(method_defs, add_string(method.name));
+                put16(method_defs, add_blob(method.signature));
+                put16(method_defs, 1);
+
+                if (method.exported)
+                {
+                    std::vector<uint8_t> value{0x01, 0x00};
+                    put16(value, (method.call_convs ? 1 : 0) + (method.entry_point.empty() ? 0 : 1));
+                    if (method.call_convs)
+                    {
+                        value.insert(value.end(), {0x54, 0x1d, 0x50});
+                        put_ser_string(value, "CallConvs");
+                        put32(value, 1);
+                        put_ser_string(value, "System.Runtime.CompilerServices.CallConvCdecl, System.Runtime");
+                    }
+                    if (!method.entry_point.empty())
+                    {
+                        value.insert(value.end(), {0x54, 0x0e});
+                        put_ser_string(value, "EntryPoint");
+                        put_ser_string(value, method.entry_point);
+                    }
+                    put16(attributes, method_row << 5); // HasCustomAttribute: MethodDef
+                    put16(attributes, (1 << 3) | 3);    // CustomAttributeType: MemberRef
+                    put16(attributes, add_blob(value));
+                }
+                if (method.other_attribute)
+                {
+                    put16(attributes, method_row << 5);
+                    put16(attributes, (2 << 3) | 3);
+                    put16(attributes, add_blob({0x01, 0x00, 0x00, 0x00}));
+                }
+                method_row++;
+            }
+            if (types[t].enclosing >= 0)
+            {
+                put16(nested, static_cast<uint32_t>(t + 2));
+                put16(nested, static_cast<uint32_t>(types[t].enclosing + 2));
+            }
+        }
+
+        put32(assembly, 0x8004);
+        for (int i = 0; i < 4; ++i)
+            put16(assembly, 1);
+        put32(assembly, 0);
+        put16(assembly, 0);
+        put16(assembly, add_string(assembly_name));
+        put16(assembly, 0);
+
+        // #~ stream: every heap and table index is two bytes wide at this size
+        struct Table
+        {
+            uint32_t id;
+            const std::vector<uint8_t> *rows;
+            uint32_t row_size;
+        };
+        const Table tables[] = {
+            {0x00, &module, 10}, {0x01, &type_refs, 6}, {0x02, &type_defs, 14}, {0x06, &method_defs, 14},
+            {0x0a, &member_refs, 6}, {0x0c, &attributes, 6}, {0x20, &assembly, 22}, {0x29, &nested, 4},
+        };
+        std::vector<uint8_t> table_stream;
+        put32(table_stream, 0);
+        table_stream.insert(table_stream.end(), {2, 0, 0, 1});
+        uint64_t valid = 0;
+        for (const auto &table : tables)
+            valid |= 1ull << table.id;
+        put32(table_stream, static_cast<uint32_t>(valid));
+        put32(table_stream, static_cast<uint32_t>(valid >> 32));
+        put32(table_stream, 0);
+        put32(table_stream, 0);
+        for (const auto &table : tables)
+            put32(table_stream, static_cast<uint32_t>(table.rows->size() / table.row_size));
+        for (const auto &table : tables)
+            table_stream.insert(table_stream.end(), table.rows->begin(), table.rows->end());
+        pad4(table_stream);
+        pad4(strings);
+        pad4(blobs);
+        std::vector<uint8_t> guids(16, 0x42);
+
+        // Metadata root and stream headers
+        struct Stream
+        {
+            const char *name;
+            const std::vector<uint8_t> *data;
+        };
+        const Stream streams[] = {{"#~", &table_stream}, {"#Strings", &strings}, {"#GUID", &guids}, {"#Blob", &blobs}};
+        std::vector<uint8_t> metadata;
+        put32(metadata, 0x424a5342);
+        put16(metadata, 1);
+        put16(metadata, 1);
+        put32(metadata, 0);
+        put32(metadata, 12);
+        const char version[12] = "v4.0.30319";
+        metadata.insert(metadata.end(), version, version + sizeof(version));
+        put16(metadata, 0);
+        put16(metadata, 4);
+        uint32_t headers_size = 0;
+        for (const auto &stream : streams)
+            headers_size += 8 + ((static_cast<uint32_t>(std::strlen(stream.name)) + 4) & ~3u);
+        uint32_t offset = static_cast<uint32_t>(metadata.size()) + headers_size;
+        for (const auto &stream : streams)
+        {
+            put32(metadata, offset);
+            put32(metadata, static_cast<uint32_t>(stream.data->size()));
+            metadata.insert(metadata.end(), stream.name, stream.name + std::strlen(stream.name) + 1);
+            pad4(metadata);
+            offset += static_cast<uint32_t>(stream.data->size());
+        }
+        for (const auto &stream : streams)
+            metadata.insert(metadata.end(), stream.data->begin(), stream.data->end());
+
+        // PE32 image with a single section at RVA 0x2000, file offset 0x200
+        constexpr uint32_t SECTION_RVA = 0x2000, SECTION_OFFSET = 0x200, CLI_HEADER_SIZE = 72;
+        std::vector<uint8_t> section;
+        put32(section, CLI_HEADER_SIZE);
+        put16(section, 2);
+        put16(section, 5);
+        put32(section, SECTION_RVA + CLI_HEADER_SIZE);
+        put32(section, static_cast<uint32_t>(metadata.size()));
+        put32(section, 1); // ILONLY
+        section.resize(CLI_HEADER_SIZE);
+        section.insert(section.end(), metadata.begin(), metadata.end());
+        pad4(section);
+
+        std::vector<uint8_t> image(SECTION_OFFSET, 0);
+        image[0] = 'M';
+        image[1] = 'Z';
+        image[0x3c] = 0x80;
+        std::vector<uint8_t> headers;
+        put32(headers, 0x00004550);
+        put16(headers, 0x14c); // COFF header
+        put16(headers, 1);
+        put32(headers, 0);
+        put32(headers, 0);
+        put32(headers, 0);
+        put16(headers, 224);
+        put16(headers, 0x2102);
+        std::vector<uint8_t> optional(224, 0);
+        optional[0] = 0x0b;
+        optional[1] = 0x01;
+        optional[92] = 16; // NumberOfRvaAndSizes
+        uint32_t cli_directory = 96 + 14 * 8;
+        for (int i = 0; i < 4; ++i)
+        {
+            optional[cli_directory + i] = static_cast<uint8_t>(SECTION_RVA >> (8 * i));
+            optional[cli_directory + 4 + i] = static_cast<uint8_t>(CLI_HEADER_SIZE >> (8 * i));
+        }
+        headers.insert(headers.end(), optional.begin(), optional.end());
+        const char name[8] = ".text";
+        headers.insert(headers.end(), name, name + 8);
+        put32(headers, static_cast<uint32_t>(section.size()));
+        put32(headers, SECTION_RVA);
+        put32(headers, static_cast<uint32_t>(section.size()));
+        put32(headers, SECTION_OFFSET);
+        headers.resize(headers.size() + 16);
+        std::copy(headers.begin(), headers.end(), image.begin() + 0x80);
+        image.insert(image.end(), section.begin(), section.end());
+        return image;
+    }
+
+    // MethodDefSig for a static method: ret and params as ELEMENT_TYPE bytes
+    std::vector<uint8_t> signature(std::vector<uint8_t> types)
+    {
+        std::vector<uint8_t> blob(types.size() + 2, 0);
+        blob[1] = static_cast<uint8_t>(types.size() - 1);
+        std::copy(types.begin(), types.end(), blob.begin() + 2);
+        return blob;
+    }
+
+    std::vector<TestType> plugin_types()
+    {
+        TestType math{"Acme.Plugins", "Math", {}};
+        math.methods.push_back({"Add", signature({0x08, 0x08, 0x08}), true, "acme_add"});
+        math.methods.push_back({"Scale", signature({0x0d, 0x0d, 0x0a}), true, "", true});
+        math.methods.push_back({"Helper", signature({0x08, 0x08}), false, "", false, true});
+
+        // void Register(delegate* unmanaged<int, void>, Point, float*) with Point a value type
+        TestType callbacks{"", "Callbacks", {}, 0};
+        callbacks.methods.push_back({"Register",
+                                     {0x00, 0x03, 0x01, 0x1b, 0x00, 0x01, 0x01, 0x08, 0x11, 0x09, 0x0f, 0x0c},
+                                     true, "acme_register", true});
+        return {math, callbacks};
+    }
+
+    void write_file(const std::filesystem::path &path, const std::vector<uint8_t> &data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+class NativeHostDiscoveryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("native_host_discovery_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_ / "plugins");
+        plugins_ = (directory_ / "plugins").u8string();
+        index_ = (directory_ / "plugins.index").u8string();
+
+        write_file(directory_ / "plugins" / "Acme.Plugins.dll", build_image("Acme.Plugins", plugin_types()));
+        write_file(directory_ / "plugins" / "native.dll", {0x7f, 'E', 'L', 'F', 2, 1, 1, 0});
+        write_file(directory_ / "plugins" / "readme.txt", {'h', 'i'});
+
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+        std::filesystem::remove_all(directory_);
+    }
+
+    native_plugin_catalog_info_t discover(bool with_index, bool recursive = false)
+    {
+        native_discovery_options_t options{};
+        options.directory = plugins_.c_str();
+        options.index_path = with_index ? index_.c_str() : nullptr;
+        options.recursive = recursive ? 1 : 0;
+
+        native_plugin_catalog_info_t info{};
+        native_catalog_handle_t catalog = nullptr;
+        EXPECT_EQ(native_host_discover_plugins(host_handle_, &options, &catalog), NativeHostStatus::SUCCESS);
+        if (catalog)
+        {
+            EXPECT_EQ(native_host_get_catalog_info(host_handle_, catalog, &info), NativeHostStatus::SUCCESS);
+            catalogs_.push_back(catalog);
+        }
+        return info;
+    }
+
+    static const native_plugin_export_t *find(const native_plugin_catalog_info_t &info, const char *method_name)
+    {
+        for (uint32_t i = 0; i < info.export_count; ++i)
+        {
+            if (std::strcmp(info.exports[i].method_name, method_name) == 0)
+                return &info.exports[i];
+        }
+        return nullptr;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    std::vector<native_catalog_handle_t> catalogs_;
+    std::filesystem::path directory_;
+    std::string plugins_;
+    std::string index_;
+};
+
+TEST_F(NativeHostDiscoveryTest, ListsExportsFromMetadata)
+{
+    auto info = discover(false);
+    EXPECT_EQ(info.assembly_count, 1u);
+    EXPECT_EQ(info.scanned_count, 2u) << "Both .dll files are read, the .txt file is not";
+    EXPECT_EQ(info.cached_count, 0u);
+    ASSERT_EQ(info.export_count, 3u);
+
+    const auto &add = info.exports[0];
+    EXPECT_STREQ(add.type_name, "Acme.Plugins.Math,Acme.Plugins");
+    EXPECT_STREQ(add.method_name, "Add");
+    EXPECT_STREQ(add.entry_point, "acme_add");
+    EXPECT_STREQ(add.signature, "iii");
+    EXPECT_EQ(std::filesystem::path(add.assembly_path).filename(), "Acme.Plugins.dll");
+
+    const auto &scale = info.exports[1];
+    EXPECT_STREQ(scale.method_name, "Scale");
+    EXPECT_EQ(scale.entry_point, nullptr) << "CallConvs alone does not name an entry point";
+    EXPECT_STREQ(scale.signature, "ddl");
+
+    const auto &register_ = info.exports[2];
+    EXPECT_STREQ(register_.type_name, "Acme.Plugins.Math+Callbacks,Acme.Plugins");
+    EXPECT_STREQ(register_.entry_point, "acme_register");
+    EXPECT_STREQ(register_.signature, "vpxp");
+
+    EXPECT_EQ(find(info, "Helper"), nullptr) << "Other attributes do not make a method an export";
+}
+
+TEST_F(NativeHostDiscoveryTest, IndexSkipsUnchangedFiles)
+{
+    auto cold = discover(true);
+    EXPECT_EQ(cold.scanned_count, 2u);
+    EXPECT_EQ(cold.cached_count, 0u);
+    ASSERT_TRUE(std::filesystem::exists(index_));
+
+    auto warm = discover(true);
+    EXPECT_EQ(warm.scanned_count, 0u);
+    EXPECT_EQ(warm.cached_count, 2u);
+    EXPECT_EQ(warm.assembly_count, 1u);
+    ASSERT_EQ(warm.export_count, cold.export_count);
+    for (uint32_t i = 0; i < warm.export_count; ++i)
+    {
+        EXPECT_STREQ(warm.exports[i].type_name, cold.exports[i].type_name);
+        EXPECT_STREQ(warm.exports[i].method_name, cold.exports[i].method_name);
+        EXPECT_STREQ(warm.exports[i].signature, cold.exports[i].signature);
+        EXPECT_EQ(warm.exports[i].entry_point == nullptr, cold.exports[i].entry_point == nullptr);
+    }
+
+    // A changed plugin is read again; the others still come from the index
+    auto types = plugin_types();
+    types[0].methods.push_back({"Negate", signature({0x0a, 0x0a}), true, "acme_negate"});
+    write_file(directory_ / "plugins" / "Acme.Plugins.dll", build_image("Acme.Plugins", types));
+    auto changed = discover(true);
+    EXPECT_EQ(changed.scanned_count, 1u);
+    EXPECT_EQ(changed.cached_count, 1u);
+    ASSERT_NE(find(changed, "Negate"), nullptr);
+    EXPECT_STREQ(find(changed, "Negate")->signature, "ll");
+
+    // A deleted file drops out of the result and the index
+    std::filesystem::remove(directory_ / "plugins" / "native.dll");
+    auto removed = discover(true);
+    EXPECT_EQ(removed.scanned_count, 0u);
+    EXPECT_EQ(removed.cached_count, 1u);
+    EXPECT_EQ(removed.export_count, 4u);
+}
+
+TEST_F(NativeHostDiscoveryTest, CorruptIndexIsRebuilt)
+{
+    write_file(index_, {'N', 'H', 'P', 'L', 'G', 'I', 'D', 'X', 1, 0, 0, 0, 9, 0, 0, 0});
+
+    auto rebuilt = discover(true);
+    EXPECT_EQ(rebuilt.scanned_count, 2u);
+    EXPECT_EQ(rebuilt.export_count, 3u);
+
+    auto warm = discover(true);
+    EXPECT_EQ(warm.scanned_count, 0u);
+    EXPECT_EQ(warm.cached_count, 2u);
+}
+
+TEST_F(NativeHostDiscoveryTest, ConcurrentDiscoveriesShareIndex)
+{
+    // Every thread starts without an index and rewrites it; each writes its own temporary file
+    native_discovery_options_t options{};
+    options.directory = plugins_.c_str();
+    options.index_path = index_.c_str();
+    std::vector<NativeHostStatus> statuses(4, NativeHostStatus::ERROR_INVALID_ARG);
+    std::vector<native_catalog_handle_t> catalogs(statuses.size(), nullptr);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < statuses.size(); ++i)
+    {
+        threads.emplace_back([&, i]
+                             { statuses[i] = native_host_discover_plugins(host_handle_, &options, &catalogs[i]); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t i = 0; i < statuses.size(); ++i)
+    {
+        ASSERT_EQ(statuses[i], NativeHostStatus::SUCCESS);
+        catalogs_.push_back(catalogs[i]);
+        native_plugin_catalog_info_t info{};
+        ASSERT_EQ(native_host_get_catalog_info(host_handle_, catalogs[i], &info), NativeHostStatus::SUCCESS);
+        EXPECT_EQ(info.export_count, 3u);
+    }
+
+    auto warm = discover(true);
+    EXPECT_EQ(warm.scanned_count, 0u) << "The index left by the last writer is complete";
+    EXPECT_EQ(warm.cached_count, 2u);
+    for (const auto &entry : std::filesystem::directory_iterator(directory_))
+    {
+        EXPECT_NE(entry.path().extension(), ".tmp") << "Leftover temporary index: " << entry.path();
+    }
+}
+
+TEST_F(NativeHostDiscoveryTest, TruncatedImageHasNoExports)
+{
+    auto image = build_image("Broken", plugin_types());
+    image.resize(image.size() / 2);
+    write_file(directory_ / "plugins" / "Broken.dll", image);
+
+    auto info = discover(false);
+    EXPECT_EQ(info.assembly_count, 1u);
+    EXPECT_EQ(info.scanned_count, 3u);
+    EXPECT_EQ(info.export_count, 3u);
+}
+
+TEST_F(NativeHostDiscoveryTest, RecursiveScan)
+{
+    std::filesystem::create_directories(directory_ / "plugins" / "nested");
+    write_file(directory_ / "plugins" / "nested" / "Nested.dll", build_image("Nested", plugin_types()));
+
+    EXPECT_EQ(discover(false).assembly_count, 1u);
+    auto info = discover(false, true);
+    EXPECT_EQ(info.assembly_count, 2u);
+    EXPECT_EQ(info.export_count, 6u);
+}
+
+TEST_F(NativeHostDiscoveryTest, InvalidArguments)
+{
+    native_discovery_options_t options{};
+    native_catalog_handle_t catalog = nullptr;
+    EXPECT_EQ(native_host_discover_plugins(host_handle_, &options, &catalog), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_discover_plugins(host_handle_, nullptr, &catalog), NativeHostStatus::ERROR_INVALID_ARG);
+
+    auto missing = (directory_ / "missing").u8string();
+    options.directory = missing.c_str();
+    EXPECT_EQ(native_host_discover_plugins(host_handle_, &options, &catalog), NativeHostStatus::ERROR_ASSEMBLY_LOAD);
+
+    native_plugin_catalog_info_t info{};
+    int not_a_catalog = 0;
+    EXPECT_EQ(native_host_get_catalog_info(host_handle_, &not_a_catalog, &info), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+    EXPECT_EQ(native_host_close_catalog(host_handle_, &not_a_catalog), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+
+    discover(false);
+    ASSERT_EQ(catalogs_.size(), 1u);
+    EXPECT_EQ(native_host_close_catalog(host_handle_, catalogs_[0]), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_close_catalog(host_handle_, catalogs_[0]), NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+}
+
+TEST_F(NativeHostDiscoveryTest, DiscoveredExportsResolve)
+{
+    auto assembly_path = test_utils::get_test_assembly_path("TestLibrary.dll");
+    std::error_code ec;
+    if (std::filesystem::file_size(assembly_path, ec) == 0)
+    {
+        GTEST_SKIP() << "Needs the compiled test library";
+    }
+
+    plugins_ = test_utils::get_test_data_path();
+    auto info = discover(false);
+    const native_plugin_export_t *add_numbers = nullptr;
+    for (uint32_t i = 0; i < info.export_count; ++i)
+    {
+        if (std::strcmp(info.exports[i].type_name, "TestLibrary.TestClass,TestLibrary") == 0 &&
+            std::strcmp(info.exports[i].method_name, "AddNumbers") == 0)
+        {
+            add_numbers = &info.exports[i];
+        }
+    }
+    ASSERT_NE(add_numbers, nullptr);
+    EXPECT_STREQ(add_numbers->entry_point, "AddNumbers");
+    EXPECT_STREQ(add_numbers->signature, "iii");
+
+    ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+    native_assembly_handle_t assembly = nullptr;
+    ASSERT_EQ(native_host_load_assembly(host_handle_, add_numbers->assembly_path, &assembly), NativeHostStatus::SUCCESS);
+    native_method_handle_t method = nullptr;
+    ASSERT_EQ(native_host_get_method(host_handle_, assembly, add_numbers->type_name, add_numbers->method_name,
+                                     add_numbers->signature, &method),
+              NativeHostStatus::SUCCESS);
+    native_value_t args[2];
+    args[0].i32 = 2;
+    args[1].i32 = 3;
+    native_value_t result{};
+    ASSERT_EQ(native_host_invoke(method, args, &result), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(result.i32, 5);
+}
@@ -0,0 +1,104 @@
+// Isolation benchmark: per-call latency of the same plugin method called directly through a
+// delegate, through native_host_invoke in process, and through native_host_invoke in an
+// isolated worker process. The isolated transport spins before sleeping, so the worker needs
+// a core of its own to reach its best latency.
+
+#include "native_host.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+
+template <typename Call>
+static bool measure(const char *mode, int iterations, Call call)
+{
+    // Warm up JIT tiers and the worker's spin loop before measuring
+    for (int i = 0; i < iterations / 10; ++i)
+    {
+        if (!call(i))
+            return false;
+    }
+
+    std::vector<double> samples(iterations);
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!call(i))
+            return false;
+        samples[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double total = 0;
+    for (double sample : samples)
+        total += sample;
+    std::sort(samples.begin(), samples.end());
+
+    printf("mode=%s calls=%d mean_ns=%.0f p50_ns=%.0f p99_ns=%.0f\n",
+           mode,
+           iterations,
+           total / iterations,
+           samples[iterations / 2],
+           samples[static_cast<size_t>(iterations * 0.99)]);
+    return true;
+}
+
+static bool invoke_add(native_method_handle_t method, int i)
+{
+    native_value_t args[2];
+    args[0].i32 = i;
+    args[1].i32 = 1;
+    native_value_t result{};
+    return native_host_invoke(method, args, &result) == NativeHostStatus::SUCCESS && result.i32 == i + 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int iterations = argc > 3 ? atoi(argv[3]) : 200000;
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t local = nullptr;
+    void *fn_ptr = nullptr;
+    native_method_handle_t local_method = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &local) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, local, type_name, "AddNumbers", &fn_ptr) != NativeHostStatus::SUCCESS ||
+        native_host_get_method(host, local, type_name, "AddNumbers", "iii", &local_method) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(fn_ptr);
+    if (!measure("direct", iterations, [&](int i) { return add_numbers(i, 1) == i + 1; }) ||
+        !measure("invoke", iterations, [&](int i) { return invoke_add(local_method, i); }))
+        return 1;
+
+    native_assembly_handle_t isolated = nullptr;
+    native_method_handle_t isolated_method = nullptr;
+    if (native_host_set_isolation(host, NATIVE_ISOLATION_PROCESS) != NativeHostStatus::SUCCESS)
+    {
+        printf("mode=isolated unsupported\n");
+        native_host_destroy(host);
+        return 0;
+    }
+    if (native_host_load_assembly(host, assembly_path, &isolated) != NativeHostStatus::SUCCESS ||
+        native_host_get_method(host, isolated, type_name, "AddNumbers", "iii", &isolated_method) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    if (!measure("isolated", iterations, [&](int i) { return invoke_add(isolated_method, i); }))
+        return 1;
+
+    native_host_destroy(host);
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+class NativeHostIsolationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        status_ = native_host_create(&host_handle_);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        EXPECT_NE(host_handle_, nullptr);
+
+        if (native_host_set_isolation(host_handle_, NATIVE_ISOLATION_PROCESS) == NativeHostStatus::ERROR_NOT_SUPPORTED)
+        {
+            GTEST_SKIP() << "Process isolation is not supported on this platform";
+        }
+        status_ = native_host_set_isolation(host_handle_, NATIVE_ISOLATION_NONE);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            status_ = native_host_destroy(host_handle_);
+            EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        }
+    }
+
+    void loadIsolated()
+    {
+        status_ = native_host_set_isolation(host_handle_, NATIVE_ISOLATION_PROCESS);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        status_ = native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+    }
+
+    native_method_handle_t getMethod(const char *method_name, const char *signature)
+    {
+        native_method_handle_t method = nullptr;
+        auto status = native_host_get_method(
+            host_handle_,
+            assembly_handle_,
+            type_name_.c_str(),
+            method_name,
+            signature,
+            &method);
+        EXPECT_EQ(status, NativeHostStatus::SUCCESS);
+        EXPECT_NE(method, nullptr);
+        return method;
+    }
+
+    int32_t addNumbers(native_method_handle_t method, int32_t a, int32_t b)
+    {
+        native_value_t args[2];
+        args[0].i32 = a;
+        args[1].i32 = b;
+        native_value_t result{};
+        EXPECT_EQ(native_host_invoke(method, args, &result), NativeHostStatus::SUCCESS);
+        return result.i32;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    NativeHostStatus status_ = NativeHostStatus::SUCCESS;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostIsolationTest, InvokeInProcessMethod)
+{
+    status_ = native_host_initialize(host_handle_);
+    ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+    status_ = native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_);
+    ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+
+    auto method = getMethod("AddNumbers", "iii");
+    EXPECT_EQ(addNumbers(method, 6, 7), 13);
+}
+
+TEST_F(NativeHostIsolationTest, InvokeIsolatedMethod)
+{
+    loadIsolated();
+
+    auto method = getMethod("AddNumbers", "iii");
+    EXPECT_EQ(addNumbers(method, 6, 7), 13);
+    EXPECT_EQ(addNumbers(method, -1, 1), 0);
+
+    native_value_t result{};
+    auto return_constant = getMethod("ReturnConstant", "i");
+    EXPECT_EQ(native_host_invoke(return_constant, nullptr, &result), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(result.i32, 42);
+}
+
+TEST_F(NativeHostIsolationTest, GetDelegateFailsForIsolatedAssembly)
+{
+    loadIsolated();
+
+    void *fn_ptr = nullptr;
+    status_ = native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr);
+    EXPECT_EQ(status_, NativeHostStatus::ERROR_NOT_SUPPORTED);
+    EXPECT_EQ(fn_ptr, nullptr);
+}
+
+TEST_F(NativeHostIsolationTest, GetMethodFailsWithInvalidSignature)
+{
+    loadIsolated();
+
+    native_method_handle_t method = nullptr;
+    for (const char *signature : {"", "x", "iv", "iiiiii"})
+    {
+        status_ = native_host_get_method(
+            host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", signature, &method);
+        EXPECT_EQ(status_, NativeHostStatus::ERROR_INVALID_ARG) << signature;
+    }
+}
+
+TEST_F(NativeHostIsolationTest, CrashedWorkerIsRestarted)
+{
+    loadIsolated();
+
+    auto add_numbers = getMethod("AddNumbers", "iii");
+    auto throw_exception = getMethod("ThrowException", "i");
+
+    // An exception escaping an UnmanagedCallersOnly frame terminates the worker, not this process
+    native_value_t result{};
+    EXPECT_EQ(native_host_invoke(throw_exception, nullptr, &result), NativeHostStatus::ERROR_PLUGIN_CRASHED);
+
+    // Assemblies and methods are replayed into the restarted worker
+    EXPECT_EQ(addNumbers(add_numbers, 20, 22), 42);
+}
+
+TEST_F(NativeHostIsolationTest, WorkerOutlivesSpawningThread)
+{
+    // The worker is started on a thread that exits before the first invoke; it must stay alive
+    // until the host process exits rather than the thread that spawned it
+    native_method_handle_t add_numbers = nullptr;
+    std::thread([&]
+                {
+        loadIsolated();
+        add_numbers = getMethod("AddNumbers", "iii"); })
+        .join();
+    ASSERT_NE(add_numbers, nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    native_value_t args[2];
+    args[0].i32 = 1;
+    args[1].i32 = 2;
+    native_value_t result{};
+    EXPECT_EQ(native_host_invoke(add_numbers, args, &result), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(result.i32, 3);
+}
+
+#ifdef __linux__
+TEST_F(NativeHostIsolationTest, WorkerDescriptorsAreNotInherited)
+{
+    // The shared call region and the parent watch pipe reach the worker through spawn file
+    // actions only; other children the application starts must not inherit them
+    loadIsolated();
+    auto add_numbers = getMethod("AddNumbers", "iii");
+    ASSERT_EQ(addNumbers(add_numbers, 1, 2), 3);
+
+    int checked = 0;
+    for (const auto &entry : std::filesystem::directory_iterator("/proc/self/fd"))
+    {
+        int fd = std::stoi(entry.path().filename().string());
+        std::error_code ec;
+        auto target = std::filesystem::read_symlink(entry.path(), ec).string();
+        if (fd <= 2 || ec || (target.rfind("memfd:native_host_isolation", 0) != 0 && target.rfind("pipe:", 0) != 0))
+        {
+            continue;
+        }
+        int flags = fcntl(fd, F_GETFD);
+        if (flags < 0)
+        {
+            continue; // the directory iterator's own descriptor
+        }
+        EXPECT_NE(flags & FD_CLOEXEC, 0) << "fd " << fd << " (" << target << ") is inherited by child processes";
+        checked++;
+    }
+    EXPECT_GT(checked, 0) << "The worker's descriptors should still be open in the host";
+}
+#endif
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+using WeightedSumDelegate = double (*)(double, int32_t, double, int32_t, double, int32_t, double, int32_t, double,
+                                       int32_t, double, int32_t, double, int32_t, double, int32_t, double, int32_t);
+
+class NativeHostLazyBindingTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+                  NativeHostStatus::SUCCESS);
+
+        options_.on_failure = on_failure;
+        options_.user_data = &failures_;
+        if (native_host_set_lazy_binding(host_handle_, &options_) == NativeHostStatus::ERROR_NOT_SUPPORTED)
+        {
+            GTEST_SKIP() << "Lazy binding stubs are not supported on this platform";
+        }
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+    }
+
+    void *get_delegate(const char *method_name)
+    {
+        void *fn_ptr = nullptr;
+        EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), method_name, &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+        return fn_ptr;
+    }
+
+    struct Failures
+    {
+        std::atomic<int> calls{0};
+        NativeHostStatus last_status = NativeHostStatus::SUCCESS;
+        std::string last_method;
+        void *replacement = nullptr;
+    };
+
+    static void *on_failure(void *user_data, native_assembly_handle_t, const char *, const char *method_name,
+                            NativeHostStatus status)
+    {
+        auto *failures = static_cast<Failures *>(user_data);
+        failures->calls++;
+        failures->last_status = status;
+        failures->last_method = method_name;
+        return failures->replacement;
+    }
+
+    static int32_t subtract_numbers(int32_t a, int32_t b) { return a - b; }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    native_lazy_binding_options_t options_{};
+    Failures failures_;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostLazyBindingTest, StubResolvesOnFirstCall)
+{
+    auto add = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+    ASSERT_NE(add, nullptr);
+    EXPECT_EQ(add(2, 3), 5);
+    EXPECT_EQ(add(-7, 10), 3) << "Later calls go straight through the patched slot";
+    EXPECT_EQ(failures_.calls.load(), 0);
+}
+
+TEST_F(NativeHostLazyBindingTest, PreservesRegisterAndStackArguments)
+{
+    auto sum = reinterpret_cast<WeightedSumDelegate>(get_delegate("WeightedSum"));
+    ASSERT_NE(sum, nullptr);
+    // Nine doubles and nine ints: the last double and three ints are passed on the stack
+    EXPECT_DOUBLE_EQ(sum(1.0, 1, 2.0, 2, 3.0, 3, 4.0, 4, 5.0, 5, 6.0, 6, 7.0, 7, 8.0, 8, 9.5, 9), 289.5);
+}
+
+TEST_F(NativeHostLazyBindingTest, SameEntryPointReturnsSameStub)
+{
+    void *first = get_delegate("AddNumbers");
+    void *second = get_delegate("AddNumbers");
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, get_delegate("WeightedSum"));
+}
+
+TEST_F(NativeHostLazyBindingTest, ConcurrentFirstCalls)
+{
+    auto add = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+    ASSERT_NE(add, nullptr);
+
+    constexpr int NUM_THREADS = 8;
+    std::atomic<int> correct{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        threads.emplace_back([&, i]()
+                             {
+            if (add(i, 100) == i + 100)
+            {
+                correct++;
+            } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(correct.load(), NUM_THREADS);
+}
+
+TEST_F(NativeHostLazyBindingTest, FailureReachesHandlerAndRetries)
+{
+    auto missing = reinterpret_cast<AddNumbersDelegate>(get_delegate("NoSuchMethod"));
+    ASSERT_NE(missing, nullptr) << "The stub is returned before the method is looked up";
+
+    EXPECT_EQ(missing(2, 3), 0);
+    EXPECT_EQ(failures_.calls.load(), 1);
+    EXPECT_EQ(failures_.last_status, NativeHostStatus::ERROR_METHOD_LOAD);
+    EXPECT_EQ(failures_.last_method, "NoSuchMethod");
+
+    EXPECT_EQ(missing(2, 3), 0);
+    EXPECT_EQ(failures_.calls.load(), 2) << "Without a replacement the next call resolves again";
+}
+
+TEST_F(NativeHostLazyBindingTest, ReplacementIsInstalled)
+{
+    failures_.replacement = reinterpret_cast<void *>(&subtract_numbers);
+    auto missing = reinterpret_cast<AddNumbersDelegate>(get_delegate("NoSuchMethod"));
+    ASSERT_NE(missing, nullptr);
+
+    EXPECT_EQ(missing(10, 4), 6);
+    EXPECT_EQ(missing(10, 4), 6);
+    EXPECT_EQ(failures_.calls.load(), 1);
+}
+
+TEST_F(NativeHostLazyBindingTest, UnloadedAssemblyIsReported)
+{
+    auto add = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+    ASSERT_NE(add, nullptr);
+    ASSERT_EQ(native_host_unload_assembly(host_handle_, assembly_handle_), NativeHostStatus::SUCCESS);
+
+    EXPECT_EQ(add(2, 3), 0);
+    EXPECT_EQ(failures_.calls.load(), 1);
+    EXPECT_EQ(failures_.last_status, NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+}
+
+TEST_F(NativeHostLazyBindingTest, DisablingReturnsDirectEntryPoints)
+{
+    void *stub = get_delegate("AddNumbers");
+    ASSERT_EQ(native_host_set_lazy_binding(host_handle_, nullptr), NativeHostStatus::SUCCESS);
+
+    void *direct = get_delegate("AddNumbers");
+    EXPECT_NE(direct, stub);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(direct)(2, 3), 5);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(stub)(2, 3), 5) << "Stubs stay valid after lazy binding is disabled";
+
+    void *missing = nullptr;
+    EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "NoSuchMethod", &missing),
+              NativeHostStatus::ERROR_METHOD_LOAD);
+}
+
+TEST_F(NativeHostLazyBindingTest, InvalidArguments)
+{
+    EXPECT_EQ(native_host_set_lazy_binding(nullptr, &options_), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_set_lazy_binding(reinterpret_cast<native_host_handle_t>(0x1), &options_),
+              NativeHostStatus::ERROR_HOST_NOT_FOUND);
+}
@@ -0,0 +1,109 @@
+// Linkage benchmark: the host's per-call entry points through libnative_host and through
+// native_host_static. Built twice from this file; the static build links with LTO, so the accessor
+// and the scope calls can be inlined instead of going through the PLT. Compare the two runs line
+// by line: the plugin call itself is the same in both.
+
+#include "native_host.h"
+#include "native_host_call.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef NATIVE_HOST_STATIC
+static const char *const linkage = "static";
+#else
+static const char *const linkage = "shared";
+#endif
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+
+template <typename Call>
+static bool measure(const char *mode, int iterations, Call call)
+{
+    // Warm up so the first measured mode does not pay for page faults and branch training
+    for (int i = 0; i < iterations / 10; ++i)
+    {
+        if (!call(i))
+            return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        if (!call(i))
+            return false;
+    }
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("linkage=%s mode=%s calls=%d ns_per_call=%.2f\n", linkage, mode, iterations, elapsed_ns / iterations);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int iterations = argc > 3 ? atoi(argv[3]) : 10000000;
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    native_method_handle_t method = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_method(host, assembly, type_name, "AddNumbers", "iii", &method) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    // Only the call path is of interest, not the sampled CPU time and allocation accounting
+    native_host_set_stats_sample_rate(host, 0);
+
+    auto accessor = [&](int i)
+    {
+        auto add_numbers = native_host::method_pointer<AddNumbersDelegate>(method);
+        return add_numbers(i, 1) == i + 1;
+    };
+    auto scoped = [&](int i)
+    {
+        native_host::call_scope scope(assembly);
+        if (!scope)
+            return false;
+        return native_host::method_pointer<AddNumbersDelegate>(method)(i, 1) == i + 1;
+    };
+    auto invoke = [&](int i)
+    {
+        native_value_t args[2];
+        args[0].i32 = i;
+        args[1].i32 = 1;
+        native_value_t result{};
+        return native_host_invoke(method, args, &result) == NativeHostStatus::SUCCESS && result.i32 == i + 1;
+    };
+    auto arena = [&](int i)
+    {
+        // One small result per call, reset once per batch as a request loop would
+        auto *value = static_cast<int32_t *>(native_host_arena_alloc(sizeof(int32_t), alignof(int32_t)));
+        if (!value)
+            return false;
+        *value = i;
+        if ((i & 63) == 63)
+            native_host_arena_reset();
+        return true;
+    };
+
+    if (!measure("method_pointer", iterations, accessor) ||
+        !measure("scoped", iterations, scoped) ||
+        !measure("invoke", iterations, invoke) ||
+        !measure("arena_alloc", iterations, arena))
+        return 1;
+
+    native_host_arena_reset();
+    native_host_destroy(host);
+    return 0;
+}
@@ -0,0 +1,576 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "mock_hostfxr.h"
+#include <chrono>
+#include <csetjmp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <execinfo.h>
+#endif
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+using CompletionCallback = void (*)(void *, int32_t, const native_value_t *);
+using AddNumbersAsyncDelegate = void (*)(int32_t, int32_t, CompletionCallback, void *);
+
+// Runs only in the NATIVE_HOST_MOCK_HOSTFXR build, where native_host loads the mock hostfxr
+class NativeHostMockTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        mock_hostfxr_configure(nullptr);
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+    }
+
+    void load_assembly()
+    {
+        ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+                  NativeHostStatus::SUCCESS);
+    }
+
+    // Turns on sampling of every call; false where profiling trampolines are not available
+    bool enable_profiling()
+    {
+        return native_host_set_profiling(host_handle_, 1) == NativeHostStatus::SUCCESS;
+    }
+
+    void *get_delegate(const char *method_name)
+    {
+        void *fn_ptr = nullptr;
+        EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), method_name, &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+        return fn_ptr;
+    }
+
+    uint64_t sampled_calls(const char *method_name)
+    {
+        uint32_t count = 0;
+        EXPECT_EQ(native_host_get_latency_profiles(host_handle_, nullptr, 0, &count), NativeHostStatus::SUCCESS);
+        std::vector<native_latency_profile_t> profiles(count);
+        EXPECT_EQ(native_host_get_latency_profiles(host_handle_, profiles.data(), count, &count), NativeHostStatus::SUCCESS);
+        for (const auto &profile : profiles)
+        {
+            if (std::strcmp(profile.method_name, method_name) == 0)
+            {
+                return profile.stats.count;
+            }
+        }
+        return 0;
+    }
+
+    static mock_hostfxr_counters_t counters()
+    {
+        mock_hostfxr_counters_t result{};
+        mock_hostfxr_get_counters(&result);
+        return result;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostMockTest, DelegatesResolveToNativeStubs)
+{
+    load_assembly();
+    EXPECT_EQ(counters().open_contexts, 0u) << "The host context should be closed after initialization";
+
+    auto before = counters().load_calls;
+    void *fn_ptr = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+    ASSERT_NE(fn_ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(fn_ptr)(2, 3), 5);
+    EXPECT_EQ(counters().load_calls, before + 1);
+}
+
+TEST_F(NativeHostMockTest, MethodPointerOfNullHandleIsNull)
+{
+    EXPECT_EQ(native_host_method_pointer(nullptr), nullptr);
+
+    load_assembly();
+    native_method_handle_t method = nullptr;
+    ASSERT_EQ(native_host_get_method(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", "iii", &method),
+              NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(native_host_method_pointer(method));
+    ASSERT_NE(add_numbers, nullptr);
+    EXPECT_EQ(add_numbers(2, 3), 5);
+}
+
+TEST_F(NativeHostMockTest, LazyBindingDefersLoadToFirstCall)
+{
+    load_assembly();
+    native_lazy_binding_options_t options{};
+    if (native_host_set_lazy_binding(host_handle_, &options) == NativeHostStatus::ERROR_NOT_SUPPORTED)
+    {
+        GTEST_SKIP() << "Lazy binding stubs are not supported on this platform";
+    }
+
+    auto before = counters().load_calls;
+    void *fn_ptr = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+    EXPECT_EQ(counters().load_calls, before) << "Getting the stub must not ask hostfxr for the entry point";
+
+    auto add = reinterpret_cast<AddNumbersDelegate>(fn_ptr);
+    EXPECT_EQ(add(2, 3), 5);
+    EXPECT_EQ(add(4, 5), 9);
+    EXPECT_EQ(counters().load_calls, before + 1);
+}
+
+TEST_F(NativeHostMockTest, PluginObjectsAreReleasedOnceAndWithTheHost)
+{
+    load_assembly();
+    auto live = counters().live_objects;
+
+    native_object_handle_t objects[3] = {};
+    for (auto &object : objects)
+    {
+        ASSERT_EQ(native_host_create_object(host_handle_, assembly_handle_, "TestLibrary.Counter,TestLibrary", &object),
+                  NativeHostStatus::SUCCESS);
+    }
+    EXPECT_EQ(counters().live_objects, live + 3);
+
+    ASSERT_EQ(native_host_release_objects(host_handle_, objects, 2), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(counters().live_objects, live + 1);
+    EXPECT_EQ(native_host_release_objects(host_handle_, objects, 2), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(counters().live_objects, live + 1);
+
+    ASSERT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+    host_handle_ = nullptr;
+    EXPECT_EQ(counters().live_objects, live);
+}
+
+TEST_F(NativeHostMockTest, UnknownMethodMapsToMethodLoad)
+{
+    load_assembly();
+
+    void *fn_ptr = nullptr;
+    EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "NoSuchMethod", &fn_ptr),
+              NativeHostStatus::ERROR_METHOD_LOAD);
+}
+
+TEST_F(NativeHostMockTest, InjectedLoadFailureIsMapped)
+{
+    load_assembly();
+
+    mock_hostfxr_config_t config{};
+    config.load_result = -2146233054; // COR_E_TYPELOAD
+    mock_hostfxr_configure(&config);
+
+    void *fn_ptr = nullptr;
+    EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::ERROR_TYPE_LOAD);
+
+    mock_hostfxr_configure(nullptr);
+    EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostMockTest, InjectedLoadLatencyReachesCallers)
+{
+    load_assembly();
+
+    mock_hostfxr_config_t config{};
+    config.load_delay_us = 20000;
+    mock_hostfxr_configure(&config);
+
+    void *fn_ptr = nullptr;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(NativeHostMockTest, TimelineRecordsHostLockWait)
+{
+    load_assembly();
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+
+    mock_hostfxr_config_t config{};
+    config.load_delay_us = 50000;
+    mock_hostfxr_configure(&config);
+
+    // Both resolutions hold the host lock for the injected latency, so one of them waits
+    void *first = nullptr;
+    std::thread other([&]()
+                      { native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &first); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    void *second = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &second),
+              NativeHostStatus::SUCCESS);
+    other.join();
+    native_host_timeline_stop();
+
+    auto path = std::filesystem::temp_directory_path() / "native_host_mock_timeline.json";
+    ASSERT_EQ(native_host_timeline_write(path.string().c_str()), NativeHostStatus::SUCCESS);
+    std::ifstream file(path, std::ios::binary);
+    std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(path);
+
+    EXPECT_NE(trace.find("\"name\":\"host_lock_wait\""), std::string::npos);
+    EXPECT_NE(trace.find("\"caller\":\"native_host_get_delegate\""), std::string::npos);
+}
+
+TEST_F(NativeHostMockTest, InitializeFailureCanBeRetried)
+{
+    mock_hostfxr_config_t config{};
+    config.initialize_result = static_cast<int32_t>(0x80008096); // FrameworkMissingFailure
+    mock_hostfxr_configure(&config);
+
+    auto before = counters().initialize_calls;
+    auto status = native_host_initialize(host_handle_);
+    if (counters().initialize_calls == before)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+    EXPECT_EQ(status, NativeHostStatus::ERROR_RUNTIME_INIT);
+
+    mock_hostfxr_configure(nullptr);
+    EXPECT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(counters().open_contexts, 0u);
+}
+
+TEST_F(NativeHostMockTest, AttachesToRunningRuntime)
+{
+    if (counters().initialize_calls != 0)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+
+    const char *keys[] = {"System.GC.Server", "System.Globalization.Invariant"};
+    const char *values[] = {"false", "true"};
+    mock_hostfxr_start_runtime(keys, values, 2);
+
+    auto config_path = std::filesystem::temp_directory_path() / "native_host_attach.runtimeconfig.json";
+    {
+        std::ofstream config(config_path);
+        config << R"({
+  "runtimeOptions": {
+    "configProperties": {
+      "System.GC.Server": true,
+      "System.Globalization.Invariant": true,
+      "Plugin.Mode": "fast"
+    }
+  }
+})";
+    }
+
+    std::string config_path_utf8 = config_path.u8string();
+    native_host_runtime_options_t options{sizeof(options)};
+    options.runtime_config_path = config_path_utf8.c_str();
+    options.attach_mode = NATIVE_RUNTIME_ATTACH_REQUIRED;
+    ASSERT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::SUCCESS);
+    std::filesystem::remove(config_path);
+
+    native_runtime_attach_info_t info{};
+    ASSERT_EQ(native_host_get_runtime_attach_info(host_handle_, &info), NativeHostStatus::SUCCESS);
+    EXPECT_NE(info.attached, 0);
+    ASSERT_EQ(info.mismatch_count, 2u);
+    EXPECT_STREQ(info.mismatches[0].name, "Plugin.Mode");
+    EXPECT_STREQ(info.mismatches[0].requested, "fast");
+    EXPECT_EQ(info.mismatches[0].active, nullptr);
+    EXPECT_STREQ(info.mismatches[1].name, "System.GC.Server");
+    EXPECT_STREQ(info.mismatches[1].requested, "true");
+    EXPECT_STREQ(info.mismatches[1].active, "false");
+    EXPECT_EQ(counters().open_contexts, 0u) << "The secondary context should be closed after initialization";
+
+    // Delegates come from the running runtime through the secondary context
+    ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+              NativeHostStatus::SUCCESS);
+    void *fn_ptr = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(fn_ptr)(2, 3), 5);
+}
+
+TEST_F(NativeHostMockTest, AttachRequiredFailsWithoutRunningRuntime)
+{
+    if (counters().initialize_calls != 0)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+
+    native_host_runtime_options_t options{sizeof(options)};
+    options.attach_mode = NATIVE_RUNTIME_ATTACH_REQUIRED;
+    EXPECT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::ERROR_RUNTIME_INIT);
+    EXPECT_EQ(counters().initialize_calls, 0u) << "No runtime should be started when attaching is required";
+
+    ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+    native_runtime_attach_info_t info{};
+    ASSERT_EQ(native_host_get_runtime_attach_info(host_handle_, &info), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(info.attached, 0);
+    EXPECT_EQ(info.mismatch_count, 0u);
+}
+
+TEST_F(NativeHostMockTest, InvalidAttachModeIsRejected)
+{
+    native_host_runtime_options_t options{sizeof(options)};
+    options.attach_mode = static_cast<native_runtime_attach_mode_t>(7);
+    EXPECT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::ERROR_INVALID_ARG);
+
+    EXPECT_EQ(native_host_get_runtime_attach_info(host_handle_, nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+}
+
+TEST_F(NativeHostMockTest, ExplicitHostFxrPathSkipsProbing)
+{
+    if (counters().initialize_calls != 0)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+
+    // A link under another name resolves to the already loaded mock, so its counters stay
+    // shared, while the timeline shows which path the host picked
+    auto link_dir = std::filesystem::temp_directory_path() / "native_host_explicit_hostfxr";
+    std::filesystem::remove_all(link_dir);
+    std::filesystem::create_directories(link_dir);
+    auto link = link_dir / std::filesystem::path(MOCK_HOSTFXR_PATH).filename();
+    std::error_code ec;
+    std::filesystem::create_symlink(MOCK_HOSTFXR_PATH, link, ec);
+    if (ec)
+    {
+        GTEST_SKIP() << "Cannot create symbolic links here: " << ec.message();
+    }
+
+    std::string link_utf8 = link.u8string();
+    native_host_runtime_options_t options{sizeof(options)};
+    options.hostfxr_path = link_utf8.c_str();
+    options.attach_mode = NATIVE_RUNTIME_ATTACH_NEVER;
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::SUCCESS);
+    native_host_timeline_stop();
+    EXPECT_EQ(counters().initialize_calls, 1u);
+
+    auto trace_path = link_dir / "timeline.json";
+    ASSERT_EQ(native_host_timeline_write(trace_path.u8string().c_str()), NativeHostStatus::SUCCESS);
+    std::ifstream file(trace_path);
+    std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove_all(link_dir);
+
+    auto expected = "\"name\":\"resolve_hostfxr\"";
+    auto at = trace.find(expected);
+    ASSERT_NE(at, std::string::npos);
+    auto args = trace.substr(at, trace.find('}', at) - at);
+    EXPECT_NE(args.find("\"source\":\"hostfxr_path\""), std::string::npos) << args;
+    EXPECT_NE(args.find("native_host_explicit_hostfxr"), std::string::npos) << "The link is used as given: " << args;
+}
+
+TEST_F(NativeHostMockTest, MissingExplicitHostFxrPathFails)
+{
+    if (counters().initialize_calls != 0)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+
+    auto missing = (std::filesystem::temp_directory_path() / "native_host_no_such_dir" / "libhostfxr.so").u8string();
+    native_host_runtime_options_t options{sizeof(options)};
+    options.hostfxr_path = missing.c_str();
+    options.attach_mode = NATIVE_RUNTIME_ATTACH_NEVER;
+    EXPECT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::ERROR_RUNTIME_INIT);
+    EXPECT_EQ(counters().initialize_calls, 0u) << "A bad explicit path must not fall back to probing";
+
+    EXPECT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS) << "Initialization can be retried";
+}
+
+TEST_F(NativeHostMockTest, AutoAttachRejectsConflictingHostFxrPath)
+{
+    if (counters().initialize_calls != 0)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+
+    // A copy is another file than the mock this process already loaded
+    auto copy_dir = std::filesystem::temp_directory_path() / "native_host_conflicting_hostfxr";
+    std::filesystem::remove_all(copy_dir);
+    std::filesystem::create_directories(copy_dir);
+    auto copy = copy_dir / std::filesystem::path(MOCK_HOSTFXR_PATH).filename();
+    std::filesystem::copy_file(MOCK_HOSTFXR_PATH, copy);
+
+    std::string copy_utf8 = copy.u8string();
+    native_host_runtime_options_t options{sizeof(options)};
+    options.hostfxr_path = copy_utf8.c_str();
+    EXPECT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::ERROR_RUNTIME_INIT)
+        << "AUTO must not ignore an explicit hostfxr_path that differs from the loaded hostfxr";
+
+    std::string dir_utf8 = copy_dir.u8string();
+    options.hostfxr_path = nullptr;
+    options.dotnet_root = dir_utf8.c_str();
+    EXPECT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::ERROR_RUNTIME_INIT)
+        << "AUTO must not ignore an explicit dotnet_root that does not contain the loaded hostfxr";
+    EXPECT_EQ(counters().initialize_calls, 0u);
+    std::filesystem::remove_all(copy_dir);
+
+    EXPECT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS) << "Initialization can be retried";
+}
+
+TEST_F(NativeHostMockTest, AutoAttachAcceptsMatchingDotnetRoot)
+{
+    if (counters().initialize_calls != 0)
+    {
+        GTEST_SKIP() << "The runtime was initialized by an earlier test in this process";
+    }
+
+    std::string root_utf8 = std::filesystem::path(MOCK_HOSTFXR_PATH).parent_path().u8string();
+    native_host_runtime_options_t options{sizeof(options)};
+    options.dotnet_root = root_utf8.c_str();
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::SUCCESS);
+    native_host_timeline_stop();
+
+    auto trace_path = std::filesystem::temp_directory_path() / "native_host_matching_root.json";
+    ASSERT_EQ(native_host_timeline_write(trace_path.u8string().c_str()), NativeHostStatus::SUCCESS);
+    std::ifstream file(trace_path);
+    std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(trace_path);
+
+    auto at = trace.find("\"name\":\"resolve_hostfxr\"");
+    ASSERT_NE(at, std::string::npos);
+    auto args = trace.substr(at, trace.find('}', at) - at);
+    EXPECT_NE(args.find("\"source\":\"loaded\""), std::string::npos) << args;
+}
+
+TEST_F(NativeHostMockTest, RuntimeOptionsRequireStructSize)
+{
+    native_host_runtime_options_t options{};
+    EXPECT_EQ(native_host_initialize_with_options(host_handle_, &options), NativeHostStatus::ERROR_INVALID_ARG);
+}
+
+TEST_F(NativeHostMockTest, ShorterRuntimeOptionsFromOlderCallers)
+{
+    // The first version of the struct, followed by bytes the host must not read as later fields
+    struct FirstVersionOptions
+    {
+        uint32_t struct_size;
+        const char *dotnet_root;
+        const char *hostfxr_path;
+        const char *runtime_config_path;
+    };
+    union
+    {
+        FirstVersionOptions options;
+        unsigned char bytes[sizeof(native_host_runtime_options_t)];
+    } caller;
+    std::memset(caller.bytes, 0xFF, sizeof(caller.bytes));
+    caller.options = FirstVersionOptions{sizeof(FirstVersionOptions), nullptr, nullptr, nullptr};
+
+    EXPECT_EQ(native_host_initialize_with_options(
+                  host_handle_, reinterpret_cast<const native_host_runtime_options_t *>(caller.bytes)),
+              NativeHostStatus::SUCCESS);
+}
+
+namespace
+{
+    // Leaves a sampled call through longjmp, so it never returns through the profiling stub
+    void jump_out(void *state, int32_t, const native_value_t *)
+    {
+        std::longjmp(*static_cast<std::jmp_buf *>(state), 1);
+    }
+
+    struct NestedCall
+    {
+        AddNumbersAsyncDelegate add_async;
+        std::jmp_buf env;
+        int32_t result;
+    };
+
+    // Runs inside a sampled call and abandons a second, nested sampled call before returning
+    void abandon_nested_call(void *state, int32_t, const native_value_t *result)
+    {
+        auto *nested = static_cast<NestedCall *>(state);
+        nested->result = result->i32;
+        if (setjmp(nested->env) == 0)
+        {
+            nested->add_async(3, 4, jump_out, &nested->env);
+        }
+    }
+
+    void capture_backtrace(void *state, int32_t, const native_value_t *)
+    {
+#ifdef __linux__
+        void *frames[64];
+        *static_cast<int *>(state) = backtrace(frames, 64);
+#else
+        *static_cast<int *>(state) = 1;
+#endif
+    }
+}
+
+TEST_F(NativeHostMockTest, SamplingSurvivesCallsLeftThroughLongjmp)
+{
+    load_assembly();
+    if (!enable_profiling())
+    {
+        GTEST_SKIP() << "Profiling trampolines are not supported on this platform";
+    }
+    auto add_async = reinterpret_cast<AddNumbersAsyncDelegate>(get_delegate("AddNumbersAsync"));
+    auto add = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+
+    // More abandoned calls than the shadow stack has frames
+    for (int i = 0; i < 100; ++i)
+    {
+        std::jmp_buf env;
+        if (setjmp(env) == 0)
+        {
+            add_async(1, 2, jump_out, &env);
+        }
+    }
+
+    for (int32_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(add(i, 1), i + 1);
+    }
+    EXPECT_EQ(sampled_calls("AddNumbers"), 10u);
+}
+
+TEST_F(NativeHostMockTest, ReturnSkipsNestedCallsLeftThroughLongjmp)
+{
+    load_assembly();
+    if (!enable_profiling())
+    {
+        GTEST_SKIP() << "Profiling trampolines are not supported on this platform";
+    }
+
+    // The outer call returns while the abandoned inner call's frame is still on the shadow stack
+    NestedCall nested{};
+    nested.add_async = reinterpret_cast<AddNumbersAsyncDelegate>(get_delegate("AddNumbersAsync"));
+    nested.add_async(1, 2, abandon_nested_call, &nested);
+    EXPECT_EQ(nested.result, 3);
+    EXPECT_EQ(sampled_calls("AddNumbersAsync"), 1u) << "Only the call that returned is recorded";
+}
+
+TEST_F(NativeHostMockTest, BacktraceInsideSampledCallStopsAtReturnStub)
+{
+    load_assembly();
+    if (!enable_profiling())
+    {
+        GTEST_SKIP() << "Profiling trampolines are not supported on this platform";
+    }
+
+    // The caller's return address is only on the shadow stack; unwinding ends cleanly there
+    int depth = 0;
+    auto add_async = reinterpret_cast<AddNumbersAsyncDelegate>(get_delegate("AddNumbersAsync"));
+    add_async(1, 2, capture_backtrace, &depth);
+    EXPECT_GE(depth, 1);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <vector>
+
+using CounterAddDelegate = int32_t (*)(native_object_handle_t, int32_t);
+using CounterTotalDelegate = int32_t (*)(native_object_handle_t);
+
+class NativeHostObjectTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.Counter,TestLibrary";
+
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+                  NativeHostStatus::SUCCESS);
+
+        void *fn_ptr = nullptr;
+        ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "Add", &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+        add_ = reinterpret_cast<CounterAddDelegate>(fn_ptr);
+        ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "Total", &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+        total_ = reinterpret_cast<CounterTotalDelegate>(fn_ptr);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+    }
+
+    native_object_handle_t create()
+    {
+        native_object_handle_t object = nullptr;
+        EXPECT_EQ(native_host_create_object(host_handle_, assembly_handle_, type_name_.c_str(), &object),
+                  NativeHostStatus::SUCCESS);
+        EXPECT_NE(object, nullptr);
+        return object;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    CounterAddDelegate add_ = nullptr;
+    CounterTotalDelegate total_ = nullptr;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostObjectTest, InstancesKeepSeparateState)
+{
+    auto first = create();
+    auto second = create();
+    ASSERT_NE(first, second);
+
+    EXPECT_EQ(add_(first, 5), 5);
+    EXPECT_EQ(add_(first, 2), 7);
+    EXPECT_EQ(add_(second, 100), 100);
+    EXPECT_EQ(total_(first), 7);
+    EXPECT_EQ(total_(second), 100);
+
+    EXPECT_EQ(native_host_release_object(host_handle_, first), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_release_object(host_handle_, second), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostObjectTest, ReleasedHandlesAreReusedForNewObjects)
+{
+    auto object = create();
+    EXPECT_EQ(add_(object, 9), 9);
+    ASSERT_EQ(native_host_release_object(host_handle_, object), NativeHostStatus::SUCCESS);
+
+    auto fresh = create();
+    EXPECT_EQ(total_(fresh), 0) << "A recycled handle must point at the new object";
+    EXPECT_EQ(native_host_release_object(host_handle_, fresh), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostObjectTest, BatchRelease)
+{
+    std::vector<native_object_handle_t> objects;
+    for (int i = 0; i < 64; ++i)
+    {
+        objects.push_back(create());
+        EXPECT_EQ(add_(objects.back(), i), i);
+    }
+    for (int i = 0; i < 64; ++i)
+    {
+        EXPECT_EQ(total_(objects[i]), i);
+    }
+
+    EXPECT_EQ(native_host_release_objects(host_handle_, objects.data(), static_cast<uint32_t>(objects.size())),
+              NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_release_objects(host_handle_, nullptr, 0), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostObjectTest, InvalidBatchReleasesNothing)
+{
+    auto first = create();
+    auto second = create();
+
+    native_object_handle_t duplicated[] = {first, second, first};
+    EXPECT_EQ(native_host_release_objects(host_handle_, duplicated, 3), NativeHostStatus::ERROR_INVALID_ARG);
+
+    native_object_handle_t unknown[] = {first, reinterpret_cast<native_object_handle_t>(0x10)};
+    EXPECT_EQ(native_host_release_objects(host_handle_, unknown, 2), NativeHostStatus::ERROR_INVALID_ARG);
+
+    EXPECT_EQ(add_(first, 1), 1) << "Objects of a rejected batch stay alive";
+    native_object_handle_t both[] = {first, second};
+    EXPECT_EQ(native_host_release_objects(host_handle_, both, 2), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_release_object(host_handle_, first), NativeHostStatus::ERROR_INVALID_ARG)
+        << "Double release must be rejected before reaching the runtime";
+}
+
+TEST_F(NativeHostObjectTest, UnreleasedObjectsAreFreedWithHost)
+{
+    create();
+    create();
+    EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+    host_handle_ = nullptr;
+}
+
+TEST_F(NativeHostObjectTest, UnloadReleasesLiveObjects)
+{
+    auto first = create();
+    auto second = create();
+    ASSERT_EQ(native_host_release_object(host_handle_, second), NativeHostStatus::SUCCESS);
+
+    // Objects of an unloaded assembly can no longer be used, so unloading releases them instead of
+    // keeping them alive until the host is destroyed
+    ASSERT_EQ(native_host_unload_assembly(host_handle_, assembly_handle_), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_release_object(host_handle_, first), NativeHostStatus::ERROR_INVALID_ARG)
+        << "Unloading the assembly already released the object";
+}
+
+TEST_F(NativeHostObjectTest, UnknownTypeFails)
+{
+    native_object_handle_t object = nullptr;
+    EXPECT_EQ(native_host_create_object(host_handle_, assembly_handle_, "TestLibrary.NoSuchType,TestLibrary", &object),
+              NativeHostStatus::ERROR_TYPE_LOAD);
+    EXPECT_EQ(object, nullptr);
+}
+
+TEST_F(NativeHostObjectTest, TypeWithoutDefaultConstructorFails)
+{
+    native_object_handle_t object = nullptr;
+    EXPECT_EQ(native_host_create_object(host_handle_, assembly_handle_, "TestLibrary.NoDefaultConstructor,TestLibrary",
+                                        &object),
+              NativeHostStatus::ERROR_TYPE_LOAD);
+}
+
+TEST_F(NativeHostObjectTest, InvalidArguments)
+{
+    native_object_handle_t object = nullptr;
+    EXPECT_EQ(native_host_create_object(nullptr, assembly_handle_, type_name_.c_str(), &object),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_create_object(host_handle_, assembly_handle_, nullptr, &object),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_create_object(host_handle_, assembly_handle_, type_name_.c_str(), nullptr),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_create_object(host_handle_, reinterpret_cast<native_assembly_handle_t>(0x1),
+                                        type_name_.c_str(), &object),
+              NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+    EXPECT_EQ(native_host_release_object(host_handle_, nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_release_objects(host_handle_, nullptr, 1), NativeHostStatus::ERROR_INVALID_ARG);
+}
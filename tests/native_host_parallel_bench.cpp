@@ -0,0 +1,104 @@
+// Data-parallel benchmark: a CPU-bound kernel (ComputeRange) over a large index range through
+// native_host_parallel_for at 1..max threads, against a std::thread fan-out with one static
+// slice per thread (threads created per call, as callers did before the pool existed).
+// Each configuration is repeated and the fastest run is reported; speedup is relative to
+// parallel_for on one thread.
+
+#include "native_host.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using RangeKernel = void (*)(int64_t, int64_t, void *);
+
+template <typename Run>
+static double best_ms(int repeats, Run run)
+{
+    double best = 0;
+    for (int r = 0; r < repeats; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!run())
+            return -1;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = r == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [elements] [max_threads]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int64_t elements = argc > 3 ? atoll(argv[3]) : 4000000;
+    unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned max_threads = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : hardware_threads;
+    const int repeats = 5;
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    void *kernel = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "ComputeRange", &kernel) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    std::vector<double> output(static_cast<size_t>(elements));
+
+    // Warm up the pool, the kernel and the output pages
+    if (native_host_parallel_for(host, assembly, kernel, 0, elements, output.data(), nullptr) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    double single_ms = 0;
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    for (unsigned threads : thread_counts)
+    {
+        native_parallel_options_t options{};
+        options.max_threads = threads;
+        double ms = best_ms(repeats, [&]
+                            { return native_host_parallel_for(host, assembly, kernel, 0, elements, output.data(), &options) ==
+                                     NativeHostStatus::SUCCESS; });
+        if (ms < 0)
+            return 1;
+        if (threads == 1)
+            single_ms = ms;
+        printf("mode=parallel_for threads=%u elements=%lld ms=%.2f speedup=%.2f efficiency=%.2f\n", threads,
+               static_cast<long long>(elements), ms, single_ms / ms, single_ms / ms / threads);
+    }
+
+    auto fan_out = reinterpret_cast<RangeKernel>(kernel);
+    double fan_out_ms = best_ms(repeats, [&]
+                                {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < max_threads; ++t)
+        {
+            int64_t begin = elements * t / max_threads;
+            int64_t end = elements * (t + 1) / max_threads;
+            workers.emplace_back([&, begin, end]
+                                 { fan_out(begin, end, output.data()); });
+        }
+        for (auto &worker : workers)
+            worker.join();
+        return true; });
+    printf("mode=thread_fan_out threads=%u elements=%lld ms=%.2f speedup=%.2f efficiency=%.2f\n", max_threads,
+           static_cast<long long>(elements), fan_out_ms, single_ms / fan_out_ms, single_ms / fan_out_ms / max_threads);
+
+    native_host_destroy(host);
+    return 0;
+}
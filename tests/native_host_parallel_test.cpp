@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class NativeHostParallelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+                  NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "MarkRange", &mark_range_),
+                  NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+    }
+
+    // Every index must be handed to exactly one kernel call
+    static void expect_marked_once(const std::vector<int32_t> &marks, size_t begin, size_t end)
+    {
+        for (size_t i = 0; i < marks.size(); ++i)
+        {
+            ASSERT_EQ(marks[i], i >= begin && i < end ? 1 : 0) << "index " << i;
+        }
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    void *mark_range_ = nullptr;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostParallelTest, CoversRangeExactlyOnce)
+{
+    std::vector<int32_t> marks(1000003);
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0,
+                                       static_cast<int64_t>(marks.size()), marks.data(), nullptr),
+              NativeHostStatus::SUCCESS);
+    expect_marked_once(marks, 0, marks.size());
+}
+
+TEST_F(NativeHostParallelTest, OffsetRangeAndMinChunk)
+{
+    std::vector<int32_t> marks(10000);
+    native_parallel_options_t options{};
+    options.min_chunk = 777;
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 123, 9876, marks.data(), &options),
+              NativeHostStatus::SUCCESS);
+    expect_marked_once(marks, 123, 9876);
+}
+
+TEST_F(NativeHostParallelTest, SingleThreadRunsOnCaller)
+{
+    std::vector<int32_t> marks(5000);
+    native_parallel_options_t options{};
+    options.max_threads = 1;
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0, 5000, marks.data(), &options),
+              NativeHostStatus::SUCCESS);
+    expect_marked_once(marks, 0, marks.size());
+}
+
+TEST_F(NativeHostParallelTest, ConcurrentCallersShareThePool)
+{
+    constexpr int NUM_CALLERS = 4;
+    std::vector<std::vector<int32_t>> marks(NUM_CALLERS, std::vector<int32_t>(200000));
+    std::vector<std::thread> callers;
+    std::atomic<int> success_count{0};
+
+    for (int i = 0; i < NUM_CALLERS; ++i)
+    {
+        callers.emplace_back([&, i]()
+                             {
+            auto &own = marks[i];
+            if (native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0,
+                                         static_cast<int64_t>(own.size()), own.data(), nullptr) == NativeHostStatus::SUCCESS)
+            {
+                success_count++;
+            } });
+    }
+    for (auto &caller : callers)
+    {
+        caller.join();
+    }
+
+    EXPECT_EQ(success_count.load(), NUM_CALLERS);
+    for (const auto &own : marks)
+    {
+        expect_marked_once(own, 0, own.size());
+    }
+}
+
+namespace
+{
+    struct Completion
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int calls = 0;
+    };
+
+    void on_completed(void *user_data)
+    {
+        auto *completion = static_cast<Completion *>(user_data);
+        std::lock_guard<std::mutex> lock(completion->mutex);
+        completion->calls++;
+        completion->cv.notify_all();
+    }
+}
+
+TEST_F(NativeHostParallelTest, CompletionCallback)
+{
+    std::vector<int32_t> marks(300000);
+    Completion completion;
+    native_parallel_options_t options{};
+    options.on_completed = on_completed;
+    options.user_data = &completion;
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0,
+                                       static_cast<int64_t>(marks.size()), marks.data(), &options),
+              NativeHostStatus::SUCCESS);
+
+    std::unique_lock<std::mutex> lock(completion.mutex);
+    ASSERT_TRUE(completion.cv.wait_for(lock, std::chrono::seconds(10), [&]()
+                                       { return completion.calls > 0; }));
+    EXPECT_EQ(completion.calls, 1);
+    expect_marked_once(marks, 0, marks.size());
+}
+
+TEST_F(NativeHostParallelTest, EmptyRangeCompletesImmediately)
+{
+    Completion completion;
+    native_parallel_options_t options{};
+    options.on_completed = on_completed;
+    options.user_data = &completion;
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 42, 42, nullptr, &options),
+              NativeHostStatus::SUCCESS);
+    EXPECT_EQ(completion.calls, 1) << "An empty range completes inside the call";
+}
+
+TEST_F(NativeHostParallelTest, CountsAsInFlightCall)
+{
+    native_assembly_stats_t before{};
+    ASSERT_EQ(native_host_get_assembly_stats(host_handle_, assembly_handle_, &before), NativeHostStatus::SUCCESS);
+
+    std::vector<int32_t> marks(1000);
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0, 1000, marks.data(), nullptr),
+              NativeHostStatus::SUCCESS);
+
+    native_assembly_stats_t after{};
+    ASSERT_EQ(native_host_get_assembly_stats(host_handle_, assembly_handle_, &after), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(after.invocations, before.invocations + 1);
+
+    ASSERT_EQ(native_host_unload_assembly(host_handle_, assembly_handle_), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0, 1000, marks.data(), nullptr),
+              NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+}
+
+namespace
+{
+    struct DestroyFromCallback
+    {
+        native_host_handle_t host = nullptr;
+        std::thread::id caller;
+        Completion completion;
+        NativeHostStatus status = NativeHostStatus::SUCCESS;
+        bool on_caller = false;
+    };
+
+    void destroy_host(void *user_data)
+    {
+        auto *state = static_cast<DestroyFromCallback *>(user_data);
+        auto status = native_host_destroy(state->host);
+        std::lock_guard<std::mutex> lock(state->completion.mutex);
+        state->status = status;
+        state->on_caller = std::this_thread::get_id() == state->caller;
+        state->completion.calls++;
+        state->completion.cv.notify_all();
+    }
+}
+
+TEST_F(NativeHostParallelTest, DestroyFromCompletionCallback)
+{
+    // On a pool thread the destroy would have to join its own thread and is rejected; without
+    // worker threads the callback runs on the caller, after the call has stopped counting
+    DestroyFromCallback state;
+    state.host = host_handle_;
+    state.caller = std::this_thread::get_id();
+    std::vector<int32_t> marks(100000);
+    native_parallel_options_t options{};
+    options.on_completed = destroy_host;
+    options.user_data = &state;
+    ASSERT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0,
+                                       static_cast<int64_t>(marks.size()), marks.data(), &options),
+              NativeHostStatus::SUCCESS);
+
+    std::unique_lock<std::mutex> lock(state.completion.mutex);
+    ASSERT_TRUE(state.completion.cv.wait_for(lock, std::chrono::seconds(10), [&]()
+                                             { return state.completion.calls > 0; }));
+    if (state.on_caller)
+    {
+        EXPECT_EQ(state.status, NativeHostStatus::SUCCESS);
+        host_handle_ = nullptr;
+    }
+    else
+    {
+        EXPECT_EQ(state.status, NativeHostStatus::ERROR_NOT_SUPPORTED);
+    }
+    expect_marked_once(marks, 0, marks.size());
+}
+
+TEST_F(NativeHostParallelTest, UnknownAssemblyHandle)
+{
+    int32_t mark = 0;
+    EXPECT_EQ(native_host_parallel_for(host_handle_, &mark, mark_range_, 0, 1, &mark, nullptr),
+              NativeHostStatus::ERROR_ASSEMBLY_NOT_FOUND);
+    EXPECT_EQ(mark, 0);
+}
+
+TEST_F(NativeHostParallelTest, InvalidArguments)
+{
+    int32_t mark = 0;
+    EXPECT_EQ(native_host_parallel_for(nullptr, assembly_handle_, mark_range_, 0, 1, &mark, nullptr),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, nullptr, 0, 1, &mark, nullptr),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 2, 1, &mark, nullptr),
+              NativeHostStatus::ERROR_INVALID_ARG);
+
+    native_parallel_options_t options{};
+    options.min_chunk = -1;
+    EXPECT_EQ(native_host_parallel_for(host_handle_, assembly_handle_, mark_range_, 0, 1, &mark, &options),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(mark, 0);
+}
@@ -0,0 +1,102 @@
+// Performance check scenarios for perf_check.cmake. One process per run, because the runtime
+// can only be initialized once per process; each run prints one "metric=value" line per
+// scenario, in integer units so the driver script can sort and compare them.
+
+#include "native_host.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+using Clock = std::chrono::steady_clock;
+
+static long long elapsed_ns(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [lookup_threads]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int lookup_threads = argc > 3 ? atoi(argv[3]) : 4;
+    constexpr int warm_lookups = 1000;
+    constexpr int calls = 1000000;
+    constexpr int lookups_per_thread = 1000;
+
+    // Cold init: locate hostfxr, start the runtime and load the support assembly
+    auto start = Clock::now();
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+    printf("cold_init_us=%lld\n", elapsed_ns(start) / 1000);
+
+    // First delegate: assembly load, type load and JIT of the method
+    start = Clock::now();
+    native_assembly_handle_t assembly = nullptr;
+    void *fn_ptr = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "AddNumbers", &fn_ptr) != NativeHostStatus::SUCCESS)
+        return 1;
+    printf("first_delegate_us=%lld\n", elapsed_ns(start) / 1000);
+
+    // Warm delegate: repeated resolution of an already resolved method
+    std::vector<long long> samples(warm_lookups);
+    for (auto &sample : samples)
+    {
+        void *again = nullptr;
+        start = Clock::now();
+        if (native_host_get_delegate(host, assembly, type_name, "AddNumbers", &again) != NativeHostStatus::SUCCESS)
+            return 1;
+        sample = elapsed_ns(start);
+    }
+    std::sort(samples.begin(), samples.end());
+    printf("warm_delegate_ns=%lld\n", samples[samples.size() / 2]);
+
+    // Call overhead: native to managed transition through the delegate
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(fn_ptr);
+    volatile int32_t sink = 0;
+    start = Clock::now();
+    for (int i = 0; i < calls; ++i)
+    {
+        sink = add_numbers(i, 1);
+    }
+    printf("call_overhead_ps=%lld\n", elapsed_ns(start) * 1000 / calls);
+
+    // Multi-thread lookups: contention on the host lock
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    start = Clock::now();
+    for (int t = 0; t < lookup_threads; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < lookups_per_thread; ++i)
+            {
+                void *resolved = nullptr;
+                if (native_host_get_delegate(host, assembly, type_name, "AddNumbers", &resolved) != NativeHostStatus::SUCCESS)
+                    failures++;
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    if (failures > 0)
+        return 1;
+    printf("mt_lookup_ns=%lld\n", elapsed_ns(start) / (lookup_threads * lookups_per_thread));
+
+    (void)sink;
+    native_host_unload_assembly(host, assembly);
+    native_host_destroy(host);
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Profiling trampoline benchmark: cost per call of a plugin delegate called directly, through its
+// timing trampoline with profiling switched off, and with profiling on at several sample rates.
+// With profiling off the trampoline is one indirect jump; with it on, every call goes through the
+// shared timing stub and each sampled call reads the clock twice.
+
+#include "native_host.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+
+static bool measure(const char *mode, AddNumbersDelegate add_numbers, int iterations)
+{
+    // Warm up so the first measured mode does not pay for tiering or page faults
+    for (int i = 0; i < iterations / 10; ++i)
+    {
+        if (add_numbers(i, 1) != i + 1)
+            return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        if (add_numbers(i, 1) != i + 1)
+            return false;
+    }
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("mode=%s calls=%d ns_per_call=%.2f\n", mode, iterations, elapsed_ns / iterations);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <assembly_path> <type_name> [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    const char *assembly_path = argv[1];
+    const char *type_name = argv[2];
+    const int iterations = argc > 3 ? atoi(argv[3]) : 10000000;
+
+    native_host_handle_t host = nullptr;
+    if (native_host_create(&host) != NativeHostStatus::SUCCESS ||
+        native_host_initialize(host) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    native_assembly_handle_t assembly = nullptr;
+    void *direct = nullptr;
+    if (native_host_load_assembly(host, assembly_path, &assembly) != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "AddNumbers", &direct) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    void *trampoline = nullptr;
+    auto status = native_host_set_profiling(host, 1);
+    if (status == NativeHostStatus::ERROR_NOT_SUPPORTED)
+    {
+        fprintf(stderr, "Profiling trampolines are not supported on this platform\n");
+        return 0;
+    }
+    if (status != NativeHostStatus::SUCCESS ||
+        native_host_get_delegate(host, assembly, type_name, "AddNumbers", &trampoline) != NativeHostStatus::SUCCESS)
+        return 1;
+
+    auto direct_fn = reinterpret_cast<AddNumbersDelegate>(direct);
+    auto trampoline_fn = reinterpret_cast<AddNumbersDelegate>(trampoline);
+    char mode[32];
+
+    if (!measure("direct", direct_fn, iterations))
+        return 1;
+
+    native_host_set_profiling(host, 0);
+    if (!measure("trampoline_off", trampoline_fn, iterations))
+        return 1;
+
+    for (uint32_t rate : {64u, 8u, 1u})
+    {
+        native_host_set_profiling(host, rate);
+        snprintf(mode, sizeof(mode), "sample_rate_%u", rate);
+        if (!measure(mode, trampoline_fn, iterations))
+            return 1;
+    }
+
+    native_latency_profile_t profile{};
+    uint32_t count = 0;
+    if (native_host_get_latency_profiles(host, &profile, 1, &count) == NativeHostStatus::SUCCESS && count > 0)
+    {
+        printf("profile method=%s count=%llu p50_ns=%llu p99_ns=%llu max_ns=%llu\n",
+               profile.method_name,
+               static_cast<unsigned long long>(profile.stats.count),
+               static_cast<unsigned long long>(profile.stats.p50_ns),
+               static_cast<unsigned long long>(profile.stats.p99_ns),
+               static_cast<unsigned long long>(profile.stats.max_ns));
+    }
+
+    native_host_destroy(host);
+    return 0;
+}
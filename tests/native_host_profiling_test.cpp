@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using AddNumbersDelegate = int32_t (*)(int32_t, int32_t);
+using WeightedSumDelegate = double (*)(double, int32_t, double, int32_t, double, int32_t, double, int32_t, double,
+                                       int32_t, double, int32_t, double, int32_t, double, int32_t, double, int32_t);
+
+class NativeHostProfilingTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        status_ = native_host_create(&host_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+        status_ = native_host_initialize(host_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+        status_ = native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        if (native_host_set_profiling(host_handle_, 1) == NativeHostStatus::ERROR_NOT_SUPPORTED)
+        {
+            GTEST_SKIP() << "Profiling trampolines are not supported on this platform";
+        }
+        native_host_set_profiling(host_handle_, 0);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            status_ = native_host_destroy(host_handle_);
+            EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        }
+    }
+
+    void *get_delegate(const char *method_name)
+    {
+        void *fn_ptr = nullptr;
+        EXPECT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), method_name, &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+        return fn_ptr;
+    }
+
+    std::vector<native_latency_profile_t> profiles()
+    {
+        uint32_t count = 0;
+        EXPECT_EQ(native_host_get_latency_profiles(host_handle_, nullptr, 0, &count), NativeHostStatus::SUCCESS);
+        std::vector<native_latency_profile_t> result(count);
+        EXPECT_EQ(native_host_get_latency_profiles(host_handle_, result.data(), count, &count), NativeHostStatus::SUCCESS);
+        return result;
+    }
+
+    native_latency_stats_t stats(const char *method_name)
+    {
+        for (const auto &profile : profiles())
+        {
+            if (std::strcmp(profile.method_name, method_name) == 0)
+            {
+                EXPECT_EQ(profile.assembly, assembly_handle_);
+                return profile.stats;
+            }
+        }
+        ADD_FAILURE() << "No profile for " << method_name;
+        return {};
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    NativeHostStatus status_;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostProfilingTest, DelegateIsUnchangedWhileProfilingIsOff)
+{
+    void *first = get_delegate("AddNumbers");
+    void *second = get_delegate("AddNumbers");
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(profiles().empty());
+}
+
+TEST_F(NativeHostProfilingTest, TrampolinePreservesArgumentsAndResults)
+{
+    void *direct = get_delegate("AddNumbers");
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+
+    void *trampoline = get_delegate("AddNumbers");
+    EXPECT_NE(trampoline, direct);
+    EXPECT_EQ(get_delegate("AddNumbers"), trampoline);
+    EXPECT_EQ(reinterpret_cast<AddNumbersDelegate>(trampoline)(40, 2), 42);
+
+    auto weighted_sum = reinterpret_cast<WeightedSumDelegate>(get_delegate("WeightedSum"));
+    EXPECT_DOUBLE_EQ(weighted_sum(1.0, 1, 2.0, 2, 3.0, 3, 4.0, 4, 5.0, 5, 6.0, 6, 7.0, 7, 8.0, 8, 9.5, 9), 289.5);
+}
+
+TEST_F(NativeHostProfilingTest, RecordsLatencyPerEntryPoint)
+{
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+    auto weighted_sum = reinterpret_cast<WeightedSumDelegate>(get_delegate("WeightedSum"));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(add_numbers(i, 1), i + 1);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        weighted_sum(1.0, 1, 1.0, 1, 1.0, 1, 1.0, 1, 1.0, 1, 1.0, 1, 1.0, 1, 1.0, 1, 1.0, i);
+    }
+
+    ASSERT_EQ(profiles().size(), 2u);
+    auto add_stats = stats("AddNumbers");
+    EXPECT_EQ(add_stats.count, 1000u);
+    EXPECT_GT(add_stats.max_ns, 0u);
+    EXPECT_LE(add_stats.min_ns, add_stats.p50_ns);
+    EXPECT_LE(add_stats.p50_ns, add_stats.p90_ns);
+    EXPECT_LE(add_stats.p90_ns, add_stats.p99_ns);
+    EXPECT_LE(add_stats.p99_ns, add_stats.p999_ns);
+    EXPECT_LE(add_stats.p999_ns, add_stats.max_ns);
+    EXPECT_GE(add_stats.total_ns, add_stats.max_ns);
+    EXPECT_EQ(stats("WeightedSum").count, 10u);
+}
+
+TEST_F(NativeHostProfilingTest, SampleRateLimitsTimedCalls)
+{
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 4), NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+
+    for (int i = 0; i < 400; ++i)
+    {
+        add_numbers(i, 1);
+    }
+
+    // The countdown may carry over from earlier calls on this thread
+    EXPECT_NEAR(static_cast<double>(stats("AddNumbers").count), 100.0, 1.0);
+}
+
+TEST_F(NativeHostProfilingTest, DisablingKeepsTrampolinesCallable)
+{
+    void *direct = get_delegate("AddNumbers");
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+    add_numbers(1, 1);
+
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 0), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(get_delegate("AddNumbers"), direct);
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(add_numbers(i, 2), i + 2);
+    }
+    EXPECT_EQ(stats("AddNumbers").count, 1u);
+
+    // Switching back on resumes timing through the trampoline handed out earlier
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    add_numbers(1, 1);
+    EXPECT_EQ(stats("AddNumbers").count, 2u);
+}
+
+TEST_F(NativeHostProfilingTest, ResetClearsProfiles)
+{
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+    add_numbers(1, 1);
+    ASSERT_EQ(stats("AddNumbers").count, 1u);
+
+    ASSERT_EQ(native_host_reset_latency_profiles(host_handle_), NativeHostStatus::SUCCESS);
+    auto cleared = stats("AddNumbers");
+    EXPECT_EQ(cleared.count, 0u);
+    EXPECT_EQ(cleared.max_ns, 0u);
+
+    add_numbers(1, 1);
+    EXPECT_EQ(stats("AddNumbers").count, 1u);
+}
+
+TEST_F(NativeHostProfilingTest, ConcurrentCallersAreAllRecorded)
+{
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+
+    constexpr int thread_count = 4;
+    constexpr int calls = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([add_numbers]
+                             {
+                                 for (int i = 0; i < calls; ++i)
+                                 {
+                                     add_numbers(i, 1);
+                                 }
+                             });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(stats("AddNumbers").count, static_cast<uint64_t>(thread_count * calls));
+}
+
+TEST_F(NativeHostProfilingTest, ExitedThreadsAreFoldedIntoProfile)
+{
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    auto add_numbers = reinterpret_cast<AddNumbersDelegate>(get_delegate("AddNumbers"));
+
+    // Short-lived threads, one after another: each one's samples outlive the thread
+    constexpr int thread_count = 200;
+    constexpr int calls = 10;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        std::thread([add_numbers]
+                    {
+                        for (int i = 0; i < calls; ++i)
+                        {
+                            add_numbers(i, 1);
+                        }
+                    })
+            .join();
+    }
+
+    auto folded = stats("AddNumbers");
+    EXPECT_EQ(folded.count, static_cast<uint64_t>(thread_count * calls));
+    EXPECT_GT(folded.max_ns, 0u);
+    EXPECT_LE(folded.min_ns, folded.p50_ns);
+    EXPECT_LE(folded.p50_ns, folded.max_ns);
+
+    // Samples of a live thread are added on top of the exited ones
+    add_numbers(1, 1);
+    EXPECT_EQ(stats("AddNumbers").count, static_cast<uint64_t>(thread_count * calls + 1));
+
+    ASSERT_EQ(native_host_reset_latency_profiles(host_handle_), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(stats("AddNumbers").count, 0u) << "Reset also clears the samples of exited threads";
+}
+
+TEST_F(NativeHostProfilingTest, ProfilesReportTotalCount)
+{
+    ASSERT_EQ(native_host_set_profiling(host_handle_, 1), NativeHostStatus::SUCCESS);
+    get_delegate("AddNumbers");
+    get_delegate("WeightedSum");
+
+    native_latency_profile_t profile{};
+    uint32_t count = 0;
+    EXPECT_EQ(native_host_get_latency_profiles(host_handle_, &profile, 1, &count), NativeHostStatus::SUCCESS);
+    EXPECT_EQ(count, 2u);
+    EXPECT_STREQ(profile.method_name, "AddNumbers");
+    EXPECT_EQ(native_host_get_latency_profiles(host_handle_, nullptr, 1, &count), NativeHostStatus::ERROR_INVALID_ARG);
+}
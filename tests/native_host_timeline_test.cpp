@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+class NativeHostTimelineTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+        trace_path_ = std::filesystem::temp_directory_path() /
+                      ("native_host_timeline_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+                       ".json");
+    }
+
+    void TearDown() override
+    {
+        native_host_timeline_stop();
+        if (host_handle_ != nullptr)
+        {
+            EXPECT_EQ(native_host_destroy(host_handle_), NativeHostStatus::SUCCESS);
+        }
+        std::error_code ec;
+        std::filesystem::remove(trace_path_, ec);
+    }
+
+    void start_host()
+    {
+        ASSERT_EQ(native_host_create(&host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_initialize(host_handle_), NativeHostStatus::SUCCESS);
+        ASSERT_EQ(native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_),
+                  NativeHostStatus::SUCCESS);
+    }
+
+    std::string write_trace()
+    {
+        EXPECT_EQ(native_host_timeline_write(trace_path_.string().c_str()), NativeHostStatus::SUCCESS);
+        std::ifstream file(trace_path_, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    static size_t count(const std::string &text, const std::string &needle)
+    {
+        size_t result = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + needle.size()))
+        {
+            ++result;
+        }
+        return result;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    std::string assembly_path_;
+    std::string type_name_;
+    std::filesystem::path trace_path_;
+};
+
+TEST_F(NativeHostTimelineTest, RecordsHostOperations)
+{
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+    start_host();
+    void *fn_ptr = nullptr;
+    ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+              NativeHostStatus::SUCCESS);
+
+    auto trace = write_trace();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"name\":\"thread_name\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"initialize\",\"cat\":\"native_host\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"load_assembly\""), std::string::npos);
+    EXPECT_NE(trace.find("TestLibrary.dll\""), std::string::npos) << "Load spans carry the assembly path";
+    EXPECT_NE(trace.find("\"args\":{\"type\":\"TestLibrary.TestClass,TestLibrary\",\"method\":\"AddNumbers\"}"),
+              std::string::npos);
+    EXPECT_NE(trace.find("\"dropped_events\":0}}"), std::string::npos);
+}
+
+TEST_F(NativeHostTimelineTest, NothingRecordedWhenStopped)
+{
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+    ASSERT_EQ(native_host_timeline_stop(), NativeHostStatus::SUCCESS);
+    start_host();
+
+    auto trace = write_trace();
+    EXPECT_EQ(count(trace, "\"ph\":\"X\""), 0u);
+}
+
+TEST_F(NativeHostTimelineTest, StartClearsPreviousRecording)
+{
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+    start_host();
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+
+    auto trace = write_trace();
+    EXPECT_EQ(trace.find("\"name\":\"load_assembly\""), std::string::npos);
+}
+
+TEST_F(NativeHostTimelineTest, RingKeepsMostRecentEvents)
+{
+    start_host();
+    native_timeline_options_t options{};
+    options.events_per_thread = 4;
+    ASSERT_EQ(native_host_timeline_start(&options), NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "AddNumbers", &fn_ptr),
+                  NativeHostStatus::SUCCESS);
+    }
+
+    auto trace = write_trace();
+    EXPECT_EQ(count(trace, "\"name\":\"resolve_delegate\""), 4u);
+    EXPECT_NE(trace.find("\"dropped_events\":6}}"), std::string::npos);
+}
+
+TEST_F(NativeHostTimelineTest, EscapesArguments)
+{
+    start_host();
+    ASSERT_EQ(native_host_timeline_start(nullptr), NativeHostStatus::SUCCESS);
+
+    void *fn_ptr = nullptr;
+    native_host_get_delegate(host_handle_, assembly_handle_, "Odd\"Type\\Name", "AddNumbers", &fn_ptr);
+
+    auto trace = write_trace();
+    EXPECT_NE(trace.find("\"type\":\"Odd\\\"Type\\\\Name\""), std::string::npos);
+}
+
+TEST_F(NativeHostTimelineTest, InvalidPath)
+{
+    EXPECT_EQ(native_host_timeline_write(nullptr), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_timeline_write(""), NativeHostStatus::ERROR_INVALID_ARG);
+    auto missing = std::filesystem::temp_directory_path() / "native_host_no_such_dir" / "timeline.json";
+    EXPECT_EQ(native_host_timeline_write(missing.string().c_str()), NativeHostStatus::ERROR_INVALID_ARG);
+}
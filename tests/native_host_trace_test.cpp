@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "native_host.h"
+#include "test_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+class NativeHostTraceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        assembly_path_ = "../tests/TestLibrary.dll";
+        type_name_ = "TestLibrary.TestClass,TestLibrary";
+
+        status_ = native_host_create(&host_handle_);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        status_ = native_host_initialize(host_handle_);
+        EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+
+        status_ = native_host_load_assembly(host_handle_, assembly_path_.c_str(), &assembly_handle_);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (host_handle_ != nullptr)
+        {
+            status_ = native_host_destroy(host_handle_);
+            EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+        }
+    }
+
+    void callTraceTarget()
+    {
+        void *delegate = nullptr;
+        status_ = native_host_get_delegate(host_handle_, assembly_handle_, type_name_.c_str(), "TraceTarget", &delegate);
+        ASSERT_EQ(status_, NativeHostStatus::SUCCESS);
+        EXPECT_EQ(reinterpret_cast<int (*)(int)>(delegate)(2), 7);
+    }
+
+    // The runtime dispatches events in batches, so poll until the JIT event shows up
+    native_method_trace_stats_t waitForJit()
+    {
+        native_method_trace_stats_t stats{};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        do
+        {
+            status_ = native_host_trace_get_method_stats(host_handle_, type_name_.c_str(), "TraceTarget", &stats);
+            if (status_ != NativeHostStatus::SUCCESS || stats.jit_count > 0)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        } while (std::chrono::steady_clock::now() < deadline);
+        return stats;
+    }
+
+    native_host_handle_t host_handle_ = nullptr;
+    native_assembly_handle_t assembly_handle_ = nullptr;
+    NativeHostStatus status_ = NativeHostStatus::SUCCESS;
+    std::string assembly_path_;
+    std::string type_name_;
+};
+
+TEST_F(NativeHostTraceTest, AggregatesJitTimePerMethod)
+{
+    ASSERT_EQ(native_host_trace_start(host_handle_, nullptr), NativeHostStatus::SUCCESS);
+    callTraceTarget();
+
+    auto stats = waitForJit();
+    EXPECT_EQ(status_, NativeHostStatus::SUCCESS);
+    EXPECT_GE(stats.jit_count, 1u);
+    EXPECT_GT(stats.jit_time_ns, 0u);
+    EXPECT_LE(stats.max_jit_time_ns, stats.jit_time_ns);
+
+    native_trace_summary_t summary{};
+    ASSERT_EQ(native_host_trace_get_summary(host_handle_, &summary), NativeHostStatus::SUCCESS);
+    EXPECT_GE(summary.jit_count, stats.jit_count);
+    EXPECT_GE(summary.jit_time_ns, stats.jit_time_ns);
+
+    EXPECT_EQ(native_host_trace_stop(host_handle_), NativeHostStatus::SUCCESS);
+}
+
+TEST_F(NativeHostTraceTest, RecordsNettraceFile)
+{
+    auto path = std::filesystem::temp_directory_path() / "native_host_trace_test.nettrace";
+    std::filesystem::remove(path);
+    auto path_text = path.string();
+
+    native_trace_options_t options{};
+    options.keywords = NATIVE_TRACE_JIT | NATIVE_TRACE_GC;
+    options.output_path = path_text.c_str();
+    ASSERT_EQ(native_host_trace_start(host_handle_, &options), NativeHostStatus::SUCCESS);
+    callTraceTarget();
+    ASSERT_EQ(native_host_trace_stop(host_handle_), NativeHostStatus::SUCCESS);
+
+    ASSERT_TRUE(std::filesystem::exists(path));
+    EXPECT_GT(std::filesystem::file_size(path), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST_F(NativeHostTraceTest, QueryFailsWithoutSession)
+{
+    native_method_trace_stats_t stats{};
+    native_trace_summary_t summary{};
+    EXPECT_EQ(native_host_trace_get_method_stats(host_handle_, type_name_.c_str(), "TraceTarget", &stats),
+              NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_trace_get_summary(host_handle_, &summary), NativeHostStatus::ERROR_INVALID_ARG);
+    EXPECT_EQ(native_host_trace_get_method_stats(host_handle_, nullptr, "TraceTarget", &stats),
+              NativeHostStatus::ERROR_INVALID_ARG);
+}
@@ -0,0 +1,140 @@
+# Performance regression gate: runs native_host_perf_check repeatedly, compares the median of
+# each metric against the baseline recorded on this machine and fails when one exceeds its
+# tolerance.
+#
+# cmake -DPERF_EXE=... -DASSEMBLY=... -DTYPE_NAME=... -DSETTINGS=... -DBASELINE=... [-DRUNS=N]
+#       [-DTOLERANCE_PCT=N] [-DUPDATE_BASELINE=ON] -P perf_check.cmake
+#
+# SETTINGS holds the run count and the tolerances; it carries no timings, since those only mean
+# something on the machine that measured them. When BASELINE does not exist yet it is created
+# from SETTINGS and the measured medians, and the run passes. TOLERANCE_PCT overrides the
+# per-metric tolerances. UPDATE_BASELINE re-records the baseline instead of comparing.
+
+cmake_minimum_required(VERSION 3.20)
+
+if(EXISTS "${BASELINE}")
+    file(READ "${BASELINE}" BASELINE_JSON)
+else()
+    file(READ "${SETTINGS}" BASELINE_JSON)
+    set(UPDATE_BASELINE ON)
+    message(STATUS "No baseline at ${BASELINE}, recording one")
+endif()
+
+if(NOT DEFINED RUNS)
+    string(JSON RUNS GET "${BASELINE_JSON}" runs)
+endif()
+string(JSON DEFAULT_TOLERANCE GET "${BASELINE_JSON}" default_tolerance_pct)
+
+# Collect the samples of every run, one list per metric
+set(METRICS "")
+foreach(RUN RANGE 1 ${RUNS})
+    execute_process(
+        COMMAND "${PERF_EXE}" "${ASSEMBLY}" "${TYPE_NAME}"
+        OUTPUT_VARIABLE OUTPUT
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE RESULT
+    )
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "Perf check run ${RUN} failed: ${RESULT}")
+    endif()
+
+    string(REPLACE "\n" ";" LINES "${OUTPUT}")
+    foreach(LINE IN LISTS LINES)
+        if(LINE MATCHES "^([a-z_]+)=([0-9]+)$")
+            set(METRIC "${CMAKE_MATCH_1}")
+            list(APPEND SAMPLES_${METRIC} "${CMAKE_MATCH_2}")
+            if(NOT METRIC IN_LIST METRICS)
+                list(APPEND METRICS "${METRIC}")
+            endif()
+        endif()
+    endforeach()
+endforeach()
+
+function(pad OUT TEXT WIDTH)
+    string(LENGTH "${TEXT}" LENGTH)
+    while(LENGTH LESS WIDTH)
+        string(APPEND TEXT " ")
+        math(EXPR LENGTH "${LENGTH} + 1")
+    endwhile()
+    set(${OUT} "${TEXT}" PARENT_SCOPE)
+endfunction()
+
+function(table_row OUT METRIC BASE MEDIAN DELTA LIMIT STATUS)
+    pad(METRIC "${METRIC}" 20)
+    pad(BASE "${BASE}" 12)
+    pad(MEDIAN "${MEDIAN}" 12)
+    pad(DELTA "${DELTA}" 10)
+    pad(LIMIT "${LIMIT}" 8)
+    set(${OUT} "${METRIC}${BASE}${MEDIAN}${DELTA}${LIMIT}${STATUS}" PARENT_SCOPE)
+endfunction()
+
+table_row(ROW "metric" "baseline" "median" "delta" "limit" "status")
+message(STATUS "${ROW}")
+
+set(REGRESSIONS 0)
+foreach(METRIC IN LISTS METRICS)
+    set(SAMPLES ${SAMPLES_${METRIC}})
+    list(SORT SAMPLES COMPARE NATURAL)
+    list(LENGTH SAMPLES COUNT)
+    math(EXPR MIDDLE "${COUNT} / 2")
+    list(GET SAMPLES ${MIDDLE} MEDIAN)
+
+    string(JSON BASE ERROR_VARIABLE MISSING GET "${BASELINE_JSON}" metrics ${METRIC} value)
+    if(MISSING)
+        table_row(ROW "${METRIC}" "-" "${MEDIAN}" "-" "-" "new")
+        message(STATUS "${ROW}")
+        if(UPDATE_BASELINE)
+            # Keep a tolerance the settings already give the metric
+            string(JSON ENTRY ERROR_VARIABLE NO_ENTRY GET "${BASELINE_JSON}" metrics ${METRIC})
+            if(NO_ENTRY)
+                string(JSON BASELINE_JSON SET "${BASELINE_JSON}" metrics ${METRIC} "{\"value\": ${MEDIAN}}")
+            else()
+                string(JSON BASELINE_JSON SET "${BASELINE_JSON}" metrics ${METRIC} value ${MEDIAN})
+            endif()
+        endif()
+        continue()
+    endif()
+
+    if(DEFINED TOLERANCE_PCT)
+        set(TOLERANCE ${TOLERANCE_PCT})
+    else()
+        string(JSON TOLERANCE ERROR_VARIABLE NO_TOLERANCE GET "${BASELINE_JSON}" metrics ${METRIC} tolerance_pct)
+        if(NO_TOLERANCE)
+            set(TOLERANCE ${DEFAULT_TOLERANCE})
+        endif()
+    endif()
+
+    # All metrics are lower-is-better integers; a zero baseline counts as one unit
+    set(DIVISOR ${BASE})
+    if(DIVISOR EQUAL 0)
+        set(DIVISOR 1)
+    endif()
+    math(EXPR DELTA "(${MEDIAN} - ${BASE}) * 100 / ${DIVISOR}")
+    if(DELTA GREATER TOLERANCE)
+        set(STATUS "REGRESSION")
+        math(EXPR REGRESSIONS "${REGRESSIONS} + 1")
+    elseif(DELTA LESS -${TOLERANCE})
+        set(STATUS "improved")
+    else()
+        set(STATUS "ok")
+    endif()
+
+    if(DELTA GREATER_EQUAL 0)
+        set(DELTA "+${DELTA}")
+    endif()
+    table_row(ROW "${METRIC}" "${BASE}" "${MEDIAN}" "${DELTA}%" "${TOLERANCE}%" "${STATUS}")
+    message(STATUS "${ROW}")
+
+    if(UPDATE_BASELINE)
+        string(JSON BASELINE_JSON SET "${BASELINE_JSON}" metrics ${METRIC} value ${MEDIAN})
+    endif()
+endforeach()
+
+if(UPDATE_BASELINE)
+    get_filename_component(BASELINE_DIR "${BASELINE}" DIRECTORY)
+    file(MAKE_DIRECTORY "${BASELINE_DIR}")
+    file(WRITE "${BASELINE}" "${BASELINE_JSON}\n")
+    message(STATUS "Baseline updated: ${BASELINE}")
+elseif(REGRESSIONS GREATER 0)
+    message(FATAL_ERROR "${REGRESSIONS} metric(s) regressed beyond tolerance (medians of ${RUNS} runs)")
+endif()
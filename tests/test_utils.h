@@ -18,6 +18,19 @@ namespace test_utils
         return (std::filesystem::path(get_test_data_path()) / assembly_name).string();
     }
 
+    // Get the path to the NativeAOT build of a test library
+    inline std::string get_aot_library_path(const std::string& library_name)
+    {
+#ifdef _WIN32
+        const std::string suffix = ".dll";
+#elif defined(__APPLE__)
+        const std::string suffix = ".dylib";
+#else
+        const std::string suffix = ".so";
+#endif
+        return (std::filesystem::path(get_test_data_path()) / "aot" / (library_name + suffix)).string();
+    }
+
     // Get the full type name for a test class
     inline std::string get_test_type_name(const std::string& class_name, const std::string& assembly_name)
     {